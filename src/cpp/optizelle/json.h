@@ -360,6 +360,38 @@ namespace Optizelle {
                 state.eps_trunc=read::real <Real> (
                     root["Optizelle"].get("eps_trunc",state.eps_trunc),
                     "eps_trunc");
+                state.trunc_reuse=read::param <KrylovReuse::t> (
+                    root["Optizelle"].get("trunc_reuse",
+                        KrylovReuse::to_string(state.trunc_reuse)),
+                    KrylovReuse::is_valid,
+                    KrylovReuse::from_string,
+                    "trunc_reuse");
+                state.trunc_solver=read::param <TrustRegionSolver::t> (
+                    root["Optizelle"].get("trunc_solver",
+                        TrustRegionSolver::to_string(state.trunc_solver)),
+                    TrustRegionSolver::is_valid,
+                    TrustRegionSolver::from_string,
+                    "trunc_solver");
+                state.trunc_forcing=read::param <ForcingTerm::t> (
+                    root["Optizelle"].get("trunc_forcing",
+                        ForcingTerm::to_string(state.trunc_forcing)),
+                    ForcingTerm::is_valid,
+                    ForcingTerm::from_string,
+                    "trunc_forcing");
+                state.nonmono_kind=read::param <NonmonotoneKind::t> (
+                    root["Optizelle"].get("nonmono_kind",
+                        NonmonotoneKind::to_string(state.nonmono_kind)),
+                    NonmonotoneKind::is_valid,
+                    NonmonotoneKind::from_string,
+                    "nonmono_kind");
+                state.nonmono_mem=read::natural(
+                    root["Optizelle"].get(
+                        "nonmono_mem",
+                        Json::Value::UInt64(state.nonmono_mem)),
+                    "nonmono_mem");
+                state.nonmono_eta=read::real <Real> (
+                    root["Optizelle"].get("nonmono_eta",state.nonmono_eta),
+                    "nonmono_eta");
                 state.algorithm_class=read::param <AlgorithmClass::t> (
                     root["Optizelle"].get("algorithm_class",
                         AlgorithmClass::to_string(state.algorithm_class)),
@@ -403,6 +435,9 @@ namespace Optizelle {
                 state.c1=read::real <Real> (
                     root["Optizelle"].get("c1",state.c1),
                     "c1");
+                state.c2=read::real <Real> (
+                    root["Optizelle"].get("c2",state.c2),
+                    "c2");
                 state.ls_iter_max=read::natural(
                     root["Optizelle"].get(
                         "ls_iter_max",
@@ -486,6 +521,17 @@ namespace Optizelle {
                 root["Optizelle"]["trunc_orthog_iter_max"]=write::natural(
                     state.trunc_orthog_iter_max);
                 root["Optizelle"]["eps_trunc"]=write::real(state.eps_trunc);
+                root["Optizelle"]["trunc_reuse"]=write_param(
+                    KrylovReuse::to_string,state.trunc_reuse);
+                root["Optizelle"]["trunc_solver"]=write_param(
+                    TrustRegionSolver::to_string,state.trunc_solver);
+                root["Optizelle"]["trunc_forcing"]=write_param(
+                    ForcingTerm::to_string,state.trunc_forcing);
+                root["Optizelle"]["nonmono_kind"]=write_param(
+                    NonmonotoneKind::to_string,state.nonmono_kind);
+                root["Optizelle"]["nonmono_mem"]=write::natural(
+                    state.nonmono_mem);
+                root["Optizelle"]["nonmono_eta"]=write::real(state.nonmono_eta);
                 root["Optizelle"]["algorithm_class"]=write_param(
                     AlgorithmClass::to_string,state.algorithm_class);
                 root["Optizelle"]["PH_type"]=write_param(
@@ -500,6 +546,7 @@ namespace Optizelle {
                 root["Optizelle"]["eta2"]=write::real(state.eta2);
                 root["Optizelle"]["alpha0"]=write::real(state.alpha0);
                 root["Optizelle"]["c1"]=write::real(state.c1);
+                root["Optizelle"]["c2"]=write::real(state.c2);
                 root["Optizelle"]["ls_iter_max"]=write::natural(
                     state.ls_iter_max);
                 root["Optizelle"]["eps_ls"]=write::real(state.eps_ls);
@@ -534,6 +581,9 @@ namespace Optizelle {
                 std::string const & fname,
                 typename Optizelle::Unconstrained <Real,XX>::State::t & state
             ) {
+                // Charge the file to the checkpoint phase
+                Profile::Timer timer(Profile::Checkpoint);
+
                 // Grab the iteration number
                 Natural iter = state.iter;
 
@@ -566,6 +616,9 @@ namespace Optizelle {
                 X_Vector const & x,
                 typename Optizelle::Unconstrained <Real,XX>::State::t & state
             ) {
+                // Charge the file to the checkpoint phase
+                Profile::Timer timer(Profile::Checkpoint);
+
                 // Read in the input file
                 Json::Value root=parse(fname);
 
@@ -670,6 +723,21 @@ namespace Optizelle {
                         "augsys_rst_freq",
                         Json::Value::UInt64(state.augsys_rst_freq)),
                     "augsys_rst_freq");
+                state.augsys_recycle=read::natural(
+                    root["Optizelle"].get(
+                        "augsys_recycle",
+                        Json::Value::UInt64(state.augsys_recycle)),
+                    "augsys_recycle");
+                state.augsys_proj_cache=read::natural(
+                    root["Optizelle"].get(
+                        "augsys_proj_cache",
+                        Json::Value::UInt64(state.augsys_proj_cache)),
+                    "augsys_proj_cache");
+                state.augsys_broyden=read::natural(
+                    root["Optizelle"].get(
+                        "augsys_broyden",
+                        Json::Value::UInt64(state.augsys_broyden)),
+                    "augsys_broyden");
                 state.PSchur_left_type=read::param <Operators::t> (
                     root["Optizelle"].get("PSchur_left_type",
                         Operators::to_string(state.PSchur_left_type)),
@@ -682,6 +750,12 @@ namespace Optizelle {
                     Operators::is_valid,
                     Operators::from_string,
                     "PSchur_right_type");
+                state.augsys_solver=read::param <AugmentedSystemSolver::t> (
+                    root["Optizelle"].get("augsys_solver",
+                        AugmentedSystemSolver::to_string(state.augsys_solver)),
+                    AugmentedSystemSolver::is_valid,
+                    AugmentedSystemSolver::from_string,
+                    "augsys_solver");
                 state.g_diag=read::param <FunctionDiagnostics::t> (
                     root["Optizelle"].get("g_diag",
                         FunctionDiagnostics::to_string(state.g_diag)),
@@ -733,10 +807,18 @@ namespace Optizelle {
                     state.augsys_iter_max);
                 root["Optizelle"]["augsys_rst_freq"]=write::natural(
                     state.augsys_rst_freq);
+                root["Optizelle"]["augsys_recycle"]=write::natural(
+                    state.augsys_recycle);
+                root["Optizelle"]["augsys_proj_cache"]=write::natural(
+                    state.augsys_proj_cache);
+                root["Optizelle"]["augsys_broyden"]=write::natural(
+                    state.augsys_broyden);
                 root["Optizelle"]["PSchur_left_type"]=write_param(
                     Operators::to_string,state.PSchur_left_type);
                 root["Optizelle"]["PSchur_right_type"]=write_param(
                     Operators::to_string,state.PSchur_right_type);
+                root["Optizelle"]["augsys_solver"]=write_param(
+                    AugmentedSystemSolver::to_string,state.augsys_solver);
                 root["Optizelle"]["g_diag"]=write_param(
                     FunctionDiagnostics::to_string,state.g_diag);
                 root["Optizelle"]["y_diag"]=write_param(
@@ -762,6 +844,9 @@ namespace Optizelle {
                 typename Optizelle::EqualityConstrained <Real,XX,YY>::State::t &
                     state
             ) {
+                // Charge the file to the checkpoint phase
+                Profile::Timer timer(Profile::Checkpoint);
+
                 // Grab the iteration number
                 Natural iter = state.iter;
 
@@ -798,6 +883,9 @@ namespace Optizelle {
                 typename Optizelle::EqualityConstrained <Real,XX,YY>::State::t &
                     state
             ) {
+                // Charge the file to the checkpoint phase
+                Profile::Timer timer(Profile::Checkpoint);
+
                 // Read in the input file
                 Json::Value root=parse(fname);
 
@@ -863,6 +951,18 @@ namespace Optizelle {
                 state.gamma=read::real <Real> (
                     root["Optizelle"].get("gamma",state.gamma),
                     "gamma");
+                state.ip_scheme=read::param <InteriorPointScheme::t> (
+                    root["Optizelle"].get("ip_scheme",
+                        InteriorPointScheme::to_string(state.ip_scheme)),
+                    InteriorPointScheme::is_valid,
+                    InteriorPointScheme::from_string,
+                    "ip_scheme");
+                state.ip_scaling=read::param <InteriorPointScaling::t> (
+                    root["Optizelle"].get("ip_scaling",
+                        InteriorPointScaling::to_string(state.ip_scaling)),
+                    InteriorPointScaling::is_valid,
+                    InteriorPointScaling::from_string,
+                    "ip_scaling");
                 state.h_diag=read::param <FunctionDiagnostics::t> (
                     root["Optizelle"].get("h_diag",
                         FunctionDiagnostics::to_string(state.h_diag)),
@@ -903,6 +1003,10 @@ namespace Optizelle {
                 root["Optizelle"]["mu"]=write::real(state.mu);
                 root["Optizelle"]["sigma"]=write::real(state.sigma);
                 root["Optizelle"]["gamma"]=write::real(state.gamma);
+                root["Optizelle"]["ip_scheme"]=write_param(
+                    InteriorPointScheme::to_string,state.ip_scheme);
+                root["Optizelle"]["ip_scaling"]=write_param(
+                    InteriorPointScaling::to_string,state.ip_scaling);
                 root["Optizelle"]["h_diag"]=write_param(
                     FunctionDiagnostics::to_string,state.h_diag);
                 root["Optizelle"]["z_diag"]=write_param(
@@ -928,6 +1032,9 @@ namespace Optizelle {
                 typename Optizelle::InequalityConstrained<Real,XX,ZZ>::State::t&
                     state
             ) {
+                // Charge the file to the checkpoint phase
+                Profile::Timer timer(Profile::Checkpoint);
+
                 // Grab the iteration number
                 Natural iter = state.iter;
 
@@ -964,6 +1071,9 @@ namespace Optizelle {
                 typename Optizelle::InequalityConstrained<Real,XX,ZZ>::State::t&
                     state
             ) {
+                // Charge the file to the checkpoint phase
+                Profile::Timer timer(Profile::Checkpoint);
+
                 // Read in the input file
                 Json::Value root=parse(fname);
 
@@ -985,6 +1095,144 @@ namespace Optizelle {
             }
         };
 
+        template <
+            typename Real,
+            template <typename> class XX
+        >
+        struct BoundConstrained {
+            // Create some type shortcuts
+            typedef typename Optizelle::BoundConstrained <Real,XX>::X_Vector
+                X_Vector;
+
+            typedef typename Optizelle::BoundConstrained <Real,XX>
+                ::Restart::X_Vectors X_Vectors;
+            typedef typename Optizelle::BoundConstrained <Real,XX>
+                ::Restart::Reals Reals;
+            typedef typename Optizelle::BoundConstrained <Real,XX>
+                ::Restart::Naturals Naturals;
+            typedef typename Optizelle::BoundConstrained <Real,XX>
+                ::Restart::Params Params;
+
+            // Read parameters from file
+            static void read_(
+                std::string const & fname,
+                typename Optizelle::BoundConstrained <Real,XX>::State::t &
+                    state
+            ) {
+                // Read in the input file
+                Json::Value root=parse(fname);
+
+                // Read in the parameters
+                state.gamma=read::real <Real> (
+                    root["Optizelle"].get("gamma",state.gamma),
+                    "gamma");
+                state.bound_push=read::real <Real> (
+                    root["Optizelle"].get("bound_push",state.bound_push),
+                    "bound_push");
+            }
+            static void read(
+                std::string const & fname,
+                typename Optizelle::BoundConstrained <Real,XX>::State::t &
+                    state
+            ) {
+                Unconstrained <Real,XX>::read_(fname,state);
+                BoundConstrained <Real,XX>::read_(fname,state);
+                Optizelle::BoundConstrained <Real,XX>::State::check(state);
+            }
+
+            // Convert parameters to a string
+            static std::string to_string_(
+                typename Optizelle::BoundConstrained <Real,XX>::State::t &
+                    state
+            ) {
+                // Create a new root for writing
+                Json::Value root;
+
+                // Create a string with the above output
+                Json::StyledWriter writer;
+
+                // Write the optimization parameters
+                root["Optizelle"]["gamma"]=write::real(state.gamma);
+                root["Optizelle"]["bound_push"]=write::real(state.bound_push);
+
+                return writer.write(root);
+            }
+            static std::string to_string(
+                typename Optizelle::BoundConstrained <Real,XX>::State::t &
+                    state
+            ) {
+                std::string ucon
+                    = Unconstrained <Real,XX>::to_string_(state);
+                std::string bcon
+                    = BoundConstrained <Real,XX>::to_string_(state);
+                return ucon.substr(0,ucon.size()-8)+",\n"+
+                       bcon.substr(17,bcon.size());
+            }
+
+            // Write all parameters to file
+            static void write_restart(
+                std::string const & fname,
+                typename Optizelle::BoundConstrained <Real,XX>::State::t &
+                    state
+            ) {
+                // Charge the file to the checkpoint phase
+                Profile::Timer timer(Profile::Checkpoint);
+
+                // Grab the iteration number
+                Natural iter = state.iter;
+
+                // Do a release
+                X_Vectors xs;
+                Reals reals;
+                Naturals nats;
+                Params params;
+                Optizelle::BoundConstrained <Real,XX>::Restart::release(
+                    state,xs,reals,nats,params);
+
+                // Serialize everything
+                Json::Value root;
+                Serialize::vectors <Real,XX>(xs,"X_Vectors",iter,root);
+                Serialize::reals <Real> (reals,"Reals",root);
+                Serialize::naturals(nats,"Naturals",root);
+                Serialize::parameters(params,"Parameters",root);
+
+                // Write everything to file
+                write_to_file(fname,root);
+
+                // Recapture the state
+                Optizelle::BoundConstrained <Real,XX>::Restart::capture(
+                    state,xs,reals,nats,params);
+            }
+
+            // Read all the parameters from file
+            static void read_restart(
+                std::string const & fname,
+                X_Vector const & x,
+                typename Optizelle::BoundConstrained <Real,XX>::State::t &
+                    state
+            ) {
+                // Charge the file to the checkpoint phase
+                Profile::Timer timer(Profile::Checkpoint);
+
+                // Read in the input file
+                Json::Value root=parse(fname);
+
+                // Extract everything from the parsed json file
+                X_Vectors xs;
+                Reals reals;
+                Naturals nats;
+                Params params;
+                Deserialize::vectors <Real,XX>(root,"X_Vectors",x,xs);
+                Deserialize::reals <Real> (root,"Reals",reals);
+                Deserialize::naturals(root,"Naturals",nats);
+                Deserialize::parameters(root,"Parameters",params);
+
+                // Move this information into the state
+                Optizelle::BoundConstrained <Real,XX>::Restart::capture(
+                    state,xs,reals,nats,params);
+            }
+        };
+
         template < typename Real,
             template <typename> class XX,
             template <typename> class YY, 
@@ -1046,6 +1294,9 @@ namespace Optizelle {
                 typename Optizelle::Constrained <Real,XX,YY,ZZ>::State::t &
                     state
             ) {
+                // Charge the file to the checkpoint phase
+                Profile::Timer timer(Profile::Checkpoint);
+
                 // Grab the iteration number
                 Natural iter = state.iter;
 
@@ -1084,6 +1335,9 @@ namespace Optizelle {
                 Z_Vector const & z,
                 typename Optizelle::Constrained <Real,XX,YY,ZZ>::State::t& state
             ) {
+                // Charge the file to the checkpoint phase
+                Profile::Timer timer(Profile::Checkpoint);
+
                 // Read in the input file
                 Json::Value root=parse(fname);
 
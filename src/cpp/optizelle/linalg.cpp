@@ -1,6 +1,8 @@
 #include "optizelle/linalg.h"
 #include "optizelle/exception.h"
 #include "FortranCInterface.h"
+#include <sstream>
+#include <iomanip>
 
 using Optizelle::Integer;
 
@@ -806,6 +808,93 @@ namespace Optizelle {
         return i-Natural(1);
     }
     
+    namespace Profile {
+        // Converts the phase to a string
+        std::string to_string(t const & phase){
+            switch(phase){
+            case Objective:
+                return "Objective";
+            case Gradient:
+                return "Gradient";
+            case HessVec:
+                return "HessVec";
+            case Constraints:
+                return "Constraints";
+            case ConstraintJacobian:
+                return "ConstraintJacobian";
+            case ConstraintHessian:
+                return "ConstraintHessian";
+            case Preconditioner:
+                return "Preconditioner";
+            case VectorSpace:
+                return "VectorSpace";
+            case Krylov:
+                return "Krylov";
+            case LineSearch:
+                return "LineSearch";
+            case Checkpoint:
+                return "Checkpoint";
+            default:
+                throw Exception::t(__LOC__ +", invalid Profile::t");
+            }
+        }
+
+        // Start with nothing 
+        Counters::Counters() :
+            seconds(),
+            calls(),
+            total(0.),
+            start(),
+            top(nullptr)
+        {
+            seconds.fill(0.);
+            calls.fill(0);
+        }
+
+        // Seconds spent in all of the solves, including the active one
+        double Counters::elapsed() const {
+            return active()==this ?
+                total + std::chrono::duration <double> (
+                    std::chrono::steady_clock::now()-start).count() :
+                total;
+        }
+
+        // Seconds spent in the objective and constraints
+        double Counters::model() const {
+            return seconds[Objective] + seconds[Gradient] + seconds[HessVec]
+                + seconds[Constraints] + seconds[ConstraintJacobian]
+                + seconds[ConstraintHessian];
+        }
+
+        // Seconds spent everywhere else
+        double Counters::solver() const {
+            return elapsed()-model();
+        }
+
+        // Counters that the timers on this thread add to
+        Counters * & active() {
+            static thread_local Counters * counters = nullptr;
+            return counters;
+        }
+
+        // Converts the counters to a JSON string
+        std::string to_json(Counters const & counters) {
+            std::stringstream ss;
+            ss << std::setprecision(6) << std::scientific
+                << "{\"total\": " << counters.elapsed()
+                << ", \"model\": " << counters.model()
+                << ", \"solver\": " << counters.solver()
+                << ", \"phases\": {";
+            for(Natural i=0;i<Size;i++)
+                ss << (i>0 ? ", " : "")
+                    << "\"" << to_string(t(i)) << "\": {\"seconds\": "
+                    << counters.seconds[i] << ", \"calls\": "
+                    << counters.calls[i] << "}";
+            ss << "}}";
+            return ss.str();
+        }
+    }
+
     namespace TruncatedStop{
         // Converts the truncated CG stopping condition to a string 
         std::string to_string(t const & trunc_stop){
@@ -840,6 +929,8 @@ namespace Optizelle {
                 return "TooManyFailedSafeguard";
             case ObjectiveIncrease:
                 return "ObjectiveIncrease";
+            case ModelDecreaseSmall:
+                return "ModelDecreaseSmall";
             default:
                 throw Exception::t(__LOC__ +", invalid TruncatedStop::t");
             }
@@ -877,6 +968,8 @@ namespace Optizelle {
                 return TooManyFailedSafeguard;
             else if(trunc_stop=="ObjectiveIncrease")
                 return ObjectiveIncrease;
+            else if(trunc_stop=="ModelDecreaseSmall")
+                return ModelDecreaseSmall;
             else
                 throw Exception::t(__LOC__
                     + ", string can't be convert into a TruncatedStop::t"); 
@@ -898,7 +991,8 @@ namespace Optizelle {
                 name=="OffsetViolatesTrustRegion" ||
                 name=="OffsetViolatesSafeguard" ||
                 name=="TooManyFailedSafeguard" ||
-                name=="ObjectiveIncrease"
+                name=="ObjectiveIncrease" ||
+                name=="ModelDecreaseSmall"
             )
                 return true;
             else
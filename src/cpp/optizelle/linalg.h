@@ -6,12 +6,18 @@
 #include <cmath>
 #include <limits>
 #include <utility>
+#include <tuple>
 #include <string>
 #include <cstddef>
 #include <iostream>
 #include <cstdlib>
 #include <random>
 #include <functional>
+#include <set>
+#include <algorithm>
+#include <iterator>
+#include <chrono>
+#include <array>
 
 // Putting this into a class prevents its construction.  Essentially, we use
 // this trick in order to create modules like in ML.  It also allows us to
@@ -592,6 +598,21 @@ namespace Optizelle {
         // y = A(x)
         virtual void eval(X_Vector const & x,Y_Vector &y) const = 0;
 
+        // ys[i] = A(xs[i]) for a batch of vectors.  The outputs must already
+        // be allocated.  By default, we apply the operator one vector at a
+        // time, but operators that can share work between the vectors, such
+        // as a single factorization, should override this.
+        virtual void eval_many(
+            std::list <X_Vector> const & xs,
+            std::list <Y_Vector> & ys
+        ) const {
+            auto y = ys.begin();
+            for(auto const & x : xs) {
+                eval(x,*y);
+                y++;
+            }
+        }
+
         // Allow a derived class to deallocate memory 
         virtual ~Operator() {}
     };
@@ -1057,6 +1078,178 @@ namespace Optizelle {
             return std::vector <Real> ();
     }
 
+    // Instrumentation that records where an optimization spends its time.
+    // When we compile with OPTIZELLE_PROFILE, each Timer adds its wall-clock
+    // time and one call to its phase in the counters of the active solve.
+    // Otherwise, the timers are empty and the compiler removes them.
+    namespace Profile {
+        enum t : Natural {
+            //---Profile0---
+            Objective,          // Evaluations of the objective, f(x)
+            Gradient,           // Gradients of the objective
+            HessVec,            // Hessian-vector products of the objective
+            Constraints,        // Evaluations of the constraints
+            ConstraintJacobian, // Derivatives of the constraints and their
+                                // adjoints
+            ConstraintHessian,  // Second derivative adjoints of the
+                                // constraints
+            Preconditioner,     // Applications of the preconditioners
+            VectorSpace,        // Vector space operations in the algorithms
+            Krylov,             // Krylov solvers, which includes their
+                                // orthogonalization and vector operations
+            LineSearch,         // Line searches
+            Checkpoint,         // Reading and writing restart files
+            Size                // Number of phases
+            //---Profile1---
+        };
+
+        // Converts the phase to a string
+        std::string to_string(t const & phase);
+
+        // Times a phase for the life of the object
+        struct Timer;
+
+        // Time and calls spent in each phase.  Since phases nest, such as
+        // the vector space operations inside of a line search, each phase
+        // only counts the time that it doesn't spend in other phases.
+        struct Counters {
+            // Seconds spent in each phase
+            std::array <double,Size> seconds;
+
+            // Number of times that we entered each phase
+            std::array <Natural,Size> calls;
+
+            // Seconds spent in the finished solves
+            double total;
+
+            // Beginning of the active solve
+            std::chrono::steady_clock::time_point start;
+
+            // Innermost running timer
+            Timer * top;
+
+            // Start with nothing 
+            Counters();
+
+            // Seconds spent in all of the solves, including the active one
+            double elapsed() const;
+
+            // Seconds spent in the objective and constraints
+            double model() const;
+
+            // Seconds spent everywhere else
+            double solver() const;
+        };
+
+        // Counters that the timers on this thread add to
+        Counters * & active();
+
+        // Converts the counters to a JSON string
+        std::string to_json(Counters const & counters);
+
+        struct Timer {
+            // Prevent the use of the copy constructor and the assignment
+            // operator
+            NO_COPY_ASSIGNMENT(Timer)
+        #ifdef OPTIZELLE_PROFILE
+        private:
+            // Counters that we add to
+            Counters * counters;
+
+            // Phase that we time
+            t phase;
+
+            // Timer that was running when we started
+            Timer * parent;
+
+            // When we started
+            std::chrono::steady_clock::time_point start;
+
+            // Seconds spent in nested phases
+            double nested;
+
+        public:
+            // Start the timer.  We skip timers outside of a profiled solve
+            // and those that nest inside of the same phase, so that wrapped
+            // functions only count once.
+            explicit Timer(t const & phase_) :
+                counters(active()),
+                phase(phase_),
+                parent(nullptr),
+                start(),
+                nested(0.)
+            {
+                if(!counters)
+                    return;
+                parent = counters->top;
+                if(parent && parent->phase==phase) {
+                    counters = nullptr;
+                    return;
+                }
+                counters->top = this;
+                start = std::chrono::steady_clock::now();
+            }
+
+            // Stop the timer and charge the elapsed time, less the time
+            // in nested phases, to our phase
+            ~Timer() {
+                if(!counters)
+                    return;
+                auto const elapsed = std::chrono::duration <double> (
+                    std::chrono::steady_clock::now()-start).count();
+                counters->seconds[phase] += elapsed-nested;
+                counters->calls[phase]++;
+                if(parent)
+                    parent->nested += elapsed;
+                counters->top = parent;
+            }
+        #else
+            explicit Timer(t const &) {}
+        #endif
+        };
+
+        // Directs the timers on this thread to the counters for the life of
+        // a solve.  Nested solves on the same counters, such as the
+        // different problem classes calling each other, count once.
+        struct Session {
+            // Prevent the use of the copy constructor and the assignment
+            // operator
+            NO_COPY_ASSIGNMENT(Session)
+        #ifdef OPTIZELLE_PROFILE
+        private:
+            // Counters for this solve
+            Counters * counters;
+
+            // Counters that were active before this solve
+            Counters * prior;
+
+        public:
+            explicit Session(Counters & counters_) :
+                counters(&counters_),
+                prior(active())
+            {
+                if(prior==counters) {
+                    counters = nullptr;
+                    return;
+                }
+                counters->top = nullptr;
+                counters->start = std::chrono::steady_clock::now();
+                active() = counters;
+            }
+
+            ~Session() {
+                if(!counters)
+                    return;
+                counters->total += std::chrono::duration <double> (
+                    std::chrono::steady_clock::now()-counters->start).count();
+                active() = prior;
+            }
+        #else
+            explicit Session(Counters &) {}
+        #endif
+        };
+    }
+
     // Reasons we stop truncated CG 
     namespace TruncatedStop{
         enum t{
@@ -1082,9 +1275,12 @@ namespace Optizelle {
                                        // delta is the trust-region radius
             OffsetViolatesSafeguard,   // Offset violates the safeguard
             TooManyFailedSafeguard,    // Too many safeguarded steps have failed
-            ObjectiveIncrease          // CG objective, 0.5 <ABx,Bx> - <b,Bx>
+            ObjectiveIncrease,         // CG objective, 0.5 <ABx,Bx> - <b,Bx>
                                        // increased between iterations, which
                                        // shouldn't happen.
+            ModelDecreaseSmall         // Relative decrease in the CG
+                                       // objective is small, which is the
+                                       // Nash-Sofer stopping test
             //---TruncatedStop1---
         };
 
@@ -1279,6 +1475,10 @@ namespace Optizelle {
     // (input) B : Projection in the system A B x = b
     // (input) C : Operator that modifies the shape of the trust-region
     // (input) eps : Stopping tolerance
+    // (input) eps_model : Stopping tolerance for the Nash-Sofer test where we
+    //     exit when i (q_i - q_{i-1}) / q_i <= eps_model where q_i denotes the
+    //     CG objective, 0.5 <ABx,Bx> - <b,Bx>, at iteration i.  A value of
+    //     zero turns off this test.
     // (input) iter_max :  Maximum number of iterations
     // (input) orthog_storage_max : Maximum number of orthgonalizations.  If
     //     this number is 1, then we do the conjugate gradient algorithm.
@@ -1308,6 +1508,7 @@ namespace Optizelle {
         typename XX <Real>::Vector const & b,
         Operator <Real,XX,XX> const & B,
         Real const & eps,
+        Real const & eps_model,
         Natural const & iter_max,
         Natural const & orthog_storage_max,
         Natural const & orthog_iter_max,
@@ -1328,6 +1529,9 @@ namespace Optizelle {
         Real & alpha_safeguard
     ){
 
+        // Charge the solve to the Krylov phase
+        Profile::Timer timer(Profile::Krylov);
+
         // Create some type shortcuts
         typedef XX <Real> X;
         typedef typename X::Vector X_Vector;
@@ -1702,10 +1906,19 @@ namespace Optizelle {
             return red3;
         };
 
+        // Track the CG objective at the current iterate along with the
+        // amount that it changed during the last step.  We use these for the
+        // Nash-Sofer stopping test.
+        auto obj = Real(0.);
+        auto obj_dec = Real(0.);
+
         // Given a step length, take a step as long as the CG objective
         // function gets reduced.  Note, this does not consider the safeguard.
         auto step_if_obj_red = [&](auto const & alpha) {
-            if(obj_red(alpha) <= Real(0.)) {
+            auto red = obj_red(alpha);
+            if(red <= Real(0.)) {
+                obj += red;
+                obj_dec = red;
                 X::axpy(alpha,Bdx,x);
                 X::axpy(alpha,Bdx,shifted_iterate);
                 X::axpy(alpha,ABdx,r);
@@ -1966,6 +2179,12 @@ namespace Optizelle {
             else if(norm_Br <= eps*norm_Br0)
                 stop = TruncatedStop::RelativeErrorSmall;
 
+            // If the relative decrease in the CG objective is small, exit
+            else if(eps_model > Real(0.) && obj < Real(0.) &&
+                Real(iter)*obj_dec/obj <= eps_model
+            )
+                stop = TruncatedStop::ModelDecreaseSmall;
+
             // If we've exceeded the maximum number of iterations, also exit
             else if(iter>=iter_max)
                 stop = TruncatedStop::MaxItersExceeded;
@@ -1997,6 +2216,629 @@ namespace Optizelle {
         }
     }
 
+    // Records every application of an operator A along with the vector that
+    // A was applied to.  Krylov methods only touch A through these
+    // applications, so the recorded vectors span the Krylov subspace the
+    // method built and we can reuse them later without applying A again.
+    // We stop recording after storage_max applications.
+    template <
+        typename Real,
+        template <typename> class XX
+    >
+    struct RecordedOperator : public Operator <Real,XX,XX> {
+    private:
+        // Create some type shortcuts
+        typedef XX <Real> X;
+        typedef typename X::Vector X_Vector;
+
+        // Operator that we're recording
+        Operator <Real,XX,XX> const & A;
+
+        // Maximum number of applications that we record
+        Natural storage_max;
+
+    public:
+        // Vectors that A was applied to
+        mutable std::deque <X_Vector> vs;
+
+        // A applied to each of the vectors above
+        mutable std::deque <X_Vector> Avs;
+
+        // Disallow copying and assignment
+        NO_COPY_ASSIGNMENT(RecordedOperator)
+
+        // Grab the operator and the amount of storage
+        RecordedOperator(
+            Operator <Real,XX,XX> const & A_,
+            Natural const & storage_max_
+        ) : A(A_), storage_max(storage_max_), vs(), Avs() {}
+
+        // Apply the operator and record the result
+        void eval(X_Vector const & x,X_Vector & y) const {
+            A.eval(x,y);
+            if(vs.size() < storage_max) {
+                vs.emplace_back(X::init(x));
+                X::copy(x,vs.back());
+                Avs.emplace_back(X::init(y));
+                X::copy(y,Avs.back());
+            }
+        }
+
+        // Forget everything that we've recorded
+        void clear() {
+            vs.clear();
+            Avs.clear();
+        }
+    };
+
+    // Solves the dense trust-region subproblem
+    //
+    // min 0.5 <A x,x> - <b,x> st || x || <= delta
+    //
+    // given the eigenvalue decomposition A = Q diag(theta) Q'.  Basically, we
+    // find lambda >= max(0,-theta_min) such that (A + lambda I) x = b and
+    // lambda (|| x || - delta) = 0.  When this requires lambda > 0, we solve
+    // the secular equation 1/|| x(lambda) || = 1/delta with a safeguarded
+    // Newton's method.  When b is orthogonal to the leftmost eigenspace, we
+    // may have the hard case where we move along the leftmost eigenvector
+    // until we hit the boundary.  The parameters are as follows.
+    //
+    // (input) m : Size of the problem
+    // (input) theta : Eigenvalues of A sorted in ascending order
+    // (input) Q : Eigenvectors of A stored in column-major format
+    // (input) b : Right hand side
+    // (input) delta : Trust-region radius
+    // (output) x : Solution to the subproblem
+    // (return) Lagrange multiplier for the trust-region constraint, lambda
+    template <typename Real>
+    Real trust_region_eigen(
+        Natural const & m,
+        Real const * const theta,
+        Real const * const Q,
+        Real const * const b,
+        Real const & delta,
+        Real * x
+    ) {
+        // Don't do anything on an empty problem
+        if(m==0) return Real(0.);
+
+        // Transform the right hand side into the eigenbasis, beta <- Q' b
+        std::vector <Real> beta(m);
+        gemv <Real> ('T',m,m,Real(1.),Q,m,b,1,Real(0.),&(beta[0]),1);
+        auto const norm_beta = std::sqrt(dot <Real> (
+            m,&(beta[0]),1,&(beta[0]),1));
+
+        // Set tolerances for when we consider an eigenvalue to be zero and
+        // when we consider the right hand side to lack a component in an
+        // eigenspace.
+        auto const eps = lamch <Real> ('E');
+        auto const eps_theta = Real(m) * eps *
+            std::max(std::max(std::fabs(theta[0]),std::fabs(theta[m-1])),
+                Real(1.));
+        auto const eps_beta = std::sqrt(eps) * norm_beta;
+
+        // Find the solution in the eigenbasis, s, for a particular lambda.
+        // We skip any component where the shifted eigenvalue lies below the
+        // cutoff.  This returns || s || and the sum of s_i^2/(theta_i+lambda),
+        // which we need for the derivative of the secular equation.
+        std::vector <Real> s(m);
+        auto shifted_solve = [&](Real const & lambda,Real const & cutoff) {
+            auto norm_s_2 = Real(0.);
+            auto dnorm = Real(0.);
+            for(Natural i=0;i<m;i++) {
+                auto shift = theta[i]+lambda;
+                if(shift > cutoff) {
+                    s[i] = beta[i]/shift;
+                    norm_s_2 += sq(s[i]);
+                    dnorm += sq(s[i])/shift;
+                } else
+                    s[i] = Real(0.);
+            }
+            return std::pair <Real,Real> (std::sqrt(norm_s_2),dnorm);
+        };
+
+        // Find the smallest allowable Lagrange multiplier
+        auto const lambda_lo = std::max(Real(0.),-theta[0]);
+
+        // Determine whether the right hand side has a component in the
+        // eigenspace that's singular at this smallest multiplier
+        auto singular_component = false;
+        for(Natural i=0;i<m;i++)
+            if(theta[i]+lambda_lo <= eps_theta && std::fabs(beta[i]) > eps_beta)
+                singular_component = true;
+
+        // Storage for the Lagrange multiplier
+        auto lambda = lambda_lo;
+
+        // If there's no singular component, check whether the solution at
+        // the smallest multiplier lies inside the trust-region.  If lambda is
+        // zero, this is the interior solution.  Otherwise, we have the hard
+        // case and move along the leftmost eigenvector to the boundary.
+        auto found = false;
+        if(!singular_component) {
+            auto norm_s = shifted_solve(lambda_lo,eps_theta).first;
+            if(norm_s <= delta) {
+                found = true;
+                if(lambda_lo > Real(0.)) {
+                    auto tau = std::sqrt(std::max(
+                        sq(delta)-sq(norm_s),Real(0.)));
+                    s[0] += tau;
+                }
+            }
+        }
+
+        // Otherwise, the solution lies on the boundary and we find the
+        // multiplier.  Since || x(lambda) || <= || b || / (theta_min+lambda),
+        // || x(lambda_hi) || <= delta and we have a bracket.
+        if(!found) {
+            auto lo = lambda_lo;
+            auto hi = std::max(norm_beta/delta - theta[0],lambda_lo);
+            lambda = hi;
+            for(Natural iter=1;iter<=100;iter++) {
+                Real norm_s,dnorm;
+                std::tie(norm_s,dnorm) = shifted_solve(lambda,Real(0.));
+
+                // Exit if we're sufficiently close to the boundary
+                if(std::fabs(norm_s-delta) <= std::sqrt(eps)*delta)
+                    break;
+
+                // Update the bracket
+                if(norm_s > delta)
+                    lo = lambda;
+                else
+                    hi = lambda;
+                if(hi-lo <= eps*std::max(hi,Real(1.)))
+                    break;
+
+                // Take a Newton step on 1/|| x(lambda) || - 1/delta and
+                // bisect if we leave the bracket
+                auto psi = Real(1.)/norm_s - Real(1.)/delta;
+                auto dpsi = dnorm/(norm_s*norm_s*norm_s);
+                lambda = lambda - psi/dpsi;
+                if(!(lambda > lo && lambda < hi))
+                    lambda = Real(0.5)*(lo+hi);
+            }
+            shifted_solve(lambda,Real(0.));
+        }
+
+        // Transform the solution back, x <- Q s
+        gemv <Real> ('N',m,m,Real(1.),Q,m,&(s[0]),1,Real(0.),x,1);
+
+        // Return the Lagrange multiplier
+        return lambda;
+    }
+
+    // Solves the dense trust-region subproblem
+    //
+    // min 0.5 <A x,x> - <b,x> st || x || <= delta
+    //
+    // where A is a symmetric matrix stored in column-major format.  We only
+    // reference the upper triangle of A.
+    //
+    // (input) m : Size of the problem
+    // (input) A : Symmetric operator
+    // (input) b : Right hand side
+    // (input) delta : Trust-region radius
+    // (output) x : Solution to the subproblem
+    // (return) Lagrange multiplier for the trust-region constraint, lambda
+    template <typename Real>
+    Real trust_region_dense(
+        Natural const & m,
+        Real const * const A,
+        Real const * const b,
+        Real const & delta,
+        Real * x
+    ) {
+        // Don't do anything on an empty problem
+        if(m==0) return Real(0.);
+
+        // Copy A since the eigenvalue solver is destructive
+        std::vector <Real> AA(m*m);
+        copy <Real> (m*m,A,1,&(AA[0]),1);
+
+        // Find the eigenvalue decomposition of A
+        std::vector <Real> theta(m);
+        std::vector <Real> Q(m*m);
+        std::vector <Integer> isuppz(2*m);
+        Integer lwork = 26*m;
+        std::vector <Real> work(lwork);
+        Integer liwork = 10*m;
+        std::vector <Integer> iwork(liwork);
+        Integer nevals(0);
+        Integer info(0);
+        syevr <Real> ('V','A','U',m,&(AA[0]),m,Real(0.),Real(0.),0,0,
+            lamch <Real> ('S'),nevals,&(theta[0]),&(Q[0]),m,&(isuppz[0]),
+            &(work[0]),lwork,&(iwork[0]),liwork,info);
+
+        // Solve the subproblem in the eigenbasis
+        return trust_region_eigen <Real> (m,&(theta[0]),&(Q[0]),b,delta,x);
+    }
+
+    // Solves the trust-region subproblem
+    //
+    // min 0.5 <A x,x> - <b,x> st || x || <= delta
+    //
+    // restricted to the span of the vectors vs.  Since we also require A
+    // applied to each of these vectors, Avs, we never apply A here.
+    // Generally, we obtain these vectors by recording a truncated-CG solve,
+    // which lets us resolve the subproblem for a smaller trust-region radius
+    // at the cost of a few inner products.  Since the vectors may be nearly
+    // linearly dependent, we orthonormalize them with an eigenvalue
+    // decomposition of their Gram matrix and drop the directions that
+    // correspond to tiny eigenvalues.
+    //
+    // (input) vs : Vectors that span the subspace 
+    // (input) Avs : A applied to each of the vectors above
+    // (input) b : Right hand side
+    // (input) delta : Trust-region radius
+    // (output) x : Solution to the subproblem
+    template <
+        typename Real,
+        template <typename> class XX
+    >
+    void trust_region_subspace(
+        std::deque <typename XX <Real>::Vector> const & vs,
+        std::deque <typename XX <Real>::Vector> const & Avs,
+        typename XX <Real>::Vector const & b,
+        Real const & delta,
+        typename XX <Real>::Vector & x
+    ) {
+        // Create some type shortcuts
+        typedef XX <Real> X;
+
+        // Start with a zero solution
+        X::zero(x);
+
+        // If we don't have any vectors, zero is the only solution
+        Natural const k = vs.size();
+        if(k==0) return;
+
+        // Form the Gram matrix G = V'V, the projected operator AA = V'AV, and
+        // the projected right hand side bb = V'b.  Since A may not be exactly
+        // symmetric, we use its symmetric part.
+        std::vector <Real> G(k*k);
+        std::vector <Real> AA(k*k);
+        std::vector <Real> bb(k);
+        for(Natural j=1;j<=k;j++) {
+            bb[itok(j)] = X::innr(b,vs[itok(j)]);
+            for(Natural i=1;i<=j;i++) {
+                G[ijtok(i,j,k)] = X::innr(vs[itok(i)],vs[itok(j)]);
+                G[ijtok(j,i,k)] = G[ijtok(i,j,k)];
+                AA[ijtok(i,j,k)] = Real(0.5)*(
+                    X::innr(Avs[itok(i)],vs[itok(j)]) +
+                    X::innr(vs[itok(i)],Avs[itok(j)]));
+                AA[ijtok(j,i,k)] = AA[ijtok(i,j,k)];
+            }
+        }
+
+        // Find the eigenvalue decomposition of the Gram matrix
+        std::vector <Real> mu(k);
+        std::vector <Real> U(k*k);
+        std::vector <Integer> isuppz(2*k);
+        Integer lwork = 26*k;
+        std::vector <Real> work(lwork);
+        Integer liwork = 10*k;
+        std::vector <Integer> iwork(liwork);
+        Integer nevals(0);
+        Integer info(0);
+        syevr <Real> ('V','A','U',k,&(G[0]),k,Real(0.),Real(0.),0,0,
+            lamch <Real> ('S'),nevals,&(mu[0]),&(U[0]),k,&(isuppz[0]),
+            &(work[0]),lwork,&(iwork[0]),liwork,info);
+
+        // Keep the directions that are numerically independent.  Since the
+        // eigenvalues are sorted in ascending order, these are the last r.
+        auto const mu_cutoff = std::sqrt(lamch <Real> ('E'))*mu[k-1];
+        Natural r = 0;
+        while(r<k && mu[k-1-r] > mu_cutoff)
+            r++;
+        if(r==0) return;
+
+        // Form the orthonormalizing transformation W = U_r diag(mu_r)^(-1/2),
+        // which satisfies W' G W = I
+        std::vector <Real> W(k*r);
+        for(Natural j=1;j<=r;j++) {
+            auto const jj = k-r+j;
+            copy <Real> (k,&(U[ijtok(1,jj,k)]),1,&(W[ijtok(1,j,k)]),1);
+            scal <Real> (k,Real(1.)/std::sqrt(mu[itok(jj)]),
+                &(W[ijtok(1,j,k)]),1);
+        }
+
+        // Find the operator and right hand side in the orthonormal basis,
+        // AAt <- W' AA W and bbt <- W' bb
+        std::vector <Real> tmp(k*r);
+        gemm <Real> ('N','N',k,r,k,Real(1.),&(AA[0]),k,&(W[0]),k,Real(0.),
+            &(tmp[0]),k);
+        std::vector <Real> AAt(r*r);
+        gemm <Real> ('T','N',r,r,k,Real(1.),&(W[0]),k,&(tmp[0]),k,Real(0.),
+            &(AAt[0]),r);
+        std::vector <Real> bbt(r);
+        gemv <Real> ('T',k,r,Real(1.),&(W[0]),k,&(bb[0]),1,Real(0.),
+            &(bbt[0]),1);
+
+        // Solve the trust-region subproblem in the orthonormal basis.  Since
+        // W' G W = I, the norm of the solution is preserved.
+        std::vector <Real> z(r);
+        trust_region_dense <Real> (r,&(AAt[0]),&(bbt[0]),delta,&(z[0]));
+
+        // Find the coefficients with respect to the original vectors, y <- W z
+        std::vector <Real> y(k);
+        gemv <Real> ('N',k,r,Real(1.),&(W[0]),k,&(z[0]),1,Real(0.),
+            &(y[0]),1);
+
+        // Assemble the solution, x <- V y
+        for(Natural i=1;i<=k;i++)
+            X::axpy(y[itok(i)],vs[itok(i)],x);
+    }
+
+    // Solves the trust-region subproblem
+    //
+    // min 0.5 <T x,x> - <b,x> st || x || <= delta
+    //
+    // where T is a symmetric tridiagonal matrix.  Generally, T comes from the
+    // Lanczos process, so it's small and we solve the subproblem to high
+    // accuracy with a tridiagonal eigenvalue decomposition.
+    //
+    // (input) m : Size of the problem
+    // (input) alpha : Diagonal of T, length m
+    // (input) beta : Off-diagonal of T, length m-1
+    // (input) b : Right hand side
+    // (input) delta : Trust-region radius
+    // (output) x : Solution to the subproblem
+    // (output) theta_min : Smallest eigenvalue of T
+    // (return) Lagrange multiplier for the trust-region constraint, lambda
+    template <typename Real>
+    Real trust_region_tridiagonal(
+        Natural const & m,
+        Real const * const alpha,
+        Real const * const beta,
+        Real const * const b,
+        Real const & delta,
+        Real * x,
+        Real & theta_min
+    ) {
+        // Don't do anything on an empty problem
+        theta_min = Real(0.);
+        if(m==0) return Real(0.);
+
+        // Copy T since the eigenvalue solver is destructive.  LAPACK wants
+        // the off-diagonal to have the same length as the diagonal.
+        std::vector <Real> D(m);
+        copy <Real> (m,alpha,1,&(D[0]),1);
+        std::vector <Real> E(m,Real(0.));
+        if(m>1) copy <Real> (m-1,beta,1,&(E[0]),1);
+
+        // Find the eigenvalue decomposition of T
+        std::vector <Real> theta(m);
+        std::vector <Real> Q(m*m);
+        std::vector <Integer> isuppz(2*m);
+        Integer lwork = 20*m;
+        std::vector <Real> work(lwork);
+        Integer liwork = 10*m;
+        std::vector <Integer> iwork(liwork);
+        Integer nevals(0);
+        Integer info(0);
+        stevr <Real> ('V','A',m,&(D[0]),&(E[0]),Real(0.),Real(0.),0,0,
+            lamch <Real> ('S'),nevals,&(theta[0]),&(Q[0]),m,&(isuppz[0]),
+            &(work[0]),lwork,&(iwork[0]),liwork,info);
+        theta_min = theta[0];
+
+        // Solve the subproblem in the eigenbasis
+        return trust_region_eigen <Real> (m,&(theta[0]),&(Q[0]),b,delta,x);
+    }
+
+    // Computes the generalized Lanczos trust-region (GLTR) method in order to
+    // solve
+    //
+    // min 0.5 <A x,x> - <b,x> st || x || <= delta
+    //
+    // Unlike truncated CG, we do not stop when we hit the trust-region or
+    // find negative curvature.  Rather, we continue to grow the Krylov
+    // subspace with the preconditioned Lanczos process and solve the
+    // tridiagonal subproblem at each iteration, which we use to estimate the
+    // error.  Once this error is small, we solve the subproblem exactly over
+    // the Krylov subspace.  The Lanczos vectors are orthonormal with respect
+    // to the inverse of B, so the tridiagonal subproblem uses this norm.
+    // Since we want a step that's feasible in the Euclidean norm, we resolve
+    // the final subproblem with respect to the Euclidean norm, which is
+    // equivalent when B is the identity.  The parameters are as follows.
+    //
+    // (input) A : Operator in the system A x = b
+    // (input) b : Right hand side in the system A x = b
+    // (input) B : Symmetric, positive definite preconditioner
+    // (input) eps : Stopping tolerance
+    // (input) iter_max :  Maximum number of iterations
+    // (input) delta : Trust region radius
+    // (input) safeguard : Our safeguard function
+    // (output) x : Final solution x
+    // (output) x_cp : The Cauchy-Point, which is defined as the solution
+    //     after a single iteration
+    // (output) norm_Br0 : The norm sqrt(<B r0,r0>) of the initial residual
+    // (output) norm_Br : The estimated norm sqrt(<B r,r>) of the final residual
+    // (output) iter : The number of iterations required to converge.
+    // (output) stop : The reason why the method was terminated.  In order to
+    //     match truncated CG, when the solution lies on the trust-region, we
+    //     report either NegativeCurvature or TrustRegionViolated depending on
+    //     the curvature of A over the Krylov subspace.
+    // (output) alpha_safeguard : Amount we truncated the final step
+    template <
+        typename Real,
+        template <typename> class XX
+    >
+    void gltr(
+        Operator <Real,XX,XX> const & A,
+        typename XX <Real>::Vector const & b,
+        Operator <Real,XX,XX> const & B,
+        Real const & eps,
+        Natural const & iter_max,
+        Real const & delta,
+        SafeguardSimplified <Real,XX> const & safeguard,
+        typename XX <Real>::Vector & x,
+        typename XX <Real>::Vector & x_cp,
+        Real & norm_Br0,
+        Real & norm_Br,
+        Natural & iter,
+        TruncatedStop::t & stop,
+        Real & alpha_safeguard
+    ){
+        // Charge the solve to the Krylov phase
+        Profile::Timer timer(Profile::Krylov);
+
+        // Create some type shortcuts
+        typedef XX <Real> X;
+        typedef typename X::Vector X_Vector;
+
+        // Initialize the solution and Cauchy point to zero
+        X::zero(x);
+        X::zero(x_cp);
+
+        // Initialize our iteration to zero and note that we haven't converged
+        iter = 0;
+        stop = TruncatedStop::NotConverged;
+        alpha_safeguard = Real(1.0);
+
+        // Find the initial residual, t = A*x-b = -b, and its preconditioned
+        // version, y = B t
+        auto t = X::init(x);
+        X::copy(b,t);
+        X::scal(Real(-1.),t);
+        auto y = X::init(x);
+        B.eval(t,y);
+        auto gamma = std::sqrt(X::innr(t,y));
+        norm_Br0 = gamma;
+        norm_Br = gamma;
+
+        // Check for NaNs in the preconditioner.  This also catches
+        // preconditioners that aren't positive definite.
+        if(gamma!=gamma) {
+            stop = TruncatedStop::NanPreconditioner;
+            return;
+        }
+
+        // If the right hand side is zero, so is the solution
+        if(gamma==Real(0.)) {
+            stop = TruncatedStop::RelativeErrorSmall;
+            return;
+        }
+
+        // Find the first Lanczos vector, q, and its image under the inverse
+        // of B, u.
+        auto q = X::init(x);
+        X::copy(y,q);
+        X::scal(Real(1.)/gamma,q);
+        auto u = X::init(x);
+        X::copy(t,u);
+        X::scal(Real(1.)/gamma,u);
+        auto u_old = X::init(x);
+        X::zero(u_old);
+
+        // Store the Lanczos vectors and A applied to them
+        auto qs = std::deque <X_Vector> ();
+        auto Aqs = std::deque <X_Vector> ();
+
+        // Store the tridiagonal matrix.  In the Lanczos basis, the right hand
+        // side becomes -gamma e1.
+        auto alphas = std::vector <Real> ();
+        auto betas = std::vector <Real> ();
+        auto bT = std::vector <Real> ();
+        auto h = std::vector <Real> ();
+        auto theta_min = Real(0.);
+
+        // Run the Lanczos process
+        auto w = X::init(x);
+        while(true) {
+            // Exit if we've exceeded the maximum number of iterations
+            if(iter >= iter_max) {
+                stop = TruncatedStop::MaxItersExceeded;
+                break;
+            }
+            iter++;
+
+            // Apply the operator, w <- A q, and find the diagonal element
+            A.eval(q,w);
+            auto alpha = X::innr(w,q);
+            if(alpha!=alpha) {
+                stop = TruncatedStop::NanOperator;
+                break;
+            }
+            alphas.emplace_back(alpha);
+
+            // Save the Lanczos vector
+            qs.emplace_back(X::init(x));
+            X::copy(q,qs.back());
+            Aqs.emplace_back(X::init(x));
+            X::copy(w,Aqs.back());
+
+            // Find the next residual,
+            // t <- A q - alpha u - beta u_old
+            X::copy(w,t);
+            X::axpy(-alpha,u,t);
+            if(betas.size()>0)
+                X::axpy(-betas.back(),u_old,t);
+            B.eval(t,y);
+            auto beta = std::sqrt(std::max(X::innr(t,y),Real(0.)));
+            if(beta!=beta) {
+                stop = TruncatedStop::NanPreconditioner;
+                break;
+            }
+
+            // Solve the tridiagonal subproblem
+            auto const k = alphas.size();
+            bT.resize(k,Real(0.));
+            bT[0] = -gamma;
+            h.resize(k);
+            trust_region_tridiagonal <Real> (k,&(alphas[0]),
+                k>1 ? &(betas[0]) : nullptr,&(bT[0]),delta,&(h[0]),theta_min);
+
+            // After the first iteration, save the Cauchy point
+            if(iter==1) {
+                X::copy(q,x_cp);
+                X::scal(h[0],x_cp);
+                auto norm_xcp = std::sqrt(X::innr(x_cp,x_cp));
+                if(norm_xcp > delta)
+                    X::scal(delta/norm_xcp,x_cp);
+            }
+
+            // Estimate the error in the subproblem.  This is the residual in
+            // the KKT conditions, which is beta |e_k' h|.
+            norm_Br = beta * std::fabs(h[k-1]);
+            if(norm_Br <= eps*norm_Br0) {
+                stop = TruncatedStop::RelativeErrorSmall;
+                break;
+            }
+
+            // Find the next Lanczos vector
+            X::copy(u,u_old);
+            X::copy(t,u);
+            X::scal(Real(1.)/beta,u);
+            X::copy(y,q);
+            X::scal(Real(1.)/beta,q);
+            betas.emplace_back(beta);
+        }
+
+        // Solve the subproblem over the Krylov subspace in the Euclidean norm
+        trust_region_subspace <Real,XX> (qs,Aqs,b,delta,x);
+
+        // If the solution lies on the trust-region, report why
+        auto const norm_x = std::sqrt(X::innr(x,x));
+        if( (stop==TruncatedStop::RelativeErrorSmall ||
+             stop==TruncatedStop::MaxItersExceeded) &&
+            norm_x >= (Real(1.)-std::sqrt(lamch <Real> ('E')))*delta
+        )
+            stop = theta_min < Real(0.) ?
+                TruncatedStop::NegativeCurvature :
+                TruncatedStop::TrustRegionViolated;
+
+        // Make sure that the Cauchy point and the solution obey the safeguard
+        auto zero = X::init(x);
+        X::zero(zero);
+        auto alpha_cp = std::min(safeguard(zero,x_cp),Real(1.));
+        if(alpha_cp < Real(1.))
+            X::scal(alpha_cp,x_cp);
+        alpha_safeguard = std::min(safeguard(zero,x),Real(1.));
+        if(alpha_safeguard < Real(1.))
+            X::scal(alpha_safeguard,x);
+    }
+
     // Solve a 2x2 linear system in packed storage.  This is done through
     // Gaussian elimination with complete pivoting.  In addition, this assumes
     // that the system is nonsingular.
@@ -2197,6 +3039,9 @@ namespace Optizelle {
         Real const * const R,
         Real const * const Qt_e1,
         std::list <typename XX <Real>::Vector> const & vs,
+        std::list <typename XX <Real>::Vector> const & zs,
+        std::list <typename XX <Real>::Vector> const & Us,
+        std::list <std::vector <Real> > const & Bs,
         Operator <Real,XX,XX> const & B_right,
         typename XX <Real>::Vector const & x,
         typename XX <Real>::Vector & dx
@@ -2227,16 +3072,46 @@ namespace Optizelle {
             return false;
 #endif
 
-        // Compute tmp = V y
-        X::zero(V_y);
-        typename std::list <X_Vector>::const_iterator vv=vs.begin();
-        for(Natural j=0;j<m;j++) {
-            X::axpy(Real(y[j]),*vv,V_y);
-            vv++;
+        // When we stored the right preconditioned Krylov vectors, Z, the
+        // update is dx = Z y
+        if(zs.size()>0) {
+            X::zero(dx);
+            auto zz=zs.cbegin();
+            for(Natural j=0;j<m;j++) {
+                X::axpy(Real(y[j]),*zz,dx);
+                zz++;
+            }
+
+        // Otherwise, it's dx = B_right V y
+        } else {
+            // Compute tmp = V y
+            X::zero(V_y);
+            typename std::list <X_Vector>::const_iterator vv=vs.begin();
+            for(Natural j=0;j<m;j++) {
+                X::axpy(Real(y[j]),*vv,V_y);
+                vv++;
+            }
+
+            // Right recondition the above linear combination
+            B_right.eval(V_y,dx);
         }
 
-        // Right recondition the above linear combination
-        B_right.eval(V_y,dx);
+        // Remove the part of the update already accounted for by the recycled
+        // directions, dx <- dx - U (B y), where B = C' B_left A B_right V 
+        if(Us.size()>0) {
+            std::vector <Real> B_y(Us.size(),Real(0.));
+            typename std::list <std::vector <Real> >::const_iterator
+                bb=Bs.begin();
+            for(Natural j=0;j<m;j++) {
+                axpy <Real> (Us.size(),y[j],&((*bb)[0]),1,&(B_y[0]),1);
+                bb++;
+            }
+            Natural l=0;
+            for(auto const & u : Us) {
+                X::axpy(Real(-1.)*B_y[l],u,dx);
+                l++;
+            }
+        }
     }
 
     // Resets the GMRES method.  This does a number of things
@@ -2246,6 +3121,9 @@ namespace Optizelle {
     // 4.  Initializes the list of Krylov vectors.
     // 5.  Finds the initial RHS for the least squares system, Q' norm(w1) e1.
     // 6.  Clears out all of the old Givens rotations
+    // 7.  Removes the part of the preconditioned residual in the span of the
+    //     recycled images, C, and returns the coefficients C' r.  This
+    //     happens between #1 and #2.
     // These steps are required during initialization as well as during a
     // restart of GMRES
     template <
@@ -2261,7 +3139,9 @@ namespace Optizelle {
         typename XX <Real>::Vector & r,
         Real & norm_r,
         std::vector <Real> & Qt_e1,
-        std::list <std::pair<Real,Real> > & Qts
+        std::list <std::pair<Real,Real> > & Qts,
+        std::list <typename XX <Real>::Vector> const & Cs,
+        std::vector <Real> & Ct_r
     ){
         // Create some type shortcuts
         typedef XX <Real> X;
@@ -2270,6 +3150,11 @@ namespace Optizelle {
         // completes #1
         B_left.eval(rtrue,r);
 
+        // Project out the recycled images.  This completes #7.
+        Ct_r.resize(Cs.size());
+        if(Cs.size()>0)
+            orthogonalize <Real,XX> (Cs,r,&(Ct_r[0]));
+
         // Store the norm of the preconditioned residual.  This completes #2.
         norm_r = std::sqrt(X::innr(r,r));
 
@@ -2338,6 +3223,138 @@ namespace Optizelle {
         ) const { } 
     };
 
+    // A subspace that GMRES recycles across a sequence of solves where the
+    // operator stays fixed or changes slowly.  We store the directions U
+    // along with their preconditioned images C = B_left A U, which we keep
+    // orthonormal.  During a solve, we first remove the part of the residual
+    // that lies in span(C) and then build the Krylov space for the operator
+    // projected onto the complement of span(C).  This is the GCRO approach.
+    // After each solve, we add the total correction to the subspace and
+    // discard the oldest direction once we exceed the maximum size.
+    template <
+        typename Real,
+        template <typename> class XX
+    >
+    struct GMRESRecycle {
+    private:
+        // Create some type shortcuts
+        typedef XX <Real> X;
+        typedef typename X::Vector X_Vector;
+
+    public:
+        // Disallow constructors
+        NO_COPY_ASSIGNMENT(GMRESRecycle)
+
+        // Maximum number of recycled directions.  Zero disables recycling.
+        Natural const size_max;
+
+        // Recycled directions
+        std::list <X_Vector> Us;
+
+        // Preconditioned images of the recycled directions
+        std::list <X_Vector> Cs;
+
+        // Whether the images correspond to the current operator
+        bool current;
+
+        // Start with an empty subspace
+        explicit GMRESRecycle(Natural const & size_max_) :
+            size_max(size_max_), Us(), Cs(), current(true) {}
+
+        // Denote that the operator, or the left preconditioner, has changed,
+        // so that the images must be recomputed prior to the next solve
+        void stale() {
+            current = false;
+        }
+
+        // Discards all of the recycled directions
+        void clear() {
+            Us.clear();
+            Cs.clear();
+            current = true;
+        }
+
+        // Adds a direction to the subspace
+        void insert(
+            Operator <Real,XX,XX> const & A,
+            Operator <Real,XX,XX> const & B_left,
+            X_Vector const & u
+        ) {
+            // If we're not storing anything, exit
+            if(size_max==0) return;
+
+            // Find the preconditioned image of the direction
+            auto A_u = X::init(u);
+            auto c = X::init(u);
+            A.eval(u,A_u);
+            B_left.eval(A_u,c);
+            auto norm_c0 = std::sqrt(X::innr(c,c));
+
+            // Orthogonalize the image against the others and apply the same
+            // transformation to the direction
+            auto uu = X::init(u);
+            X::copy(u,uu);
+            auto u_old = Us.cbegin();
+            for(auto const & c_old : Cs) {
+                auto beta=X::innr(c_old,c);
+                X::axpy(Real(-1.)*beta,c_old,c);
+                X::axpy(Real(-1.)*beta,*u_old,uu);
+                u_old++;
+            }
+
+            // Skip directions whose images are numerically dependent on the
+            // ones that we already have
+            auto norm_c = std::sqrt(X::innr(c,c));
+            if(!(norm_c > std::sqrt(std::numeric_limits <Real>::epsilon())
+                * norm_c0)
+            )
+                return;
+
+            // Normalize and store the pair
+            X::scal(Real(1.)/norm_c,c);
+            X::scal(Real(1.)/norm_c,uu);
+            Us.emplace_back(std::move(uu));
+            Cs.emplace_back(std::move(c));
+
+            // If we've too many elements, drop the oldest.  The remaining
+            // images stay orthonormal.
+            if(Us.size() > size_max) {
+                Us.pop_front();
+                Cs.pop_front();
+            }
+        }
+
+        // Recomputes the images of the recycled directions for the current
+        // operator when they're out of date
+        void refresh(
+            Operator <Real,XX,XX> const & A,
+            Operator <Real,XX,XX> const & B_left
+        ) {
+            // If we're current, there's nothing to do
+            if(current) return;
+
+            // Rebuild the subspace from the old directions
+            std::list <X_Vector> Us_old;
+            Us_old.swap(Us);
+            Cs.clear();
+            for(auto const & u : Us_old)
+                insert(A,B_left,u);
+            current = true;
+        }
+
+        // Moves the iterate by the recycled directions, x <- x + U alpha
+        void correct(
+            std::vector <Real> const & alpha,
+            X_Vector & x
+        ) const {
+            Natural l=0;
+            for(auto const & u : Us) {
+                X::axpy(alpha[l],u,x);
+                l++;
+            }
+        }
+    };
+
     // Computes the GMRES algorithm in order to solve A(x)=b.
     // (input) A : Operator that computes A(x)
     // (input) b : Right hand side
@@ -2349,15 +3366,20 @@ namespace Optizelle {
     //    want restarting, set this to zero. 
     // (input) B_left : Operator that computes the left preconditioner
     // (input) B_right : Operator that computes the right preconditioner
+    // (input/output) recycle : Subspace recycled from the prior solves.  On
+    //    exit, it contains the correction from this solve.
     // (input/output) x : Initial guess of the solution.  Returns the final
     //    solution.
+    // (input) flexible : Whether to store the right preconditioned Krylov
+    //    vectors and build the solution from them, which allows B_right to
+    //    change between iterations
     // (return) (norm_rtrue,iter) : Final norm of the true residual and
     //    the number of iterations computed.  They are returned in a STL pair.
     template <
         typename Real,
         template <typename> class XX
     >
-    std::pair <Real,Natural> gmres(
+    std::pair <Real,Natural> gmres_(
         Operator <Real,XX,XX> const & A,
         typename XX <Real>::Vector const & b,
         Real eps,
@@ -2366,9 +3388,14 @@ namespace Optizelle {
         Operator <Real,XX,XX> const & B_left,
         Operator <Real,XX,XX> const & B_right,
         GMRESManipulator <Real,XX> const & gmanip,
-        typename XX <Real>::Vector & x
+        GMRESRecycle <Real,XX> & recycle,
+        typename XX <Real>::Vector & x,
+        bool const & flexible
     ){
 
+        // Charge the solve to the Krylov phase
+        Profile::Timer timer(Profile::Krylov);
+
         // Create some type shortcuts
         typedef XX <Real> X;
         typedef typename X::Vector X_Vector;
@@ -2411,6 +3438,10 @@ namespace Optizelle {
         // Allocate memory for the list of Krylov vectors
         std::list <X_Vector> vs;
 
+        // Allocate memory for the list of right preconditioned Krylov
+        // vectors, which we only store in flexible GMRES
+        std::list <X_Vector> zs;
+
         // Allocate memory for right hand side of the linear system, the vector
         // Q' norm(w1) e1.  Since we have a problem overdetermined by a single
         // index at each step, the size of this vector is the restart frequency
@@ -2423,6 +3454,18 @@ namespace Optizelle {
         // Allocate a temporary work element
         X_Vector A_Mrinv_v(X::init(x));
 
+        // Allocate memory for the projection of the Krylov vectors onto the
+        // recycled images, B = C' B_left A B_right V, stored by column
+        std::list <std::vector <Real> > Bs;
+
+        // Allocate memory for the projection of the residual onto the
+        // recycled images
+        std::vector <Real> Ct_r;
+
+        // Allocate memory for the initial guess, which we use to find the
+        // total correction to add to the recycled subspace
+        X_Vector x_orig(X::init(x));
+
         // Allocate memory for the subiteration number of GMRES taking into
         // account restarting
         Natural i(0);
@@ -2433,9 +3476,26 @@ namespace Optizelle {
         X::axpy(Real(1.),b,rtrue);
         norm_rtrue = std::sqrt(X::innr(rtrue,rtrue));
 
+        // Make sure that the recycled images match the current operator and
+        // save the initial guess
+        if(recycle.size_max > 0) {
+            recycle.refresh(A,B_left);
+            X::copy(x,x_orig);
+        }
+
         // Initialize the GMRES algorithm
         resetGMRES<Real,XX> (rtrue,B_left,rst_freq,v,vs,r,norm_r,
-            Qt_e1,Qts);
+            Qt_e1,Qts,recycle.Cs,Ct_r);
+
+        // Move the iterate by the recycled directions and find the resulting
+        // true residual.  Sometimes, this is enough to solve the system. 
+        if(recycle.Cs.size() > 0) {
+            recycle.correct(Ct_r,x);
+            A.eval(x,rtrue);
+            X::scal(Real(-1.),rtrue);
+            X::axpy(Real(1.),b,rtrue);
+            norm_rtrue = std::sqrt(X::innr(rtrue,rtrue));
+        }
 
         // If for some bizarre reason, we're already optimal, don't do any work 
         gmanip.eval(0,x,b,eps);
@@ -2454,11 +3514,22 @@ namespace Optizelle {
             // size rst_freq x rst_freq.
             if(i == 0) i = rst_freq;
 
-            // Find the next Krylov vector
+            // Find the next Krylov vector.  If flexible, save the right
+            // preconditioned vector since B_right may change.
             B_right.eval(v,w);
+            if(flexible) {
+                zs.emplace_back(std::move(X::init(x)));
+                X::copy(w,zs.back());
+            }
             A.eval(w,A_Mrinv_v);
             B_left.eval(A_Mrinv_v,w);
 
+            // Orthogonalize this Krylov vector with respect to the recycled
+            // images
+            Bs.emplace_back(recycle.Cs.size());
+            if(recycle.Cs.size() > 0)
+                orthogonalize <Real,XX> (recycle.Cs,w,&(Bs.back()[0]));
+
             // Orthogonalize this Krylov vector with respect to the rest
             orthogonalize <Real,XX> (vs,w,&(R[(i-1)*i/2]));
 
@@ -2504,7 +3575,8 @@ namespace Optizelle {
             bool nan_detected = false;
             for(Natural ii = 0;ii <= 1;ii++) { 
                 // Solve for the new iterate update
-                solveInKrylov <Real,XX> (i,&(R[0]),&(Qt_e1[0]),vs,B_right,x,dx);
+                solveInKrylov <Real,XX> (i,&(R[0]),&(Qt_e1[0]),vs,zs,
+                    recycle.Us,Bs,B_right,x,dx);
 
                 // Find the current iterate, its residual, the residual's norm
                 X::copy(x,x_p_dx);
@@ -2523,6 +3595,8 @@ namespace Optizelle {
                 // quit
                 else {
                     vs.pop_back();
+                    Bs.pop_back();
+                    if(flexible) zs.pop_back();
                     iter--;
                     i--;
                     nan_detected=true;
@@ -2549,13 +3623,28 @@ namespace Optizelle {
 
                 // Reset the GMRES algorithm
                 resetGMRES<Real,XX> (rtrue,B_left,rst_freq,v,vs,r,norm_r,
-                    Qt_e1,Qts);
+                    Qt_e1,Qts,recycle.Cs,Ct_r);
+                Bs.clear();
+                zs.clear();
        
                 // Make sure to correctly indicate that we're now working on
                 // iteration 0 of the next round of GMRES.  If we exit
                 // immediately thereafter, we use this check to make sure we
                 // don't do any additional solves for x.
                 i = 0;
+
+                // Move the iterate by the recycled directions and find the
+                // resulting true residual, which may be enough to solve the
+                // system
+                if(recycle.Cs.size() > 0) {
+                    recycle.correct(Ct_r,x);
+                    A.eval(x,rtrue);
+                    X::scal(Real(-1.),rtrue);
+                    X::axpy(Real(1.),b,rtrue);
+                    norm_rtrue = std::sqrt(X::innr(rtrue,rtrue));
+                    gmanip.eval(i,x,b,eps);
+                    if(norm_rtrue <= eps) break;
+                }
             }
         }
 
@@ -2565,14 +3654,1310 @@ namespace Optizelle {
         // As long as we didn't just solve for our new iterate, go ahead and
         // solve for it now.
         if(i > 0){ 
-            solveInKrylov <Real,XX> (i,&(R[0]),&(Qt_e1[0]),vs,B_right,x,dx);
+            solveInKrylov <Real,XX> (i,&(R[0]),&(Qt_e1[0]),vs,zs,
+                recycle.Us,Bs,B_right,x,dx);
             X::axpy(Real(1.),dx,x);
         }
 
+        // Add the total correction to the recycled subspace
+        if(recycle.size_max > 0) {
+            X::copy(x,dx);
+            X::axpy(Real(-1.),x_orig,dx);
+            recycle.insert(A,B_left,dx);
+        }
+
+        // Return the norm and the residual
+        return std::pair <Real,Natural> (norm_rtrue,iter);
+    }
+
+    // Computes the GMRES algorithm with fixed linear preconditioners
+    template <
+        typename Real,
+        template <typename> class XX
+    >
+    std::pair <Real,Natural> gmres(
+        Operator <Real,XX,XX> const & A,
+        typename XX <Real>::Vector const & b,
+        Real eps,
+        Natural iter_max,
+        Natural rst_freq,
+        Operator <Real,XX,XX> const & B_left,
+        Operator <Real,XX,XX> const & B_right,
+        GMRESManipulator <Real,XX> const & gmanip,
+        GMRESRecycle <Real,XX> & recycle,
+        typename XX <Real>::Vector & x
+    ){
+        return gmres_ <Real,XX> (A,b,eps,iter_max,rst_freq,B_left,B_right,
+            gmanip,recycle,x,false);
+    }
+
+    // Computes the flexible GMRES algorithm, FGMRES, where the right
+    // preconditioner need not be a fixed linear operator.  For example, it
+    // may be a few iterations of an inner Krylov method or multigrid.  We
+    // store the right preconditioned Krylov vectors, which doubles the
+    // memory of GMRES, and build the solution from them directly.  The left
+    // preconditioner must still be fixed and linear.
+    template <
+        typename Real,
+        template <typename> class XX
+    >
+    std::pair <Real,Natural> fgmres(
+        Operator <Real,XX,XX> const & A,
+        typename XX <Real>::Vector const & b,
+        Real eps,
+        Natural iter_max,
+        Natural rst_freq,
+        Operator <Real,XX,XX> const & B_left,
+        Operator <Real,XX,XX> const & B_right,
+        GMRESManipulator <Real,XX> const & gmanip,
+        GMRESRecycle <Real,XX> & recycle,
+        typename XX <Real>::Vector & x
+    ){
+        return gmres_ <Real,XX> (A,b,eps,iter_max,rst_freq,B_left,B_right,
+            gmanip,recycle,x,true);
+    }
+
+    // Computes the FGMRES algorithm without recycling a subspace
+    template <
+        typename Real,
+        template <typename> class XX
+    >
+    std::pair <Real,Natural> fgmres(
+        Operator <Real,XX,XX> const & A,
+        typename XX <Real>::Vector const & b,
+        Real eps,
+        Natural iter_max,
+        Natural rst_freq,
+        Operator <Real,XX,XX> const & B_left,
+        Operator <Real,XX,XX> const & B_right,
+        GMRESManipulator <Real,XX> const & gmanip,
+        typename XX <Real>::Vector & x
+    ){
+        GMRESRecycle <Real,XX> recycle(0);
+        return fgmres <Real,XX> (A,b,eps,iter_max,rst_freq,B_left,B_right,
+            gmanip,recycle,x);
+    }
+
+    // Computes the GMRES algorithm without recycling a subspace
+    template <
+        typename Real,
+        template <typename> class XX
+    >
+    std::pair <Real,Natural> gmres(
+        Operator <Real,XX,XX> const & A,
+        typename XX <Real>::Vector const & b,
+        Real eps,
+        Natural iter_max,
+        Natural rst_freq,
+        Operator <Real,XX,XX> const & B_left,
+        Operator <Real,XX,XX> const & B_right,
+        GMRESManipulator <Real,XX> const & gmanip,
+        typename XX <Real>::Vector & x
+    ){
+        GMRESRecycle <Real,XX> recycle(0);
+        return gmres <Real,XX> (A,b,eps,iter_max,rst_freq,B_left,B_right,
+            gmanip,recycle,x);
+    }
+
+    // Computes the block GMRES algorithm in order to solve A(x_j)=b_j for
+    // several right hand sides at once.  All of the systems share a single
+    // Krylov space, which we grow a block at a time, so that the operator and
+    // the preconditioners see batches of vectors through eval_many.  When a
+    // new Krylov vector is numerically dependent on the others, we drop it,
+    // which deflates the space.  Once a system converges, we fix its solution
+    // and stop computing its residual.
+    // (input) A : Operator that computes A(x)
+    // (input) bs : Right hand sides
+    // (input) eps : Relative stopping tolerance.  The manipulators may
+    //    overwrite this for each system.
+    // (input) iter_max : Maximum number of block iterations
+    // (input) rst_freq : Restarts every rst_freq block iterations.  If we
+    //    don't want restarting, set this to zero.
+    // (input) B_left : Operator that computes the left preconditioner
+    // (input) B_right : Operator that computes the right preconditioner
+    // (input) gmanips : Manipulators for the stopping tolerance of each system
+    // (input/output) xs : Initial guesses of the solutions.  Returns the final
+    //    solutions.
+    // (return) [(norm_rtrue,iter)] : Final norm of the true residual and the
+    //    number of block iterations computed for each system.
+    template <
+        typename Real,
+        template <typename> class XX
+    >
+    std::list <std::pair <Real,Natural> > block_gmres(
+        Operator <Real,XX,XX> const & A,
+        std::list <typename XX <Real>::Vector> const & bs,
+        Real eps,
+        Natural iter_max,
+        Natural rst_freq,
+        Operator <Real,XX,XX> const & B_left,
+        Operator <Real,XX,XX> const & B_right,
+        std::list <std::reference_wrapper <GMRESManipulator <Real,XX> const> >
+            const & gmanips,
+        std::list <typename XX <Real>::Vector> & xs
+    ){
+        // Charge the solve to the Krylov phase
+        Profile::Timer timer(Profile::Krylov);
+
+        // Create some type shortcuts
+        typedef XX <Real> X;
+        typedef typename X::Vector X_Vector;
+
+        // Adjust the restart frequency if it is too big or if none is desired
+        rst_freq = rst_freq > iter_max ? iter_max : rst_freq;
+        rst_freq = rst_freq == 0 ? iter_max : rst_freq;
+
+        // Allow random access to the systems
+        std::vector <X_Vector const *> b;
+        for(auto const & bb : bs)
+            b.emplace_back(&bb);
+        std::vector <X_Vector *> x;
+        for(auto & xx : xs)
+            x.emplace_back(&xx);
+        std::vector <GMRESManipulator <Real,XX> const *> gmanip;
+        for(auto const & gm : gmanips)
+            gmanip.emplace_back(&(gm.get()));
+        Natural const s = b.size();
+
+        // Allocate memory for the stopping tolerances, the final norms of the
+        // true residuals and iterations, and whether we're still solving each
+        // system
+        std::vector <Real> epss(s,eps);
+        std::vector <std::pair <Real,Natural> > result(s,
+            std::pair <Real,Natural> (Real(0.),Natural(0)));
+        std::vector <bool> active(s,true);
+
+        // Allocate memory for the true residuals and the trial iterates
+        std::vector <X_Vector> rtrue;
+        std::vector <X_Vector> x_p_dx;
+        rtrue.reserve(s);
+        x_p_dx.reserve(s);
+        for(Natural j=0;j<s;j++) {
+            rtrue.emplace_back(X::init(*(x[j])));
+            x_p_dx.emplace_back(X::init(*(x[j])));
+            X::copy(*(x[j]),x_p_dx[j]);
+        }
+
+        // Finds the true residuals, b_j - A x_p_dx_j, and their norms for the
+        // systems js
+        auto residuals = [&](std::vector <Natural> const & js) {
+            std::list <X_Vector> xx;
+            std::list <X_Vector> A_xx;
+            for(auto const & j : js) {
+                xx.emplace_back(X::init(x_p_dx[j]));
+                X::copy(x_p_dx[j],xx.back());
+                A_xx.emplace_back(X::init(x_p_dx[j]));
+            }
+            A.eval_many(xx,A_xx);
+            auto A_x = A_xx.cbegin();
+            for(auto const & j : js) {
+                X::copy(*(b[j]),rtrue[j]);
+                X::axpy(Real(-1.),*A_x,rtrue[j]);
+                result[j].first = std::sqrt(X::innr(rtrue[j],rtrue[j]));
+                A_x++;
+            }
+        };
+
+        // Orthogonalizes w against the Krylov vectors twice, in order to
+        // counteract a loss of orthogonality, and stores the coefficients in
+        // h.  If what remains is numerically dependent on the Krylov vectors,
+        // this returns false.  Otherwise, we normalize w, append its norm to
+        // h, and return true.
+        auto extend = [](
+            std::list <X_Vector> const & vs,
+            X_Vector & w,
+            std::vector <Real> & h
+        ) {
+            auto norm_w0 = std::sqrt(X::innr(w,w));
+            h.assign(vs.size(),Real(0.));
+            auto hh = std::vector <Real> (vs.size());
+            for(Natural k=0;k<2;k++) {
+                orthogonalize <Real,XX> (vs,w,hh.data());
+                for(Natural l=0;l<vs.size();l++)
+                    h[l] += hh[l];
+            }
+            auto norm_w = std::sqrt(X::innr(w,w));
+            if(!(norm_w > std::numeric_limits <Real>::epsilon()*Real(1e3)
+                * norm_w0)
+            )
+                return false;
+            X::scal(Real(1.)/norm_w,w);
+            h.emplace_back(norm_w);
+            return true;
+        };
+
+        // Find the initial residuals and determine if any of the systems are
+        // already solved
+        auto js = std::vector <Natural> (s);
+        for(Natural j=0;j<s;j++)
+            js[j] = j;
+        residuals(js);
+        for(Natural j=0;j<s;j++) {
+            gmanip[j]->eval(0,*(x[j]),*(b[j]),epss[j]);
+            if(result[j].first <= epss[j]) active[j] = false;
+        }
+
+        // Iterate until the maximum iteration, restarting as necessary
+        Natural iter = 0;
+        bool nan_detected = false;
+        while(iter < iter_max && !nan_detected) {
+
+            // Figure out which systems we're still solving
+            js.clear();
+            for(Natural j=0;j<s;j++)
+                if(active[j]) js.emplace_back(j);
+            if(js.size()==0) break;
+
+            // Apply the left preconditioner to the true residuals
+            std::list <X_Vector> rs_true;
+            std::list <X_Vector> rs;
+            for(auto const & j : js) {
+                rs_true.emplace_back(X::init(rtrue[j]));
+                X::copy(rtrue[j],rs_true.back());
+                rs.emplace_back(X::init(rtrue[j]));
+            }
+            B_left.eval_many(rs_true,rs);
+
+            // Find an orthonormal basis for the preconditioned residuals,
+            // which forms the first block of Krylov vectors.  Any vectors
+            // that we add to the basis must have the operator applied to
+            // them on the next iteration.
+            std::list <X_Vector> vs;
+            std::list <X_Vector> vs_new;
+            for(auto const & r : rs) {
+                auto w = X::init(r);
+                X::copy(r,w);
+                auto h = std::vector <Real> ();
+                if(extend(vs,w,h)) {
+                    vs_new.emplace_back(X::init(w));
+                    X::copy(w,vs_new.back());
+                    vs.emplace_back(std::move(w));
+                }
+            }
+
+            // Find the coefficients of the preconditioned residuals in this
+            // basis.  The residuals have no component in the Krylov vectors
+            // that we add later.
+            std::list <std::vector <Real> > cs;
+            for(auto const & r : rs) {
+                cs.emplace_back();
+                for(auto const & v : vs)
+                    cs.back().emplace_back(X::innr(v,r));
+            }
+
+            // Allocate memory for the columns of H where
+            // B_left A B_right V_q = V_p H
+            std::list <std::vector <Real> > Hs;
+
+            // Run block iterations until we restart or the space stops growing
+            Natural i;
+            for(i=1; i<=rst_freq && iter<iter_max && vs_new.size()>0; i++) {
+                iter++;
+
+                // Apply the operator and the preconditioners to the new block
+                // of Krylov vectors
+                std::list <X_Vector> Mrinv_vs;
+                std::list <X_Vector> A_Mrinv_vs;
+                std::list <X_Vector> ws;
+                for(auto const & v : vs_new) {
+                    Mrinv_vs.emplace_back(X::init(v));
+                    A_Mrinv_vs.emplace_back(X::init(v));
+                    ws.emplace_back(X::init(v));
+                }
+                B_right.eval_many(vs_new,Mrinv_vs);
+                A.eval_many(Mrinv_vs,A_Mrinv_vs);
+                B_left.eval_many(A_Mrinv_vs,ws);
+
+                // Orthogonalize the result against the Krylov vectors and add
+                // whatever remains as the next block
+                vs_new.clear();
+                for(auto & w : ws) {
+                    Hs.emplace_back();
+                    if(extend(vs,w,Hs.back())) {
+                        vs_new.emplace_back(X::init(w));
+                        X::copy(w,vs_new.back());
+                        vs.emplace_back(std::move(w));
+                    }
+                }
+
+                // Factor H = Q R where H is p x q
+                Natural const p = vs.size();
+                Natural const q = Hs.size();
+                std::vector <Real> Q(p*q,Real(0.));
+                {
+                    Natural l=1;
+                    for(auto const & h : Hs) {
+                        copy <Real> (h.size(),h.data(),1,&(Q[ijtok(1,l,p)]),1);
+                        l++;
+                    }
+                }
+                std::vector <Real> tau(q);
+                Integer lwork = q*64;
+                std::vector <Real> work(lwork);
+                Integer info(0);
+                geqrf <Real> (p,q,&(Q[0]),p,&(tau[0]),&(work[0]),lwork,info);
+                std::vector <Real> R(q*q,Real(0.));
+                for(Natural jj=1;jj<=q;jj++)
+                    for(Natural ii=1;ii<=jj;ii++)
+                        R[ijtok(ii,jj,q)]=Q[ijtok(ii,jj,p)];
+                orgqr <Real> (p,q,q,&(Q[0]),p,&(tau[0]),&(work[0]),lwork,
+                    info);
+
+                // For each system, solve the least squares problem
+                // min || c - H y || with y = R^{-1} Q' c and then form the
+                // update V_q y
+                std::list <X_Vector> V_ys;
+                std::list <X_Vector> dxs;
+                auto c = cs.cbegin();
+                for(auto const & j : js) {
+                    V_ys.emplace_back(X::init(rtrue[j]));
+                    dxs.emplace_back(X::init(rtrue[j]));
+                    X::zero(V_ys.back());
+                    if(active[j]) {
+                        auto cc = std::vector <Real> (p,Real(0.));
+                        copy <Real> (c->size(),c->data(),1,cc.data(),1);
+                        auto y = std::vector <Real> (q);
+                        gemv <Real> ('T',p,q,Real(1.),&(Q[0]),p,cc.data(),1,
+                            Real(0.),y.data(),1);
+                        trsv <Real> ('U','N','N',q,&(R[0]),q,y.data(),1);
+                        auto v = vs.cbegin();
+                        for(Natural l=0;l<q;l++) {
+                            X::axpy(y[l],*v,V_ys.back());
+                            v++;
+                        }
+                    }
+                    c++;
+                }
+
+                // Right precondition the updates and find the trial iterates
+                B_right.eval_many(V_ys,dxs);
+                auto js_active = std::vector <Natural> ();
+                auto dx = dxs.cbegin();
+                for(auto const & j : js) {
+                    if(active[j]) {
+                        X::copy(*(x[j]),x_p_dx[j]);
+                        X::axpy(Real(1.),*dx,x_p_dx[j]);
+                        js_active.emplace_back(j);
+                    }
+                    dx++;
+                }
+
+                // Find the true residuals of the trial iterates.  If we
+                // detect a NaN, something has gone terribly wrong, so quit
+                // and keep the last iterates.
+                residuals(js_active);
+                for(auto const & j : js_active)
+                    if(result[j].first != result[j].first)
+                        nan_detected = true;
+                if(nan_detected) break;
+
+                // Adjust the stopping tolerances and fix the solution of any
+                // system that converged
+                for(auto const & j : js_active) {
+                    gmanip[j]->eval(i,x_p_dx[j],*(b[j]),epss[j]);
+                    result[j].second = iter;
+                    if(result[j].first <= epss[j]) {
+                        X::copy(x_p_dx[j],*(x[j]));
+                        active[j] = false;
+                    }
+                }
+            }
+
+            // If we couldn't grow the Krylov space at all, there's nothing
+            // more that we can do
+            if(i==1) break;
+
+            // Move the systems that we're still solving to their new iterates
+            if(!nan_detected)
+                for(auto const & j : js)
+                    if(active[j])
+                        X::copy(x_p_dx[j],*(x[j]));
+        }
+
+        // Return the norms of the residuals and the iterations
+        return std::list <std::pair <Real,Natural> > (
+            result.begin(),result.end());
+    }
+
+    // Computes the preconditioned MINRES algorithm in order to solve A(x)=b
+    // when A is symmetric, but possibly indefinite.  Unlike GMRES, the short
+    // recurrence means that we only store a fixed number of vectors and never
+    // need to restart.
+    // (input) A : Operator that computes A(x), which must be symmetric
+    // (input) b : Right hand side
+    // (input) eps : Stopping tolerance on the norm of the true residual
+    // (input) iter_max : Maximum number of iterations
+    // (input) B : Operator that computes the preconditioner, which must be
+    //    symmetric positive definite
+    // (input) gmanip : Manipulator that adjusts the stopping tolerance
+    // (input/output) x : Initial guess of the solution.  Returns the final
+    //    solution.
+    // (return) (norm_rtrue,iter) : Final norm of the true residual and
+    //    the number of iterations computed.  They are returned in a STL pair.
+    template <
+        typename Real,
+        template <typename> class XX
+    >
+    std::pair <Real,Natural> minres(
+        Operator <Real,XX,XX> const & A,
+        typename XX <Real>::Vector const & b,
+        Real eps,
+        Natural iter_max,
+        Operator <Real,XX,XX> const & B,
+        GMRESManipulator <Real,XX> const & gmanip,
+        typename XX <Real>::Vector & x
+    ){
+        // Charge the solve to the Krylov phase
+        Profile::Timer timer(Profile::Krylov);
+
+        // Create some type shortcuts
+        typedef XX <Real> X;
+        typedef typename X::Vector X_Vector;
+
+        // Allocate memory for the last, current, and next Lanczos vectors
+        X_Vector v_old(X::init(x));
+        X_Vector v(X::init(x));
+        X_Vector v_new(X::init(x));
+
+        // Allocate memory for the current and next preconditioned Lanczos
+        // vectors
+        X_Vector z(X::init(x));
+        X_Vector z_new(X::init(x));
+
+        // Allocate memory for the operator applied to the preconditioned
+        // Lanczos vector
+        X_Vector A_z(X::init(x));
+
+        // Allocate memory for the last, current, and next search directions
+        // as well as the operator applied to them.  The latter allows us to
+        // update the true residual without additional operator applications.
+        X_Vector w_old(X::init(x));
+        X_Vector w(X::init(x));
+        X_Vector w_new(X::init(x));
+        X_Vector A_w_old(X::init(x));
+        X_Vector A_w(X::init(x));
+        X_Vector A_w_new(X::init(x));
+
+        // Allocate memory for the true residual
+        X_Vector rtrue(X::init(x));
+
+        // Find the true residual and its norm
+        A.eval(x,rtrue);
+        X::scal(Real(-1.),rtrue);
+        X::axpy(Real(1.),b,rtrue);
+        Real norm_rtrue = std::sqrt(X::innr(rtrue,rtrue));
+
+        // Start the Lanczos process from the true residual
+        X::zero(v_old);
+        X::copy(rtrue,v);
+        B.eval(v,z);
+        Real gamma = std::sqrt(X::innr(z,v));
+        Real gamma_old(1.);
+
+        // Initialize the Givens rotations along with the norm of the
+        // preconditioned residual
+        Real eta = gamma;
+        Real c_old(1.);
+        Real c(1.);
+        Real s_old(0.);
+        Real s(0.);
+
+        // Initialize the search directions
+        X::zero(w_old);
+        X::zero(w);
+        X::zero(A_w_old);
+        X::zero(A_w);
+
+        // If for some bizarre reason, we're already optimal, don't do any work 
+        gmanip.eval(0,x,b,eps);
+        if(norm_rtrue <= eps) iter_max=0;
+
+        // Iterate until the maximum iteration
+        Natural iter;
+        for(iter = 1; iter <= iter_max;iter++) {
+
+            // If the Lanczos process broke down, we've exhausted the Krylov
+            // space.  In addition, we catch a preconditioner that isn't
+            // positive definite, or a NaN, here.
+            if(!(gamma > Real(0.))) {
+                iter--;
+                break;
+            }
+
+            // Normalize the preconditioned Lanczos vector
+            X::scal(Real(1.)/gamma,z);
+
+            // Find the next Lanczos vector
+            A.eval(z,A_z);
+            Real delta = X::innr(A_z,z);
+            X::copy(A_z,v_new);
+            X::axpy(-delta/gamma,v,v_new);
+            X::axpy(-gamma/gamma_old,v_old,v_new);
+            B.eval(v_new,z_new);
+            Real gamma_new = std::sqrt(X::innr(z_new,v_new));
+
+            // Apply the last two Givens rotations to the newest column of
+            // the tridiagonal matrix and then find the rotation that
+            // eliminates its subdiagonal
+            Real alpha0 = c*delta - c_old*s*gamma;
+            Real alpha1 = std::sqrt(alpha0*alpha0 + gamma_new*gamma_new);
+            Real alpha2 = s*delta + c_old*c*gamma;
+            Real alpha3 = s_old*gamma;
+            if(!(alpha1 > Real(0.))) {
+                iter--;
+                break;
+            }
+            c_old = c;
+            s_old = s;
+            c = alpha0/alpha1;
+            s = gamma_new/alpha1;
+
+            // Find the new search direction and the operator applied to it
+            X::copy(z,w_new);
+            X::axpy(-alpha3,w_old,w_new);
+            X::axpy(-alpha2,w,w_new);
+            X::scal(Real(1.)/alpha1,w_new);
+            X::copy(A_z,A_w_new);
+            X::axpy(-alpha3,A_w_old,A_w_new);
+            X::axpy(-alpha2,A_w,A_w_new);
+            X::scal(Real(1.)/alpha1,A_w_new);
+
+            // Update the iterate and the true residual
+            X::axpy(c*eta,w_new,x);
+            X::axpy(-c*eta,A_w_new,rtrue);
+            norm_rtrue = std::sqrt(X::innr(rtrue,rtrue));
+            eta = -s*eta;
+
+            // Shift the Lanczos vectors and search directions
+            X::copy(v,v_old);
+            X::copy(v_new,v);
+            X::copy(z_new,z);
+            gamma_old = gamma;
+            gamma = gamma_new;
+            X::copy(w,w_old);
+            X::copy(w_new,w);
+            X::copy(A_w,A_w_old);
+            X::copy(A_w_new,A_w);
+
+            // Adjust the stopping tolerance
+            gmanip.eval(iter,x,b,eps);
+
+            // Determine if we should exit since the norm of the true residual
+            // is small
+            if(norm_rtrue <= eps) break;
+        }
+
+        // Adjust the iteration number if we ran out of iterations
+        iter = iter > iter_max ? iter_max : iter;
+
+        // Since we updated the residual with a recurrence, find the true
+        // residual one final time in case it drifted
+        if(iter > 0) {
+            A.eval(x,rtrue);
+            X::scal(Real(-1.),rtrue);
+            X::axpy(Real(1.),b,rtrue);
+            norm_rtrue = std::sqrt(X::innr(rtrue,rtrue));
+        }
+
         // Return the norm and the residual
         return std::pair <Real,Natural> (norm_rtrue,iter);
     }
     
+    // Dense, direct solver for the augmented system
+    //
+    // [ I  A ] [ u ] = [ b1 ]
+    // [ A' 0 ] [ v ]   [ b2 ]
+    //
+    // where A is a tall m x n matrix with full column rank.  We factor A with
+    // a thin QR factorization, A = Q R, which gives
+    //
+    // u = (I - Q Q') b1 + Q R^{-T} b2
+    // v = R^{-1} (Q' b1 - R^{-T} b2)
+    //
+    // Once factored, each solve costs O(mn) operations.
+    template <typename Real>
+    struct DenseAugmentedSystemQR {
+        // Disallow constructors
+        NO_COPY_ASSIGNMENT(DenseAugmentedSystemQR)
+
+        // Size of A
+        Natural m;
+        Natural n;
+
+        // Orthogonal factor of A, m x n
+        std::vector <Real> Q;
+
+        // Upper triangular factor of A, n x n
+        std::vector <Real> R;
+
+        // Whether or not we have a factorization with full column rank
+        bool factored;
+
+        // Start without a factorization
+        DenseAugmentedSystemQR() : m(0), n(0), Q(), R(), factored(false) {}
+
+        // Factors the matrix A, which is stored column major, and determines
+        // whether it has full column rank.  The matrix A is overwritten.
+        void factor(
+            Natural const & m_,
+            Natural const & n_,
+            std::vector <Real> & A
+        ) {
+            // Save the sizes
+            m = m_;
+            n = n_;
+            factored = false;
+
+            // If we're wider than we are tall, A can't have full column rank
+            if(n > m) return;
+
+            // Factor A
+            std::vector <Real> tau(n);
+            Integer lwork = std::max(Natural(1),n)*64;
+            std::vector <Real> work(lwork);
+            Integer info(0);
+            if(n > 0) {
+                geqrf <Real> (m,n,&(A[0]),m,&(tau[0]),&(work[0]),lwork,info);
+                if(info != 0) return;
+            }
+
+            // Save R and find the scale of its diagonal
+            R.assign(n*n,Real(0.));
+            auto diag_max = Real(0.);
+            auto diag_min = std::numeric_limits <Real>::infinity();
+            for(Natural j=1;j<=n;j++) {
+                for(Natural i=1;i<=j;i++)
+                    R[ijtok(i,j,n)]=A[ijtok(i,j,m)];
+                auto diag = std::fabs(R[ijtok(j,j,n)]);
+                diag_max = std::max(diag_max,diag);
+                diag_min = std::min(diag_min,diag);
+            }
+
+            // Form Q explicitly
+            if(n > 0) {
+                orgqr <Real> (m,n,n,&(A[0]),m,&(tau[0]),&(work[0]),lwork,
+                    info);
+                if(info != 0) return;
+            }
+            Q = std::move(A);
+
+            // Reject factorizations that are numerically rank deficient
+            factored = n==0 || diag_min
+                > std::numeric_limits <Real>::epsilon()*Real(m)*diag_max;
+        }
+
+        // Solves the augmented system.  The vectors b1 and u have length m
+        // while b2 and v have length n.
+        void solve(
+            Real const * const b1,
+            Real const * const b2,
+            Real * const u,
+            Real * const v
+        ) const {
+            // u <- b1, which is the solution when there are no columns
+            copy <Real> (m,b1,1,u,1);
+            if(n==0) return;
+
+            // z <- R^{-T} b2
+            std::vector <Real> z(n);
+            copy <Real> (n,b2,1,&(z[0]),1);
+            trsv <Real> ('U','T','N',n,&(R[0]),n,&(z[0]),1);
+
+            // v <- Q' b1 - z
+            gemv <Real> ('T',m,n,Real(1.),&(Q[0]),m,b1,1,Real(0.),v,1);
+            axpy <Real> (n,Real(-1.),&(z[0]),1,v,1);
+
+            // u <- b1 - Q (Q' b1 - z) = b1 - Q v
+            gemv <Real> ('N',m,n,Real(-1.),&(Q[0]),m,v,1,Real(1.),u,1);
+
+            // v <- R^{-1} v
+            trsv <Real> ('U','N','N',n,&(R[0]),n,v,1);
+        }
+    };
+
+    // Sparse matrix stored in compressed sparse row (CSR) format.  Row i
+    // holds the entries vals[k] in the columns cols[k] for
+    // k = offsets[i],...,offsets[i+1]-1.  All of the indexing is zero based.
+    template <typename Real>
+    struct CSRMatrix {
+        // Number of rows and columns
+        Natural m;
+        Natural n;
+
+        // Offsets of each row into cols and vals.  This has m+1 elements and
+        // the last element holds the number of nonzeros.
+        std::vector <Natural> offsets;
+
+        // Column of each nonzero
+        std::vector <Natural> cols;
+
+        // Value of each nonzero
+        std::vector <Real> vals;
+
+        // Create an empty matrix
+        CSRMatrix() : m(0), n(0), offsets(1,0), cols(), vals() {}
+
+        // Create an m x n matrix with no nonzeros
+        CSRMatrix(Natural const & m_,Natural const & n_) :
+            m(m_), n(n_), offsets(m_+1,0), cols(), vals() {}
+
+        // Number of nonzeros
+        Natural nnz() const {
+            return offsets.back();
+        }
+
+        // Checks whether the structure of the matrix is consistent
+        bool valid() const {
+            if( offsets.size() != m+1 || offsets.front() != 0 ||
+                cols.size() != offsets.back() || vals.size() != cols.size()
+            )
+                return false;
+            for(Natural i=0;i<m;i++)
+                if(offsets[i] > offsets[i+1]) return false;
+            for(Natural k=0;k<cols.size();k++)
+                if(cols[k] >= n) return false;
+            return true;
+        }
+    };
+
+    // Computes y <- alpha A x + beta y where A is stored in CSR format.  Each
+    // row is independent, so we split the rows between threads.
+    template <typename Real>
+    void csrmv(
+        Real const & alpha,
+        CSRMatrix <Real> const & A,
+        Real const * const x,
+        Real const & beta,
+        Real * const y
+    ) {
+        #ifdef _OPENMP
+        #pragma omp parallel for schedule(static)
+        #endif
+        for(Natural i=0;i<A.m;i++) {
+            auto Ax_i = Real(0.);
+            for(Natural k=A.offsets[i];k<A.offsets[i+1];k++)
+                Ax_i += A.vals[k]*x[A.cols[k]];
+            y[i] = beta==Real(0.) ? alpha*Ax_i : alpha*Ax_i + beta*y[i];
+        }
+    }
+
+    // Computes At <- A' where both matrices are stored in CSR format.  Since
+    // we bucket the entries by column, the columns in each row of At are
+    // sorted.  This allows the transpose product to be computed row by row
+    // in parallel without any write conflicts.
+    template <typename Real>
+    void csrtrans(CSRMatrix <Real> const & A,CSRMatrix <Real> & At) {
+        // Size the transpose
+        At.m = A.n;
+        At.n = A.m;
+        At.offsets.assign(A.n+1,0);
+        At.cols.resize(A.nnz());
+        At.vals.resize(A.nnz());
+
+        // Count the number of nonzeros in each column of A
+        for(Natural k=0;k<A.nnz();k++)
+            At.offsets[A.cols[k]+1]++;
+
+        // Accumulate the counts into offsets
+        for(Natural j=0;j<A.n;j++)
+            At.offsets[j+1] += At.offsets[j];
+
+        // Scatter the entries of A into their columns
+        auto next = std::vector <Natural> (At.offsets.begin(),
+            At.offsets.end()-1);
+        for(Natural i=0;i<A.m;i++)
+            for(Natural k=A.offsets[i];k<A.offsets[i+1];k++) {
+                auto kt = next[A.cols[k]]++;
+                At.cols[kt] = i;
+                At.vals[kt] = A.vals[k];
+            }
+    }
+
+    // Finds a fill-reducing ordering for the symmetric matrix A with the
+    // minimum degree algorithm.  We only use the sparsity pattern of A and
+    // symmetrize it if required.  Since we eliminate the graph explicitly,
+    // the work is on the order of the work in the factorization itself.  The
+    // result, perm, lists the rows of A in the order they should be
+    // eliminated.
+    template <typename Real>
+    std::vector <Natural> mindeg(CSRMatrix <Real> const & A) {
+        // Form the adjacency graph of A without the diagonal
+        auto n = A.m;
+        auto adj = std::vector <std::vector <Natural> > (n);
+        for(Natural i=0;i<n;i++)
+            for(Natural k=A.offsets[i];k<A.offsets[i+1];k++)
+                if(A.cols[k]!=i) {
+                    adj[i].emplace_back(A.cols[k]);
+                    adj[A.cols[k]].emplace_back(i);
+                }
+        for(Natural i=0;i<n;i++) {
+            std::sort(adj[i].begin(),adj[i].end());
+            adj[i].erase(std::unique(adj[i].begin(),adj[i].end()),
+                adj[i].end());
+        }
+
+        // Order the nodes by their degree.  Ties go to the lowest index.
+        auto degrees = std::set <std::pair <Natural,Natural> > ();
+        for(Natural i=0;i<n;i++)
+            degrees.emplace(adj[i].size(),i);
+
+        // Repeatedly eliminate the node with the smallest degree, which turns
+        // its neighbors into a clique
+        auto perm = std::vector <Natural> ();
+        perm.reserve(n);
+        auto merged = std::vector <Natural> ();
+        while(!degrees.empty()) {
+            // Grab the node with the smallest degree
+            auto v = degrees.begin()->second;
+            degrees.erase(degrees.begin());
+            perm.emplace_back(v);
+
+            // Connect the neighbors of v to each other.  The adjacency lists
+            // only hold nodes that we've not yet eliminated.
+            auto nbrs = std::move(adj[v]);
+            for(auto const & u : nbrs) {
+                degrees.erase(std::make_pair(adj[u].size(),u));
+                merged.clear();
+                std::set_union(adj[u].begin(),adj[u].end(),
+                    nbrs.begin(),nbrs.end(),std::back_inserter(merged));
+                adj[u].clear();
+                for(auto const & w : merged)
+                    if(w!=u && w!=v)
+                        adj[u].emplace_back(w);
+                degrees.emplace(adj[u].size(),u);
+            }
+        }
+        return perm;
+    }
+
+    // Sparse LDL' factorization of a symmetric matrix with static pivoting.
+    // We order the matrix with minimum degree, find its elimination tree, and
+    // then factor it one row at a time with the up-looking algorithm.  Rows
+    // in disjoint subtrees of the elimination tree touch disjoint columns of
+    // L, so we factor these subtrees in parallel and finish the rows at the
+    // top of the tree afterwards.  Rather than pivot dynamically, we require
+    // the expected sign of each pivot.  Any pivot with the wrong sign, or
+    // that's too small, is perturbed, so this is intended for
+    // quasidefinite matrices or for use with iterative refinement.
+    template <typename Real>
+    struct SparseLDLT {
+        // Disallow constructors
+        NO_COPY_ASSIGNMENT(SparseLDLT)
+
+        // Size of the matrix
+        Natural n;
+
+        // Elimination order and its inverse
+        std::vector <Natural> perm;
+        std::vector <Natural> iperm;
+
+        // Elimination tree where the root has a parent of n
+        std::vector <Natural> parent;
+
+        // Unit lower triangular factor, stored by columns, without the
+        // diagonal
+        std::vector <Natural> Lp;
+        std::vector <Natural> Li;
+        std::vector <Real> Lx;
+
+        // Diagonal factor
+        std::vector <Real> D;
+
+        // Rows in disjoint subtrees of the elimination tree, which we factor
+        // in parallel, and the remaining rows, which we factor afterwards
+        std::vector <std::vector <Natural> > subtrees;
+        std::vector <Natural> top;
+
+        // Sparsity pattern used in the analysis
+        std::vector <Natural> pattern_offsets;
+        std::vector <Natural> pattern_cols;
+
+        // Number of perturbed pivots in the last factorization
+        Natural perturbed;
+
+        // Start without a factorization
+        SparseLDLT() : n(0), perm(), iperm(), parent(), Lp(1,0), Li(), Lx(),
+            D(), subtrees(), top(), pattern_offsets(), pattern_cols(),
+            perturbed(0) {}
+
+        // Determines the ordering, elimination tree, and the structure of L.
+        // The matrix A must hold the full symmetric matrix.
+        void analyze(CSRMatrix <Real> const & A) {
+            // Save the sparsity pattern
+            n = A.m;
+            pattern_offsets = A.offsets;
+            pattern_cols = A.cols;
+
+            // Find a fill-reducing ordering
+            perm = mindeg <Real> (A);
+            iperm.resize(n);
+            for(Natural k=0;k<n;k++)
+                iperm[perm[k]] = k;
+
+            // Find the elimination tree and the number of nonzeros in each
+            // column of L.  We walk up the tree from every nonzero in the
+            // upper triangle of row k of the permuted matrix, which traces
+            // out the nonzero pattern of row k of L.
+            parent.assign(n,n);
+            auto flag = std::vector <Natural> (n);
+            auto Lnz = std::vector <Natural> (n,0);
+            for(Natural k=0;k<n;k++) {
+                flag[k] = k;
+                auto row = perm[k];
+                for(Natural p=A.offsets[row];p<A.offsets[row+1];p++) {
+                    for(auto i = iperm[A.cols[p]]; i < k && flag[i]!=k;
+                        i = parent[i]
+                    ) {
+                        if(parent[i]==n) parent[i] = k;
+                        Lnz[i]++;
+                        flag[i] = k;
+                    }
+                }
+            }
+            Lp.assign(n+1,0);
+            for(Natural k=0;k<n;k++)
+                Lp[k+1] = Lp[k] + Lnz[k];
+            Li.resize(Lp.back());
+            Lx.resize(Lp.back());
+            D.resize(n);
+
+            // Find the size of each subtree.  Since parents are always
+            // eliminated after their children, we can accumulate in order.
+            auto size = std::vector <Natural> (n,1);
+            for(Natural k=0;k<n;k++)
+                if(parent[k]!=n)
+                    size[parent[k]] += size[k];
+
+            // Split off the largest subtrees that are small enough to give
+            // each thread a few of them.  Rows are assigned to the subtree
+            // of their ancestor, which we find walking down from the roots.
+            auto const size_max = std::max(Natural(1),n/64);
+            auto owner = std::vector <Natural> (n,n);
+            subtrees.clear();
+            top.clear();
+            for(Natural k=n;k-- > 0;) {
+                if(parent[k]!=n && owner[parent[k]]!=n)
+                    owner[k] = owner[parent[k]];
+                else if(size[k] <= size_max) {
+                    owner[k] = subtrees.size();
+                    subtrees.emplace_back();
+                }
+            }
+            for(Natural k=0;k<n;k++)
+                if(owner[k]==n)
+                    top.emplace_back(k);
+                else
+                    subtrees[owner[k]].emplace_back(k);
+        }
+
+        // Analyzes A unless we already analyzed a matrix with the same
+        // sparsity pattern
+        void reanalyze(CSRMatrix <Real> const & A) {
+            if( n != A.m ||
+                pattern_offsets != A.offsets ||
+                pattern_cols != A.cols
+            )
+                analyze(A);
+        }
+
+        // Factors A, which must have the same sparsity pattern as the matrix
+        // we analyzed.  The sign of each pivot, indexed by the rows of A,
+        // should be +1 or -1.  Pivots with the wrong sign or whose magnitude
+        // is less than pivot_min are replaced with +-pivot_min.
+        void factor(
+            CSRMatrix <Real> const & A,
+            std::vector <Real> const & signs,
+            Real const & pivot_min
+        ) {
+            // Workspace.  Since the rows in different subtrees touch
+            // different entries, we can share all of it except for the stack
+            // holding the pattern of each row.
+            auto Y = std::vector <Real> (n,Real(0.));
+            auto flag = std::vector <Natural> (n);
+            auto Lnz = std::vector <Natural> (n,0);
+            perturbed = 0;
+
+            // Factor the subtrees in parallel and then the top of the tree
+            #ifdef _OPENMP
+            #pragma omp parallel for schedule(dynamic)
+            #endif
+            for(Natural t=0;t<subtrees.size();t++) {
+                auto pattern = std::vector <Natural> (n);
+                for(auto const & k : subtrees[t])
+                    factor_row(k,A,signs,pivot_min,Y,flag,Lnz,pattern);
+            }
+            auto pattern = std::vector <Natural> (n);
+            for(auto const & k : top)
+                factor_row(k,A,signs,pivot_min,Y,flag,Lnz,pattern);
+        }
+
+        // Solves A x = b in place
+        void solve(Real * const x) const {
+            // Permute the right hand side
+            auto y = std::vector <Real> (n);
+            for(Natural k=0;k<n;k++)
+                y[k] = x[perm[k]];
+
+            // y <- inv(L) y
+            for(Natural j=0;j<n;j++)
+                for(Natural p=Lp[j];p<Lp[j+1];p++)
+                    y[Li[p]] -= Lx[p]*y[j];
+
+            // y <- inv(D) y
+            for(Natural j=0;j<n;j++)
+                y[j] /= D[j];
+
+            // y <- inv(L') y
+            for(Natural j=n;j-- > 0;)
+                for(Natural p=Lp[j];p<Lp[j+1];p++)
+                    y[j] -= Lx[p]*y[Li[p]];
+
+            // Undo the permutation
+            for(Natural k=0;k<n;k++)
+                x[perm[k]] = y[k];
+        }
+
+    private:
+        // Computes row k of L and the kth pivot
+        void factor_row(
+            Natural const & k,
+            CSRMatrix <Real> const & A,
+            std::vector <Real> const & signs,
+            Real const & pivot_min,
+            std::vector <Real> & Y,
+            std::vector <Natural> & flag,
+            std::vector <Natural> & Lnz,
+            std::vector <Natural> & pattern
+        ) {
+            // Scatter the upper triangle of row k of the permuted matrix into
+            // Y and find the nonzero pattern of row k of L, which we store in
+            // topological order in pattern[top..n-1]
+            auto top = n;
+            flag[k] = k;
+            auto row = perm[k];
+            for(Natural p=A.offsets[row];p<A.offsets[row+1];p++) {
+                auto i = iperm[A.cols[p]];
+                if(i > k) continue;
+                Y[i] += A.vals[p];
+                auto len = Natural(0);
+                for(; i < k && flag[i]!=k; i = parent[i]) {
+                    pattern[len++] = i;
+                    flag[i] = k;
+                }
+                while(len > 0)
+                    pattern[--top] = pattern[--len];
+            }
+
+            // Solve for row k of L and the pivot 
+            auto d = Y[k];
+            Y[k] = Real(0.);
+            for(; top < n; top++) {
+                auto i = pattern[top];
+                auto yi = Y[i];
+                Y[i] = Real(0.);
+                auto p2 = Lp[i] + Lnz[i];
+                for(Natural p=Lp[i];p<p2;p++)
+                    Y[Li[p]] -= Lx[p]*yi;
+                auto l_ki = yi/D[i];
+                d -= l_ki*yi;
+                Li[p2] = k;
+                Lx[p2] = l_ki;
+                Lnz[i]++;
+            }
+
+            // Perturb the pivot if it has the wrong sign or is too small
+            auto sign = signs[row];
+            if(!(sign*d >= pivot_min)) {
+                d = sign*pivot_min;
+                #ifdef _OPENMP
+                #pragma omp atomic
+                #endif
+                perturbed++;
+            }
+            D[k] = d;
+        }
+    };
+
+    // Finds log(det(A)) for a sparse, symmetric positive definite matrix A,
+    // which must hold both triangles, with a sparse Cholesky factorization.
+    // When the sparsity pattern of A is chordal, or close to it, this costs
+    // far less than the dense factorization.  If A is not positive definite,
+    // we return NaN.  We only redo the ordering and symbolic analysis in ldlt
+    // when the sparsity pattern of A differs from the last one.
+    template <typename Real>
+    Real sparse_logdet(CSRMatrix <Real> const & A,SparseLDLT <Real> & ldlt) {
+        // Factor A as L D L' and require positive pivots
+        ldlt.reanalyze(A);
+        ldlt.factor(A,std::vector <Real> (A.m,Real(1.)),
+            std::numeric_limits <Real>::min());
+        if(ldlt.perturbed > 0)
+            return std::numeric_limits <Real>::quiet_NaN();
+
+        // log(det(A)) = sum_i log(D_i)
+        auto log_det = Real(0.);
+        for(auto const & d : ldlt.D)
+            log_det += std::log(d);
+        return log_det;
+    }
+
+    // Finds argmax {alpha >= 0 : alpha X + Y >= 0} for sparse, symmetric
+    // matrices X and Y that share a sparsity pattern and where Y is
+    // positive definite.  Both matrices must hold both triangles.  Rather
+    // than an eigenvalue solver, we bisect on t in [0,1] with
+    //
+    // (1-t) Y + t X >= 0  <=>  alpha X + Y >= 0  where alpha = t/(1-t)
+    //
+    // and check definiteness with a sparse Cholesky factorization.  We reuse
+    // the symbolic factorization in ldlt for all of the checks, and between
+    // calls while the sparsity pattern stays the same, and always return a
+    // step on the feasible side of the boundary.
+    template <typename Real>
+    Real sparse_srch(
+        CSRMatrix <Real> const & X,
+        CSRMatrix <Real> const & Y,
+        SparseLDLT <Real> & ldlt
+    ) {
+        // Analyze the shared sparsity pattern if it changed
+        ldlt.reanalyze(Y);
+        auto const signs = std::vector <Real> (Y.m,Real(1.));
+        auto Z = Y;
+
+        // Checks whether (1-t) Y + t X is positive definite
+        auto definite = [&](Real const & t) {
+            for(Natural k=0;k<Z.vals.size();k++)
+                Z.vals[k] = (Real(1.)-t)*Y.vals[k] + t*X.vals[k];
+            ldlt.factor(Z,signs,std::numeric_limits <Real>::min());
+            return ldlt.perturbed == 0;
+        };
+
+        // If X is positive definite, we can step as far as we like
+        if(definite(Real(1.)))
+            return std::numeric_limits <Real>::infinity();
+
+        // Otherwise, bisect until we know alpha to a relative precision of
+        // sqrt(eps)
+        auto alpha = [](Real const & t) { return t/(Real(1.)-t); };
+        auto t_lo = Real(0.);
+        auto t_hi = Real(1.);
+        auto const tol = std::sqrt(std::numeric_limits <Real>::epsilon());
+        for(Natural iter=0;iter<Natural(std::numeric_limits<Real>::digits);
+            iter++
+        ) {
+            if(t_lo > Real(0.) && alpha(t_hi)-alpha(t_lo) <= tol*alpha(t_lo))
+                break;
+            auto t = Real(0.5)*(t_lo+t_hi);
+            if(definite(t))
+                t_lo = t;
+            else
+                t_hi = t;
+        }
+        return alpha(t_lo);
+    }
+
+    // Sparse, direct solver for the augmented system
+    //
+    // [ I  A' ] [ u ] = [ b1 ]
+    // [ A  0  ] [ v ]   [ b2 ]
+    //
+    // where A is a sparse m x n matrix.  Instead of the system itself, we
+    // factor the quasidefinite system
+    //
+    // [ I  A'       ]
+    // [ A  -delta I ]
+    //
+    // with a sparse LDL' factorization.  Quasidefinite matrices have an LDL'
+    // factorization for any symmetric ordering, so we're free to choose a
+    // fill-reducing ordering.  Since delta is small, the result is a good
+    // preconditioner for iterative refinement on the original system.  We
+    // reuse the ordering and symbolic factorization as long as the sparsity
+    // pattern of A doesn't change.
+    template <typename Real>
+    struct SparseAugmentedSystemLDLT {
+        // Disallow constructors
+        NO_COPY_ASSIGNMENT(SparseAugmentedSystemLDLT)
+
+        // Size of A
+        Natural m;
+        Natural n;
+
+        // Regularized augmented system
+        CSRMatrix <Real> K;
+
+        // Factorization of the regularized augmented system
+        SparseLDLT <Real> ldlt;
+
+        // Start without a factorization
+        SparseAugmentedSystemLDLT() : m(0), n(0), K(), ldlt() {}
+
+        // Factors the regularized augmented system given A and A'
+        void factor(CSRMatrix <Real> const & A,CSRMatrix <Real> const & At) {
+            // Save the sizes
+            m = A.m;
+            n = A.n;
+
+            // Scale the regularization to the size of the entries of A
+            auto A_max = Real(0.);
+            for(auto const & a : A.vals)
+                A_max = std::max(A_max,std::fabs(a));
+            auto scale = std::max(Real(1.),A_max*A_max);
+            auto delta = std::sqrt(std::numeric_limits <Real>::epsilon())
+                * scale;
+
+            // Assemble the full symmetric matrix row by row
+            K.m = m+n;
+            K.n = m+n;
+            K.offsets.resize(m+n+1);
+            K.cols.resize(m+n+2*A.nnz());
+            K.vals.resize(m+n+2*A.nnz());
+            auto q = Natural(0);
+            for(Natural i=0;i<n;i++) {
+                K.offsets[i] = q;
+                K.cols[q] = i;
+                K.vals[q++] = Real(1.);
+                for(Natural p=At.offsets[i];p<At.offsets[i+1];p++) {
+                    K.cols[q] = n+At.cols[p];
+                    K.vals[q++] = At.vals[p];
+                }
+            }
+            for(Natural i=0;i<m;i++) {
+                K.offsets[n+i] = q;
+                for(Natural p=A.offsets[i];p<A.offsets[i+1];p++) {
+                    K.cols[q] = A.cols[p];
+                    K.vals[q++] = A.vals[p];
+                }
+                K.cols[q] = n+i;
+                K.vals[q++] = -delta;
+            }
+            K.offsets[m+n] = q;
+
+            // Analyze the matrix if the pattern changed
+            ldlt.reanalyze(K);
+
+            // Factor the matrix.  The pivots associated with the identity are
+            // positive and the rest are negative.
+            auto signs = std::vector <Real> (m+n,Real(1.));
+            for(Natural i=n;i<m+n;i++)
+                signs[i] = Real(-1.);
+            ldlt.factor(K,signs,std::numeric_limits <Real>::epsilon()*scale);
+        }
+
+        // Solves the regularized augmented system.  The vectors b1 and u have
+        // length n while b2 and v have length m.
+        void solve(
+            Real const * const b1,
+            Real const * const b2,
+            Real * const u,
+            Real * const v
+        ) const {
+            auto w = std::vector <Real> (m+n);
+            copy <Real> (n,b1,1,w.data(),1);
+            copy <Real> (m,b2,1,w.data()+n,1);
+            ldlt.solve(w.data());
+            copy <Real> (n,w.data(),1,u,1);
+            copy <Real> (m,w.data()+n,1,v,1);
+        }
+    };
+            
     // Determines the relative error between two vectors where the second vector
     // may or may not have been initialized.  This is typically used for
     // determining the relative error between a vector and some cached value.
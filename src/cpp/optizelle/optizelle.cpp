@@ -250,6 +250,8 @@ namespace Optizelle{
                 return "TwoPointA";
             case TwoPointB:
                 return "TwoPointB";
+            case MoreThuente:
+                return "MoreThuente";
             default:
                 throw Exception::t(__LOC__
                     + ", invalid LineSearchKind::t"); 
@@ -266,6 +268,8 @@ namespace Optizelle{
                 return TwoPointA; 
             else if(kind=="TwoPointB")
                 return TwoPointB; 
+            else if(kind=="MoreThuente")
+                return MoreThuente; 
             else
                 throw Exception::t(__LOC__
                     + ", string can't be convert into a LineSearchKind::t"); 
@@ -276,7 +280,8 @@ namespace Optizelle{
             if( name=="GoldenSection" ||
                 name=="BackTracking" ||
                 name=="TwoPointA" ||
-                name=="TwoPointB" 
+                name=="TwoPointB" ||
+                name=="MoreThuente"
             )
                 return true;
             else
@@ -289,6 +294,7 @@ namespace Optizelle{
             switch(kind){
             case GoldenSection:
             case BackTracking:
+            case MoreThuente:
                 return true;
             case TwoPointA:
             case TwoPointB:
@@ -637,6 +643,323 @@ namespace Optizelle{
                 return false;
         }
     }
+
+    // Different ways to reuse truncated-CG information between solves
+    namespace KrylovReuse{
+
+        // Converts the Krylov reuse strategy to a string
+        std::string to_string(t const & reuse) {
+            switch(reuse){
+            case NoReuse:
+                return "NoReuse";
+            case Subspace:
+                return "Subspace";
+            case SubspaceWarmStart:
+                return "SubspaceWarmStart";
+            default:
+                throw Exception::t(__LOC__+", invalid KrylovReuse::t"); 
+            }
+        }
+        
+        // Converts a string to the Krylov reuse strategy
+        t from_string(std::string const & reuse) {
+            if(reuse=="NoReuse")
+                return NoReuse; 
+            else if(reuse=="Subspace")
+                return Subspace;
+            else if(reuse=="SubspaceWarmStart")
+                return SubspaceWarmStart;
+            else
+                throw Exception::t(__LOC__
+                    + ", string can't be convert into a KrylovReuse::t"); 
+        }
+
+        // Checks whether or not a string is valid
+        bool is_valid(std::string const & name) {
+            if( name=="NoReuse" ||
+                name=="Subspace" ||
+                name=="SubspaceWarmStart"
+            )
+                return true;
+            else
+                return false;
+        }
+    }
+
+    // Different solvers for the trust-region subproblem
+    namespace TrustRegionSolver{
+
+        // Converts the trust-region subproblem solver to a string
+        std::string to_string(t const & x) {
+            switch(x){
+            case TruncatedCG:
+                return "TruncatedCG";
+            case GLTR:
+                return "GLTR";
+            default:
+                throw Exception::t(__LOC__+", invalid TrustRegionSolver::t"); 
+            }
+        }
+        
+        // Converts a string to the trust-region subproblem solver
+        t from_string(std::string const & x) {
+            if(x=="TruncatedCG")
+                return TruncatedCG;
+            else if(x=="GLTR")
+                return GLTR;
+            else
+                throw Exception::t(__LOC__
+                    + ", string can't be convert into a TrustRegionSolver::t"); 
+        }
+
+        // Checks whether or not a string is valid
+        bool is_valid(std::string const & name) {
+            if( name=="TruncatedCG" ||
+                name=="GLTR"
+            )
+                return true;
+            else
+                return false;
+        }
+    }
+
+    // How we choose the stopping tolerance for truncated CG
+    namespace ForcingTerm{
+
+        // Converts the truncated-CG stopping tolerance strategy to a string
+        std::string to_string(t const & x) {
+            switch(x){
+            case Constant:
+                return "Constant";
+            case EisenstatWalker1:
+                return "EisenstatWalker1";
+            case EisenstatWalker2:
+                return "EisenstatWalker2";
+            case NashSofer:
+                return "NashSofer";
+            default:
+                throw Exception::t(__LOC__+", invalid ForcingTerm::t"); 
+            }
+        }
+        
+        // Converts a string to the truncated-CG stopping tolerance strategy
+        t from_string(std::string const & x) {
+            if(x=="Constant")
+                return Constant;
+            else if(x=="EisenstatWalker1")
+                return EisenstatWalker1;
+            else if(x=="EisenstatWalker2")
+                return EisenstatWalker2;
+            else if(x=="NashSofer")
+                return NashSofer;
+            else
+                throw Exception::t(__LOC__
+                    + ", string can't be convert into a ForcingTerm::t"); 
+        }
+
+        // Checks whether or not a string is valid
+        bool is_valid(std::string const & name) {
+            if( name=="Constant" ||
+                name=="EisenstatWalker1" ||
+                name=="EisenstatWalker2" ||
+                name=="NashSofer"
+            )
+                return true;
+            else
+                return false;
+        }
+
+        // Checks whether we adapt eps_trunc between iterations
+        bool is_adaptive(t const & x) {
+            return x==EisenstatWalker1 || x==EisenstatWalker2;
+        }
+    }
+
+    // Reference value used when accepting a step
+    namespace NonmonotoneKind{
+
+        // Converts the nonmonotone kind to a string
+        std::string to_string(t const & x) {
+            switch(x){
+            case Monotone:
+                return "Monotone";
+            case MaxWindow:
+                return "MaxWindow";
+            case WeightedAverage:
+                return "WeightedAverage";
+            default:
+                throw Exception::t(__LOC__+", invalid NonmonotoneKind::t"); 
+            }
+        }
+        
+        // Converts a string to the nonmonotone kind
+        t from_string(std::string const & x) {
+            if(x=="Monotone")
+                return Monotone;
+            else if(x=="MaxWindow")
+                return MaxWindow;
+            else if(x=="WeightedAverage")
+                return WeightedAverage;
+            else
+                throw Exception::t(__LOC__
+                    + ", string can't be convert into a NonmonotoneKind::t"); 
+        }
+
+        // Checks whether or not a string is valid
+        bool is_valid(std::string const & name) {
+            if( name=="Monotone" ||
+                name=="MaxWindow" ||
+                name=="WeightedAverage"
+            )
+                return true;
+            else
+                return false;
+        }
+    }
+
+    // Different solvers for the augmented system
+    namespace AugmentedSystemSolver{
+
+        // Converts the augmented system solver to a string
+        std::string to_string(t const & x) {
+            switch(x){
+            case GMRES:
+                return "GMRES";
+            case MINRES:
+                return "MINRES";
+            case QR:
+                return "QR";
+            case LDLT:
+                return "LDLT";
+            case FGMRES:
+                return "FGMRES";
+            default:
+                throw Exception::t(__LOC__+", invalid AugmentedSystemSolver::t"); 
+            }
+        }
+        
+        // Converts a string to the augmented system solver
+        t from_string(std::string const & x) {
+            if(x=="GMRES")
+                return GMRES;
+            else if(x=="MINRES")
+                return MINRES;
+            else if(x=="QR")
+                return QR;
+            else if(x=="LDLT")
+                return LDLT;
+            else if(x=="FGMRES")
+                return FGMRES;
+            else
+                throw Exception::t(__LOC__
+                    + ", string can't be convert into a AugmentedSystemSolver::t"); 
+        }
+
+        // Checks whether or not a string is valid
+        bool is_valid(std::string const & name) {
+            if( name=="GMRES" ||
+                name=="MINRES" ||
+                name=="QR" ||
+                name=="LDLT" ||
+                name=="FGMRES"
+            )
+                return true;
+            else
+                return false;
+        }
+    }
+
+    namespace InteriorPointScheme{
+
+        // Converts the interior point scheme to a string
+        std::string to_string(t const & x) {
+            switch(x){
+            case FixedReduction:
+                return "FixedReduction";
+            case Mehrotra:
+                return "Mehrotra";
+            default:
+                throw Exception::t(__LOC__+", invalid InteriorPointScheme::t"); 
+            }
+        }
+        
+        // Converts a string to the interior point scheme
+        t from_string(std::string const & x) {
+            if(x=="FixedReduction")
+                return FixedReduction;
+            else if(x=="Mehrotra")
+                return Mehrotra;
+            else
+                throw Exception::t(__LOC__
+                    + ", string can't be convert into a InteriorPointScheme::t"); 
+        }
+
+        // Checks whether or not a string is valid
+        bool is_valid(std::string const & name) {
+            if( name=="FixedReduction" ||
+                name=="Mehrotra"
+            )
+                return true;
+            else
+                return false;
+        }
+    }
+
+    namespace InteriorPointScaling{
+
+        // Converts the interior point scaling to a string
+        std::string to_string(t const & x) {
+            switch(x){
+            case Unscaled:
+                return "Unscaled";
+            case NesterovTodd:
+                return "NesterovTodd";
+            default:
+                throw Exception::t(__LOC__+", invalid InteriorPointScaling::t"); 
+            }
+        }
+        
+        // Converts a string to the interior point scaling
+        t from_string(std::string const & x) {
+            if(x=="Unscaled")
+                return Unscaled;
+            else if(x=="NesterovTodd")
+                return NesterovTodd;
+            else
+                throw Exception::t(__LOC__
+                    + ", string can't be convert into a InteriorPointScaling::t"); 
+        }
+
+        // Checks whether or not a string is valid
+        bool is_valid(std::string const & name) {
+            if( name=="Unscaled" ||
+                name=="NesterovTodd"
+            )
+                return true;
+            else
+                return false;
+        }
+    }
+    
+    // Pieces of a solved state that we can carry into the solve of a related
+    // problem
+    namespace WarmStart {
+
+        // Checks whether items selects the restart item called name
+        bool is_selected(Natural const & items,std::string const & name) {
+            return
+                ((items & Iterate) && name=="x") ||
+                ((items & TrustRegion) && name=="delta") ||
+                ((items & QuasiNewton) && (
+                    name.substr(0,5)=="oldY_" ||
+                    name.substr(0,5)=="oldS_")) ||
+                ((items & Multipliers) && name=="y") ||
+                ((items & InteriorPoint) && (
+                    name=="z" ||
+                    name=="mu" ||
+                    name=="mu_typ"));
+        }
+    }
     
     // Reasons why the quasinormal problem exited
     namespace QuasinormalStop{
@@ -783,6 +1106,8 @@ namespace Optizelle{
             return atos("Safeguard");
         case TruncatedStop::ObjectiveIncrease:
             return atos("ObjIncr");
+        case TruncatedStop::ModelDecreaseSmall:
+            return atos("ModDecSml");
         default:
             throw Exception::t(__LOC__ + ", invalid TruncatedStop::t");
         }
@@ -817,4 +1142,33 @@ namespace Optizelle{
             throw Exception::t(__LOC__ + ", invalid QuasiNormalStop::t");
         }
     }
+    std::string Utility::atos(Profile::t const & x){
+        // Converts the phase to a shorter string
+        switch(x){
+        case Profile::Objective:
+            return atos("t_obj");
+        case Profile::Gradient:
+            return atos("t_grad");
+        case Profile::HessVec:
+            return atos("t_hessvec");
+        case Profile::Constraints:
+            return atos("t_con");
+        case Profile::ConstraintJacobian:
+            return atos("t_con_p");
+        case Profile::ConstraintHessian:
+            return atos("t_con_pps");
+        case Profile::Preconditioner:
+            return atos("t_prec");
+        case Profile::VectorSpace:
+            return atos("t_vspace");
+        case Profile::Krylov:
+            return atos("t_krylov");
+        case Profile::LineSearch:
+            return atos("t_ls");
+        case Profile::Checkpoint:
+            return atos("t_chkpt");
+        default:
+            throw Exception::t(__LOC__ + ", invalid Profile::t");
+        }
+    }
 }
@@ -11,6 +11,7 @@
 #include<functional>
 #include<algorithm>
 #include<numeric>
+#include<type_traits>
 #include "optizelle/exception.h"
 #include "optizelle/linalg.h"
 
@@ -170,12 +171,93 @@ namespace Optizelle{
              Y_Vector const & dy,
              X_Vector & z
          ) const = 0;
+
+         // Whether f is affine.  In this case, f'(x) doesn't depend on x
+         // and f''(x)=0, so we cache anything that depends only on f' for
+         // the life of the solve.
+         virtual bool is_affine() const {
+             return false;
+         }
          
          // Allow a derived class to deallocate memory
          virtual ~VectorValuedFunction() {}
     };
     //---VectorValuedFunction1---
 
+    // Vector valued functions on Rm that can give their derivative as a
+    // sparse matrix.  This allows us to factor the augmented system directly.
+    template <typename Real>
+    struct SparseJacobian {
+        // Returns f'(x)
+        virtual CSRMatrix <Real> const & jac(
+            std::vector <Real> const & x
+        ) const = 0;
+
+        // Returns f'(x)'
+        virtual CSRMatrix <Real> const & jac_trans(
+            std::vector <Real> const & x
+        ) const = 0;
+
+        // Allow a derived class to deallocate memory
+        virtual ~SparseJacobian() {}
+    };
+
+    // Nesterov-Todd scaling for vector spaces that are symmetric cones.
+    // Given x and z in the interior of the cone, the scaling point w is the
+    // unique point in the interior of the cone where P(w) x = z and P denotes
+    // the quadratic representation.  Since P(w) is symmetric positive
+    // definite, we can use it in place of inv(L(x)) L(z) when we linearize
+    // the complementarity conditions.  Vector spaces that support this
+    // specialize this structure to contain
+    //
+    // available : std::true_type
+    // point(x,z,w) : w <- the scaling point between x and z
+    // quad(w,dx,y) : y <- P(w) dx
+    template <typename Real,template <typename> class ZZ>
+    struct NesterovTodd {
+        typedef std::false_type available;
+    };
+
+    // Fused kernels for the compositions of the Jordan algebra operations
+    // that the interior point method applies every iteration.  Composing
+    // id, prod, linv, scal, and axpy requires a separate pass through the
+    // vector and a workspace for each, so vector spaces can instead
+    // specialize this structure to contain
+    //
+    // available : std::true_type
+    // linv_id(x,y) : y <- inv(L(x)) e
+    // linv_prod(x,dx,z,y) : y <- inv(L(x)) (dx o z)
+    // linv_id_shift(x,mu,z,y) : y <- y + mu inv(L(x)) e - z
+    template <typename Real,template <typename> class ZZ>
+    struct InteriorPointFused {
+        typedef std::false_type available;
+    };
+
+    // Simple bounds x_lo <= x <= x_hi for vector spaces whose elements we
+    // can compare pointwise.  Either bound may be infinite.  Since the bound
+    // constrained algorithms touch every element of x several times per
+    // iteration, we fuse each of the following operations into a single pass.
+    // Vector spaces that support this specialize this structure to contain
+    //
+    // available : std::true_type
+    // valid(x_lo,x_hi) : whether x_lo < x_hi
+    // proj(x_lo,x_hi,kappa,x) : x <- x projected into the bounds after we
+    //     push them inward relative to kappa
+    // pgrad(x_lo,x_hi,x,grad,pg) : pg <- x - proj(x - grad)
+    // scaling(x_lo,x_hi,x,grad,c,d) : c <- |grad| / dist(x,bound) and
+    //     d <- sqrt(min(1,dist(x,bound))) where we take the bound that -grad
+    //     points toward
+    // srch(x_lo,x_hi,x,dx,frac) : the largest alpha >= 0 such that
+    //     x + alpha dx stays within the bounds after we move them toward x by
+    //     the fraction (1-frac)
+    // trunc(x_lo,x_hi,x,frac,dx) : dx <- dx truncated elementwise so that
+    //     x + dx stays within the bounds after we move them toward x by the
+    //     fraction (1-frac)
+    template <typename Real,template <typename> class XX>
+    struct Bounds {
+        typedef std::false_type available;
+    };
+
     //---Messaging0---
     // Defines how we output messages to the user
     namespace Messaging {
@@ -331,7 +413,8 @@ namespace Optizelle{
             GoldenSection,    // Golden-section search 
             BackTracking,     // BackTracking search 
             TwoPointA,        // Barzilai and Borwein's method A
-            TwoPointB         // Barzilai and Borwein's method B
+            TwoPointB,        // Barzilai and Borwein's method B
+            MoreThuente       // More and Thuente's strong-Wolfe search
             //---LineSearchKind1---
         };
             
@@ -538,6 +621,192 @@ namespace Optizelle{
         bool is_valid(std::string const & eps_rel);
     }
 
+    // Different ways to reuse truncated-CG information between solves
+    namespace KrylovReuse {
+        enum t : Natural{
+            //---KrylovReuse0---
+            NoReuse,            // Compute everything from scratch
+            Subspace,           // Retain the Krylov subspace built by
+                                // truncated CG and resolve the trust-region
+                                // subproblem within it after a rejected step
+            SubspaceWarmStart   // Retain the Krylov subspace as above and
+                                // warm-start truncated CG with the prior step
+            //---KrylovReuse1---
+        };
+        
+        // Converts the Krylov reuse strategy to a string
+        std::string to_string(t const & reuse);
+        
+        // Converts a string to the Krylov reuse strategy
+        t from_string(std::string const & reuse);
+
+        // Checks whether or not a string is valid
+        bool is_valid(std::string const & name);
+    }
+
+    // Different solvers for the trust-region subproblem
+    namespace TrustRegionSolver {
+        enum t : Natural{
+            //---TrustRegionSolver0---
+            TruncatedCG, // Steihaug-Toint truncated CG, which stops at the
+                         // trust-region or on negative curvature
+            GLTR         // Generalized Lanczos trust-region method, which
+                         // continues past the trust-region and solves the
+                         // subproblem over the Krylov subspace
+            //---TrustRegionSolver1---
+        };
+        
+        // Converts the trust-region subproblem solver to a string
+        std::string to_string(t const & x);
+        
+        // Converts a string to the trust-region subproblem solver
+        t from_string(std::string const & x);
+
+        // Checks whether or not a string is valid
+        bool is_valid(std::string const & name);
+    }
+
+    // How we choose the stopping tolerance for truncated CG
+    namespace ForcingTerm {
+        enum t : Natural{
+            //---ForcingTerm0---
+            Constant,         // Use eps_trunc as given
+            EisenstatWalker1, // Eisenstat-Walker choice 1, which compares the
+                              // gradient to the prior linear model
+            EisenstatWalker2, // Eisenstat-Walker choice 2, which uses the
+                              // reduction in the norm of the gradient
+            NashSofer         // Use eps_trunc as given, but also exit truncated
+                              // CG when the relative decrease in the quadratic
+                              // model is small
+            //---ForcingTerm1---
+        };
+        
+        // Converts the truncated-CG stopping tolerance strategy to a string
+        std::string to_string(t const & x);
+        
+        // Converts a string to the truncated-CG stopping tolerance strategy
+        t from_string(std::string const & x);
+
+        // Checks whether or not a string is valid
+        bool is_valid(std::string const & name);
+
+        // Checks whether we adapt eps_trunc between iterations
+        bool is_adaptive(t const & x);
+    }
+
+    // Reference value used when accepting a step
+    namespace NonmonotoneKind {
+        enum t : Natural{
+            //---NonmonotoneKind0---
+            Monotone,        // Compare against the current merit value
+            MaxWindow,       // Compare against the largest of the last few
+                             // merit values (Grippo, Lampariello, and Lucidi)
+            WeightedAverage  // Compare against a weighted average of the
+                             // prior merit values (Zhang and Hager)
+            //---NonmonotoneKind1---
+        };
+        
+        // Converts the nonmonotone kind to a string
+        std::string to_string(t const & x);
+        
+        // Converts a string to the nonmonotone kind
+        t from_string(std::string const & x);
+
+        // Checks whether or not a string is valid
+        bool is_valid(std::string const & name);
+    }
+
+    // Different solvers for the augmented system
+    namespace AugmentedSystemSolver {
+        enum t : Natural{
+            //---AugmentedSystemSolver0---
+            GMRES,  // Restarted GMRES, which handles any preconditioner
+            MINRES, // MINRES, which uses a short recurrence, but requires a
+                    // symmetric positive definite preconditioner
+            QR,     // Direct solve with a dense QR factorization of g'(x)*,
+                    // which requires X and Y to be Rm
+            LDLT,   // Direct solve with a sparse LDL' factorization, which
+                    // requires g to provide a sparse Jacobian
+            FGMRES  // Flexible GMRES, which allows the right preconditioner
+                    // to change between iterations, such as an inner
+                    // iterative solve
+            //---AugmentedSystemSolver1---
+        };
+        
+        // Converts the augmented system solver to a string
+        std::string to_string(t const & x);
+        
+        // Converts a string to the augmented system solver
+        t from_string(std::string const & x);
+
+        // Checks whether or not a string is valid
+        bool is_valid(std::string const & name);
+    }
+
+    // Different schemes for updating the interior point parameter
+    namespace InteriorPointScheme {
+        enum t : Natural{
+            //---InteriorPointScheme0---
+            FixedReduction, // Reduce mu by sigma once the barrier subproblem
+                            // has converged
+            Mehrotra        // Choose mu each iteration from an affine-scaling
+                            // predictor and add a second-order corrector
+            //---InteriorPointScheme1---
+        };
+        
+        // Converts the interior point scheme to a string
+        std::string to_string(t const & x);
+        
+        // Converts a string to the interior point scheme
+        t from_string(std::string const & x);
+
+        // Checks whether or not a string is valid
+        bool is_valid(std::string const & name);
+    }
+
+    // Different scalings for the linearization of the complementarity
+    // conditions h(x) o z = mu e
+    namespace InteriorPointScaling {
+        enum t : Natural{
+            //---InteriorPointScaling0---
+            Unscaled,       // Linearize h(x) o z directly, which gives the
+                            // operator inv(L(h(x))) L(z)
+            NesterovTodd    // Use the symmetric Nesterov-Todd scaling P(w)
+                            // where P(w) h(x) = z, which requires Z to
+                            // specialize NesterovTodd
+            //---InteriorPointScaling1---
+        };
+        
+        // Converts the interior point scaling to a string
+        std::string to_string(t const & x);
+        
+        // Converts a string to the interior point scaling
+        t from_string(std::string const & x);
+
+        // Checks whether or not a string is valid
+        bool is_valid(std::string const & name);
+    }
+
+    // Pieces of a solved state that we can carry into the solve of a related
+    // problem.  Since we often want several of these, combine them with a
+    // bitwise or.
+    namespace WarmStart {
+        enum t : Natural{
+            //---WarmStart0---
+            Iterate = 1,        // The optimization variable x
+            TrustRegion = 2,    // The trust-region radius delta
+            QuasiNewton = 4,    // The quasi-Newton history oldY and oldS
+            Multipliers = 8,    // The equality multiplier y
+            InteriorPoint = 16, // The inequality multiplier z along with the
+                                // interior point parameters mu and mu_typ
+            All = 31            // Everything above
+            //---WarmStart1---
+        };
+
+        // Checks whether items selects the restart item called name
+        bool is_selected(Natural const & items,std::string const & name);
+    }
+
     // Reasons why the quasinormal problem exited
     namespace QuasinormalStop{
         enum t{
@@ -1651,6 +1920,14 @@ namespace Optizelle{
                 }
                 break;
 
+            // Output where we spent our time
+            case OptimizationLocation::EndOfOptimization:
+            #ifdef OPTIZELLE_PROFILE
+                if(msg_level >= 1)
+                    msg(Profile::to_json(state.profile));
+            #endif
+                break;
+
             default:
                 break;
             }
@@ -1716,6 +1993,45 @@ namespace Optizelle{
                     + kind + item->first);
         }
 
+        // Removes the items that select picks
+        template <typename T>
+        void removeItems(
+            std::function <bool(std::string const &)> const & select,
+            typename RestartPackage <T>::t & items
+        ) {
+            items.remove_if([&](typename RestartPackage <T>::tuple const & item)
+                { return select(item.first); });
+        }
+
+        // Copies the scalars in src that select picks into dst
+        template <typename T>
+        void copyScalars(
+            std::function <bool(std::string const &)> const & select,
+            typename RestartPackage <T>::t const & src,
+            typename RestartPackage <T>::t & dst
+        ) {
+            for(auto const & item : src)
+                if(select(item.first))
+                    dst.emplace_back(item);
+        }
+
+        // Copies the vectors in src that select picks into dst.  Since we
+        // can only copy vectors through their vector space, VS, we allocate
+        // new memory for each of them.
+        template <typename VS>
+        void copyVectors(
+            std::function <bool(std::string const &)> const & select,
+            typename RestartPackage <typename VS::Vector>::t const & src,
+            typename RestartPackage <typename VS::Vector>::t & dst
+        ) {
+            for(auto const & item : src)
+                if(select(item.first)) {
+                    auto x = VS::init(item.second);
+                    VS::copy(item.second,x);
+                    dst.emplace_back(item.first,std::move(x));
+                }
+        }
+
         // Converts a variety of basic datatypes to strings
         std::ostream& formatReal(std::ostream& out);
         std::ostream& formatInt(std::ostream& out);
@@ -1727,6 +2043,7 @@ namespace Optizelle{
         std::string atos(std::string const & x);
         std::string atos(TruncatedStop::t const & x);
         std::string atos(QuasinormalStop::t const & x);
+        std::string atos(Profile::t const & x);
 
         // Blank separator for printing
         std::string const blankSeparator = ".           ";
@@ -1750,6 +2067,384 @@ namespace Optizelle{
         }
     }
        
+    // Wrappers that charge the time spent in the functions and vector spaces
+    // of a problem to their phases.  See Profile in linalg.h.
+    namespace Profile {
+        // Times the operations of the vector space VS
+        template <typename VS>
+        struct Space : public VS {
+            // Disallow constructors
+            NO_CONSTRUCTORS(Space)
+
+            template <typename... Args>
+            static auto init(Args &&... args)
+                -> decltype(VS::init(std::forward <Args> (args)...))
+            {
+                Timer timer(VectorSpace);
+                return VS::init(std::forward <Args> (args)...);
+            }
+
+            template <typename... Args>
+            static auto copy(Args &&... args)
+                -> decltype(VS::copy(std::forward <Args> (args)...))
+            {
+                Timer timer(VectorSpace);
+                return VS::copy(std::forward <Args> (args)...);
+            }
+
+            template <typename... Args>
+            static auto scal(Args &&... args)
+                -> decltype(VS::scal(std::forward <Args> (args)...))
+            {
+                Timer timer(VectorSpace);
+                return VS::scal(std::forward <Args> (args)...);
+            }
+
+            template <typename... Args>
+            static auto zero(Args &&... args)
+                -> decltype(VS::zero(std::forward <Args> (args)...))
+            {
+                Timer timer(VectorSpace);
+                return VS::zero(std::forward <Args> (args)...);
+            }
+
+            template <typename... Args>
+            static auto axpy(Args &&... args)
+                -> decltype(VS::axpy(std::forward <Args> (args)...))
+            {
+                Timer timer(VectorSpace);
+                return VS::axpy(std::forward <Args> (args)...);
+            }
+
+            template <typename... Args>
+            static auto innr(Args &&... args)
+                -> decltype(VS::innr(std::forward <Args> (args)...))
+            {
+                Timer timer(VectorSpace);
+                return VS::innr(std::forward <Args> (args)...);
+            }
+
+            template <typename... Args>
+            static auto rand(Args &&... args)
+                -> decltype(VS::rand(std::forward <Args> (args)...))
+            {
+                Timer timer(VectorSpace);
+                return VS::rand(std::forward <Args> (args)...);
+            }
+
+            template <typename... Args>
+            static auto prod(Args &&... args)
+                -> decltype(VS::prod(std::forward <Args> (args)...))
+            {
+                Timer timer(VectorSpace);
+                return VS::prod(std::forward <Args> (args)...);
+            }
+
+            template <typename... Args>
+            static auto id(Args &&... args)
+                -> decltype(VS::id(std::forward <Args> (args)...))
+            {
+                Timer timer(VectorSpace);
+                return VS::id(std::forward <Args> (args)...);
+            }
+
+            template <typename... Args>
+            static auto linv(Args &&... args)
+                -> decltype(VS::linv(std::forward <Args> (args)...))
+            {
+                Timer timer(VectorSpace);
+                return VS::linv(std::forward <Args> (args)...);
+            }
+
+            template <typename... Args>
+            static auto barr(Args &&... args)
+                -> decltype(VS::barr(std::forward <Args> (args)...))
+            {
+                Timer timer(VectorSpace);
+                return VS::barr(std::forward <Args> (args)...);
+            }
+
+            template <typename... Args>
+            static auto srch(Args &&... args)
+                -> decltype(VS::srch(std::forward <Args> (args)...))
+            {
+                Timer timer(VectorSpace);
+                return VS::srch(std::forward <Args> (args)...);
+            }
+
+            template <typename... Args>
+            static auto symm(Args &&... args)
+                -> decltype(VS::symm(std::forward <Args> (args)...))
+            {
+                Timer timer(VectorSpace);
+                return VS::symm(std::forward <Args> (args)...);
+            }
+        };
+
+        // The vector space that the algorithms use in place of VS
+    #ifdef OPTIZELLE_PROFILE
+        template <typename VS>
+        using Timed = Space <VS>;
+    #else
+        template <typename VS>
+        using Timed = VS;
+    #endif
+
+        // Times the objective
+        template <typename Real,template <typename> class XX>
+        struct ScalarValuedFunction
+            : public Optizelle::ScalarValuedFunction <Real,XX>
+        {
+        private:
+            // Underlying function
+            std::unique_ptr <Optizelle::ScalarValuedFunction <Real,XX> > f;
+
+        public:
+            // Create some type shortcuts
+            typedef typename XX <Real>::Vector Vector;
+
+            // Prevent constructors
+            NO_DEFAULT_COPY_ASSIGNMENT(ScalarValuedFunction)
+
+            // Take ownership of the function
+            explicit ScalarValuedFunction(
+                std::unique_ptr <Optizelle::ScalarValuedFunction <Real,XX> >
+                    && f_
+            ) : f(std::move(f_)) {}
+
+            // <- f(x)
+            Real eval(Vector const & x) const {
+                Timer timer(Objective);
+                return f->eval(x);
+            }
+
+            // grad = grad f(x)
+            void grad(Vector const & x,Vector & grad) const {
+                Timer timer(Gradient);
+                f->grad(x,grad);
+            }
+
+            // H_dx = hess f(x) dx
+            void hessvec(Vector const & x,Vector const & dx,Vector & H_dx)
+                const
+            {
+                Timer timer(HessVec);
+                f->hessvec(x,dx,H_dx);
+            }
+        };
+
+        // Times the constraints
+        template <
+            typename Real,
+            template <typename> class XX,
+            template <typename> class YY
+        >
+        struct VectorValuedFunction
+            : public Optizelle::VectorValuedFunction <Real,XX,YY>
+        {
+        protected:
+            // Underlying function
+            std::unique_ptr <Optizelle::VectorValuedFunction <Real,XX,YY> > f;
+
+        public:
+            // Create some type shortcuts
+            typedef typename XX <Real>::Vector X_Vector;
+            typedef typename YY <Real>::Vector Y_Vector;
+
+            // Prevent constructors
+            NO_DEFAULT_COPY_ASSIGNMENT(VectorValuedFunction)
+
+            // Take ownership of the function
+            explicit VectorValuedFunction(
+                std::unique_ptr <Optizelle::VectorValuedFunction<Real,XX,YY> >
+                    && f_
+            ) : f(std::move(f_)) {}
+
+            // y=f(x)
+            void eval(X_Vector const & x,Y_Vector & y) const {
+                Timer timer(Constraints);
+                f->eval(x,y);
+            }
+
+            // y=f'(x)dx
+            void p(X_Vector const & x,X_Vector const & dx,Y_Vector & y) const{
+                Timer timer(ConstraintJacobian);
+                f->p(x,dx,y);
+            }
+
+            // z=f'(x)*dy
+            void ps(X_Vector const & x,Y_Vector const & dy,X_Vector & z) const{
+                Timer timer(ConstraintJacobian);
+                f->ps(x,dy,z);
+            }
+
+            // z=(f''(x)dx)*dy
+            void pps(
+                X_Vector const & x,
+                X_Vector const & dx,
+                Y_Vector const & dy,
+                X_Vector & z
+            ) const {
+                Timer timer(ConstraintHessian);
+                f->pps(x,dx,dy,z);
+            }
+
+            // Whether f is affine
+            bool is_affine() const {
+                return f->is_affine();
+            }
+        };
+
+        // Times the constraints when they also give their Jacobian as a
+        // sparse matrix.  This keeps the sparse augmented system solvers
+        // available.
+        template <
+            typename Real,
+            template <typename> class XX,
+            template <typename> class YY
+        >
+        struct SparseVectorValuedFunction :
+            public Profile::VectorValuedFunction <Real,XX,YY>,
+            public SparseJacobian <Real>
+        {
+        private:
+            // Underlying Jacobian
+            SparseJacobian <Real> const & g;
+
+        public:
+            // Prevent constructors
+            NO_DEFAULT_COPY_ASSIGNMENT(SparseVectorValuedFunction)
+
+            // Take ownership of the function
+            explicit SparseVectorValuedFunction(
+                std::unique_ptr <Optizelle::VectorValuedFunction<Real,XX,YY> >
+                    && f_
+            ) :
+                Profile::VectorValuedFunction <Real,XX,YY> (std::move(f_)),
+                g(dynamic_cast <SparseJacobian <Real> const &> (*(this->f)))
+            {}
+
+            // Returns f'(x)
+            CSRMatrix <Real> const & jac(std::vector <Real> const & x) const {
+                Timer timer(ConstraintJacobian);
+                return g.jac(x);
+            }
+
+            // Returns f'(x)'
+            CSRMatrix <Real> const & jac_trans(
+                std::vector <Real> const & x
+            ) const {
+                Timer timer(ConstraintJacobian);
+                return g.jac_trans(x);
+            }
+        };
+
+        // Times the preconditioners
+        template <
+            typename Real,
+            template <typename> class XX,
+            template <typename> class YY
+        >
+        struct Operator : public Optizelle::Operator <Real,XX,YY> {
+        private:
+            // Underlying operator
+            std::unique_ptr <Optizelle::Operator <Real,XX,YY> > A;
+
+        public:
+            // Create some type shortcuts
+            typedef typename XX <Real>::Vector X_Vector;
+            typedef typename YY <Real>::Vector Y_Vector;
+
+            // Prevent constructors
+            NO_DEFAULT_COPY_ASSIGNMENT(Operator)
+
+            // Take ownership of the operator
+            explicit Operator(
+                std::unique_ptr <Optizelle::Operator <Real,XX,YY> > && A_
+            ) : A(std::move(A_)) {}
+
+            // y = A(x)
+            void eval(X_Vector const & x,Y_Vector & y) const {
+                Timer timer(Preconditioner);
+                A->eval(x,y);
+            }
+
+            // ys[i] = A(xs[i])
+            void eval_many(
+                std::list <X_Vector> const & xs,
+                std::list <Y_Vector> & ys
+            ) const {
+                Timer timer(Preconditioner);
+                A->eval_many(xs,ys);
+            }
+        };
+
+        // Replaces the objective with one that we time
+    #ifdef OPTIZELLE_PROFILE
+        template <typename Real,template <typename> class XX>
+        void instrument(
+            std::unique_ptr <Optizelle::ScalarValuedFunction <Real,XX> > & f
+        ) {
+            f.reset(new ScalarValuedFunction <Real,XX> (std::move(f)));
+        }
+    #else
+        template <typename Real,template <typename> class XX>
+        void instrument(
+            std::unique_ptr <Optizelle::ScalarValuedFunction <Real,XX> > &
+        ) {}
+    #endif
+
+        // Replaces the constraints with ones that we time
+    #ifdef OPTIZELLE_PROFILE
+        template <
+            typename Real,
+            template <typename> class XX,
+            template <typename> class YY
+        >
+        void instrument(
+            std::unique_ptr <Optizelle::VectorValuedFunction <Real,XX,YY> > & f
+        ) {
+            if(dynamic_cast <SparseJacobian <Real> const *> (f.get()))
+                f.reset(new SparseVectorValuedFunction <Real,XX,YY> (
+                    std::move(f)));
+            else
+                f.reset(new VectorValuedFunction <Real,XX,YY> (std::move(f)));
+        }
+    #else
+        template <
+            typename Real,
+            template <typename> class XX,
+            template <typename> class YY
+        >
+        void instrument(
+            std::unique_ptr <Optizelle::VectorValuedFunction <Real,XX,YY> > &
+        ) {}
+    #endif
+
+        // Replaces the preconditioner with one that we time
+    #ifdef OPTIZELLE_PROFILE
+        template <
+            typename Real,
+            template <typename> class XX,
+            template <typename> class YY
+        >
+        void instrument(
+            std::unique_ptr <Optizelle::Operator <Real,XX,YY> > & A
+        ) {
+            A.reset(new Operator <Real,XX,YY> (std::move(A)));
+        }
+    #else
+        template <
+            typename Real,
+            template <typename> class XX,
+            template <typename> class YY
+        >
+        void instrument(
+            std::unique_ptr <Optizelle::Operator <Real,XX,YY> > &
+        ) {}
+    #endif
+    }
+
     // Routines that manipulate and support problems of the form
     // 
     // min_{x \in X} f(x)
@@ -1783,7 +2478,7 @@ namespace Optizelle{
 
     public:
         // Create some type shortcuts
-        typedef XX <Real> X;
+        typedef Profile::Timed <XX <Real> > X;
         typedef typename X::Vector X_Vector;
         
         // Disallow constructors
@@ -1863,6 +2558,9 @@ namespace Optizelle{
                 // Old trial step 
                 X_Vector dx_old;
 
+                // Gradient of the objective at the trial step
+                X_Vector grad_xpdx;
+
                 // Current value of the objective function 
                 Real f_x;
 
@@ -1933,6 +2631,40 @@ namespace Optizelle{
                 // Stopping tolerance for truncated CG 
                 Real eps_trunc;
 
+                // How we reuse the Krylov subspace built by truncated CG
+                KrylovReuse::t trunc_reuse;
+
+                // Solver for the trust-region subproblem
+                TrustRegionSolver::t trunc_solver;
+
+                // How we choose the stopping tolerance for truncated CG
+                ForcingTerm::t trunc_forcing;
+
+                // Norm of the gradient step at the prior iterate, which the
+                // Eisenstat-Walker forcing terms compare against
+                Real norm_gradold;
+
+                // Reference value used when accepting a step
+                NonmonotoneKind::t nonmono_kind;
+
+                // Number of prior merit values used by the max-window
+                // nonmonotone reference
+                Natural nonmono_mem;
+
+                // Weight of the prior reference in the weighted-average
+                // nonmonotone reference
+                Real nonmono_eta;
+
+                // Reference value of the merit function that we compare
+                // against when accepting a step
+                Real merit_ref;
+
+                // Accumulated weight of the weighted-average reference
+                Real merit_ref_q;
+
+                // Prior merit values used by the max-window reference
+                std::list <Real> merit_hist;
+
                 // ---------- Inequality Safeguards ----------
 
                 // Number of failed safe-guard steps before quitting the method
@@ -1984,6 +2716,10 @@ namespace Optizelle{
                 // Parameter that helps govern the sufficient decrease
                 Real c1;
 
+                // Parameter that helps govern the curvature condition in the
+                // strong-Wolfe line-search
+                Real c2;
+
                 // Current number of iterations used in the line-search
                 Natural ls_iter;
 
@@ -2002,6 +2738,12 @@ namespace Optizelle{
                 // Type of line-search 
                 LineSearchKind::t kind;
 
+                // ---------- Instrumentation ----------
+
+                // Time and calls spent in each phase of the optimization.
+                // These only accumulate when we compile with OPTIZELLE_PROFILE.
+                Profile::Counters profile;
+
                 // Initialization constructors
                 explicit t(X_Vector const & x_user) :
                     eps_grad(
@@ -2140,6 +2882,11 @@ namespace Optizelle{
                         X::init(x_user)
                         //---dx_old1---
                     ),
+                    grad_xpdx(
+                        //---grad_xpdx0---
+                        X::init(x_user)
+                        //---grad_xpdx1---
+                    ),
                     oldY(
                         //---oldY0---
                         // Empty
@@ -2165,6 +2912,56 @@ namespace Optizelle{
                         1
                         //---msg_level1---
                     ),
+                    trunc_reuse(
+                        //---trunc_reuse0---
+                        KrylovReuse::NoReuse
+                        //---trunc_reuse1---
+                    ),
+                    trunc_solver(
+                        //---trunc_solver0---
+                        TrustRegionSolver::TruncatedCG
+                        //---trunc_solver1---
+                    ),
+                    trunc_forcing(
+                        //---trunc_forcing0---
+                        ForcingTerm::Constant
+                        //---trunc_forcing1---
+                    ),
+                    norm_gradold(
+                        //---norm_gradold0---
+                        std::numeric_limits<Real>::quiet_NaN()
+                        //---norm_gradold1---
+                    ),
+                    nonmono_kind(
+                        //---nonmono_kind0---
+                        NonmonotoneKind::Monotone
+                        //---nonmono_kind1---
+                    ),
+                    nonmono_mem(
+                        //---nonmono_mem0---
+                        10
+                        //---nonmono_mem1---
+                    ),
+                    nonmono_eta(
+                        //---nonmono_eta0---
+                        0.85
+                        //---nonmono_eta1---
+                    ),
+                    merit_ref(
+                        //---merit_ref0---
+                        std::numeric_limits <Real>::quiet_NaN()
+                        //---merit_ref1---
+                    ),
+                    merit_ref_q(
+                        //---merit_ref_q0---
+                        std::numeric_limits <Real>::quiet_NaN()
+                        //---merit_ref_q1---
+                    ),
+                    merit_hist(
+                        //---merit_hist0---
+                        std::list <Real> ()
+                        //---merit_hist1---
+                    ),
                     safeguard_failed_max(
                         //---safeguard_failed_max0---
                         5 
@@ -2235,6 +3032,11 @@ namespace Optizelle{
                         1e-4
                         //---c11---
                     ),
+                    c2(
+                        //---c20---
+                        0.9
+                        //---c21---
+                    ),
                     ls_iter(
                         //---ls_iter0---
                         0
@@ -2284,7 +3086,8 @@ namespace Optizelle{
                         //---dscheme0---
                         DiagnosticScheme::Never
                         //---dscheme1---
-                    )
+                    ),
+                    profile()
                 {
                         //---x0---
                         X::copy(x_user,x);
@@ -2423,9 +3226,65 @@ namespace Optizelle{
                         "condition must be positive: eps_trunc = "
                     << state.eps_trunc;
                     
-                    //---algorithm_class_valid0---
+                    //---trunc_reuse_valid0---
                     // Any 
-                    //---algorithm_class_valid1---
+                    //---trunc_reuse_valid1---
+                    
+                    //---trunc_solver_valid0---
+                    // Any 
+                    //---trunc_solver_valid1---
+                    
+                    //---trunc_forcing_valid0---
+                    // Any 
+                    //---trunc_forcing_valid1---
+                    
+                    //---norm_gradold_valid0---
+                    // Any 
+                    //---norm_gradold_valid1---
+                    
+                    //---nonmono_kind_valid0---
+                    // Any 
+                    //---nonmono_kind_valid1---
+
+
+                // Check that the memory for the nonmonotone reference is
+                // positive
+                else if(!(
+                    //---nonmono_mem_valid0---
+                    state.nonmono_mem > 0
+                    //---nonmono_mem_valid1---
+                ))
+                    ss << "The number of prior merit values used by the "
+                        "nonmonotone reference must be positive: nonmono_mem = "
+                        << state.nonmono_mem;
+
+                // Check that the weight for the nonmonotone reference lies
+                // between 0 and 1
+                else if(!(
+                    //---nonmono_eta_valid0---
+                    state.nonmono_eta >= Real(0.) &&
+                    state.nonmono_eta <= Real(1.)
+                    //---nonmono_eta_valid1---
+                ))
+                    ss << "The weight used by the nonmonotone reference must "
+                        "lie between 0 and 1: nonmono_eta = "
+                        << state.nonmono_eta;
+                    
+                    //---merit_ref_valid0---
+                    // Any 
+                    //---merit_ref_valid1---
+                    
+                    //---merit_ref_q_valid0---
+                    // Any 
+                    //---merit_ref_q_valid1---
+                    
+                    //---merit_hist_valid0---
+                    // Any 
+                    //---merit_hist_valid1---
+                    
+                    //---algorithm_class_valid0---
+                    // Any 
+                    //---algorithm_class_valid1---
                     
                     //---PH_type_valid0---
                     // Any 
@@ -2607,6 +3466,17 @@ namespace Optizelle{
                 ))
                     ss << "The sufficient decrease parameter must lie between "
                         "0 and 1: c1 = " << state.c1;
+
+                // When using the strong-Wolfe line-search, check that the
+                // curvature parameter lies between c1 and 1.
+                else if(!(
+                    //---c2_valid0---
+                    state.kind!=LineSearchKind::MoreThuente ||
+                    (state.c2 > state.c1 && state.c2 < Real(1.))
+                    //---c2_valid1---
+                ))
+                    ss << "The curvature parameter must lie between c1 and "
+                        "1: c2 = " << state.c2;
                     
                     //---ls_iter_valid0---
                     // Any 
@@ -2706,6 +3576,7 @@ namespace Optizelle{
                     item.first == "eps_dx" || 
                     item.first == "trunc_err" || 
                     item.first == "eps_trunc" || 
+                    item.first == "norm_gradold" || 
                     item.first == "norm_gradtyp" || 
                     item.first == "norm_dxtyp" || 
                     item.first == "f_x" || 
@@ -2720,7 +3591,12 @@ namespace Optizelle{
                     item.first == "alpha0" || 
                     item.first == "alpha" || 
                     item.first == "c1" || 
-                    item.first == "eps_ls"
+                    item.first == "c2" || 
+                    item.first == "eps_ls" ||
+                    item.first == "nonmono_eta" ||
+                    item.first == "merit_ref" ||
+                    item.first == "merit_ref_q" ||
+                    item.first.substr(0,11)=="merit_hist_"
                 ) 
                     return true;
                 else
@@ -2748,7 +3624,8 @@ namespace Optizelle{
                     item.first == "safeguard_failed_total" ||
                     item.first == "ls_iter" || 
                     item.first == "ls_iter_max" ||
-                    item.first == "ls_iter_total" 
+                    item.first == "ls_iter_total" ||
+                    item.first == "nonmono_mem"
                 ) 
                     return true;
                 else
@@ -2782,7 +3659,15 @@ namespace Optizelle{
                     (item.first=="dscheme" &&
                         DiagnosticScheme::is_valid(item.second)) ||
                     (item.first=="eps_kind" &&
-                        ToleranceKind::is_valid(item.second))
+                        ToleranceKind::is_valid(item.second)) ||
+                    (item.first=="trunc_reuse" &&
+                        KrylovReuse::is_valid(item.second)) ||
+                    (item.first=="trunc_solver" &&
+                        TrustRegionSolver::is_valid(item.second)) ||
+                    (item.first=="trunc_forcing" &&
+                        ForcingTerm::is_valid(item.second)) ||
+                    (item.first=="nonmono_kind" &&
+                        NonmonotoneKind::is_valid(item.second))
                 )
                     return true;
                 else
@@ -2799,6 +3684,7 @@ namespace Optizelle{
                     item.first == "x_old" || 
                     item.first == "grad_old" || 
                     item.first == "dx_old" || 
+                    item.first == "grad_xpdx" || 
                     item.first.substr(0,5)=="oldY_" || 
                     item.first.substr(0,5)=="oldS_" 
                 ) 
@@ -2836,6 +3722,7 @@ namespace Optizelle{
                 xs.emplace_back("x_old",std::move(state.x_old));
                 xs.emplace_back("grad_old",std::move(state.grad_old));
                 xs.emplace_back("dx_old",std::move(state.dx_old));
+                xs.emplace_back("grad_xpdx",std::move(state.grad_xpdx));
                 
                 // Write out the quasi-Newton information with sequential names.
                 // Note, we're padding the numbers with zeros.  Likely, this
@@ -2877,6 +3764,8 @@ namespace Optizelle{
                 reals.emplace_back("trunc_err",
                     std::move(state.trunc_err));
                 reals.emplace_back("eps_trunc",std::move(state.eps_trunc));
+                reals.emplace_back("norm_gradold",
+                    std::move(state.norm_gradold));
                 reals.emplace_back("norm_gradtyp",
                     std::move(state.norm_gradtyp));
                 reals.emplace_back("norm_dxtyp",std::move(state.norm_dxtyp));
@@ -2892,7 +3781,19 @@ namespace Optizelle{
                 reals.emplace_back("alpha0",std::move(state.alpha0));
                 reals.emplace_back("alpha",std::move(state.alpha));
                 reals.emplace_back("c1",std::move(state.c1));
+                reals.emplace_back("c2",std::move(state.c2));
                 reals.emplace_back("eps_ls",std::move(state.eps_ls));
+                reals.emplace_back("nonmono_eta",std::move(state.nonmono_eta));
+                reals.emplace_back("merit_ref",std::move(state.merit_ref));
+                reals.emplace_back("merit_ref_q",std::move(state.merit_ref_q));
+
+                // Write out the prior merit values with sequential names
+                {Natural i=1;
+                for(auto & merit : state.merit_hist) {
+                    std::stringstream ss;
+                    ss << std::setfill('0') << std::setw(6) << i++;
+                    reals.emplace_back("merit_hist_"+ss.str(),std::move(merit));
+                }}
 
                 // Copy in all the natural numbers
                 nats.emplace_back("stored_history",
@@ -2926,6 +3827,8 @@ namespace Optizelle{
                     std::move(state.ls_iter_max));
                 nats.emplace_back("ls_iter_total",
                     std::move(state.ls_iter_total));
+                nats.emplace_back("nonmono_mem",
+                    std::move(state.nonmono_mem));
 
                 // Copy in all the parameters
                 params.emplace_back("algorithm_class",
@@ -2953,6 +3856,14 @@ namespace Optizelle{
                 params.emplace_back("eps_kind",
                     ToleranceKind::to_string(
                         state.eps_kind));
+                params.emplace_back("trunc_reuse",
+                    KrylovReuse::to_string(state.trunc_reuse));
+                params.emplace_back("trunc_solver",
+                    TrustRegionSolver::to_string(state.trunc_solver));
+                params.emplace_back("trunc_forcing",
+                    ForcingTerm::to_string(state.trunc_forcing));
+                params.emplace_back("nonmono_kind",
+                    NonmonotoneKind::to_string(state.nonmono_kind));
             }
 
             // Copy in all variables.  This assumes that the quasi-Newton
@@ -2981,6 +3892,8 @@ namespace Optizelle{
                         state.grad_old = std::move(item->second);
                     else if(item->first=="dx_old")
                         state.dx_old = std::move(item->second);
+                    else if(item->first=="grad_xpdx")
+                        state.grad_xpdx = std::move(item->second);
                     else if(item->first.substr(0,5)=="oldY_")
                         state.oldY.emplace_back(std::move(item->second));
                     else if(item->first.substr(0,5)=="oldS_")
@@ -2996,6 +3909,9 @@ namespace Optizelle{
                 Naturals & nats,
                 Params & params
             ) {
+                // Clear out the prior merit values
+                state.merit_hist.clear();
+
                 // Copy in any reals 
                 for(typename Reals::iterator item = reals.begin();
                     item!=reals.end();
@@ -3009,6 +3925,8 @@ namespace Optizelle{
                         state.trunc_err=std::move(item->second);
                     else if(item->first=="eps_trunc")
                         state.eps_trunc=std::move(item->second);
+                    else if(item->first=="norm_gradold")
+                        state.norm_gradold=std::move(item->second);
                     else if(item->first=="norm_gradtyp")
                         state.norm_gradtyp=std::move(item->second);
                     else if(item->first=="norm_dxtyp")
@@ -3037,8 +3955,18 @@ namespace Optizelle{
                         state.alpha=std::move(item->second);
                     else if(item->first=="c1")
                         state.c1=std::move(item->second);
+                    else if(item->first=="c2")
+                        state.c2=std::move(item->second);
                     else if(item->first=="eps_ls")
                         state.eps_ls=std::move(item->second);
+                    else if(item->first=="nonmono_eta")
+                        state.nonmono_eta=std::move(item->second);
+                    else if(item->first=="merit_ref")
+                        state.merit_ref=std::move(item->second);
+                    else if(item->first=="merit_ref_q")
+                        state.merit_ref_q=std::move(item->second);
+                    else if(item->first.substr(0,11)=="merit_hist_")
+                        state.merit_hist.emplace_back(std::move(item->second));
                 }
             
                 // Next, copy in any naturals
@@ -3080,6 +4008,8 @@ namespace Optizelle{
                         state.ls_iter=std::move(item->second);
                     else if(item->first=="ls_iter_max")
                         state.ls_iter_max=std::move(item->second);
+                    else if(item->first=="nonmono_mem")
+                        state.nonmono_mem=std::move(item->second);
                     else if(item->first=="ls_iter_total")
                         state.ls_iter_total=std::move(item->second);
                 }
@@ -3122,6 +4052,18 @@ namespace Optizelle{
                     else if(item->first=="eps_kind")
                         state.eps_kind
                             = ToleranceKind::from_string(item->second);
+                    else if(item->first=="trunc_reuse")
+                        state.trunc_reuse
+                            = KrylovReuse::from_string(item->second);
+                    else if(item->first=="trunc_solver")
+                        state.trunc_solver
+                            = TrustRegionSolver::from_string(item->second);
+                    else if(item->first=="trunc_forcing")
+                        state.trunc_forcing
+                            = ForcingTerm::from_string(item->second);
+                    else if(item->first=="nonmono_kind")
+                        state.nonmono_kind
+                            = NonmonotoneKind::from_string(item->second);
                 }
             }
             
@@ -3168,6 +4110,76 @@ namespace Optizelle{
                 // Check that we have a valid state 
                 State::check(state);
             }
+
+            // Pieces of a solved state that we carry over to the next problem
+            // in a sequence of related problems
+            struct Warm {
+                // Pieces of the state that we carry over.  See WarmStart.
+                Natural items;
+
+                // The pieces themselves
+                X_Vectors xs;
+                Reals reals;
+
+                // Start with nothing
+                Warm() : items(0), xs(), reals() {}
+            };
+
+            // Copies the pieces of the state that items selects into warm
+            static void warmRelease(
+                Natural const & items,
+                typename State::t & state,
+                Warm & warm
+            ) {
+                // Release the state
+                X_Vectors xs;
+                Reals reals;
+                Naturals nats;
+                Params params;
+                Unconstrained <Real,XX>
+                    ::Restart::release(state,xs,reals,nats,params);
+
+                // Copy out the pieces that we carry over
+                auto select = [&](std::string const & name) {
+                    return WarmStart::is_selected(items,name);
+                };
+                warm.items = items;
+                warm.xs.clear();
+                warm.reals.clear();
+                Utility::copyVectors <X> (select,xs,warm.xs);
+                Utility::copyScalars <Real> (select,reals,warm.reals);
+
+                // Put the state back together
+                Unconstrained <Real,XX>
+                    ::Restart::capture(state,xs,reals,nats,params);
+            }
+
+            // Replaces the pieces of the state with those in warm
+            static void warmCapture(
+                Warm const & warm,
+                typename State::t & state
+            ) {
+                // Release the state
+                X_Vectors xs;
+                Reals reals;
+                Naturals nats;
+                Params params;
+                Unconstrained <Real,XX>
+                    ::Restart::release(state,xs,reals,nats,params);
+
+                // Swap in the pieces that we carry over
+                auto select = [&](std::string const & name) {
+                    return WarmStart::is_selected(warm.items,name);
+                };
+                Utility::removeItems <X_Vector> (select,xs);
+                Utility::removeItems <Real> (select,reals);
+                Utility::copyVectors <X> (select,warm.xs,xs);
+                Utility::copyScalars <Real> (select,warm.reals,reals);
+
+                // Put the state back together
+                Unconstrained <Real,XX>
+                    ::Restart::capture(state,xs,reals,nats,params);
+            }
         };
 
         // All the functions required by an optimization algorithm.  Note, this
@@ -3843,6 +4855,10 @@ namespace Optizelle{
                 // objective).
                 check(fns);
 
+                // Time the objective and the preconditioner
+                Profile::instrument(fns.f);
+                Profile::instrument(fns.PH);
+
                 // Modify the objective function if necessary
                 fns.f.reset(new HessianAdjustedFunction(state,fns));
 
@@ -3887,6 +4903,7 @@ namespace Optizelle{
                 AlgorithmClass::t const & algorithm_class=state.algorithm_class;
                 LineSearchDirection::t const & dir=state.dir;
                 Natural const & msg_level = state.msg_level;
+                auto const & trunc_forcing = state.trunc_forcing;
 
                 // Basic information
                 out.emplace_back(Utility::atos("iter"));
@@ -3905,6 +4922,10 @@ namespace Optizelle{
                         out.emplace_back(Utility::atos("trunc_iter"));
                         out.emplace_back(Utility::atos("trunc_err"));
                         out.emplace_back(Utility::atos("trunc_stop"));
+
+                        // In case we adapt the truncated-CG tolerance
+                        if(ForcingTerm::is_adaptive(trunc_forcing))
+                            out.emplace_back(Utility::atos("eps_trunc"));
                     }
 
                     // In case we're using a line-search method
@@ -3943,6 +4964,8 @@ namespace Optizelle{
             ) {
                 Unconstrained <Real,XX>::Diagnostics::getStateHeader_(
                     state,out);
+                Unconstrained <Real,XX>::Diagnostics::getProfileHeader_(
+                    state,out);
             }
 
             // Gets the state information for output
@@ -3977,6 +5000,8 @@ namespace Optizelle{
                 AlgorithmClass::t const & algorithm_class=state.algorithm_class;
                 LineSearchDirection::t const & dir=state.dir;
                 Natural const & msg_level=state.msg_level;
+                auto const & trunc_forcing = state.trunc_forcing;
+                auto const & eps_trunc = state.eps_trunc;
 
                 // Figure out if we're at the absolute beginning of the
                 // optimization.
@@ -4020,6 +5045,14 @@ namespace Optizelle{
                         } else 
                             for(Natural i=0;i<3;i++)
                                 out.emplace_back(Utility::blankSeparator);
+
+                        // In case we adapt the truncated-CG tolerance
+                        if(ForcingTerm::is_adaptive(trunc_forcing)) {
+                            if(!opt_begin)
+                                out.emplace_back(Utility::atos(eps_trunc));
+                            else
+                                out.emplace_back(Utility::blankSeparator);
+                        }
                     }
 
                     // In case we're using a line-search method
@@ -4085,7 +5118,77 @@ namespace Optizelle{
             ) {
                 Unconstrained <Real,XX>::Diagnostics
                     ::getState_(fns,state,blank,noiter,out);
+                Unconstrained <Real,XX>::Diagnostics
+                    ::getProfile_(state,blank,out);
+            }
+
+            // Gets the header for the time spent in the model, the solver,
+            // and, with more detail, each phase.  We only have these when we
+            // compile with OPTIZELLE_PROFILE.
+        #ifdef OPTIZELLE_PROFILE
+            static void getProfileHeader_(
+                typename State::t const & state,
+                std::list <std::string> & out
+            ) {
+                // Create some shortcuts
+                Natural const & msg_level=state.msg_level;
+
+                // Basic information
+                out.emplace_back(Utility::atos("t_model"));
+                out.emplace_back(Utility::atos("t_solver"));
+
+                // More detailed information
+                if(msg_level >= 3)
+                    for(Natural i=0;i<Profile::Size;i++)
+                        out.emplace_back(Utility::atos(Profile::t(i)));
+            }
+        #else
+            static void getProfileHeader_(
+                typename State::t const &,
+                std::list <std::string> &
+            ) {}
+        #endif
+
+            // Gets the time spent in the model, the solver, and each phase
+        #ifdef OPTIZELLE_PROFILE
+            static void getProfile_(
+                typename State::t const & state,
+                bool const & blank,
+                std::list <std::string> & out
+            ) {
+                // Create some shortcuts
+                auto const & profile=state.profile;
+                Natural const & msg_level=state.msg_level;
+
+                // Get a iterator to the last element prior to inserting
+                // elements
+                std::list <std::string>::iterator prior=out.end(); prior--;
+
+                // Basic information
+                out.emplace_back(Utility::atos(profile.model()));
+                out.emplace_back(Utility::atos(profile.solver()));
+
+                // More detailed information
+                if(msg_level >= 3)
+                    for(Natural i=0;i<Profile::Size;i++)
+                        out.emplace_back(Utility::atos(profile.seconds[i]));
+
+                // If we needed to do blank insertions, overwrite the elements
+                // with spaces 
+                if(blank)
+                    for(std::list <std::string>::iterator x=++prior;
+                        x!=out.end();
+                        x++
+                    )
+                        (*x)=Utility::blankSeparator;
             }
+        #else
+            static void getProfile_(
+                typename State::t const &,
+                bool const &,
+                std::list <std::string> &
+            ) {}
+        #endif
 
             // Runs the specified function diagnostics 
             static void checkFunctions_(
@@ -4339,6 +5442,11 @@ namespace Optizelle{
                 ared = merit_x - merit_xpdx;
                 pred = merit_x - model_dx;
 
+                // Determine the reduction relative to the nonmonotone
+                // reference.  In the monotone case, this is just ared.
+                auto ared_ref = nonmonotone_reference(state,merit_x)
+                    - merit_xpdx;
+
                 // Add a safety check in case we don't actually minimize the TR
                 // subproblem correctly. This could happen for a variety of
                 // reasons.  Most notably, if we do not correctly calculate the
@@ -4364,12 +5472,183 @@ namespace Optizelle{
                     return true;
                 } else if(ared >= eta1*pred && ared < eta2*pred)
                     return true;
+
+                // Accept steps that only decrease the merit function relative
+                // to the nonmonotone reference, but leave the radius alone
+                else if(ared_ref >= eta1*pred)
+                    return true;
                 else {
                     delta = norm_dx/Real(2.);
                     return false;
                 }
             }
+
+            // Returns the reference value of the merit function used when
+            // accepting a step.  In the monotone case, this is just the
+            // merit function at the current iterate.
+            static Real nonmonotone_reference(
+                typename State::t const & state,
+                Real const & merit_x
+            ) {
+                return state.nonmono_kind==NonmonotoneKind::Monotone ||
+                    !(state.merit_ref > merit_x) ? merit_x : state.merit_ref;
+            }
+
+            // Updates the reference value of the merit function used by the
+            // nonmonotone acceptance tests.  For the max window, we take the
+            // largest of the last nonmono_mem merit values from Grippo,
+            // Lampariello, and Lucidi.  For the weighted average, we use the
+            // recurrence from Zhang and Hager
+            //
+            // q_{k+1} = eta q_k + 1
+            // c_{k+1} = (eta q_k c_k + merit(x_{k+1})) / q_{k+1}
+            //
+            // where c_k denotes the reference and eta denotes nonmono_eta.
+            static void updateNonmonotone(
+                typename Functions::t const & fns,
+                typename State::t & state
+            ){
+                // Create some shortcuts
+                auto const & f_mod = *(fns.f_mod);
+                auto const & x = state.x;
+                auto const & f_x = state.f_x;
+                auto const & nonmono_kind = state.nonmono_kind;
+                auto const & nonmono_mem = state.nonmono_mem;
+                auto const & nonmono_eta = state.nonmono_eta;
+                auto & merit_ref = state.merit_ref;
+                auto & merit_ref_q = state.merit_ref_q;
+                auto & merit_hist = state.merit_hist;
+
+                // Determine merit(x)
+                auto merit_x = f_mod.merit(x,f_x);
+
+                switch(nonmono_kind){
+                case NonmonotoneKind::Monotone:
+                    merit_hist.clear();
+                    merit_ref = merit_x;
+                    break;
+
+                case NonmonotoneKind::MaxWindow:
+                    merit_hist.emplace_back(merit_x);
+                    while(merit_hist.size() > nonmono_mem)
+                        merit_hist.pop_front();
+                    merit_ref = *std::max_element(
+                        merit_hist.begin(),merit_hist.end());
+                    break;
+
+                case NonmonotoneKind::WeightedAverage:
+                    if(merit_ref != merit_ref || merit_ref_q != merit_ref_q) {
+                        merit_ref = merit_x;
+                        merit_ref_q = Real(1.);
+                    } else {
+                        auto q = nonmono_eta*merit_ref_q + Real(1.);
+                        merit_ref = (nonmono_eta*merit_ref_q*merit_ref
+                            + merit_x) / q;
+                        merit_ref_q = q;
+                    }
+                    break;
+                }
+            }
+
+            // Forgets the merit values used by the nonmonotone acceptance
+            // tests.  We need this whenever the merit function itself
+            // changes, such as when an interior point method changes mu,
+            // since the old values are no longer comparable to the new ones.
+            static void resetNonmonotone(typename State::t & state) {
+                state.merit_hist.clear();
+                state.merit_ref = std::numeric_limits <Real>::quiet_NaN();
+                state.merit_ref_q = std::numeric_limits <Real>::quiet_NaN();
+            }
         
+            // Returns the tolerance for the Nash-Sofer model-decrease test in
+            // truncated CG.  We use the value 1/2 from Nash and Sofer.
+            static Real nash_sofer_tolerance(
+                ForcingTerm::t const & trunc_forcing
+            ) {
+                return trunc_forcing==ForcingTerm::NashSofer ?
+                    Real(0.5) : Real(0.);
+            }
+
+            // Updates the stopping tolerance for truncated CG using the
+            // Eisenstat-Walker forcing terms.  Let g_k denote the gradient
+            // at the current iterate and r_{k-1} = g_{k-1} + H_{k-1} dx_{k-1}
+            // the residual of the prior Newton system.  Then, we choose
+            //
+            // choice 1: eta = | ||g_k|| - ||r_{k-1}|| | / ||g_{k-1}||
+            // choice 2: eta = 0.9 (||g_k|| / ||g_{k-1}||)^2
+            //
+            // safeguarded so that eta does not decrease too quickly.  We
+            // obtain ||r_{k-1}|| from the relative error reported by truncated
+            // CG, which is exact when the preconditioner is the identity.
+            // Finally, we don't need to solve the Newton system more
+            // accurately than our gradient stopping tolerance, so we bound
+            // eta below by this amount.  We also bound eta above by 1/2 since
+            // the gradient need not decrease monotonically in optimization
+            // and larger tolerances lead to poor steps.
+            static void updateForcingTerm(
+                typename Functions::t const & fns,
+                typename State::t & state
+            ) {
+                // Create some shortcuts
+                ScalarValuedFunctionModifications <Real,XX> const & f_mod
+                    = *(fns.f_mod);
+                auto const & absrel = *(fns.absrel);
+                X_Vector const & x=state.x;
+                X_Vector const & grad=state.grad;
+                auto const & trunc_forcing = state.trunc_forcing;
+                auto const & trunc_err = state.trunc_err;
+                auto const & iter = state.iter;
+                auto const & eps_grad = state.eps_grad;
+                auto const & norm_gradtyp = state.norm_gradtyp;
+                auto & eps_trunc = state.eps_trunc;
+                auto & norm_gradold = state.norm_gradold;
+
+                // Only update the tolerance when requested
+                if(!ForcingTerm::is_adaptive(trunc_forcing))
+                    return;
+
+                // Find the norm of the current gradient.  We cache this for
+                // the next iteration since the gradient step depends on the
+                // iterate where we take it.
+                auto grad_step = X::init(x);
+                f_mod.grad_step(x,grad,grad_step);
+                auto const norm_grad = std::sqrt(X::innr(grad_step,grad_step));
+                auto const norm_gradprior = norm_gradold;
+                norm_gradold = norm_grad;
+
+                // We need a prior gradient, so wait until we've taken a step
+                if(iter==1 || norm_gradprior != norm_gradprior)
+                    return;
+
+                // Find the new forcing term along with its safeguard
+                auto eta = std::numeric_limits <Real>::quiet_NaN();
+                auto eta_safe = Real(0.);
+                if(trunc_forcing==ForcingTerm::EisenstatWalker1) {
+                    auto const norm_r = trunc_err * norm_gradprior;
+                    eta = std::fabs(norm_grad - norm_r) / norm_gradprior;
+                    eta_safe = std::pow(eps_trunc,
+                        Real(0.5)*(Real(1.)+std::sqrt(Real(5.))));
+                } else {
+                    eta = Real(0.9) * sq(norm_grad / norm_gradprior);
+                    eta_safe = Real(0.9) * sq(eps_trunc);
+                }
+                if(eta_safe > Real(0.1))
+                    eta = std::max(eta,eta_safe);
+
+                // Bound the forcing term
+                auto grad_stop = X::init(x);
+                f_mod.grad_stop(x,grad,grad_stop);
+                auto const norm_gradstop
+                    = std::sqrt(X::innr(grad_stop,grad_stop));
+                eta = std::max(eta,
+                    Real(0.5)*eps_grad*absrel(norm_gradtyp)/norm_gradstop);
+                eta = std::min(eta,Real(0.5));
+
+                // Only accept a valid tolerance
+                if(eta > Real(0.))
+                    eps_trunc = eta;
+            }
+
             // Finds the trust-region step
             static void getStepTR(
                 StateManipulator <Unconstrained <Real,XX> > const & smanip,
@@ -4397,6 +5676,11 @@ namespace Optizelle{
                 Real const & norm_dxtyp=state.norm_dxtyp;
                 auto const & safeguard_failed_max = state.safeguard_failed_max;
                 auto const & glob_iter_max = state.glob_iter_max;
+                auto const & trunc_reuse = state.trunc_reuse;
+                auto const & trunc_solver = state.trunc_solver;
+                auto const & trunc_forcing = state.trunc_forcing;
+                auto const & iter = state.iter;
+                X_Vector const & dx_old=state.dx_old;
                 X_Vector & dx=state.dx;
                 Natural & trunc_iter=state.trunc_iter;
                 Natural & trunc_iter_total=state.trunc_iter_total;
@@ -4432,6 +5716,17 @@ namespace Optizelle{
                 // Create the Hessian operator
                 HessianOperator H(fns,x);
 
+                // When we reuse the Krylov subspace, record every
+                // Hessian-vector product that we compute during this step.
+                // We need one more than the maximum number of truncated-CG
+                // iterations since a warm start costs an additional product.
+                // GLTR always retains its subspace, so we record it then as well.
+                auto const reuse_subspace = trunc_reuse!=KrylovReuse::NoReuse
+                    || trunc_solver==TrustRegionSolver::GLTR;
+                RecordedOperator <Real,XX> H_rec(
+                    H,
+                    reuse_subspace ? trunc_iter_max+1 : 0);
+
                 // Manipulate the state if required
                 smanip.eval(fns,state,OptimizationLocation::BeforeGetStep);
 
@@ -4450,38 +5745,124 @@ namespace Optizelle{
                         std::placeholders::_2,
                         Real(1.)));
 
+                // Allocate memory for a zero step, which we use to check the
+                // safeguard
+                auto zero = X::init(x);
+                X::zero(zero);
+
+                // Set the right hand side for truncated CG
+                auto rhs = X::init(x);
+                X::copy(minus_grad,rhs);
+
+                // Set the relative stopping tolerance for truncated CG
+                auto eps_trunc_ = eps_trunc;
+
+                // Set the tolerance for the Nash-Sofer model-decrease test
+                auto const eps_model = nash_sofer_tolerance(trunc_forcing);
+
+                // Norm of the preconditioned residual at zero.  When we
+                // warm-start, we measure the truncated-CG error relative to
+                // this quantity and not the residual at the warm start.
+                auto norm_PH_rhs0 = std::numeric_limits <Real>::quiet_NaN();
+
+                // When requested, warm-start truncated CG with the prior step,
+                // dx0.  Since truncated CG always starts from zero, we solve
+                // for a correction, e, to this step.  Namely, we solve 
+                //
+                // H e = -grad - H dx0
+                //
+                // subject to || e + dx0 || <= delta where dx0 acts as the
+                // offset.  We only do this when the prior step lies strictly
+                // inside the trust-region, satisfies the safeguard, and
+                // reduces the model, 0.5 <H dx0,dx0> + <grad,dx0> < 0.
+                // Otherwise, we start from zero as normal.
+                auto const norm_dxold = std::sqrt(X::innr(dx_old,dx_old));
+                if( trunc_reuse==KrylovReuse::SubspaceWarmStart &&
+                    trunc_solver==TrustRegionSolver::TruncatedCG &&
+                    iter > 1 &&
+                    norm_dxold > Real(0.) &&
+                    norm_dxold < delta &&
+                    simplified_safeguard(zero,dx_old) >= Real(1.)
+                ) {
+                    auto H_dxold = X::init(x);
+                    H_rec.eval(dx_old,H_dxold);
+                    auto model_dxold = Real(0.5)*X::innr(H_dxold,dx_old)
+                        - X::innr(minus_grad,dx_old);
+                    if(model_dxold < Real(0.)) {
+                        auto PH_rhs = X::init(x);
+                        PH.eval(rhs,PH_rhs);
+                        norm_PH_rhs0 = std::sqrt(X::innr(PH_rhs,PH_rhs));
+
+                        X::copy(dx_old,x_tmp1);
+                        X::axpy(Real(-1.),H_dxold,rhs);
+
+                        // Adjust the tolerance so that we stop relative to
+                        // the residual at zero and not the warm start
+                        PH.eval(rhs,PH_rhs);
+                        auto norm_PH_rhs = std::sqrt(X::innr(PH_rhs,PH_rhs));
+                        if(norm_PH_rhs > Real(0.))
+                            eps_trunc_ = std::min(
+                                eps_trunc*norm_PH_rhs0/norm_PH_rhs,Real(1.));
+                    }
+                }
+
                 // Find the trial step 
-                truncated_cg(
-                    H,
-                    minus_grad,
-                    PH,
-                    eps_trunc,
-                    trunc_iter_max,
-                    trunc_orthog_storage_max,
-                    trunc_orthog_iter_max,
-                    delta,
-                    x_tmp1,
-                    safeguard_failed_max,
-                    simplified_safeguard,
-                    false,
-                    true,
-                    true,
-                    dx_n,
-                    dx_cp,
-                    residual_err0,
-                    residual_err,
-                    trunc_iter,
-                    trunc_stop,
-                    safeguard_failed,
-                    alpha_x);
+                if(trunc_solver==TrustRegionSolver::GLTR) {
+                    gltr(
+                        H_rec,
+                        rhs,
+                        PH,
+                        eps_trunc_,
+                        trunc_iter_max,
+                        delta,
+                        simplified_safeguard,
+                        dx_n,
+                        dx_cp,
+                        residual_err0,
+                        residual_err,
+                        trunc_iter,
+                        trunc_stop,
+                        alpha_x);
+                    safeguard_failed = alpha_x < Real(1.) ? 1 : 0;
+                } else
+                    truncated_cg(
+                        H_rec,
+                        rhs,
+                        PH,
+                        eps_trunc_,
+                        eps_model,
+                        trunc_iter_max,
+                        trunc_orthog_storage_max,
+                        trunc_orthog_iter_max,
+                        delta,
+                        x_tmp1,
+                        safeguard_failed_max,
+                        simplified_safeguard,
+                        false,
+                        true,
+                        true,
+                        dx_n,
+                        dx_cp,
+                        residual_err0,
+                        residual_err,
+                        trunc_iter,
+                        trunc_stop,
+                        safeguard_failed,
+                        alpha_x);
 
                 // Calculate the truncated CG error
-                trunc_err = residual_err / residual_err0;
+                trunc_err = residual_err / (norm_PH_rhs0==norm_PH_rhs0 ?
+                    norm_PH_rhs0 : residual_err0);
                 trunc_iter_total += trunc_iter;
 
                 // Keep track of the number of failed safeguard steps
                 safeguard_failed_total+=safeguard_failed;
 
+                // If we warm-started, add the prior step back into both the
+                // Newton and Cauchy points
+                X::axpy(Real(1.),x_tmp1,dx_n);
+                X::axpy(Real(1.),x_tmp1,dx_cp);
+
                 // Find the Newton shift, dx_dnewton = dx_newton-dx_cp.  We
                 // use this in the dogleg computation if required.
                 auto dx_dnewton = X::init(x);
@@ -4527,19 +5908,38 @@ namespace Optizelle{
                     //
                     // Note, this only works when both dx_n and dx_cp are both
                     // feasible with respect to the safeguard.
-                    if(norm_dxcp >= delta) {
-                        X::copy(dx_cp,dx);
-                        X::scal(delta/norm_dxcp,dx);
-                    } else if(norm_dxn <= delta) {
-                        X::copy(dx_n,dx);
-                    } else {
-                        auto aa = X::innr(dx_dnewton,dx_dnewton);
-                        auto bb = Real(2.) * X::innr(dx_dnewton,dx_cp);
-                        auto cc = norm_dxcp*norm_dxcp - delta*delta;
-                        auto roots = quad_equation(aa,bb,cc);
-                        auto theta = roots[0] > roots[1] ? roots[0] : roots[1];
-                        X::copy(dx_cp,dx);
-                        X::axpy(theta,dx_dnewton,dx);
+                    //
+                    // That said, after a rejected step, when we've retained
+                    // the Krylov subspace from truncated CG or GLTR, we instead
+                    // resolve the trust-region subproblem for the new radius
+                    // within this subspace.  This requires no new
+                    // Hessian-vector products and the subspace contains both
+                    // dx_cp and dx_n, so it does at least as well as the
+                    // dogleg on the model.  If the result isn't safe, we
+                    // fall back to the dogleg.
+                    auto resolved = false;
+                    if(glob_iter > 1 && reuse_subspace) {
+                        trust_region_subspace <Real,XX> (
+                            H_rec.vs,H_rec.Avs,minus_grad,delta,dx);
+                        auto norm_dx = std::sqrt(X::innr(dx,dx));
+                        resolved = norm_dx==norm_dx &&
+                            simplified_safeguard(zero,dx) >= Real(1.);
+                    }
+                    if(!resolved) {
+                        if(norm_dxcp >= delta) {
+                            X::copy(dx_cp,dx);
+                            X::scal(delta/norm_dxcp,dx);
+                        } else if(norm_dxn <= delta) {
+                            X::copy(dx_n,dx);
+                        } else {
+                            auto aa = X::innr(dx_dnewton,dx_dnewton);
+                            auto bb = Real(2.) * X::innr(dx_dnewton,dx_cp);
+                            auto cc = norm_dxcp*norm_dxcp - delta*delta;
+                            auto roots = quad_equation(aa,bb,cc);
+                            auto theta = roots[0]>roots[1] ? roots[0]:roots[1];
+                            X::copy(dx_cp,dx);
+                            X::axpy(theta,dx_dnewton,dx);
+                        }
                     }
 
                     // Manipulate the state if required
@@ -4794,6 +6194,9 @@ namespace Optizelle{
                 typename Functions::t const & fns,
                 typename State::t & state
             ) {
+                // Charge the search to the line-search phase
+                Profile::Timer timer(Profile::LineSearch);
+
                 // Create some shortcuts
                 ScalarValuedFunction <Real,XX> const & f=*(fns.f);
                 ScalarValuedFunctionModifications <Real,XX> const &
@@ -4906,6 +6309,9 @@ namespace Optizelle{
                 typename Functions::t const & fns,
                 typename State::t & state
             ) {
+                // Charge the search to the line-search phase
+                Profile::Timer timer(Profile::LineSearch);
+
                 // Create some shortcuts
                 ScalarValuedFunction <Real,XX> const & f=*(fns.f);
                 X_Vector const & x=state.x;
@@ -4938,6 +6344,9 @@ namespace Optizelle{
                 typename Functions::t const & fns,
                 typename State::t & state
             ) {
+                // Charge the search to the line-search phase
+                Profile::Timer timer(Profile::LineSearch);
+
                 // Create some shortcuts
                 ScalarValuedFunction <Real,XX> const & f=*(fns.f);
                 ScalarValuedFunctionModifications <Real,XX> const & f_mod
@@ -4988,21 +6397,379 @@ namespace Optizelle{
                 iter=1; iter_total++;
             }
             
-            // Finds a trial step using a line-search for globalization
-            static void getStepLS(
-                StateManipulator <Unconstrained <Real,XX> > const & smanip,
-                typename Functions::t const & fns,
-                typename State::t & state
-            ){
-                // Create some shortcuts
-                ScalarValuedFunction <Real,XX> const & f=*(fns.f);
-                ScalarValuedFunctionModifications <Real,XX> const & f_mod
-                    = *(fns.f_mod);
-                auto const & gradmod = *(fns.gradmod);
-                auto const & absrel = *(fns.absrel);
-                Operator <Real,XX,XX> const & PH=*(fns.PH);
-                auto const & safeguard = *(fns.safeguard); 
-                X_Vector const & x=state.x;
+            // Safeguarded cubic and quadratic step from More and Thuente,
+            // "Line search algorithms with guaranteed sufficient decrease."
+            // Here, (stx,fx,dx) denotes the best step found so far, (sty,fy,dy)
+            // the other endpoint of the interval of uncertainty, and
+            // (stp,fp,dp) the current step.  We update the interval and
+            // return the new trial step in stp.
+            static void moreThuenteStep(
+                Real & stx,Real & fx,Real & dx,
+                Real & sty,Real & fy,Real & dy,
+                Real & stp,Real const & fp,Real const & dp,
+                bool & brackt,
+                Real const & stpmin,
+                Real const & stpmax
+            ) {
+                // Determine whether the derivatives have opposite sign
+                auto sgnd = dp*(dx/std::fabs(dx));
+
+                // Find the new trial step
+                auto stpf = Real(0.);
+
+                // A higher function value.  The minimum is bracketed.  If the
+                // cubic step is closer to stx than the quadratic step, take the
+                // cubic step.  Otherwise, average the two.
+                if(fp > fx) {
+                    auto theta = Real(3.)*(fx-fp)/(stp-stx)+dx+dp;
+                    auto s = std::max(std::max(std::fabs(theta),std::fabs(dx)),
+                        std::fabs(dp));
+                    auto gamma = s*std::sqrt((theta/s)*(theta/s)-(dx/s)*(dp/s));
+                    if(stp < stx) gamma = -gamma;
+                    auto p = (gamma-dx)+theta;
+                    auto q = ((gamma-dx)+gamma)+dp;
+                    auto stpc = stx+p/q*(stp-stx);
+                    auto stpq = stx+((dx/((fx-fp)/(stp-stx)+dx))/Real(2.))
+                        *(stp-stx);
+                    stpf = std::fabs(stpc-stx) < std::fabs(stpq-stx) ?
+                        stpc : stpc+(stpq-stpc)/Real(2.);
+                    brackt = true;
+
+                // A lower function value and derivatives of opposite sign.  The
+                // minimum is bracketed.  Take whichever of the cubic and secant
+                // steps lies farther from stp.
+                } else if(sgnd < Real(0.)) {
+                    auto theta = Real(3.)*(fx-fp)/(stp-stx)+dx+dp;
+                    auto s = std::max(std::max(std::fabs(theta),std::fabs(dx)),
+                        std::fabs(dp));
+                    auto gamma = s*std::sqrt((theta/s)*(theta/s)-(dx/s)*(dp/s));
+                    if(stp > stx) gamma = -gamma;
+                    auto p = (gamma-dp)+theta;
+                    auto q = ((gamma-dp)+gamma)+dx;
+                    auto stpc = stp+p/q*(stx-stp);
+                    auto stpq = stp+(dp/(dp-dx))*(stx-stp);
+                    stpf = std::fabs(stpc-stp) > std::fabs(stpq-stp) ?
+                        stpc : stpq;
+                    brackt = true;
+
+                // A lower function value, derivatives of the same sign, and
+                // the magnitude of the derivative decreases.  The cubic may
+                // not have a minimizer in the direction of the step, so we
+                // fall back to the secant step and the bounds.
+                } else if(std::fabs(dp) < std::fabs(dx)) {
+                    auto theta = Real(3.)*(fx-fp)/(stp-stx)+dx+dp;
+                    auto s = std::max(std::max(std::fabs(theta),std::fabs(dx)),
+                        std::fabs(dp));
+                    auto gamma = s*std::sqrt(std::max(Real(0.),
+                        (theta/s)*(theta/s)-(dx/s)*(dp/s)));
+                    if(stp > stx) gamma = -gamma;
+                    auto p = (gamma-dp)+theta;
+                    auto q = (gamma+(dx-dp))+gamma;
+                    auto r = p/q;
+                    auto stpc = r < Real(0.) && gamma != Real(0.) ?
+                        stp+r*(stx-stp) : (stp > stx ? stpmax : stpmin);
+                    auto stpq = stp+(dp/(dp-dx))*(stx-stp);
+                    if(brackt) {
+                        stpf = std::fabs(stpc-stp) < std::fabs(stpq-stp) ?
+                            stpc : stpq;
+                        stpf = stp > stx ?
+                            std::min(stp+Real(0.66)*(sty-stp),stpf) :
+                            std::max(stp+Real(0.66)*(sty-stp),stpf);
+                    } else {
+                        stpf = std::fabs(stpc-stp) > std::fabs(stpq-stp) ?
+                            stpc : stpq;
+                        stpf = std::max(stpmin,std::min(stpmax,stpf));
+                    }
+
+                // A lower function value, derivatives of the same sign, and
+                // the magnitude of the derivative does not decrease.  If the
+                // minimum is bracketed, take the cubic step through sty.
+                // Otherwise, move to the appropriate bound.
+                } else {
+                    if(brackt) {
+                        auto theta = Real(3.)*(fp-fy)/(sty-stp)+dy+dp;
+                        auto s = std::max(std::max(std::fabs(theta),
+                            std::fabs(dy)),std::fabs(dp));
+                        auto gamma = s*std::sqrt(
+                            (theta/s)*(theta/s)-(dy/s)*(dp/s));
+                        if(stp > sty) gamma = -gamma;
+                        auto p = (gamma-dp)+theta;
+                        auto q = ((gamma-dp)+gamma)+dy;
+                        stpf = stp+p/q*(sty-stp);
+                    } else
+                        stpf = stp > stx ? stpmax : stpmin;
+                }
+
+                // Update the interval which contains a minimizer
+                if(fp > fx) {
+                    sty = stp;
+                    fy = fp;
+                    dy = dp;
+                } else {
+                    if(sgnd < Real(0.)) {
+                        sty = stx;
+                        fy = fx;
+                        dy = dx;
+                    }
+                    stx = stp;
+                    fx = fp;
+                    dx = dp;
+                }
+
+                // Save the new step
+                stp = stpf;
+            }
+
+            // Find the line search parameter with the algorithm of More and
+            // Thuente, which uses the derivative of the merit function at the
+            // trial points in order to satisfy the strong Wolfe conditions.
+            static void moreThuente(
+                typename Functions::t const & fns,
+                typename State::t & state
+            ) {
+                // Charge the search to the line-search phase
+                Profile::Timer timer(Profile::LineSearch);
+
+                // Create some shortcuts
+                ScalarValuedFunction <Real,XX> const & f=*(fns.f);
+                ScalarValuedFunctionModifications <Real,XX> const & f_mod
+                    = *(fns.f_mod);
+                auto const & safeguard = *(fns.safeguard); 
+                X_Vector const & x=state.x;
+                X_Vector const & grad=state.grad;
+                X_Vector const & dx=state.dx;
+                Real const & alpha0=state.alpha0;
+                Real const & alpha_x=state.alpha_x;
+                Real const & c1=state.c1;
+                Real const & c2=state.c2;
+                Real const & eps_ls=state.eps_ls;
+                Natural const & iter_max=state.ls_iter_max;
+                Natural & iter_total=state.ls_iter_total;
+                Natural & iter=state.ls_iter;
+                Real const & f_x=state.f_x;
+                Real & f_xpdx=state.f_xpdx;
+                X_Vector & grad_xpdx=state.grad_xpdx;
+                Real & alpha=state.alpha;
+
+                // Amount we extrapolate the step when the minimum is not yet
+                // bracketed 
+                auto const xtrapl = Real(1.1);
+                auto const xtrapu = Real(4.);
+
+                // Allocate memory for x+alpha dx and the gradients there.  We
+                // leave the gradient at the step we return in grad_xpdx, so
+                // that the main loop doesn't have to evaluate it again.
+                X_Vector x_p_adx(X::init(x));
+                X_Vector grad_stx(X::init(x));
+                X_Vector grad_step(X::init(x));
+                
+                // Determine the merit function and its derivative at x
+                auto finit = f_mod.merit(x,f_x);
+                f_mod.grad_step(x,grad,grad_step);
+                auto ginit = X::innr(grad_step,dx);
+                auto gtest = c1*ginit;
+
+                // Evaluates the objective, merit, and the derivative of the
+                // merit along dx at x+alpha dx
+                auto phi = [&](Real const & alpha_) {
+                    X::copy(x,x_p_adx);
+                    X::axpy(alpha_,dx,x_p_adx);
+                    auto f_alpha = f.eval(x_p_adx);
+                    f.grad(x_p_adx,grad_xpdx);
+                    f_mod.grad_step(x_p_adx,grad_xpdx,grad_step);
+                    return std::make_tuple(
+                        f_alpha,
+                        f_mod.merit(x_p_adx,f_alpha),
+                        X::innr(grad_step,dx));
+                };
+
+                // Set alpha to the base alpha
+                alpha=alpha0;
+
+                // If we don't have a descent direction, there's nothing for
+                // the derivative information to tell us.  Simply evaluate the
+                // objective at the base step and let the sufficient decrease
+                // check sort it out.
+                if(!(ginit < Real(0.))) {
+                    X::copy(x,x_p_adx);
+                    X::axpy(alpha,dx,x_p_adx);
+                    f_xpdx=f.eval(x_p_adx);
+                    f.grad(x_p_adx,grad_xpdx);
+                    iter=1;
+                    iter_total+=iter;
+                    return;
+                }
+
+                // The base step has already been checked against the
+                // safeguard, so only steps beyond it need to be checked again.
+                // When the safeguard truncated the base step, it's also the
+                // largest step we allow.
+                auto alpha_safe = alpha0;
+                auto stpmin = Real(0.);
+                auto stpmax = alpha_x < Real(1.) ?
+                    alpha0 : std::numeric_limits <Real>::infinity();
+                auto zero = X::init(x);
+                X::zero(zero);
+                auto alpha_dx = X::init(x);
+
+                // Initialize the interval of uncertainty.  We track the best
+                // step as well as the objective value there.
+                auto brackt = false;
+                auto stage1 = true;
+                auto width = stpmax-stpmin;
+                auto width1 = Real(2.)*width;
+                auto stx = Real(0.);
+                auto fx = finit;
+                auto gx = ginit;
+                auto f_stx = std::numeric_limits <Real>::quiet_NaN();
+                auto sty = Real(0.);
+                auto fy = finit;
+                auto gy = ginit;
+                auto stmin = Real(0.);
+                auto stmax = alpha+xtrapu*alpha;
+
+                // Keep track of the objective at the current trial
+                auto f_stp = std::numeric_limits <Real>::quiet_NaN();
+
+                for(iter=1;iter<=iter_max;iter++) {
+                    // Make sure that we don't extrapolate past the safeguard
+                    if(alpha > alpha_safe) {
+                        X::copy(dx,alpha_dx);
+                        X::scal(alpha,alpha_dx);
+                        auto alpha_frac = std::min(
+                            Real(1.),safeguard(zero,alpha_dx,Real(1.)));
+                        if(alpha_frac < Real(1.)) {
+                            alpha *= alpha_frac;
+                            stpmax = alpha;
+                        }
+                        alpha_safe = alpha;
+                    }
+
+                    // Evaluate the merit function and its derivative
+                    auto merit_stp = Real(0.);
+                    auto g_stp = Real(0.);
+                    std::tie(f_stp,merit_stp,g_stp) = phi(alpha);
+
+                    // If we generate a NaN, move back toward the best step and
+                    // don't allow steps past this one
+                    if(merit_stp != merit_stp || g_stp != g_stp) {
+                        stpmax = alpha;
+                        alpha = stx+Real(0.5)*(alpha-stx);
+                        f_stp = std::numeric_limits <Real>::quiet_NaN();
+                        continue;
+                    }
+
+                    // Once we have sufficient decrease and a nonnegative
+                    // derivative, we quit using the modified function
+                    auto ftest = finit+alpha*gtest;
+                    if(stage1 && merit_stp <= ftest && g_stp >= Real(0.))
+                        stage1 = false;
+
+                    // Check if we satisfy the strong Wolfe conditions
+                    if( merit_stp <= ftest &&
+                        std::fabs(g_stp) <= c2*(-ginit)
+                    )
+                        break;
+
+                    // Check if we're stuck at the bounds, if the interval of
+                    // uncertainty has become too small, or if we're out of
+                    // iterations.  In this case, take the best step so far.
+                    if( (brackt && (alpha <= stmin || alpha >= stmax)) ||
+                        (brackt && stmax-stmin <= eps_ls*stmax) ||
+                        (alpha==stpmax && merit_stp<=ftest && g_stp<=gtest) ||
+                        (alpha==stpmin && (merit_stp>ftest || g_stp>=gtest)) ||
+                        iter==iter_max
+                    ) {
+                        if(stx > Real(0.) && merit_stp > fx) {
+                            alpha = stx;
+                            f_stp = f_stx;
+                            X::copy(grad_stx,grad_xpdx);
+                        }
+                        break;
+                    }
+
+                    // Find a new trial step.  In the first stage, we use the
+                    // modified function merit(alpha)-merit(0)-alpha gtest when
+                    // it has a lower value, but not sufficient decrease.
+                    auto alpha_old = alpha;
+                    if(stage1 && merit_stp <= fx && merit_stp > ftest) {
+                        auto fxm = fx-stx*gtest;
+                        auto fym = fy-sty*gtest;
+                        auto gxm = gx-gtest;
+                        auto gym = gy-gtest;
+                        moreThuenteStep(stx,fxm,gxm,sty,fym,gym,
+                            alpha,merit_stp-alpha*gtest,g_stp-gtest,
+                            brackt,stmin,stmax);
+                        fx = fxm+stx*gtest;
+                        fy = fym+sty*gtest;
+                        gx = gxm+gtest;
+                        gy = gym+gtest;
+                    } else
+                        moreThuenteStep(stx,fx,gx,sty,fy,gy,
+                            alpha,merit_stp,g_stp,
+                            brackt,stmin,stmax);
+                    if(stx==alpha_old) {
+                        f_stx = f_stp;
+                        X::copy(grad_xpdx,grad_stx);
+                    }
+
+                    // Force a sufficient decrease in the size of the interval
+                    // of uncertainty
+                    if(brackt) {
+                        if(std::fabs(sty-stx) >= Real(0.66)*width1)
+                            alpha = stx+Real(0.5)*(sty-stx);
+                        width1 = width;
+                        width = std::fabs(sty-stx);
+                        stmin = std::min(stx,sty);
+                        stmax = std::max(stx,sty);
+                    } else {
+                        stmin = alpha+xtrapl*(alpha-stx);
+                        stmax = alpha+xtrapu*(alpha-stx);
+                    }
+
+                    // Keep the step within its bounds.  If we can't make
+                    // further progress, let alpha be the best step so far.
+                    alpha = std::max(std::min(alpha,stpmax),stpmin);
+                    if( brackt && (alpha <= stmin || alpha >= stmax ||
+                        stmax-stmin <= eps_ls*stmax) &&
+                        stx > Real(0.)
+                    ) {
+                        alpha = stx;
+                        f_stp = f_stx;
+                        X::copy(grad_stx,grad_xpdx);
+                        break;
+                    }
+                }
+
+                // If we exited without a valid trial, fall back to the best
+                // step found so far, when we have one
+                iter = std::min(iter,iter_max);
+                if((f_stp != f_stp || alpha != alpha) && stx > Real(0.)) {
+                    alpha = stx;
+                    f_stp = f_stx;
+                    X::copy(grad_stx,grad_xpdx);
+                }
+                f_xpdx = f_stp;
+
+                // Keep track of the total number of iterations
+                iter_total += iter;
+            }
+            
+            // Finds a trial step using a line-search for globalization
+            static void getStepLS(
+                StateManipulator <Unconstrained <Real,XX> > const & smanip,
+                typename Functions::t const & fns,
+                typename State::t & state
+            ){
+                // Create some shortcuts
+                ScalarValuedFunction <Real,XX> const & f=*(fns.f);
+                ScalarValuedFunctionModifications <Real,XX> const & f_mod
+                    = *(fns.f_mod);
+                auto const & gradmod = *(fns.gradmod);
+                auto const & absrel = *(fns.absrel);
+                Operator <Real,XX,XX> const & PH=*(fns.PH);
+                auto const & safeguard = *(fns.safeguard); 
+                X_Vector const & x=state.x;
                 X_Vector const & grad=state.grad;
                 LineSearchDirection::t const & dir=state.dir;
                 LineSearchKind::t const & kind=state.kind;
@@ -5019,8 +6786,11 @@ namespace Optizelle{
                 Real const & c1=state.c1;
                 auto const & safeguard_failed_max = state.safeguard_failed_max;
                 auto const & glob_iter_max = state.glob_iter_max;
+                auto const & nonmono_kind = state.nonmono_kind;
+                auto const & trunc_forcing = state.trunc_forcing;
                 X_Vector & dx=state.dx;
                 Real & f_xpdx=state.f_xpdx;
+                X_Vector & grad_xpdx=state.grad_xpdx;
                 Real & alpha0=state.alpha0;
                 Real & alpha=state.alpha;
                 Real & trunc_err=state.trunc_err;
@@ -5084,6 +6854,9 @@ namespace Optizelle{
                     Real residual_err0(std::numeric_limits <Real>::quiet_NaN());
                     Real residual_err(std::numeric_limits <Real>::quiet_NaN());
 
+                    // Set the tolerance for the Nash-Sofer model-decrease test
+                    auto const eps_model = nash_sofer_tolerance(trunc_forcing);
+
                     // Turn off the safeguards for the line-search Newton-CG 
                     auto simplified_safeguard =
                         SafeguardSimplified <Real,XX>(std::bind(
@@ -5098,6 +6871,7 @@ namespace Optizelle{
                         minus_grad,
                         PH,
                         eps_trunc,
+                        eps_model,
                         trunc_iter_max,
                         trunc_orthog_storage_max,
                         trunc_orthog_iter_max,
@@ -5184,6 +6958,8 @@ namespace Optizelle{
                             ls_stop=goldenSection(fns,state);
                         else if(kind==LineSearchKind::BackTracking)
                             backTracking(fns,state);
+                        else if(kind==LineSearchKind::MoreThuente)
+                            moreThuente(fns,state);
 
                         // Determine x+dx 
                         X::copy(x,x_p_adx);
@@ -5195,9 +6971,10 @@ namespace Optizelle{
                         Real merit_xpdx=f_mod.merit(x_p_adx,f_xpdx);
 
                         // Determine if we've satisfied the sufficient decrease
-                        // condition.  Also make sure that we don't generate
-                        // a NaN
-                        auto merit_pred =merit_x+c1*alpha*X::innr(grad_step,dx);
+                        // condition relative to the nonmonotone reference.
+                        // Also make sure that we don't generate a NaN
+                        auto merit_pred = nonmonotone_reference(state,merit_x)
+                            + c1*alpha*X::innr(grad_step,dx);
                         sufficient_decrease = 
                             (merit_xpdx==merit_xpdx) &&
                             (merit_xpdx <= merit_pred);
@@ -5223,6 +7000,8 @@ namespace Optizelle{
                             norm_dx != norm_dx
                         ) {
                             X::zero(dx);
+                            f_xpdx=f_x;
+                            X::copy(grad,grad_xpdx);
                             break;
                         }
 
@@ -5255,7 +7034,9 @@ namespace Optizelle{
                     // reasonable value.  Since the safe guarding modifies
                     // the base line-search parameter, we need to restore it
                     // here.
-                    if(kind==LineSearchKind::BackTracking)
+                    if(kind==LineSearchKind::BackTracking ||
+                        kind==LineSearchKind::MoreThuente
+                    )
                         alpha0=alpha0_orig;
 
                 // Do the line-searches that are not based on sufficient
@@ -5264,6 +7045,46 @@ namespace Optizelle{
                     twoPoint(fns,state);
                     glob_iter = 1;
                     glob_iter_total++;
+
+                    // When using a nonmonotone reference, safeguard the
+                    // two-point step with a nonmonotone backtracking search as
+                    // in Raydan's globalized Barzilai-Borwein method
+                    if(nonmono_kind!=NonmonotoneKind::Monotone) {
+                        // Determine merit(x) and the derivative along dx
+                        auto merit_x = f_mod.merit(x,f_x);
+                        auto grad_step = X::init(x);
+                            f_mod.grad_step(x,grad,grad_step);
+                        auto grad_step_dx = X::innr(grad_step,dx);
+                        auto merit_ref = nonmonotone_reference(state,merit_x);
+
+                        // Without positive curvature, the two-point step
+                        // points uphill, so we restart from the base step
+                        auto x_p_adx = X::init(x);
+                        if(!(alpha > Real(0.))) {
+                            alpha = alpha0;
+                            X::copy(x,x_p_adx);
+                            X::axpy(alpha,dx,x_p_adx);
+                            f_xpdx=f.eval(x_p_adx);
+                        }
+
+                        // Backtrack until we satisfy the nonmonotone
+                        // sufficient decrease condition
+                        for(;glob_iter<glob_iter_max;glob_iter++) {
+                            X::copy(x,x_p_adx);
+                            X::axpy(alpha,dx,x_p_adx);
+                            auto merit_xpdx = f_mod.merit(x_p_adx,f_xpdx);
+                            if( merit_xpdx==merit_xpdx &&
+                                merit_xpdx <= merit_ref
+                                    + c1*alpha*grad_step_dx
+                            )
+                                break;
+                            alpha/=Real(2.);
+                            X::copy(x,x_p_adx);
+                            X::axpy(alpha,dx,x_p_adx);
+                            f_xpdx=f.eval(x_p_adx);
+                            glob_iter_total++;
+                        }
+                    }
                 }
 
                 // Adjust the size of the step (apply the line-search 
@@ -5286,6 +7107,12 @@ namespace Optizelle{
                 // Create some shortcuts
                 AlgorithmClass::t const & algorithm_class=state.algorithm_class;
 
+                // Update the stopping tolerance for truncated CG
+                updateForcingTerm(fns,state);
+
+                // Update the reference for the nonmonotone acceptance tests
+                updateNonmonotone(fns,state);
+
                 // Choose whether we use a line-search or trust-region method
                 switch(algorithm_class){
                 case AlgorithmClass::TrustRegion:
@@ -5437,6 +7264,9 @@ namespace Optizelle{
                 typename Functions::t const & fns,
                 typename State::t & state
             ){
+                // Record where we spend our time
+                Profile::Session session(state.profile);
+
                 // Create some shortcuts
                 ScalarValuedFunction <Real,XX> const & f=*(fns.f);
                 ScalarValuedFunctionModifications <Real,XX> const &
@@ -5448,6 +7278,9 @@ namespace Optizelle{
                 X_Vector & x_old=state.x_old;
                 X_Vector & grad_old=state.grad_old;
                 X_Vector & dx_old=state.dx_old;
+                X_Vector const & grad_xpdx=state.grad_xpdx;
+                AlgorithmClass::t const & algorithm_class=state.algorithm_class;
+                LineSearchKind::t const & kind=state.kind;
                 Real & f_x=state.f_x;
                 Real & f_xpdx=state.f_xpdx;
                 Real & norm_gradtyp=state.norm_gradtyp;
@@ -5531,9 +7364,16 @@ namespace Optizelle{
                     smanip.eval(fns,state,
                         OptimizationLocation::AfterStepBeforeGradient);
 
-                    // Find the new objective value and gradient
+                    // Find the new objective value and gradient.  The
+                    // strong-Wolfe line-search already evaluated the gradient
+                    // at the new iterate and stored it in grad_xpdx.
                     f_x=f_xpdx;
-                    f.grad(x,grad);
+                    if( algorithm_class==AlgorithmClass::LineSearch &&
+                        kind==LineSearchKind::MoreThuente
+                    )
+                        X::copy(grad_xpdx,grad);
+                    else
+                        f.grad(x,grad);
                     
                     // Manipulate the state if required
                     smanip.eval(fns,state,OptimizationLocation::AfterGradient);
@@ -5565,6 +7405,16 @@ namespace Optizelle{
                 smanip.eval(fns,state,OptimizationLocation::EndOfOptimization);
             }
             
+            // Checks whether the iterate that we carried over from a related
+            // problem is a valid starting point for this one.  Without
+            // inequality constraints, any iterate works.
+            static bool warmStartFeasible(
+                typename Functions::t const &,
+                typename State::t const &
+            ) {
+                return true;
+            }
+
             // Solves an optimization problem where the user doesn't know about
             // the state manipulator
             static void getMin(
@@ -5618,9 +7468,9 @@ namespace Optizelle{
         NO_CONSTRUCTORS(EqualityConstrained)
 
         // Create some shortcuts for some type names
-        typedef XX <Real> X;
+        typedef Profile::Timed <XX <Real> > X;
         typedef typename X::Vector X_Vector;
-        typedef YY <Real> Y;
+        typedef Profile::Timed <YY <Real> > Y;
         typedef typename Y::Vector Y_Vector;
 
         // This defines a product space between X and Y
@@ -5667,6 +7517,12 @@ namespace Optizelle{
         typedef XXxYY <Real> XxY;
         typedef typename XxY::Vector XxY_Vector;
 
+        // Determines whether X and Y both store their elements contiguously
+        // in a std::vector, which allows us to factor g'(x)* directly
+        typedef std::integral_constant <bool,
+            std::is_same <X_Vector,std::vector <Real> >::value &&
+            std::is_same <Y_Vector,std::vector <Real> >::value> is_dense;
+
         // Routines that manipulate the internal state of the optimization 
         // algorithm.
         struct State {
@@ -5742,6 +7598,9 @@ namespace Optizelle{
                 // Right preconditioner for the augmented system
                 Operators::t PSchur_right_type;
 
+                // Solver for the augmented system
+                AugmentedSystemSolver::t augsys_solver;
+
                 // Maximum number of iterations used when solving the augmented
                 // system
                 Natural augsys_iter_max;
@@ -5749,6 +7608,20 @@ namespace Optizelle{
                 // How often we restart the augmented system solve
                 Natural augsys_rst_freq;
 
+                // Number of directions recycled between the augmented system
+                // solves.  When 0, we do not recycle.
+                Natural augsys_recycle;
+
+                // Maximum number of vectors cached from the nullspace
+                // projections as a basis for the range of g'(x)*.  When 0,
+                // we do not cache.
+                Natural augsys_proj_cache;
+
+                // Maximum number of Broyden updates to the approximation of
+                // g'(x) used by the augmented system solves before we
+                // rebuild it from g'(x).  When 0, we use g'(x) directly.
+                Natural augsys_broyden;
+
                 // Number of iterations taken by the augmented system solve
                 Natural augsys_qn_iter;
                 Natural augsys_pg_iter;
@@ -5951,6 +7824,11 @@ namespace Optizelle{
                         Operators::Identity
                         //---PSchur_right_type1---
                     ),
+                    augsys_solver(
+                        //---augsys_solver0---
+                        AugmentedSystemSolver::GMRES
+                        //---augsys_solver1---
+                    ),
                     augsys_iter_max(
                         //---augsys_iter_max0---
                         100
@@ -5961,6 +7839,21 @@ namespace Optizelle{
                         0
                         //---augsys_rst_freq1---
                     ),
+                    augsys_recycle(
+                        //---augsys_recycle0---
+                        0
+                        //---augsys_recycle1---
+                    ),
+                    augsys_proj_cache(
+                        //---augsys_proj_cache0---
+                        0
+                        //---augsys_proj_cache1---
+                    ),
+                    augsys_broyden(
+                        //---augsys_broyden0---
+                        0
+                        //---augsys_broyden1---
+                    ),
                     augsys_qn_iter(
                         //---augsys_qn_iter0---
                         0
@@ -6371,6 +8264,20 @@ namespace Optizelle{
                         "PSchur_right_type = "
                         << Operators::to_string(state.PSchur_right_type);
 
+                // Check that we only use MINRES with a symmetric
+                // preconditioner, which means that we can't have a right
+                // preconditioner
+                else if(!(
+                    //---augsys_solver_valid0---
+                    state.augsys_solver != AugmentedSystemSolver::MINRES ||
+                    state.PSchur_right_type == Operators::Identity
+                    //---augsys_solver_valid1---
+                ))
+                    ss << "MINRES requires the right preconditioner for the "
+                        "augmented system to be the identity: "
+                        "PSchur_right_type = "
+                        << Operators::to_string(state.PSchur_right_type);
+
                 // Check that the number of iterations used when solving the
                 // augmented system is positive
                 else if(!(
@@ -6386,6 +8293,18 @@ namespace Optizelle{
                     // Any
                     //---augsys_rst_freq_valid1---
                     
+                    //---augsys_recycle_valid0---
+                    // Any
+                    //---augsys_recycle_valid1---
+                    
+                    //---augsys_proj_cache_valid0---
+                    // Any
+                    //---augsys_proj_cache_valid1---
+                    
+                    //---augsys_broyden_valid0---
+                    // Any
+                    //---augsys_broyden_valid1---
+                    
                     //---augsys_qn_iter_valid0---
                     // Any
                     //---augsys_qn_iter_valid1---
@@ -6578,6 +8497,18 @@ namespace Optizelle{
                     // Any
                     //---qn_stop_valid1---
 
+                // Check that we accept steps monotonically.  The composite
+                // step method compares the actual and predicted reduction of
+                // its own merit function and has no nonmonotone reference.
+                else if(!(
+                    //---nonmono_kind_valid0---
+                    state.nonmono_kind == NonmonotoneKind::Monotone
+                    //---nonmono_kind_valid1---
+                ))
+                    ss << "Nonmonotone step acceptance is not supported for "
+                        "equality constrained problems: nonmono_kind = "
+                        << NonmonotoneKind::to_string(state.nonmono_kind);
+
                 // If there's an error, print it
                 if(ss.str()!="")
                     throw Exception::t(__LOC__ + ", " + ss.str());
@@ -6646,6 +8577,9 @@ namespace Optizelle{
                 if( Unconstrained <Real,XX>::Restart::is_nat(item) ||
                     item.first == "augsys_iter_max" ||
                     item.first == "augsys_rst_freq" ||
+                    item.first == "augsys_recycle" ||
+                    item.first == "augsys_proj_cache" ||
+                    item.first == "augsys_broyden" ||
                     item.first == "augsys_qn_iter" ||
                     item.first == "augsys_pg_iter" ||
                     item.first == "augsys_proj_iter" ||
@@ -6678,6 +8612,8 @@ namespace Optizelle{
                         Operators::is_valid(item.second)) ||
                     (item.first=="PSchur_right_type" &&
                         Operators::is_valid(item.second)) ||
+                    (item.first=="augsys_solver" &&
+                        AugmentedSystemSolver::is_valid(item.second)) ||
                     (item.first=="g_diag" &&
                         FunctionDiagnostics::is_valid(item.second)) ||
                     (item.first=="y_diag" &&
@@ -6822,6 +8758,12 @@ namespace Optizelle{
                     std::move(state.augsys_iter_max));
                 nats.emplace_back("augsys_rst_freq",
                     std::move(state.augsys_rst_freq));
+                nats.emplace_back("augsys_recycle",
+                    std::move(state.augsys_recycle));
+                nats.emplace_back("augsys_proj_cache",
+                    std::move(state.augsys_proj_cache));
+                nats.emplace_back("augsys_broyden",
+                    std::move(state.augsys_broyden));
                 nats.emplace_back("augsys_qn_iter",
                     std::move(state.augsys_qn_iter));
                 nats.emplace_back("augsys_pg_iter",
@@ -6862,6 +8804,8 @@ namespace Optizelle{
                     Operators::to_string(state.PSchur_left_type));
                 params.emplace_back("PSchur_right_type",
                     Operators::to_string(state.PSchur_right_type));
+                params.emplace_back("augsys_solver",
+                    AugmentedSystemSolver::to_string(state.augsys_solver));
                 params.emplace_back("g_diag",
                     FunctionDiagnostics::to_string(state.g_diag));
                 params.emplace_back("y_diag",
@@ -6992,6 +8936,12 @@ namespace Optizelle{
                         state.augsys_iter_max=std::move(item->second);
                     else if(item->first=="augsys_rst_freq")
                         state.augsys_rst_freq=std::move(item->second);
+                    else if(item->first=="augsys_recycle")
+                        state.augsys_recycle=std::move(item->second);
+                    else if(item->first=="augsys_proj_cache")
+                        state.augsys_proj_cache=std::move(item->second);
+                    else if(item->first=="augsys_broyden")
+                        state.augsys_broyden=std::move(item->second);
                     else if(item->first=="augsys_qn_iter")
                         state.augsys_qn_iter=std::move(item->second);
                     else if(item->first=="augsys_pg_iter")
@@ -7039,6 +8989,9 @@ namespace Optizelle{
                     else if(item->first=="PSchur_right_type")
                         state.PSchur_right_type
                             =Operators::from_string(item->second);
+                    else if(item->first=="augsys_solver")
+                        state.augsys_solver
+                            =AugmentedSystemSolver::from_string(item->second);
                     else if(item->first=="g_diag")
                         state.g_diag=FunctionDiagnostics::from_string(
                             item->second);
@@ -7101,6 +9054,83 @@ namespace Optizelle{
                 // Check that we have a valid state 
                 State::check(state);
             }
+
+            // Pieces of a solved state that we carry over to the next problem
+            // in a sequence of related problems
+            struct Warm {
+                // Pieces of the state that we carry over.  See WarmStart.
+                Natural items;
+
+                // The pieces themselves
+                X_Vectors xs;
+                Y_Vectors ys;
+                Reals reals;
+
+                // Start with nothing
+                Warm() : items(0), xs(), ys(), reals() {}
+            };
+
+            // Copies the pieces of the state that items selects into warm
+            static void warmRelease(
+                Natural const & items,
+                typename State::t & state,
+                Warm & warm
+            ) {
+                // Release the state
+                X_Vectors xs;
+                Y_Vectors ys;
+                Reals reals;
+                Naturals nats;
+                Params params;
+                EqualityConstrained <Real,XX,YY>
+                    ::Restart::release(state,xs,ys,reals,nats,params);
+
+                // Copy out the pieces that we carry over
+                auto select = [&](std::string const & name) {
+                    return WarmStart::is_selected(items,name);
+                };
+                warm.items = items;
+                warm.xs.clear();
+                warm.ys.clear();
+                warm.reals.clear();
+                Utility::copyVectors <X> (select,xs,warm.xs);
+                Utility::copyVectors <Y> (select,ys,warm.ys);
+                Utility::copyScalars <Real> (select,reals,warm.reals);
+
+                // Put the state back together
+                EqualityConstrained <Real,XX,YY>
+                    ::Restart::capture(state,xs,ys,reals,nats,params);
+            }
+
+            // Replaces the pieces of the state with those in warm
+            static void warmCapture(
+                Warm const & warm,
+                typename State::t & state
+            ) {
+                // Release the state
+                X_Vectors xs;
+                Y_Vectors ys;
+                Reals reals;
+                Naturals nats;
+                Params params;
+                EqualityConstrained <Real,XX,YY>
+                    ::Restart::release(state,xs,ys,reals,nats,params);
+
+                // Swap in the pieces that we carry over
+                auto select = [&](std::string const & name) {
+                    return WarmStart::is_selected(warm.items,name);
+                };
+                Utility::removeItems <X_Vector> (select,xs);
+                Utility::removeItems <Y_Vector> (select,ys);
+                Utility::removeItems <Real> (select,reals);
+                Utility::copyVectors <X> (select,warm.xs,xs);
+                Utility::copyVectors <Y> (select,warm.ys,ys);
+                Utility::copyScalars <Real> (select,warm.reals,reals);
+
+                // Put the state back together
+                EqualityConstrained <Real,XX,YY>
+                    ::Restart::capture(state,xs,ys,reals,nats,params);
+            }
         };
         
         // All the functions required by an optimization algorithm.  Note, this
@@ -7109,6 +9139,199 @@ namespace Optizelle{
             // Disallow constructors
             NO_CONSTRUCTORS(Functions)
             
+            // Subspace recycled between the augmented system solves.  Since
+            // the augmented system depends on g'(x), we track the iterate
+            // used to compute the images of the recycled directions.
+            struct AugsysRecycle : public GMRESRecycle <Real,XXxYY> {
+                // Disallow constructors
+                NO_COPY_ASSIGNMENT(AugsysRecycle)
+
+                // Iterate that defines the current images
+                std::pair <bool,X_Vector> x_base;
+
+                // Whether the operator and left preconditioner are the same
+                // at every iterate
+                bool const fixed;
+
+                // Start with an empty subspace
+                AugsysRecycle(
+                    Natural const & size_max,
+                    X_Vector const & x,
+                    bool const & fixed_
+                ) :
+                    GMRESRecycle <Real,XXxYY> (size_max),
+                    x_base(false,X::init(x)),
+                    fixed(fixed_)
+                {}
+
+                // Returns the subspace for the augmented system at x.  If
+                // the iterate moved, the images are out of date unless the
+                // operator is fixed.
+                GMRESRecycle <Real,XXxYY> & at(X_Vector const & x) {
+                    if( this->size_max > 0 &&
+                        !(fixed && x_base.first) &&
+                        rel_err_cached <Real,XX> (x,x_base)
+                            >= std::numeric_limits <Real>::epsilon()*1e1
+                    ) {
+                        this->stale();
+                        x_base.first=true;
+                        X::copy(x,x_base.second);
+                    }
+                    return *this;
+                }
+            };
+            
+            // Orthonormal basis for part of the range of g'(x)*, which we
+            // build from the nullspace projections at the current iterate.
+            // Once the basis spans the range, we project without solving
+            // the augmented system.
+            struct AugsysProjCache {
+                // Disallow constructors
+                NO_COPY_ASSIGNMENT(AugsysProjCache)
+
+                // Maximum number of basis vectors.  Zero disables the cache.
+                Natural const size_max;
+
+                // Basis vectors
+                std::list <X_Vector> ws;
+
+                // Iterate that defines the current basis
+                std::pair <bool,X_Vector> x_base;
+
+                // Whether g is affine, which means that the range of g'(x)*
+                // is the same at every iterate
+                bool const affine;
+
+                // Start with an empty basis
+                AugsysProjCache(
+                    Natural const & size_max_,
+                    X_Vector const & x,
+                    bool const & affine_
+                ) :
+                    size_max(size_max_),
+                    ws(),
+                    x_base(false,X::init(x)),
+                    affine(affine_)
+                {}
+
+                // Returns the basis at x.  If the iterate moved, we discard
+                // the basis since g'(x) changed unless g is affine.
+                AugsysProjCache & at(X_Vector const & x) {
+                    if( size_max > 0 &&
+                        !(affine && x_base.first) &&
+                        rel_err_cached <Real,XX> (x,x_base)
+                            >= std::numeric_limits <Real>::epsilon()*1e1
+                    ) {
+                        ws.clear();
+                        x_base.first=true;
+                        X::copy(x,x_base.second);
+                    }
+                    return *this;
+                }
+
+                // Removes the components of dx in the span of the basis
+                void remove(X_Vector & dx) const {
+                    for(auto const & w : ws)
+                        X::axpy(Real(-1.)*X::innr(w,dx),w,dx);
+                }
+
+                // Adds a direction in the range of g'(x)* to the basis
+                void insert(X_Vector const & dx) {
+                    // If we're full, exit
+                    if(ws.size() >= size_max) return;
+
+                    // Orthogonalize the direction against the basis twice in
+                    // order to counteract a loss of orthogonality
+                    auto w = X::init(dx);
+                    X::copy(dx,w);
+                    auto norm_w0 = std::sqrt(X::innr(w,w));
+                    remove(w);
+                    remove(w);
+
+                    // Skip directions that are numerically dependent on the
+                    // basis
+                    auto norm_w = std::sqrt(X::innr(w,w));
+                    if(!(norm_w > std::sqrt(std::numeric_limits <Real>::epsilon())
+                        * norm_w0)
+                    )
+                        return;
+
+                    // Normalize and store the direction
+                    X::scal(Real(1.)/norm_w,w);
+                    ws.emplace_back(std::move(w));
+                }
+            };
+
+            // Dense QR factorization of g'(x)* used by the direct augmented
+            // system solver along with the iterate where we factored it
+            struct AugsysQR : public DenseAugmentedSystemQR <Real> {
+                // Disallow constructors
+                NO_COPY_ASSIGNMENT(AugsysQR)
+
+                // Iterate that defines the current factorization
+                std::pair <bool,X_Vector> x_base;
+
+                // Start without a factorization
+                explicit AugsysQR(X_Vector const & x) :
+                    DenseAugmentedSystemQR <Real> (),
+                    x_base(false,X::init(x))
+                {}
+            };
+
+            // Sparse LDL' factorization of the augmented system used by the
+            // direct augmented system solver along with the iterate where we
+            // factored it
+            struct AugsysLDLT : public SparseAugmentedSystemLDLT <Real> {
+                // Disallow constructors
+                NO_COPY_ASSIGNMENT(AugsysLDLT)
+
+                // Iterate that defines the current factorization
+                std::pair <bool,X_Vector> x_base;
+
+                // Start without a factorization
+                explicit AugsysLDLT(X_Vector const & x) :
+                    SparseAugmentedSystemLDLT <Real> (),
+                    x_base(false,X::init(x))
+                {}
+            };
+
+            // Broyden approximation of g'(x) used by the augmented system
+            // solves.  When we rebuild the approximation at x_lin, we
+            // assemble g'(x_lin)* densely, which costs one application of
+            // g'(x_lin)* per constraint.  After each accepted step s, we
+            // apply the good Broyden update,
+            //
+            // J <- J + (dg - J s) <s,.> / <s,s>,
+            //
+            // where dg is the change in g along s, directly to this matrix.
+            // Hence, products with the approximation never apply g'(x) or
+            // g'(x)*.
+            struct AugsysBroyden {
+                // Disallow constructors
+                NO_COPY_ASSIGNMENT(AugsysBroyden)
+
+                // Approximation of g'(x)*, which is m x n and column major
+                // where m is the size of x and n is the size of y
+                std::vector <Real> Gs;
+
+                // Number of updates since we last rebuilt the approximation
+                Natural updates;
+
+                // Iterate that defines the current approximation
+                std::pair <bool,X_Vector> x_base;
+
+                // g(x_base)
+                Y_Vector g_base;
+
+                // Start without an approximation
+                AugsysBroyden(X_Vector const & x,Y_Vector const & y) :
+                    Gs(),
+                    updates(0),
+                    x_base(false,X::init(x)),
+                    g_base(Y::init(y))
+                {}
+            };
+
             // Actual storage of the functions required
             struct t: public virtual Unconstrained <Real,XX>::Functions::t {
                 // Prevent the use of the copy constructor and the assignment
@@ -7125,10 +9348,27 @@ namespace Optizelle{
 
                 // Right preconditioner for the augmented system
                 std::unique_ptr <Operator <Real,YY,YY> > PSchur_right;
+
+                // Subspace recycled between the augmented system solves
+                std::unique_ptr <AugsysRecycle> augsys_recycle;
+
+                // Cached basis for the range of g'(x)* used by the nullspace
+                // projections
+                std::unique_ptr <AugsysProjCache> augsys_proj_cache;
+
+                // Factorizations used by the direct augmented system solvers
+                std::unique_ptr <AugsysQR> augsys_qr;
+                std::unique_ptr <AugsysLDLT> augsys_ldlt;
+
+                // Approximation of g'(x) used by the augmented system solves
+                std::unique_ptr <AugsysBroyden> augsys_broyden;
                 
                 // Initialize all of the pointers to null
                 t() : Unconstrained <Real,XX>::Functions::t(), g(nullptr),
-                    PSchur_left(nullptr), PSchur_right(nullptr) {}
+                    PSchur_left(nullptr), PSchur_right(nullptr),
+                    augsys_recycle(nullptr), augsys_proj_cache(nullptr),
+                    augsys_qr(nullptr), augsys_ldlt(nullptr),
+                    augsys_broyden(nullptr) {}
             };
 
             struct EqualityModifications
@@ -7176,9 +9416,11 @@ namespace Optizelle{
                     X::copy(grad,grad_lag);
                     
                     // If relative error between the current and cached values
-                    // is large, compute anew.
-                    if( rel_err_cached <Real,XX> (x,x_grad)
-                            >= std::numeric_limits <Real>::epsilon()*1e1 ||
+                    // is large, compute anew.  When g is affine, g'(x)*
+                    // doesn't depend on x, so we only check y.
+                    if( (!(g.is_affine() && x_grad.first) &&
+                            rel_err_cached <Real,XX> (x,x_grad)
+                                >= std::numeric_limits <Real>::epsilon()*1e1)||
                         rel_err_cached <Real,YY> (y,y_grad)
                             >= std::numeric_limits <Real>::epsilon()*1e1 
                     ) {
@@ -7301,6 +9543,9 @@ namespace Optizelle{
                     // Modify the Hessian vector product 
                     f_mod->hessvec_step(x,dx,H_dx,Hdx_step);
 
+                    // If g is affine, g''(x)=0
+                    if(g.is_affine()) return;
+
                     // x_tmp1 <- (g''(x)dx)*y
                     g.pps(x,dx,y,x_tmp1);
 
@@ -7384,6 +9629,66 @@ namespace Optizelle{
 
                 // Check that all functions are defined 
                 check(fns);
+
+                // Time the constraints and the preconditioners
+                Profile::instrument(fns.g);
+                Profile::instrument(fns.PSchur_left);
+                Profile::instrument(fns.PSchur_right);
+
+                // Allocate the subspace recycled between the augmented system
+                // solves
+                fns.augsys_recycle.reset(new AugsysRecycle(
+                    state.augsys_recycle,state.x,
+                    fns.g->is_affine() &&
+                        state.PSchur_left_type == Operators::Identity));
+
+                // Allocate the basis cached by the nullspace projections
+                fns.augsys_proj_cache.reset(new AugsysProjCache(
+                    state.augsys_proj_cache,state.x,fns.g->is_affine()));
+
+                // Allocate the factorization for the direct augmented system
+                // solver.  Since we access the elements of g'(x)* directly,
+                // this requires X and Y to be Rm.
+                if(state.augsys_solver == AugmentedSystemSolver::QR) {
+                    if(!is_dense::value)
+                        throw Exception::t(__LOC__
+                            + ", the QR augmented system solver requires "
+                            "both X and Y to be Rm");
+                    fns.augsys_qr.reset(new AugsysQR(state.x));
+                }
+
+                // Allocate the factorization for the sparse augmented system
+                // solver, which requires the Jacobian of g
+                if(state.augsys_solver == AugmentedSystemSolver::LDLT) {
+                    if( !is_dense::value ||
+                        !dynamic_cast <SparseJacobian <Real> const *> (
+                            fns.g.get())
+                    )
+                        throw Exception::t(__LOC__
+                            + ", the LDLT augmented system solver requires "
+                            "both X and Y to be Rm and g to be a "
+                            "SparseVectorValuedFunction");
+                    fns.augsys_ldlt.reset(new AugsysLDLT(state.x));
+                }
+
+                // Allocate the approximation of g'(x).  The direct solvers
+                // already avoid repeated applications of g'(x), so we only
+                // use it with the iterative solvers.  Since we store the
+                // approximation densely, this requires X and Y to be Rm.
+                if(state.augsys_broyden > 0) {
+                    if(!is_dense::value)
+                        throw Exception::t(__LOC__
+                            + ", the Broyden approximation of g'(x) requires "
+                            "both X and Y to be Rm");
+                    if( state.augsys_solver == AugmentedSystemSolver::QR ||
+                        state.augsys_solver == AugmentedSystemSolver::LDLT
+                    )
+                        throw Exception::t(__LOC__
+                            + ", the Broyden approximation of g'(x) requires "
+                            "an iterative augmented system solver");
+                    fns.augsys_broyden.reset(
+                        new AugsysBroyden(state.x,state.y));
+                }
                 
                 // Modify the objective 
                 fns.f_mod.reset(new EqualityModifications(
@@ -7490,6 +9795,8 @@ namespace Optizelle{
                     state,out);
                 EqualityConstrained <Real,XX,YY>::Diagnostics::getStateHeader_(
                     state,out);
+                Unconstrained <Real,XX>::Diagnostics::getProfileHeader_(
+                    state,out);
             }
 
             // Gets the state information for output
@@ -7673,6 +9980,8 @@ namespace Optizelle{
                     ::getState_(fns,state,blank,noiter,out);
                 EqualityConstrained <Real,XX,YY>::Diagnostics
                     ::getState_(fns,state,blank,out);
+                Unconstrained <Real,XX>::Diagnostics
+                    ::getProfile_(state,blank,out);
             }
             
             // Runs the specified function diagnostics 
@@ -7877,17 +10186,23 @@ namespace Optizelle{
             // [ I      g'(x)* ]
             // [ g'(x)  0      ]
             //
+            // When given an approximation of g'(x), we use it in place of
+            // g'(x).
             struct AugmentedSystem: public Operator <Real,XXxYY,XXxYY> {
             private:
                 typename State::t const & state;
                 typename Functions::t const & fns;
                 X_Vector const & x_base;
+                typename Functions::AugsysBroyden const * const broyden;
             public:
                 AugmentedSystem(
                     typename State::t const & state_,
                     typename Functions::t const & fns_,
-                    X_Vector const & x_base_
-                ) : state(state_), fns(fns_), x_base(x_base_) {}
+                    X_Vector const & x_base_,
+                    typename Functions::AugsysBroyden const * const broyden_
+                        = nullptr
+                ) : state(state_), fns(fns_), x_base(x_base_),
+                    broyden(broyden_) {}
                 
                 // Operator interface
                 void eval(
@@ -7898,13 +10213,19 @@ namespace Optizelle{
                     VectorValuedFunction <Real,XX,YY> const & g=*(fns.g);
 
                     // g'(x_base)* dy
-                    g.ps(x_base,dx_dy.second,result.first);
+                    if(broyden)
+                        broyden_ps(*broyden,dx_dy.second,result.first);
+                    else
+                        g.ps(x_base,dx_dy.second,result.first);
 
                     // dx + g'(x_base)* dy 
                     X::axpy(Real(1.),dx_dy.first,result.first);
 
                     // g'(x_base)* dx
-                    g.p(x_base,dx_dy.first,result.second);
+                    if(broyden)
+                        broyden_p(*broyden,dx_dy.first,result.second);
+                    else
+                        g.p(x_base,dx_dy.first,result.second);
                 }
             };
             
@@ -7937,14 +10258,548 @@ namespace Optizelle{
                 }
             };
 
-            // Adjusts an augmented system solve stopping tolerance from 
-            //
-            // || e1 || + || e2 || <= eps
-            //
-            // to
-            //
-            // sqrt(|| e1 ||^2 + || e2 ||^2) <= eps'
-            //
+            // Assembles g'(x)* at x one column at a time.  We do this
+            // serially since g.ps belongs to the user and need not be
+            // reentrant.
+            static void assemble_gps(
+                typename Functions::t const & fns,
+                X_Vector const & x,
+                Y_Vector const & y,
+                std::vector <Real> & Gs
+            ) {
+                Natural m = x.size();
+                Natural n = y.size();
+                Gs.resize(m*n);
+                auto e = Y::init(y);
+                auto col = X::init(x);
+                for(Natural j=0;j<n;j++) {
+                    Y::zero(e);
+                    e[j]=Real(1.);
+                    fns.g->ps(x,e,col);
+                    Optizelle::copy <Real> (m,col.data(),1,&(Gs[j*m]),1);
+                }
+            }
+
+            // Applies the approximation of g'(x) to dx
+            static void broyden_p(
+                typename Functions::AugsysBroyden const & broyden,
+                X_Vector const & dx,
+                Y_Vector & y,
+                std::true_type
+            ) {
+                Optizelle::gemv <Real> ('T',dx.size(),y.size(),Real(1.),
+                    broyden.Gs.data(),dx.size(),dx.data(),1,Real(0.),
+                    y.data(),1);
+            }
+
+            // Applies the adjoint of the approximation of g'(x) to dy
+            static void broyden_ps(
+                typename Functions::AugsysBroyden const & broyden,
+                Y_Vector const & dy,
+                X_Vector & z,
+                std::true_type
+            ) {
+                Optizelle::gemv <Real> ('N',z.size(),dy.size(),Real(1.),
+                    broyden.Gs.data(),z.size(),dy.data(),1,Real(0.),
+                    z.data(),1);
+            }
+
+            // Rebuilds the approximation of g'(x) at x
+            static void broyden_assemble(
+                typename Functions::t const & fns,
+                X_Vector const & x,
+                typename Functions::AugsysBroyden & broyden,
+                std::true_type
+            ) {
+                assemble_gps(fns,x,broyden.g_base,broyden.Gs);
+            }
+
+            // Adds the update u <s,.> / <s,s> to the approximation of g'(x)
+            static void broyden_update(
+                typename Functions::AugsysBroyden & broyden,
+                X_Vector const & s,
+                Y_Vector const & u,
+                Real const & ss,
+                std::true_type
+            ) {
+                Natural m = s.size();
+                for(Natural j=0;j<u.size();j++)
+                    Optizelle::axpy <Real> (m,u[j]/ss,s.data(),1,
+                        &(broyden.Gs[j*m]),1);
+            }
+
+            // Without dense storage, we can't store the approximation.  We
+            // check for this during initialization, so these should never
+            // be called.
+            static void broyden_p(
+                typename Functions::AugsysBroyden const &,
+                X_Vector const &,
+                Y_Vector &,
+                std::false_type
+            ) {
+                throw Exception::t(__LOC__
+                    + ", the Broyden approximation of g'(x) requires both X "
+                    "and Y to be Rm");
+            }
+            static void broyden_ps(
+                typename Functions::AugsysBroyden const &,
+                Y_Vector const &,
+                X_Vector &,
+                std::false_type
+            ) {
+                throw Exception::t(__LOC__
+                    + ", the Broyden approximation of g'(x) requires both X "
+                    "and Y to be Rm");
+            }
+            static void broyden_assemble(
+                typename Functions::t const &,
+                X_Vector const &,
+                typename Functions::AugsysBroyden &,
+                std::false_type
+            ) {
+                throw Exception::t(__LOC__
+                    + ", the Broyden approximation of g'(x) requires both X "
+                    "and Y to be Rm");
+            }
+            static void broyden_update(
+                typename Functions::AugsysBroyden &,
+                X_Vector const &,
+                Y_Vector const &,
+                Real const &,
+                std::false_type
+            ) {
+                throw Exception::t(__LOC__
+                    + ", the Broyden approximation of g'(x) requires both X "
+                    "and Y to be Rm");
+            }
+
+            // Applies the approximation of g'(x) and its adjoint
+            static void broyden_p(
+                typename Functions::AugsysBroyden const & broyden,
+                X_Vector const & dx,
+                Y_Vector & y
+            ) {
+                broyden_p(broyden,dx,y,is_dense());
+            }
+            static void broyden_ps(
+                typename Functions::AugsysBroyden const & broyden,
+                Y_Vector const & dy,
+                X_Vector & z
+            ) {
+                broyden_ps(broyden,dy,z,is_dense());
+            }
+
+            // Returns the approximation of g'(x) when we have one at x and
+            // nullptr otherwise
+            static typename Functions::AugsysBroyden const *
+            augsys_broyden_at(
+                typename Functions::t const & fns,
+                X_Vector const & x
+            ) {
+                if( fns.augsys_broyden &&
+                    rel_err_cached <Real,XX> (x,fns.augsys_broyden->x_base)
+                        < std::numeric_limits <Real>::epsilon()*1e1
+                )
+                    return fns.augsys_broyden.get();
+                return nullptr;
+            }
+
+            // Rebuilds the approximation of g'(x) at x, which costs one
+            // application of g'(x)* per constraint
+            static void augsys_broyden_rebuild(
+                typename Functions::t const & fns,
+                X_Vector const & x
+            ) {
+                // Create some shortcuts
+                auto & broyden = *(fns.augsys_broyden);
+
+                // Assemble g'(x)*
+                broyden_assemble(fns,x,broyden,is_dense());
+                broyden.updates = 0;
+
+                // Save where we built the approximation
+                broyden.x_base.first=true;
+                X::copy(x,broyden.x_base.second);
+                fns.g->eval(x,broyden.g_base);
+
+                // The augmented system changed, so the images of the recycled
+                // directions are out of date
+                fns.augsys_recycle->stale();
+            }
+
+            // Rebuilds the approximation of g'(x) at x if we don't have one
+            // yet or if we've stored as many corrections as allowed
+            static void augsys_broyden_refresh(
+                typename Functions::t const & fns,
+                typename State::t const & state,
+                X_Vector const & x
+            ) {
+                if( fns.augsys_broyden &&
+                    (!fns.augsys_broyden->x_base.first ||
+                        fns.augsys_broyden->updates >= state.augsys_broyden)
+                )
+                    augsys_broyden_rebuild(fns,x);
+            }
+
+            // Updates the approximation of g'(x) from the step between the
+            // iterate where we last updated it and x as well as the change in
+            // g.  This requires no applications of g'(x).
+            static void augsys_broyden_update(
+                typename Functions::t const & fns,
+                X_Vector const & x,
+                Y_Vector const & g_x
+            ) {
+                // If we don't have an approximation yet, there's nothing to
+                // update
+                if(!fns.augsys_broyden || !fns.augsys_broyden->x_base.first)
+                    return;
+                auto & broyden = *(fns.augsys_broyden);
+
+                // s = x - x_base
+                auto s = X::init(x);
+                X::copy(x,s);
+                X::axpy(Real(-1.),broyden.x_base.second,s);
+
+                // Add the update u <s,.> / <s,s> where u = dg - J s and
+                // dg = g(x) - g(x_base).  We skip zero steps.
+                auto ss = X::innr(s,s);
+                if(ss > Real(0.)) {
+                    auto u = Y::init(g_x);
+                    broyden_p(broyden,s,u);
+                    Y::scal(Real(-1.),u);
+                    Y::axpy(Real(1.),g_x,u);
+                    Y::axpy(Real(-1.),broyden.g_base,u);
+                    broyden_update(broyden,s,u,ss,is_dense());
+                    broyden.updates++;
+                }
+
+                // Save where we updated the approximation
+                X::copy(x,broyden.x_base.second);
+                Y::copy(g_x,broyden.g_base);
+            }
+
+            // Checks a solution of the augmented system found with the
+            // approximation of g'(x) against the true system, which costs one
+            // application of g'(x) and g'(x)*.  When the residual meets the
+            // tolerance, we return true and store it in the result.
+            static bool augsys_broyden_check(
+                typename Functions::t const & fns,
+                typename State::t const & state,
+                X_Vector const & x,
+                XxY_Vector const & b0,
+                GMRESManipulator <Real,XXxYY> const & gmanip,
+                XxY_Vector const & x0,
+                std::pair <Real,Natural> & result
+            ) {
+                auto eps = Real(1.);
+                gmanip.eval(result.second,x0,b0,eps);
+                AugmentedSystem A(state,fns,x);
+                auto r = XxY::init(b0);
+                A.eval(x0,r);
+                XxY::scal(Real(-1.),r);
+                XxY::axpy(Real(1.),b0,r);
+                auto norm_r = std::sqrt(XxY::innr(r,r));
+                if(norm_r > std::max(eps,result.first))
+                    return false;
+                result.first = norm_r;
+                return true;
+            }
+
+            // Solves the augmented system directly with a dense QR
+            // factorization of g'(x)*, which we reuse until x moves.  We
+            // ignore the preconditioners, but still run the manipulator so
+            // that the caller's tolerances are set.  This returns false when
+            // g'(x)* is numerically rank deficient.
+            static bool augsys_solve_qr(
+                typename Functions::t const & fns,
+                typename State::t const & state,
+                X_Vector const & x,
+                XxY_Vector const & b0,
+                GMRESManipulator <Real,XXxYY> const & gmanip,
+                XxY_Vector & x0,
+                std::pair <Real,Natural> & result,
+                std::true_type
+            ) {
+                // Create some shortcuts
+                auto const & g = *(fns.g);
+                auto & qr = *(fns.augsys_qr);
+
+                // Factor g'(x)* if we moved, unless g is affine
+                if( !(g.is_affine() && qr.x_base.first) &&
+                    rel_err_cached <Real,XX> (x,qr.x_base)
+                        >= std::numeric_limits <Real>::epsilon()*1e1
+                ) {
+                    // Assemble g'(x)*
+                    Natural m = x.size();
+                    Natural n = state.y.size();
+                    auto Gs = std::vector <Real> ();
+                    assemble_gps(fns,x,state.y,Gs);
+
+                    // Factor the result
+                    qr.factor(m,n,Gs);
+                    qr.x_base.first=true;
+                    X::copy(x,qr.x_base.second);
+                }
+
+                // If we're rank deficient, let someone else do the solve
+                if(!qr.factored) return false;
+
+                // Solve the system
+                qr.solve(b0.first.data(),b0.second.data(),
+                    x0.first.data(),x0.second.data());
+
+                // Set the caller's stopping tolerance
+                auto eps = Real(1.);
+                gmanip.eval(1,x0,b0,eps);
+
+                // Find the true residual
+                AugmentedSystem A(state,fns,x);
+                auto r = XxY::init(b0);
+                A.eval(x0,r);
+                XxY::scal(Real(-1.),r);
+                XxY::axpy(Real(1.),b0,r);
+                auto norm_r = std::sqrt(XxY::innr(r,r));
+                auto iter = Natural(1);
+
+                // If we miss the tolerance, which happens when the target is
+                // near roundoff, take a step of iterative refinement
+                if(norm_r > eps) {
+                    auto dx0 = XxY::init(x0);
+                    qr.solve(r.first.data(),r.second.data(),
+                        dx0.first.data(),dx0.second.data());
+                    XxY::axpy(Real(1.),dx0,x0);
+                    iter++;
+                    gmanip.eval(iter,x0,b0,eps);
+
+                    A.eval(x0,r);
+                    XxY::scal(Real(-1.),r);
+                    XxY::axpy(Real(1.),b0,r);
+                    norm_r = std::sqrt(XxY::innr(r,r));
+                }
+
+                // Return the norm of the residual and the number of solves
+                result = std::pair <Real,Natural> (norm_r,iter);
+                return true;
+            }
+
+            // Without dense storage, we can't factor g'(x)*.  We check for
+            // this during initialization, so this should never be called.
+            static bool augsys_solve_qr(
+                typename Functions::t const &,
+                typename State::t const &,
+                X_Vector const &,
+                XxY_Vector const &,
+                GMRESManipulator <Real,XXxYY> const &,
+                XxY_Vector &,
+                std::pair <Real,Natural> &,
+                std::false_type
+            ) {
+                throw Exception::t(__LOC__
+                    + ", the QR augmented system solver requires both X "
+                    "and Y to be Rm");
+            }
+
+            // Solves the augmented system with a sparse LDL' factorization of
+            // a regularized augmented system, which we reuse until x moves.
+            // We then use iterative refinement on the true system until we
+            // meet the tolerance set by the manipulator or run out of
+            // iterations.  Each refinement step counts as an iteration.
+            static std::pair <Real,Natural> augsys_solve_ldlt(
+                typename Functions::t const & fns,
+                typename State::t const & state,
+                X_Vector const & x,
+                XxY_Vector const & b0,
+                GMRESManipulator <Real,XXxYY> const & gmanip,
+                XxY_Vector & x0,
+                std::true_type
+            ) {
+                // Create some shortcuts
+                auto const & g = dynamic_cast <SparseJacobian <Real> const &> (
+                    *(fns.g));
+                auto & ldlt = *(fns.augsys_ldlt);
+
+                // Factor the augmented system if we moved, unless g is affine
+                if( !(fns.g->is_affine() && ldlt.x_base.first) &&
+                    rel_err_cached <Real,XX> (x,ldlt.x_base)
+                        >= std::numeric_limits <Real>::epsilon()*1e1
+                ) {
+                    ldlt.factor(g.jac(x),g.jac_trans(x));
+                    ldlt.x_base.first=true;
+                    X::copy(x,ldlt.x_base.second);
+                }
+
+                // Find the initial residual
+                AugmentedSystem A(state,fns,x);
+                auto r = XxY::init(b0);
+                A.eval(x0,r);
+                XxY::scal(Real(-1.),r);
+                XxY::axpy(Real(1.),b0,r);
+                auto norm_r = std::sqrt(XxY::innr(r,r));
+
+                // Refine the solution
+                auto dx0 = XxY::init(x0);
+                auto eps = Real(1.);
+                auto iter = Natural(1);
+                for(iter = 1; iter <= state.augsys_iter_max; iter++) {
+                    // Solve with the regularized system and update the
+                    // solution 
+                    ldlt.solve(r.first.data(),r.second.data(),
+                        dx0.first.data(),dx0.second.data());
+                    XxY::axpy(Real(1.),dx0,x0);
+
+                    // Adjust the stopping tolerance
+                    gmanip.eval(iter,x0,b0,eps);
+
+                    // Find the new residual
+                    A.eval(x0,r);
+                    XxY::scal(Real(-1.),r);
+                    XxY::axpy(Real(1.),b0,r);
+                    norm_r = std::sqrt(XxY::innr(r,r));
+
+                    // Exit if we've met the tolerance
+                    if(norm_r <= eps) break;
+                }
+
+                // Adjust the iteration number if we ran out of iterations
+                iter = iter > state.augsys_iter_max
+                    ? state.augsys_iter_max : iter;
+
+                // Return the norm of the residual and the number of iterations
+                return std::pair <Real,Natural> (norm_r,iter);
+            }
+
+            // Without dense storage, we can't access the sparse Jacobian.  We
+            // check for this during initialization, so this should never be
+            // called.
+            static std::pair <Real,Natural> augsys_solve_ldlt(
+                typename Functions::t const &,
+                typename State::t const &,
+                X_Vector const &,
+                XxY_Vector const &,
+                GMRESManipulator <Real,XXxYY> const &,
+                XxY_Vector &,
+                std::false_type
+            ) {
+                throw Exception::t(__LOC__
+                    + ", the LDLT augmented system solver requires both X "
+                    "and Y to be Rm");
+            }
+
+            // Solves the augmented system at x with the method given
+            // by augsys_solver.  The preconditioners are built from the
+            // Schur preconditioners PSchur_left and PSchur_right.  When we
+            // approximate g'(x), the iterative methods use the approximation
+            // and we rebuild it when the solution misses the tolerance on the
+            // true system.
+            static std::pair <Real,Natural> augsys_solve(
+                typename Functions::t const & fns,
+                typename State::t const & state,
+                X_Vector const & x,
+                XxY_Vector const & b0,
+                GMRESManipulator <Real,XXxYY> const & gmanip,
+                XxY_Vector & x0
+            ) {
+                // Build Schur style preconditioners
+                typename Unconstrained <Real,XX>::Functions::Identity I;
+                BlockDiagonalPreconditioner PAugSys_l(I,*(fns.PSchur_left));
+                BlockDiagonalPreconditioner PAugSys_r(I,*(fns.PSchur_right));
+
+                // Solve the augmented system with one of the iterative
+                // methods.  Note, the stopping tolerance is overwritten by the
+                // manipulator.
+                auto krylov = [&](
+                    typename Functions::AugsysBroyden const * const broyden
+                ) {
+                    switch(state.augsys_solver) {
+                    case AugmentedSystemSolver::QR:
+                    case AugmentedSystemSolver::GMRES:
+                        return Optizelle::gmres <Real,XXxYY> (
+                            AugmentedSystem(state,fns,x,broyden),
+                            b0,
+                            Real(1.),
+                            state.augsys_iter_max,
+                            state.augsys_rst_freq,
+                            PAugSys_l,
+                            PAugSys_r,
+                            gmanip,
+                            fns.augsys_recycle->at(x),
+                            x0);
+                    case AugmentedSystemSolver::FGMRES:
+                        return Optizelle::fgmres <Real,XXxYY> (
+                            AugmentedSystem(state,fns,x,broyden),
+                            b0,
+                            Real(1.),
+                            state.augsys_iter_max,
+                            state.augsys_rst_freq,
+                            PAugSys_l,
+                            PAugSys_r,
+                            gmanip,
+                            fns.augsys_recycle->at(x),
+                            x0);
+                    case AugmentedSystemSolver::MINRES:
+                        return Optizelle::minres <Real,XXxYY> (
+                            AugmentedSystem(state,fns,x,broyden),
+                            b0,
+                            Real(1.),
+                            state.augsys_iter_max,
+                            PAugSys_l,
+                            gmanip,
+                            x0);
+                    default:
+                        throw Exception::t(__LOC__
+                            + ", unknown augmented system solver");
+                    }
+                };
+
+                // Use the direct solvers when requested
+                switch(state.augsys_solver) {
+                case AugmentedSystemSolver::QR: {
+                    // Solve directly unless g'(x)* is rank deficient, in
+                    // which case we fall back to GMRES
+                    auto result = std::pair <Real,Natural> ();
+                    if(augsys_solve_qr(fns,state,x,b0,gmanip,x0,result,
+                        is_dense())
+                    )
+                        return result;
+                    return krylov(nullptr);
+                }
+                case AugmentedSystemSolver::LDLT:
+                    return augsys_solve_ldlt(fns,state,x,b0,gmanip,x0,
+                        is_dense());
+                default:
+                    break;
+                }
+
+                // Rebuild the approximation of g'(x) if we need to
+                augsys_broyden_refresh(fns,state,x);
+
+                // Solve the system.  Without an approximation of g'(x), we're
+                // done.
+                auto broyden = augsys_broyden_at(fns,x);
+                auto result = krylov(broyden);
+                if(!broyden) return result;
+
+                // Check our solution against the true augmented system
+                if(augsys_broyden_check(fns,state,x,b0,gmanip,x0,result))
+                    return result;
+
+                // If the approximation isn't good enough, rebuild it at x and
+                // continue the solve from where we left off
+                augsys_broyden_rebuild(fns,x);
+                auto iter = result.second;
+                result = krylov(augsys_broyden_at(fns,x));
+                result.second += iter;
+                return result;
+            }
+
+            // Adjusts an augmented system solve stopping tolerance from 
+            //
+            // || e1 || + || e2 || <= eps
+            //
+            // to
+            //
+            // sqrt(|| e1 ||^2 + || e2 ||^2) <= eps'
+            //
             // Basically, GMRES really needs the latter kind of condition, but
             // often the theory for the inexact composite-step SQP provides the
             // first.
@@ -7960,16 +10815,26 @@ namespace Optizelle{
                 auto const & x=state.x;
                 auto const & y=state.y;
 
+                // If the augmented system uses an approximation of g'(x), so
+                // do we
+                auto broyden = augsys_broyden_at(fns,x);
+
                 // e1 = xx1 + g'(x)*xx2 - bb1
                 auto e1 = X::init(x);
-                g.ps(x,xx.second,e1);
+                if(broyden)
+                    broyden_ps(*broyden,xx.second,e1);
+                else
+                    g.ps(x,xx.second,e1);
                 X::axpy(Real(1.),xx.first,e1);
                 X::axpy(Real(-1.),bb.first,e1);
                 auto norm_e1 = std::sqrt(X::innr(e1,e1));
 
                 // e2 = g'(x)xx1 - bb2
                 auto e2 = Y::init(y);
-                g.p(x,xx.first,e2);
+                if(broyden)
+                    broyden_p(*broyden,xx.first,e2);
+                else
+                    g.p(x,xx.first,e2);
                 Y::axpy(Real(-1.),bb.second,e2);
                 auto norm_e2 = std::sqrt(Y::innr(e2,e2));
 
@@ -8047,8 +10912,6 @@ namespace Optizelle{
                 auto const & absrel = *(fns.absrel);
                 auto const & x=state.x;
                 auto const & g_x=state.g_x;
-                auto const & augsys_iter_max=state.augsys_iter_max;
-                auto const & augsys_rst_freq=state.augsys_rst_freq;
                 auto const & delta = state.delta;
                 auto const & zeta = state.zeta;
                 auto const & norm_gxtyp = state.norm_gxtyp;
@@ -8190,28 +11053,15 @@ namespace Optizelle{
                         Y::scal(Real(-1.),b0.second);
                         Y::axpy(Real(-1.),g_x,b0.second);
 
-                        // Build Schur style preconditioners
-                        auto I = typename
-                            Unconstrained <Real,XX>::Functions::Identity();
-                        auto PAugSys_l =
-                            BlockDiagonalPreconditioner (I,*(fns.PSchur_left));
-                        auto PAugSys_r =
-                            BlockDiagonalPreconditioner (I,*(fns.PSchur_right));
-
                         // Solve the augmented system for the Newton step
                         std::tie(augsys_qn_err,augsys_qn_iter) =
-                            Optizelle::gmres <Real,XXxYY> (
-                                AugmentedSystem(state,fns,x),
+                            augsys_solve(
+                                fns,
+                                state,
+                                x,
                                 b0,
-                                // This will be overwritten by the manipulator
-                                Real(1.),
-                                augsys_iter_max,
-                                augsys_rst_freq,
-                                PAugSys_l,
-                                PAugSys_r,
                                 QNManipulator(state,fns),
-                                x0 
-                            );
+                                x0);
                         augsys_qn_iter_total+=augsys_qn_iter;
                         augsys_iter_total+=augsys_qn_iter;
                         auto augsys_failed = augsys_qn_err>augsys_qn_err_target;
@@ -8416,27 +11266,36 @@ namespace Optizelle{
                 auto const & g=*(fns.g);
                 auto const & x=state.x;
                 auto const & y=state.y;
-                auto const & augsys_iter_max=state.augsys_iter_max;
-                auto const & augsys_rst_freq=state.augsys_rst_freq;
                 auto const & eps_dx = state.eps_dx;
                 auto const & norm_dxtyp = state.norm_dxtyp;
                 auto & augsys_failed_total = state.augsys_failed_total;
                 auto & augsys_iter_total = state.augsys_iter_total;
+                auto & proj_cache = fns.augsys_proj_cache->at(x);
+
+                // Remove the components of the direction that lie in the
+                // cached basis for the range of g'(x)*.  Since the projector
+                // annihilates these components, this doesn't change the
+                // projection, but it may leave us in the nullspace already.
+                auto dx_red = X::init(dx);
+                X::copy(dx,dx_red);
+                proj_cache.remove(dx_red);
 
                 // Test if our direction is already in the nullspace of
                 // g'(x).  If so, don't do the nullspace solve, just return
                 // the direction as is.  Note, we do a separate test to
                 // check whether the direction is zero.  In theory, this
                 // should be detected by the first test, but that can be
-                // hard to discern due to numerical error.
+                // hard to discern due to numerical error.  Since dx_red is
+                // the direction that we return, we measure the error
+                // relative to it rather than to dx.
                 auto gp_x_dx = Y::init(y);
-                g.p(x,dx,gp_x_dx);
+                g.p(x,dx_red,gp_x_dx);
                 auto norm_gp_x_dx = std::sqrt(Y::innr(gp_x_dx,gp_x_dx));
-                auto norm_dx = std::sqrt(X::innr(dx,dx));
+                auto norm_dx = std::sqrt(X::innr(dx_red,dx_red));
                 if( norm_gp_x_dx <= xi*std::min(norm_dx,delta) ||
                     norm_dx <= eps_dx * absrel(norm_dxtyp)
                 ) {
-                    X::copy(dx,result);
+                    X::copy(dx_red,result);
                     augsys_null_err = norm_gp_x_dx;
                     augsys_null_err_target = xi * std::min(norm_dx,delta);
                     return;
@@ -8448,30 +11307,19 @@ namespace Optizelle{
 
                 // Create the rhs, b0=(dx,0)
                 XxY_Vector b0(XxY::init(x0));
-                    X::copy(dx,b0.first);
+                    X::copy(dx_red,b0.first);
                     Y::zero(b0.second);
             
-                // Build Schur style preconditioners
-                typename Unconstrained <Real,XX>::Functions::Identity I;
-                BlockDiagonalPreconditioner
-                    PAugSys_l(I,*(fns.PSchur_left));
-                BlockDiagonalPreconditioner
-                    PAugSys_r(I,*(fns.PSchur_right));
-
                 // Solve the augmented system for the nullspace projection 
                 auto iter = Natural(0);
                 std::tie(augsys_null_err,iter) =
-                    Optizelle::gmres <Real,XXxYY> (
-                        AugmentedSystem(state,fns,x),
+                    augsys_solve(
+                        fns,
+                        state,
+                        x,
                         b0,
-                        Real(1.), // Overwritten by the manipulator
-                        augsys_iter_max,
-                        augsys_rst_freq,
-                        PAugSys_l,
-                        PAugSys_r,
                         gmanip,
-                        x0 
-                    );
+                        x0);
                 augsys_null_iter+=iter;
                 augsys_null_iter_total+=iter;
                 augsys_iter_total+=iter;
@@ -8481,6 +11329,20 @@ namespace Optizelle{
 
                 // Copy out the solution
                 X::copy(x0.first,result);
+
+                // Cache the part of the direction that we removed.  Since
+                // the solve only meets a loose tolerance, dx_red - result
+                // may carry a piece of the nullspace, which later calls to
+                // remove would strip from their directions.  Instead, we
+                // cache g'(x)*y, which lies in the range of g'(x)* no matter
+                // how accurately we solved for y.
+                if( !augsys_failed &&
+                    proj_cache.ws.size() < proj_cache.size_max
+                ) {
+                    auto gps_x_y = X::init(x);
+                    g.ps(x,x0.second,gps_x_y);
+                    proj_cache.insert(gps_x_y);
+                }
             }
             
             // Sets the tolerances for projecting 
@@ -8774,6 +11636,7 @@ namespace Optizelle{
                     minus_W_gradpHdxn,
                     NullspaceProjForTrunc(state,fns), // Add in PH?
                     eps_trunc,
+                    Real(0.),
                     trunc_iter_max,
                     trunc_orthog_storage_max,
                     trunc_orthog_iter_max,
@@ -8866,8 +11729,6 @@ namespace Optizelle{
                 // Create some shortcuts
                 X_Vector const & x=state.x;
                 Y_Vector const & y=state.y;
-                Natural const & augsys_iter_max=state.augsys_iter_max;
-                Natural const & augsys_rst_freq=state.augsys_rst_freq;
                 X_Vector const & dx_t_uncorrected=state.dx_t_uncorrected;
                 X_Vector & dx_t=state.dx_t;
                 auto const & augsys_tang_err_target
@@ -8888,24 +11749,15 @@ namespace Optizelle{
                     X::copy(dx_t_uncorrected,b0.first);
                     Y::zero(b0.second);
 
-                // Build Schur style preconditioners
-                typename Unconstrained <Real,XX>::Functions::Identity I;
-                BlockDiagonalPreconditioner PAugSys_l(I,*(fns.PSchur_left));
-                BlockDiagonalPreconditioner PAugSys_r(I,*(fns.PSchur_right));
-
                 // Solve the augmented system for the tangential step 
                 std::tie(augsys_tang_err,augsys_tang_iter) =
-                    Optizelle::gmres <Real,XXxYY> (
-                        AugmentedSystem(state,fns,x),
+                    augsys_solve(
+                        fns,
+                        state,
+                        x,
                         b0,
-                        Real(1.), // This will be overwritten by the manipulator
-                        augsys_iter_max,
-                        augsys_rst_freq,
-                        PAugSys_l,
-                        PAugSys_r,
                         TangentialStepManipulator(state,fns),
-                        x0 
-                    );
+                        x0);
                 augsys_tang_iter_total += augsys_tang_iter;
                 augsys_iter_total += augsys_tang_iter;
                 auto augsys_failed = augsys_tang_err>augsys_tang_err_target;
@@ -8972,8 +11824,6 @@ namespace Optizelle{
                 ScalarValuedFunctionModifications <Real,XX> const & f_mod
                     = *(fns.f_mod);
                 X_Vector const & x=state.x;
-                Natural const & augsys_iter_max=state.augsys_iter_max;
-                Natural const & augsys_rst_freq=state.augsys_rst_freq;
                 X_Vector const & grad=state.grad;
                 Y_Vector & y=state.y;
                 auto const & augsys_lmh_err_target
@@ -9000,25 +11850,16 @@ namespace Optizelle{
                     X::scal(Real(-1.),b0.first);
                     Y::zero(b0.second);
 
-                // Build Schur style preconditioners
-                typename Unconstrained <Real,XX>::Functions::Identity I;
-                BlockDiagonalPreconditioner PAugSys_l(I,*(fns.PSchur_left));
-                BlockDiagonalPreconditioner PAugSys_r(I,*(fns.PSchur_right));
-
                 // Solve the augmented system for the initial equality 
                 // multiplier 
                 std::tie(augsys_lmh_err,augsys_lmh_iter) =
-                    Optizelle::gmres <Real,XXxYY> (
-                        AugmentedSystem(state,fns,x),
+                    augsys_solve(
+                        fns,
+                        state,
+                        x,
                         b0,
-                        Real(1.), // This will be overwritten by the manipulator
-                        augsys_iter_max,
-                        augsys_rst_freq,
-                        PAugSys_l,
-                        PAugSys_r,
                         EqualityMultiplierStepManipulator(state,fns),
-                        x0 
-                    );
+                        x0);
                 augsys_lmh_iter_total+=augsys_lmh_iter;
                 augsys_iter_total+=augsys_lmh_iter;
                 auto augsys_failed = augsys_lmh_err>augsys_lmh_err_target;
@@ -9040,8 +11881,6 @@ namespace Optizelle{
                     = *(fns.f_mod);
                 X_Vector const & grad=state.grad;
                 X_Vector const & dx=state.dx;
-                Natural const & augsys_iter_max=state.augsys_iter_max;
-                Natural const & augsys_rst_freq=state.augsys_rst_freq;
                 X_Vector & x=state.x;
                 Y_Vector & dy=state.dy;
                 auto const & augsys_lmh_err_target= state.augsys_lmh_err_target;
@@ -9076,11 +11915,6 @@ namespace Optizelle{
                     X::scal(Real(-1.),b0.first);
                     Y::zero(b0.second);
 
-                // Build Schur style preconditioners
-                typename Unconstrained <Real,XX>::Functions::Identity I;
-                BlockDiagonalPreconditioner PAugSys_l(I,*(fns.PSchur_left));
-                BlockDiagonalPreconditioner PAugSys_r(I,*(fns.PSchur_right));
-
                 // This is a somewhat unsatisfying hack.  Basically, many
                 // of our operators like the preconditioner need to know
                 // what the current iterate is.  Right now, we just have
@@ -9097,17 +11931,13 @@ namespace Optizelle{
 
                 // Solve the augmented system for the equality multiplier step 
                 std::tie(augsys_lmh_err,augsys_lmh_iter) =
-                    Optizelle::gmres <Real,XXxYY> (
-                        AugmentedSystem(state,fns,x),
+                    augsys_solve(
+                        fns,
+                        state,
+                        x,
                         b0,
-                        Real(1.), // This will be overwritten by the manipulator
-                        augsys_iter_max,
-                        augsys_rst_freq,
-                        PAugSys_l,
-                        PAugSys_r,
                         EqualityMultiplierStepManipulator(state,fns),
-                        x0 
-                    );
+                        x0);
                 augsys_lmh_iter_total+=augsys_lmh_iter;
                 augsys_iter_total+=augsys_lmh_iter;
                 auto augsys_failed = augsys_lmh_err>augsys_lmh_err_target;
@@ -9716,6 +12546,10 @@ namespace Optizelle{
                     case OptimizationLocation::AfterStepBeforeGradient:
                         // Make sure we update our cached value of g(x) 
                         g.eval(x,g_x);
+
+                        // Update our approximation of g'(x) from the step
+                        // and the change in g
+                        augsys_broyden_update(fns,x,g_x);
                         break;
 
                     case OptimizationLocation::AfterGradient:
@@ -9739,6 +12573,16 @@ namespace Optizelle{
                 }
             };
 
+            // Checks whether the iterate that we carried over from a related
+            // problem is a valid starting point for this one.  Without
+            // inequality constraints, any iterate works.
+            static bool warmStartFeasible(
+                typename Functions::t const &,
+                typename State::t const &
+            ) {
+                return true;
+            }
+
             // Solves an optimization problem where the user doesn't know about
             // the state manipulator
             static void getMin(
@@ -9804,9 +12648,9 @@ namespace Optizelle{
         NO_CONSTRUCTORS(InequalityConstrained)
 
         // Create some shortcuts for some type names
-        typedef XX <Real> X;
+        typedef Profile::Timed <XX <Real> > X;
         typedef typename X::Vector X_Vector;
-        typedef ZZ <Real> Z;
+        typedef Profile::Timed <ZZ <Real> > Z;
         typedef typename Z::Vector Z_Vector;
 
         // Routines that manipulate the internal state of the optimization 
@@ -9839,6 +12683,11 @@ namespace Optizelle{
                 // factorization.
                 Z_Vector h_x;
 
+                // Target for the complementarity h(x) o z in the Newton
+                // system.  Without a corrector, this is mu e.  Only used
+                // by the Mehrotra scheme.
+                Z_Vector comp_target;
+
                 // Interior point parameter
                 Real mu;
 
@@ -9862,6 +12711,13 @@ namespace Optizelle{
                 // of the inequality multiplier
                 Real alpha_z;
 
+                // Scheme for updating the interior point parameter
+                InteriorPointScheme::t ip_scheme;
+
+                // Scaling for the linearization of the complementarity
+                // conditions
+                InteriorPointScaling::t ip_scaling;
+
                 // Function diagnostics on h
                 FunctionDiagnostics::t h_diag;
 
@@ -9885,6 +12741,11 @@ namespace Optizelle{
                         Z::init(z_user)
                         //---h_x1---
                     ),
+                    comp_target(
+                        //---comp_target0---
+                        Z::init(z_user)
+                        //---comp_target1---
+                    ),
                     mu(
                         //---mu0---
                         1.0
@@ -9920,6 +12781,16 @@ namespace Optizelle{
                         std::numeric_limits <Real>::quiet_NaN() 
                         //---alpha_z1---
                     ),
+                    ip_scheme(
+                        //---ip_scheme0---
+                        InteriorPointScheme::FixedReduction
+                        //---ip_scheme1---
+                    ),
+                    ip_scaling(
+                        //---ip_scaling0---
+                        InteriorPointScaling::Unscaled
+                        //---ip_scaling1---
+                    ),
                     h_diag(
                         //---h_diag0---
                         FunctionDiagnostics::NoDiagnostics
@@ -9932,6 +12803,7 @@ namespace Optizelle{
                     )
                 {
                         Z::copy(z_user,z);
+                        Z::zero(comp_target);
                 }
                 
                 // A trick to allow dynamic casting later
@@ -9954,6 +12826,10 @@ namespace Optizelle{
                     //---h_x_valid0---
                     // Any
                     //---h_x_valid1---
+                    
+                    //---comp_target_valid0---
+                    // Any
+                    //---comp_target_valid1---
                 
                 // Check that the interior point parameter is positive
                 if(!(
@@ -10016,6 +12892,14 @@ namespace Optizelle{
                     // Any
                     //---alpha_z_valid1---
                     
+                    //---ip_scheme_valid0---
+                    // Any
+                    //---ip_scheme_valid1---
+                    
+                    //---ip_scaling_valid0---
+                    // Any
+                    //---ip_scaling_valid1---
+                    
                     //---h_diag_valid0---
                     // Any
                     //---h_diag_valid1---
@@ -10078,6 +12962,10 @@ namespace Optizelle{
                 typename RestartPackage <std::string>::tuple const & item
             ){
                 if( Unconstrained <Real,XX>::Restart::is_param(item) ||
+                    (item.first=="ip_scheme" &&
+                        InteriorPointScheme::is_valid(item.second)) ||
+                    (item.first=="ip_scaling" &&
+                        InteriorPointScaling::is_valid(item.second)) ||
                     (item.first=="h_diag" &&
                         FunctionDiagnostics::is_valid(item.second)) ||
                     (item.first=="z_diag" &&
@@ -10104,7 +12992,8 @@ namespace Optizelle{
             ) {
                 if( item.first == "z" ||
                     item.first == "dz" ||
-                    item.first == "h_x"
+                    item.first == "h_x" ||
+                    item.first == "comp_target"
                 )
                     return true;
                 else
@@ -10140,6 +13029,7 @@ namespace Optizelle{
                 zs.emplace_back("z",std::move(state.z));
                 zs.emplace_back("dz",std::move(state.dz));
                 zs.emplace_back("h_x",std::move(state.h_x));
+                zs.emplace_back("comp_target",std::move(state.comp_target));
             }
             
             // Copy out the scalar information
@@ -10159,6 +13049,10 @@ namespace Optizelle{
                 reals.emplace_back("alpha_z",std::move(state.alpha_z));
 
                 // Copy in all of the parameters
+                params.emplace_back("ip_scheme",
+                    InteriorPointScheme::to_string(state.ip_scheme));
+                params.emplace_back("ip_scaling",
+                    InteriorPointScaling::to_string(state.ip_scaling));
                 params.emplace_back("h_diag",
                     FunctionDiagnostics::to_string(state.h_diag));
                 params.emplace_back("z_diag",
@@ -10181,6 +13075,8 @@ namespace Optizelle{
                         state.dz = std::move(item->second);
                     else if(item->first=="h_x")
                         state.h_x = std::move(item->second);
+                    else if(item->first=="comp_target")
+                        state.comp_target = std::move(item->second);
                 }
             }
             
@@ -10217,7 +13113,13 @@ namespace Optizelle{
                     item!=params.end();
                     item++
                 ){
-                    if(item->first=="h_diag")
+                    if(item->first=="ip_scheme")
+                        state.ip_scheme=InteriorPointScheme::from_string(
+                            item->second);
+                    else if(item->first=="ip_scaling")
+                        state.ip_scaling=InteriorPointScaling::from_string(
+                            item->second);
+                    else if(item->first=="h_diag")
                         state.h_diag=FunctionDiagnostics::from_string(
                             item->second);
                     else if(item->first=="z_diag")
@@ -10275,6 +13177,83 @@ namespace Optizelle{
                 // Check that we have a valid state 
                 State::check(state);
             }
+
+            // Pieces of a solved state that we carry over to the next problem
+            // in a sequence of related problems
+            struct Warm {
+                // Pieces of the state that we carry over.  See WarmStart.
+                Natural items;
+
+                // The pieces themselves
+                X_Vectors xs;
+                Z_Vectors zs;
+                Reals reals;
+
+                // Start with nothing
+                Warm() : items(0), xs(), zs(), reals() {}
+            };
+
+            // Copies the pieces of the state that items selects into warm
+            static void warmRelease(
+                Natural const & items,
+                typename State::t & state,
+                Warm & warm
+            ) {
+                // Release the state
+                X_Vectors xs;
+                Z_Vectors zs;
+                Reals reals;
+                Naturals nats;
+                Params params;
+                InequalityConstrained <Real,XX,ZZ>
+                    ::Restart::release(state,xs,zs,reals,nats,params);
+
+                // Copy out the pieces that we carry over
+                auto select = [&](std::string const & name) {
+                    return WarmStart::is_selected(items,name);
+                };
+                warm.items = items;
+                warm.xs.clear();
+                warm.zs.clear();
+                warm.reals.clear();
+                Utility::copyVectors <X> (select,xs,warm.xs);
+                Utility::copyVectors <Z> (select,zs,warm.zs);
+                Utility::copyScalars <Real> (select,reals,warm.reals);
+
+                // Put the state back together
+                InequalityConstrained <Real,XX,ZZ>
+                    ::Restart::capture(state,xs,zs,reals,nats,params);
+            }
+
+            // Replaces the pieces of the state with those in warm
+            static void warmCapture(
+                Warm const & warm,
+                typename State::t & state
+            ) {
+                // Release the state
+                X_Vectors xs;
+                Z_Vectors zs;
+                Reals reals;
+                Naturals nats;
+                Params params;
+                InequalityConstrained <Real,XX,ZZ>
+                    ::Restart::release(state,xs,zs,reals,nats,params);
+
+                // Swap in the pieces that we carry over
+                auto select = [&](std::string const & name) {
+                    return WarmStart::is_selected(warm.items,name);
+                };
+                Utility::removeItems <X_Vector> (select,xs);
+                Utility::removeItems <Z_Vector> (select,zs);
+                Utility::removeItems <Real> (select,reals);
+                Utility::copyVectors <X> (select,warm.xs,xs);
+                Utility::copyVectors <Z> (select,warm.zs,zs);
+                Utility::copyScalars <Real> (select,warm.reals,reals);
+
+                // Put the state back together
+                InequalityConstrained <Real,XX,ZZ>
+                    ::Restart::capture(state,xs,zs,reals,nats,params);
+            }
         };
         
         // All the functions required by an optimization algorithm.  Note, this
@@ -10322,6 +13301,15 @@ namespace Optizelle{
 
                 // Inequality constraint evaluated at x
                 Z_Vector const & h_x;
+
+                // Target for the complementarity h(x) o z
+                Z_Vector const & comp_target;
+
+                // Scheme for updating the interior point parameter
+                InteriorPointScheme::t const & ip_scheme;
+
+                // Scaling for the linearization of the complementarity
+                InteriorPointScaling::t const & ip_scaling;
                 
                 // Some workspace for the below functions
                 mutable X_Vector grad_tmp;
@@ -10340,6 +13328,9 @@ namespace Optizelle{
                 mutable std::pair <bool,Z_Vector> z_schur;
                 mutable X_Vector hpxsz;
                 mutable X_Vector hpxs_invLhx_e;
+                mutable std::pair <bool,Z_Vector> hx_nt;
+                mutable std::pair <bool,Z_Vector> z_nt;
+                mutable Z_Vector w_nt;
 
                 // Adds the Lagrangian pieces to the gradient
                 void grad_lag(
@@ -10351,9 +13342,11 @@ namespace Optizelle{
                     X::copy(grad,grad_lag);
                     
                     // If relative error between the current and cached values
-                    // is large, compute anew.
-                    if( rel_err_cached <Real,XX> (x,x_lag)
-                            >= std::numeric_limits <Real>::epsilon()*1e1 ||
+                    // is large, compute anew.  When h is affine, h'(x)*
+                    // doesn't depend on x, so we only check z.
+                    if( (!(h.is_affine() && x_lag.first) &&
+                            rel_err_cached <Real,XX> (x,x_lag)
+                                >= std::numeric_limits <Real>::epsilon()*1e1)||
                         rel_err_cached <Real,ZZ> (z,z_lag)
                             >= std::numeric_limits <Real>::epsilon()*1e1 
                     ) {
@@ -10379,6 +13372,20 @@ namespace Optizelle{
                 ) const {
                     // grad_schur <- grad f(x)
                     X::copy(grad,grad_schur);
+
+                    // When we use Mehrotra's scheme, the target for h(x) o z
+                    // changes every iteration, so we don't cache anything
+                    if(ip_scheme==InteriorPointScheme::Mehrotra) {
+                        // z_tmp2 <- inv(L(h(x))) comp_target
+                        Z::linv(h_x,comp_target,z_tmp2);
+
+                        // x_tmp1 <- h'(x)* (inv(L(h(x))) comp_target)
+                        h.ps(x,z_tmp2,x_tmp1);
+
+                        // grad_schur<- grad f(x) - h'(x)* (inv(L(h(x))) target)
+                        X::axpy(Real(-1.),x_tmp1,grad_schur);
+                        return;
+                    }
                     
                     // If relative error between the current and cached values
                     // is large, compute anew.
@@ -10387,11 +13394,8 @@ namespace Optizelle{
                         rel_err_cached <Real,ZZ> (z,z_schur)
                             >= std::numeric_limits <Real>::epsilon()*1e1
                     ) {
-                        // z_tmp1 <- e
-                        Z::id(z_tmp1);
-
                         // z_tmp2 <- inv(L(h(x))) e 
-                        Z::linv(h_x,z_tmp1,z_tmp2);
+                        Algorithms::applyLinvId(h_x,z_tmp2,z_tmp1);
 
                         // hpxs_invLhx_e <- h'(x)* (inv(L(h(x))) e)
                         h.ps(x,z_tmp2,hpxs_invLhx_e);
@@ -10419,6 +13423,9 @@ namespace Optizelle{
                     z(state.z),
                     mu(state.mu),
                     h_x(state.h_x),
+                    comp_target(state.comp_target),
+                    ip_scheme(state.ip_scheme),
+                    ip_scaling(state.ip_scaling),
                     grad_tmp(X::init(state.x)),
                     hess_mod(X::init(state.x)),
                     x_tmp1(X::init(state.x)),
@@ -10431,7 +13438,10 @@ namespace Optizelle{
                     x_schur(false,X::init(state.x)),
                     z_schur(false,Z::init(state.z)),
                     hpxsz(X::init(state.x)),
-                    hpxs_invLhx_e(X::init(state.x))
+                    hpxs_invLhx_e(X::init(state.x)),
+                    hx_nt(false,Z::init(state.z)),
+                    z_nt(false,Z::init(state.z)),
+                    w_nt(Z::init(state.z))
                 {}
 
                 // Merit function additions to the objective
@@ -10521,11 +13531,37 @@ namespace Optizelle{
                     // z_tmp1 <- h'(x) dx
                     h.p(x,dx,z_tmp1);
 
-                    // z_tmp2 <- h'(x) dx o z
-                    Z::prod(z_tmp1,z,z_tmp2);
+                    // With the Nesterov-Todd scaling, we replace
+                    // inv(L(h(x))) L(z) with the symmetric operator P(w)
+                    if(ip_scaling==InteriorPointScaling::NesterovTodd) {
+                        // The scaling point only changes with the iterate,
+                        // so find it once per h(x) and z
+                        if( rel_err_cached <Real,ZZ> (h_x,hx_nt)
+                                >= std::numeric_limits <Real>::epsilon()*1e1 ||
+                            rel_err_cached <Real,ZZ> (z,z_nt)
+                                >= std::numeric_limits <Real>::epsilon()*1e1
+                        ) {
+                            // w_nt <- w where P(w) h(x) = z
+                            Algorithms::findNesterovToddPoint(h_x,z,w_nt);
+
+                            // Cache the values
+                            hx_nt.first=true;
+                            Z::copy(h_x,hx_nt.second);
+                            z_nt.first=true;
+                            Z::copy(z,z_nt.second);
+                        }
+
+                        // z_tmp2 <- P(w) h'(x) dx
+                        Algorithms::applyNesterovTodd(w_nt,z_tmp1,z_tmp2);
+
+                        // H_dx = hess f(x) dx + h'(x)* (P(w) h'(x) dx)
+                        h.ps(x,z_tmp2,hess_mod);
+                        X::axpy(Real(1.),hess_mod,Hdx_step);
+                        return;
+                    }
 
-                    // linv_hx_hpx_prod_z <- inv(L(h(x))) (h'(x) dx o z) 
-                    Z::linv(h_x,z_tmp2,z_tmp1);
+                    // z_tmp1 <- inv(L(h(x))) (h'(x) dx o z) 
+                    Algorithms::applyLinvProd(h_x,z_tmp1,z,z_tmp1,z_tmp2);
 
                     // hess_mod <- h'(x)* (inv(L(h(x))) (h'(x) dx o z))
                     h.ps(x,z_tmp1,hess_mod);
@@ -10623,6 +13659,10 @@ namespace Optizelle{
                 auto & z=state.z;
                 auto & dz=state.dz;
 
+                // Mehrotra's scheme sets mu at the start of every iteration
+                if(state.ip_scheme==InteriorPointScheme::Mehrotra)
+                    return false;
+
                 // If mu satisfies the stopping criteria, stop trying to
                 // reduce the interior point parameter
                 if(std::fabs(mu-absrel(mu_typ)*eps_mu)<absrel(mu_typ)*eps_mu)
@@ -10695,6 +13735,10 @@ namespace Optizelle{
                 ) {
                     // Reduce mu;
                     mu *= sigma;
+
+                    // Since the barrier changed, so did the merit function
+                    Unconstrained <Real,XX>::Algorithms::
+                        resetNonmonotone(state);
                     
                     // If we're doing a log-barrier method, update our
                     // multiplier
@@ -10726,6 +13770,30 @@ namespace Optizelle{
                         + ", missing the inequality constraint definition");
             }
 
+            // Check that the interior point scheme and scaling make sense
+            // for the algorithm and vector space.  Mehrotra's predictor
+            // requires a Newton system, so we can't use it with a
+            // log-barrier method.
+            static void check_scheme(typename State::t const & state) {
+                if( state.ip_scheme==InteriorPointScheme::Mehrotra &&
+                    !Algorithms::usePrimalDual(state)
+                )
+                    throw Exception::t(__LOC__
+                        + ", the Mehrotra interior point scheme requires a "
+                        "trust-region or Newton-CG line-search algorithm");
+
+                // We can only scale when the vector space knows how to find
+                // the scaling point
+                if( state.ip_scaling==InteriorPointScaling::NesterovTodd &&
+                    !NesterovTodd <Real,ZZ>::available::value
+                )
+                    throw Exception::t(__LOC__
+                        + ", the Nesterov-Todd interior point scaling "
+                        "requires a vector space for the inequality "
+                        "constraints that specializes NesterovTodd, such as "
+                        "Rm or SQL");
+            }
+
             // Initialize any missing functions for just inequality constrained 
             // optimization.
             static void init_(
@@ -10734,6 +13802,10 @@ namespace Optizelle{
             ) {
                 // Check that all functions are defined 
                 check(fns);
+                check_scheme(state);
+
+                // Time the constraints
+                Profile::instrument(fns.h);
 
                 // Modify the objective 
                 fns.f_mod.reset(new InequalityModifications(
@@ -10813,6 +13885,8 @@ namespace Optizelle{
                     state,out);
                 InequalityConstrained<Real,XX,ZZ>::Diagnostics::getStateHeader_(
                     state,out);
+                Unconstrained <Real,XX>::Diagnostics::getProfileHeader_(
+                    state,out);
             }
 
             // Gets the state information for output
@@ -10887,6 +13961,8 @@ namespace Optizelle{
                     ::getState_(fns,state,blank,noiter,out);
                 InequalityConstrained <Real,XX,ZZ>::Diagnostics
                     ::getState_(fns,state,blank,out);
+                Unconstrained <Real,XX>::Diagnostics
+                    ::getProfile_(state,blank,out);
             }
             
             // Runs the specified function diagnostics 
@@ -11118,8 +14194,252 @@ namespace Optizelle{
             NO_CONSTRUCTORS(Algorithms)
 
 
-            // Finds the new inequality multiplier step
-            // dz = -z + inv L(h(x)) (-h'(x)dx o z + mu e)
+            // Finds the Nesterov-Todd scaling point w where P(w) h(x) = z
+            static void findNesterovToddPoint(
+                Z_Vector const & h_x,
+                Z_Vector const & z,
+                Z_Vector & w
+            ) {
+                findNesterovToddPoint(h_x,z,w,
+                    typename NesterovTodd <Real,ZZ>::available());
+            }
+            static void findNesterovToddPoint(
+                Z_Vector const & h_x,
+                Z_Vector const & z,
+                Z_Vector & w,
+                std::true_type
+            ) {
+                NesterovTodd <Real,ZZ>::point(h_x,z,w);
+            }
+            static void findNesterovToddPoint(
+                Z_Vector const &,
+                Z_Vector const &,
+                Z_Vector &,
+                std::false_type
+            ) {
+                throw Exception::t(__LOC__
+                    + ", the vector space doesn't specialize NesterovTodd");
+            }
+
+            // Applies the Nesterov-Todd scaling, y <- P(w) dz
+            static void applyNesterovTodd(
+                Z_Vector const & w,
+                Z_Vector const & dz,
+                Z_Vector & y
+            ) {
+                applyNesterovTodd(w,dz,y,
+                    typename NesterovTodd <Real,ZZ>::available());
+            }
+            static void applyNesterovTodd(
+                Z_Vector const & w,
+                Z_Vector const & dz,
+                Z_Vector & y,
+                std::true_type
+            ) {
+                NesterovTodd <Real,ZZ>::quad(w,dz,y);
+            }
+            static void applyNesterovTodd(
+                Z_Vector const &,
+                Z_Vector const &,
+                Z_Vector &,
+                std::false_type
+            ) {
+                throw Exception::t(__LOC__
+                    + ", the vector space doesn't specialize NesterovTodd");
+            }
+
+            // Finds y <- inv(L(h(x))) e.  When the vector space doesn't
+            // specialize InteriorPointFused, we compose the Jordan algebra
+            // operations and use z_tmp as a workspace.
+            static void applyLinvId(
+                Z_Vector const & h_x,
+                Z_Vector & y,
+                Z_Vector & z_tmp
+            ) {
+                applyLinvId(h_x,y,z_tmp,
+                    typename InteriorPointFused <Real,ZZ>::available());
+            }
+            static void applyLinvId(
+                Z_Vector const & h_x,
+                Z_Vector & y,
+                Z_Vector &,
+                std::true_type
+            ) {
+                InteriorPointFused <Real,ZZ>::linv_id(h_x,y);
+            }
+            static void applyLinvId(
+                Z_Vector const & h_x,
+                Z_Vector & y,
+                Z_Vector & z_tmp,
+                std::false_type
+            ) {
+                Z::id(z_tmp);
+                Z::linv(h_x,z_tmp,y);
+            }
+
+            // Finds y <- inv(L(h(x))) e when the caller has no workspace.  We
+            // only allocate one when we have to compose the operations.
+            static void applyLinvId(
+                Z_Vector const & h_x,
+                Z_Vector & y
+            ) {
+                applyLinvId(h_x,y,
+                    typename InteriorPointFused <Real,ZZ>::available());
+            }
+            static void applyLinvId(
+                Z_Vector const & h_x,
+                Z_Vector & y,
+                std::true_type
+            ) {
+                InteriorPointFused <Real,ZZ>::linv_id(h_x,y);
+            }
+            static void applyLinvId(
+                Z_Vector const & h_x,
+                Z_Vector & y,
+                std::false_type
+            ) {
+                auto z_tmp = Z::init(y);
+                applyLinvId(h_x,y,z_tmp,std::false_type());
+            }
+
+            // Finds y <- inv(L(h(x))) (dz o z) where y may be dz.  As above,
+            // z_tmp is a workspace for the composed operations.
+            static void applyLinvProd(
+                Z_Vector const & h_x,
+                Z_Vector const & dz,
+                Z_Vector const & z,
+                Z_Vector & y,
+                Z_Vector & z_tmp
+            ) {
+                applyLinvProd(h_x,dz,z,y,z_tmp,
+                    typename InteriorPointFused <Real,ZZ>::available());
+            }
+            static void applyLinvProd(
+                Z_Vector const & h_x,
+                Z_Vector const & dz,
+                Z_Vector const & z,
+                Z_Vector & y,
+                Z_Vector &,
+                std::true_type
+            ) {
+                InteriorPointFused <Real,ZZ>::linv_prod(h_x,dz,z,y);
+            }
+            static void applyLinvProd(
+                Z_Vector const & h_x,
+                Z_Vector const & dz,
+                Z_Vector const & z,
+                Z_Vector & y,
+                Z_Vector & z_tmp,
+                std::false_type
+            ) {
+                Z::prod(dz,z,z_tmp);
+                Z::linv(h_x,z_tmp,y);
+            }
+
+            // Finds y <- inv(L(h(x))) (dz o z) when the caller has no
+            // workspace
+            static void applyLinvProd(
+                Z_Vector const & h_x,
+                Z_Vector const & dz,
+                Z_Vector const & z,
+                Z_Vector & y
+            ) {
+                applyLinvProd(h_x,dz,z,y,
+                    typename InteriorPointFused <Real,ZZ>::available());
+            }
+            static void applyLinvProd(
+                Z_Vector const & h_x,
+                Z_Vector const & dz,
+                Z_Vector const & z,
+                Z_Vector & y,
+                std::true_type
+            ) {
+                InteriorPointFused <Real,ZZ>::linv_prod(h_x,dz,z,y);
+            }
+            static void applyLinvProd(
+                Z_Vector const & h_x,
+                Z_Vector const & dz,
+                Z_Vector const & z,
+                Z_Vector & y,
+                std::false_type
+            ) {
+                auto z_tmp = Z::init(z);
+                applyLinvProd(h_x,dz,z,y,z_tmp,std::false_type());
+            }
+
+            // Finds y <- y + mu inv(L(h(x))) e - z.  We only allocate
+            // workspace when we have to compose the operations.
+            static void applyLinvIdShift(
+                Z_Vector const & h_x,
+                Real const & mu,
+                Z_Vector const & z,
+                Z_Vector & y
+            ) {
+                applyLinvIdShift(h_x,mu,z,y,
+                    typename InteriorPointFused <Real,ZZ>::available());
+            }
+            static void applyLinvIdShift(
+                Z_Vector const & h_x,
+                Real const & mu,
+                Z_Vector const & z,
+                Z_Vector & y,
+                std::true_type
+            ) {
+                InteriorPointFused <Real,ZZ>::linv_id_shift(h_x,mu,z,y);
+            }
+            static void applyLinvIdShift(
+                Z_Vector const & h_x,
+                Real const & mu,
+                Z_Vector const & z,
+                Z_Vector & y,
+                std::false_type
+            ) {
+                auto z_tmp1 = Z::init(z);
+                auto z_tmp2 = Z::init(z);
+                Z::id(z_tmp1);
+                Z::scal(mu,z_tmp1);
+                Z::linv(h_x,z_tmp1,z_tmp2);
+                Z::axpy(Real(1.),z_tmp2,y);
+                Z::axpy(Real(-1.),z,y);
+            }
+
+            // Finds the change in the inequality multiplier that the
+            // linearized complementarity conditions give for a step dx with
+            // a zero target,
+            //
+            // dz_lin = -inv L(h(x)) (h'(x)dx o z)
+            //
+            // or, with the Nesterov-Todd scaling,
+            //
+            // dz_lin = -P(w) h'(x)dx
+            //
+            // where hp_dx = h'(x)dx.
+            static void findLinearizedMultiplierStep(
+                typename State::t const & state,
+                Z_Vector const & hp_dx,
+                Z_Vector & dz_lin
+            ) {
+                // Create some shortcuts
+                auto const & z=state.z;
+                auto const & h_x=state.h_x;
+
+                // dz_lin <- -P(w) h'(x)dx
+                if(state.ip_scaling==InteriorPointScaling::NesterovTodd) {
+                    auto w = Z::init(z);
+                    findNesterovToddPoint(h_x,z,w);
+                    applyNesterovTodd(w,hp_dx,dz_lin);
+
+                // dz_lin <- -inv L(h(x)) (h'(x)dx o z)
+                } else
+                    applyLinvProd(h_x,hp_dx,z,dz_lin);
+                Z::scal(Real(-1.),dz_lin);
+            }
+
+            // Finds the new inequality multiplier step
+            // dz = -z + inv L(h(x)) (-h'(x)dx o z + mu e)
+            //
+            // With the Nesterov-Todd scaling, this becomes
+            // dz = -z + inv L(h(x)) (mu e) - P(w) h'(x)dx
             static void findInequalityMultiplierStep(
                 typename Functions::t const & fns,
                 typename State::t & state
@@ -11130,6 +14450,7 @@ namespace Optizelle{
                 X_Vector const & x=state.x;
                 X_Vector const & dx=state.dx;
                 Real const & mu=state.mu;
+                Z_Vector const & comp_target=state.comp_target;
                 VectorValuedFunction <Real,XX,ZZ> const & h=*(fns.h);
                 Z_Vector & dz=state.dz;
 
@@ -11137,24 +14458,18 @@ namespace Optizelle{
                 Z_Vector z_tmp1(Z::init(z));
                 h.p(x,dx,z_tmp1);
 
-                // z_tmp2 <- h'(x)dx o z
-                Z_Vector z_tmp2(Z::init(z));
-                Z::prod(z_tmp1,z,z_tmp2);
-
-                // z_tmp2 <- -h'(x)dx o z
-                Z::scal(Real(-1.),z_tmp2);
-
-                // z_tmp1 <- e
-                Z::id(z_tmp1);
-
-                // z_tmp2 <- -h'(x)dx o z + mu e
-                Z::axpy(mu,z_tmp1,z_tmp2);
-
-                // dz <- inv L(h(x)) (-h'(x)dx o z + mu e)
-                Z::linv(h_x,z_tmp2,dz);
-
-                // dz <- -z + inv L(h(x)) (-h'(x)dx o z + mu e)
-                Z::axpy(Real(-1.),z,dz);
+                // dz <- -inv L(h(x)) (h'(x)dx o z)
+                findLinearizedMultiplierStep(state,z_tmp1,dz);
+
+                // dz <- -z + inv L(h(x)) (-h'(x)dx o z + mu e).  For
+                // Mehrotra's scheme, the target also contains the corrector,
+                // so we use it instead of mu e.
+                if(state.ip_scheme==InteriorPointScheme::Mehrotra) {
+                    Z::linv(h_x,comp_target,z_tmp1);
+                    Z::axpy(Real(1.),z_tmp1,dz);
+                    Z::axpy(Real(-1.),z,dz);
+                } else
+                    applyLinvIdShift(h_x,mu,z,dz);
                 
                 // Symmetrize the direction
                 Z::symm(dz);
@@ -11179,17 +14494,93 @@ namespace Optizelle{
                 Real const & mu=state.mu;
                 Z_Vector & z=state.z;
 
-                // z_tmp1 <- e
-                auto e = Z::init(z);
-                Z::id(e);
-
                 // z <- inv(L(h(x))) e
-                Z::linv(h_x,e,z);
+                applyLinvId(h_x,z);
 
                 // z <- mu inv(L(h(x))) e
                 Z::scal(mu,z);
             }
            
+            // Checks whether the iterate that we carried over from a related
+            // problem lies strictly inside the cone for this one.  If not, the
+            // multiplier and interior point parameter from the prior solution
+            // don't give a valid starting point.  Since e lies inside the
+            // cone, h(x) does as well exactly when we can step past h(x) on
+            // the ray from e through h(x).
+            static bool warmStartFeasible(
+                typename Functions::t const & fns,
+                typename State::t const & state
+            ) {
+                // Create some shortcuts
+                auto const & h=*(fns.h);
+                auto const & x=state.x;
+
+                // h_x <- h(x) - e
+                auto h_x = Z::init(state.h_x);
+                h.eval(x,h_x);
+                auto e = Z::init(h_x);
+                Z::id(e);
+                Z::axpy(Real(-1.),e,h_x);
+
+                // Check that e + alpha (h(x) - e) lies in the cone for some
+                // alpha > 1
+                return Z::srch(h_x,e) > Real(1.);
+            }
+
+            // Safeguards an inequality multiplier and interior point parameter
+            // that we carried over from the solution of a related problem.
+            // Since h(x) changed, the prior z may lie on or past the boundary
+            // and the prior mu may be far smaller than the complementarity of
+            // this problem.  First, we raise mu to this complementarity,
+            //
+            // mu <- max(mu, <h(x),z> / <e,e>).
+            //
+            // Then, we move z toward the log-barrier multiplier
+            // zc = mu inv(L(h(x))) e,
+            //
+            // z <- zc + alpha (z - zc),
+            //
+            // where alpha = min(1, gamma srch(z - zc, zc)).  In other words,
+            // we keep z when it lies well inside the cone and otherwise apply
+            // the fraction to the boundary rule.
+            static void warmStartInequalityMultiplier(
+                typename Functions::t const & fns,
+                typename State::t & state
+            ) {
+                // Create some shortcuts
+                auto const & h_x=state.h_x;
+                auto const & gamma=state.gamma;
+                auto const & mu_est=state.mu_est;
+                auto & mu=state.mu;
+                auto & z=state.z;
+
+                // mu <- max(mu, <h(x),z> / <e,e>)
+                estimateInteriorPointParameter(fns,state);
+                mu = std::max(mu,mu_est);
+
+                // Any merit values from the previous solve used another
+                // barrier
+                Unconstrained <Real,XX>::Algorithms::resetNonmonotone(state);
+
+                // zc <- mu inv(L(h(x))) e
+                auto zc = Z::init(z);
+                applyLinvId(h_x,zc);
+                Z::scal(mu,zc);
+
+                // z_tmp <- z - zc
+                auto z_tmp = Z::init(z);
+                Z::copy(z,z_tmp);
+                Z::axpy(Real(-1.),zc,z_tmp);
+
+                // z <- zc + alpha (z - zc)
+                auto alpha = std::min(Real(1.),gamma*Z::srch(z_tmp,zc));
+                Z::copy(zc,z);
+                Z::axpy(alpha,z_tmp,z);
+
+                // Update the estimate of the interior point parameter
+                estimateInteriorPointParameter(fns,state);
+            }
+
             // Assume that dz has already been calculated.  Truncate the step
             // in order to insure that our fraction to the boundary rule has
             // been satisfied
@@ -11242,6 +14633,171 @@ namespace Optizelle{
                 // Estimate the interior-point parameter
                 mu_est = Z::innr(z,h_x) / m;
             }
+
+            // Sets the interior point parameter and the complementarity
+            // target with Mehrotra's predictor-corrector scheme.  First, we
+            // find the affine-scaling step, which solves the Newton system
+            // with a zero target for h(x) o z,
+            //
+            // H dx_aff = -grad f(x)
+            // dz_aff = -z + inv L(h(x)) (-h'(x)dx_aff o z)
+            //
+            // Then, we find the complementarity that this step would achieve
+            // if we moved as far as we could toward the boundary,
+            //
+            // mu_aff = <h(x) + alpha_p h'(x)dx_aff, z + alpha_d dz_aff> / m
+            //
+            // and center with sigma = (mu_aff / mu_est)^3.  Finally, we add
+            // the second-order corrector, so that the target becomes
+            //
+            // mu e - alpha_p alpha_d h'(x)dx_aff o dz_aff.
+            //
+            // Note, we globalize the step with the barrier merit function,
+            // f(x) - mu barr(h(x)), so we scale the corrector by the step
+            // lengths.  Otherwise, a long affine-scaling step far from the
+            // solution gives a corrector that overwhelms the barrier term and
+            // the model no longer agrees with the merit function.
+            static void findMehrotraTarget(
+                typename Functions::t const & fns,
+                typename State::t & state
+            ) {
+                // Create some shortcuts
+                auto const & f_mod = *(fns.f_mod);
+                auto const & absrel = *(fns.absrel);
+                Operator <Real,XX,XX> const & PH=*(fns.PH);
+                VectorValuedFunction <Real,XX,ZZ> const & h=*(fns.h);
+                auto const & x=state.x;
+                auto const & grad=state.grad;
+                auto const & z=state.z;
+                auto const & h_x=state.h_x;
+                auto const & mu_est=state.mu_est;
+                auto const & mu_typ=state.mu_typ;
+                auto const & eps_mu=state.eps_mu;
+                auto const & sigma=state.sigma;
+                auto const & norm_gradtyp=state.norm_gradtyp;
+                auto const & eps_trunc=state.eps_trunc;
+                auto const & trunc_iter_max=state.trunc_iter_max;
+                auto const & trunc_orthog_storage_max
+                    = state.trunc_orthog_storage_max;
+                auto const & trunc_orthog_iter_max
+                    = state.trunc_orthog_iter_max;
+                auto const & safeguard_failed_max = state.safeguard_failed_max;
+                auto const & trunc_forcing = state.trunc_forcing;
+                auto & mu=state.mu;
+                auto & comp_target=state.comp_target;
+
+                // Find the gradient of the affine-scaling system, which has
+                // a zero complementarity target
+                Z::zero(comp_target);
+                auto minus_grad = X::init(x);
+                f_mod.grad_step(x,grad,minus_grad);
+                X::scal(Real(-1.),minus_grad);
+
+                // Solve for the affine-scaling step without a trust-region
+                // or safeguard since we only use it to predict the
+                // complementarity
+                typename Unconstrained <Real,XX>::Algorithms::HessianOperator
+                    H(fns,x);
+                auto simplified_safeguard =
+                    SafeguardSimplified <Real,XX>(std::bind(
+                        Safeguard <Real,XX> (
+                            Unconstrained <Real,XX>::Functions::noSafeguard),
+                        std::placeholders::_1,
+                        std::placeholders::_2,
+                        Real(1.)));
+                auto x_offset = X::init(x);
+                X::zero(x_offset);
+                auto dx_aff = X::init(x);
+                auto dx_cp = X::init(x);
+                auto residual_err0 = std::numeric_limits <Real>::quiet_NaN();
+                auto residual_err = std::numeric_limits <Real>::quiet_NaN();
+                auto iter = Natural(0);
+                auto stop = TruncatedStop::NotConverged;
+                auto safeguard_failed = Natural(0);
+                auto alpha_safeguard = Real(0.);
+                truncated_cg(
+                    H,
+                    minus_grad,
+                    PH,
+                    eps_trunc,
+                    Unconstrained <Real,XX>::Algorithms
+                        ::nash_sofer_tolerance(trunc_forcing),
+                    trunc_iter_max,
+                    trunc_orthog_storage_max,
+                    trunc_orthog_iter_max,
+                    std::numeric_limits <Real>::infinity(),
+                    x_offset,
+                    safeguard_failed_max,
+                    simplified_safeguard,
+                    false,
+                    true,
+                    true,
+                    dx_aff,
+                    dx_cp,
+                    residual_err0,
+                    residual_err,
+                    iter,
+                    stop,
+                    safeguard_failed,
+                    alpha_safeguard);
+
+                // hp_dxaff <- h'(x)dx_aff
+                auto hp_dxaff = Z::init(z);
+                h.p(x,dx_aff,hp_dxaff);
+
+                // dz_aff <- -z + inv L(h(x)) (-h'(x)dx_aff o z)
+                auto dz_aff = Z::init(z);
+                findLinearizedMultiplierStep(state,hp_dxaff,dz_aff);
+                Z::axpy(Real(-1.),z,dz_aff);
+                Z::symm(dz_aff);
+
+                // Find how far we can move toward the boundary
+                auto alpha_p = std::min(Real(1.),Z::srch(hp_dxaff,h_x));
+                auto alpha_d = std::min(Real(1.),Z::srch(dz_aff,z));
+
+                // mu_aff <- <h(x) + alpha_p h'(x)dx_aff, z + alpha_d dz_aff>/m
+                auto h_aff = Z::init(z);
+                Z::copy(h_x,h_aff);
+                Z::axpy(alpha_p,hp_dxaff,h_aff);
+                auto z_aff = Z::init(z);
+                Z::copy(z,z_aff);
+                Z::axpy(alpha_d,dz_aff,z_aff);
+                auto e = Z::init(z);
+                Z::id(e);
+                auto m = Z::innr(e,e);
+                auto mu_aff = Z::innr(h_aff,z_aff) / m;
+
+                // Center based on how much the affine-scaling step reduces
+                // the complementarity.  So that the complementarity doesn't
+                // get ahead of stationarity, which jams the iterates against
+                // the boundary, we bound the centering below by the relative
+                // size of the gradient, but never by more than sigma.  This
+                // floor vanishes as we converge, so we then center with
+                // sigma_aff alone.  We also don't reduce mu below the
+                // interior point stopping tolerance.
+                if(mu_est > Real(0.)) {
+                    auto sigma_aff = std::min(Real(1.),
+                        std::pow(std::max(mu_aff,Real(0.))/mu_est,Real(3.)));
+                    auto grad_stop = X::init(x);
+                    f_mod.grad_stop(x,grad,grad_stop);
+                    auto sigma_min = std::min(sigma,
+                        std::sqrt(X::innr(grad_stop,grad_stop))
+                            / absrel(norm_gradtyp));
+                    auto mu_old = mu;
+                    mu = std::max(std::max(sigma_aff,sigma_min)*mu_est,
+                        absrel(mu_typ)*eps_mu);
+
+                    // Changing mu changes the barrier merit function
+                    if(mu != mu_old)
+                        Unconstrained <Real,XX>::Algorithms::
+                            resetNonmonotone(state);
+                }
+
+                // comp_target <- mu e - alpha_p alpha_d h'(x)dx_aff o dz_aff
+                Z::prod(hp_dxaff,dz_aff,comp_target);
+                Z::scal(-alpha_p*alpha_d,comp_target);
+                Z::axpy(mu,e,comp_target);
+            }
            
             // Adjust the stopping conditions unless the criteria below are
             // satisfied.
@@ -11290,6 +14846,9 @@ namespace Optizelle{
                 typename Functions::t const & fns,
                 typename State::t & state
             ) {
+                // Charge the search to the line-search phase
+                Profile::Timer timer(Profile::LineSearch);
+
                 // Create some shortcuts 
                 Real const & gamma=state.gamma;
                 AlgorithmClass::t const & algorithm_class
@@ -11408,6 +14967,9 @@ namespace Optizelle{
                 typename Functions::t const & fns,
                 typename State::t & state
             ) {
+                // Charge the search to the line-search phase
+                Profile::Timer timer(Profile::LineSearch);
+
                 // Create some shortcuts 
                 Real const & gamma=state.gamma;
                 Real const & mu=state.mu;
@@ -11523,6 +15085,9 @@ namespace Optizelle{
                 typename Functions::t const & fns,
                 typename State::t & state
             ) {
+                // Charge the search to the line-search phase
+                Profile::Timer timer(Profile::LineSearch);
+
                 // Create some shortcuts 
                 Real const & gamma=state.gamma;
                 AlgorithmClass::t const & algorithm_class
@@ -11631,6 +15196,17 @@ namespace Optizelle{
 
                         // Initialize the value h(x)
                         h.eval(x,h_x);
+
+                        // When we warm start from a related problem, we
+                        // already have z and mu_typ, so we just move them
+                        // back into the interior.  Since mu_typ is NaN until
+                        // we set it, this doesn't trigger on a cold start.
+                        // Continuation only keeps these when h(x) lies
+                        // strictly inside the cone, which we require below.
+                        if(state.iter==1 && mu_typ > Real(0.)) {
+                            warmStartInequalityMultiplier(fns,state);
+                            break;
+                        }
             
                         // Find the initial inequality multiplier.  Currently,
                         // we choose our initial z to be what it would be
@@ -11644,6 +15220,15 @@ namespace Optizelle{
                         mu_typ=mu_est;
                         break;
 
+                    case OptimizationLocation::BeginningOfOptimizationLoop:
+                        // Predict the interior point parameter and the
+                        // corrector for this iteration
+                        if( state.ip_scheme==InteriorPointScheme::Mehrotra &&
+                            usePrimalDual(state)
+                        )
+                            findMehrotraTarget(fns,state);
+                        break;
+
                     case OptimizationLocation::BeforeLineSearch:
                     case OptimizationLocation::BeforeActualVersusPredicted:
                         if(usePrimalDual(state)) {
@@ -11753,40 +15338,41 @@ namespace Optizelle{
     };
         
     // Routines that manipulate and support problems of the form
-    // problem of the form
-    // 
-    // min_{x \in X} f(x) st g(x) = 0, h(x) >=_K 0
     //
-    // where f : X -> R, g : X -> Y, and h : X -> Z
+    // min_{x \in X} f(x) st x_lo <= x <= x_hi
+    //
+    // where f : X -> R.  Although we can write these bounds as the inequality
+    // constraint h(x) = [x-x_lo;x_hi-x] >= 0, doing so doubles the size of
+    // the variables, requires an inequality multiplier, and routes every
+    // bound through the virtual calls to h.  Instead, we use the affine
+    // scaling method of Coleman and Li, which keeps x strictly inside the
+    // bounds and only needs the fused kernels in Bounds <Real,XX>.
     template <
         typename Real,
-        template <typename> class XX,
-        template <typename> class YY,
-        template <typename> class ZZ
-    > 
-    struct Constrained {
+        template <typename> class XX
+    >
+    struct BoundConstrained {
         // Disallow constructors
-        NO_CONSTRUCTORS(Constrained)
+        NO_CONSTRUCTORS(BoundConstrained)
 
         // Create some shortcuts for some type names
-        typedef XX <Real> X;
+        typedef Profile::Timed <XX <Real> > X;
         typedef typename X::Vector X_Vector;
-        typedef YY <Real> Y;
-        typedef typename Y::Vector Y_Vector;
-        typedef ZZ <Real> Z;
-        typedef typename Z::Vector Z_Vector;
+        typedef Optizelle::Bounds <Real,XX> B;
 
-        // Routines that manipulate the internal state of the optimization 
+        // We require the vector space to know how to handle bounds
+        static_assert(B::available::value,
+            "Bound constrained problems require a vector space that "
+            "specializes Bounds, such as Rm");
+
+        // Routines that manipulate the internal state of the optimization
         // algorithm.
         struct State {
             // Disallow constructors
             NO_CONSTRUCTORS(State)
-            
+
             // Internal state of the optimization
-            struct t: 
-                public EqualityConstrained <Real,XX,YY>::State::t,
-                public InequalityConstrained <Real,XX,ZZ>::State::t
-            {
+            struct t: public virtual Unconstrained <Real,XX>::State::t {
                 // Prevent the use of the copy constructor and the assignment
                 // operator.  Basically, the state can hold a large amount
                 // of memory and the safe way to move this memory around
@@ -11794,35 +15380,992 @@ namespace Optizelle{
                 // inside of the restart section.
                 NO_DEFAULT_COPY_ASSIGNMENT(t)
 
+                // Lower bound on the variables.  Elements may be -infinity.
+                X_Vector x_lo;
+
+                // Upper bound on the variables.  Elements may be infinity.
+                X_Vector x_hi;
+
+                // How close we move to the boundary during a single step
+                Real gamma;
+
+                // How far we push the starting point into the interior of
+                // the bounds relative to the size of each bound
+                Real bound_push;
+
                 // Initialization constructors
-                explicit t(
-                    X_Vector const & x,Y_Vector const & y,Z_Vector const & z
-                ) : Unconstrained <Real,XX>::State::t(x), 
-                    EqualityConstrained <Real,XX,YY>::State::t(x,y),
-                    InequalityConstrained <Real,XX,ZZ>::State::t(x,z)
-                {}
+                t(
+                    X_Vector const & x_user,
+                    X_Vector const & x_lo_user,
+                    X_Vector const & x_hi_user
+                ) :
+                    Unconstrained <Real,XX>::State::t(x_user),
+                    x_lo(
+                        //---x_lo0---
+                        X::init(x_user)
+                        //---x_lo1---
+                    ),
+                    x_hi(
+                        //---x_hi0---
+                        X::init(x_user)
+                        //---x_hi1---
+                    ),
+                    gamma(
+                        //---gamma0---
+                        0.99
+                        //---gamma1---
+                    ),
+                    bound_push(
+                        //---bound_push0---
+                        1e-2
+                        //---bound_push1---
+                    )
+                {
+                        X::copy(x_lo_user,x_lo);
+                        X::copy(x_hi_user,x_hi);
+                }
+
+                // A trick to allow dynamic casting later
+                virtual ~t() {}
             };
-            
+
             // Check that we have a valid set of parameters.
-            static void check(t const & state) {
-                Unconstrained <Real,XX>::State::check_(state);
-                EqualityConstrained <Real,XX,YY>::State::check_(state);
-                InequalityConstrained <Real,XX,ZZ>::State::check_(state);
-            }
-        };
-        
-        // Utilities for restarting the optimization
-        struct Restart {
-            // Disallow constructors
-            NO_CONSTRUCTORS(Restart)
-       
-            // Create some type shortcuts 
-            typedef typename RestartPackage <Real>::t Reals;
-            typedef typename RestartPackage <Natural>::t Naturals;
-            typedef typename RestartPackage <std::string>::t Params;
-            typedef typename RestartPackage <X_Vector>::t X_Vectors;
-            typedef typename RestartPackage <Y_Vector>::t Y_Vectors;
-            typedef typename RestartPackage <Z_Vector>::t Z_Vectors;
+            static void check_(t const & state) {
+                // Use this to build an error message
+                std::stringstream ss;
+
+                // Check that the bounds leave room for an interior
+                if(!(
+                    //---x_lo_valid0---
+                    B::valid(state.x_lo,state.x_hi)
+                    //---x_lo_valid1---
+                ))
+                    ss << "The lower bounds must lie strictly below the "
+                        "upper bounds";
+
+                    //---x_hi_valid0---
+                    // Any
+                    //---x_hi_valid1---
+
+                // Check that the fraction to the boundary is between 0 and 1.
+                else if(!(
+                    //---gamma_valid0---
+                    state.gamma > Real(0.) && state.gamma < Real(1.)
+                    //---gamma_valid1---
+                ))
+                    ss << "The fraction to the boundary must be between "
+                        "0 and 1: gamma = " << state.gamma;
+
+                // Check that the push into the interior stays inside the
+                // bounds
+                else if(!(
+                    //---bound_push_valid0---
+                    state.bound_push > Real(0.) && state.bound_push < Real(.5)
+                    //---bound_push_valid1---
+                ))
+                    ss << "The push into the interior of the bounds must be "
+                        "between 0 and 1/2: bound_push = " << state.bound_push;
+
+                // If there's an error, print it
+                if(ss.str()!="")
+                    throw Exception::t(__LOC__ + ", " + ss.str());
+            }
+            static void check(t const & state) {
+                Unconstrained <Real,XX>::State::check_(state);
+                BoundConstrained <Real,XX>::State::check_(state);
+            }
+        };
+
+        // Utilities for restarting the optimization
+        struct Restart {
+            // Disallow constructors
+            NO_CONSTRUCTORS(Restart)
+
+            // Create some type shortcuts
+            typedef typename RestartPackage <Real>::t Reals;
+            typedef typename RestartPackage <Natural>::t Naturals;
+            typedef typename RestartPackage <std::string>::t Params;
+            typedef typename RestartPackage <X_Vector>::t X_Vectors;
+
+            // Checks whether we have a valid real
+            static bool is_real(
+                typename RestartPackage <Real>::tuple const & item
+            ) {
+                if( Unconstrained <Real,XX>::Restart::is_real(item) ||
+                    item.first == "gamma" ||
+                    item.first == "bound_push"
+                )
+                    return true;
+                else
+                    return false;
+            }
+
+            // Checks whether we have a valid natural number
+            static bool is_nat(
+                typename RestartPackage <Natural>::tuple const & item
+            ) {
+                if( Unconstrained <Real,XX>::Restart::is_nat(item))
+                    return true;
+                else
+                    return false;
+            }
+
+            // Checks whether we have a valid parameter
+            static bool is_param(
+                typename RestartPackage <std::string>::tuple const & item
+            ){
+                if( Unconstrained <Real,XX>::Restart::is_param(item))
+                    return true;
+                else
+                    return false;
+            }
+
+            // Checks whether we have a valid variable
+            static bool is_x(
+                typename RestartPackage <X_Vector>::tuple const & item
+            ) {
+                if( Unconstrained <Real,XX>::Restart::is_x(item) ||
+                    item.first == "x_lo" ||
+                    item.first == "x_hi"
+                )
+                    return true;
+                else
+                    return false;
+            }
+
+            // Checks whether we have valid labels
+            static void checkItems(
+                Reals const & reals,
+                Naturals const & nats,
+                Params const & params,
+                X_Vectors const & xs
+            ) {
+                Utility::checkItems <Real> (
+                    is_real,reals," real name: ");
+                Utility::checkItems <Natural> (
+                    is_nat,nats," natural name: ");
+                Utility::checkItems <std::string> (
+                    is_param,params," paramater: ");
+                Utility::checkItems <X_Vector> (
+                    is_x,xs," variable name: ");
+            }
+
+            // Copy out the bounds
+            static void stateToVectors(
+                typename State::t & state,
+                X_Vectors & xs
+            ) {
+                xs.emplace_back("x_lo",std::move(state.x_lo));
+                xs.emplace_back("x_hi",std::move(state.x_hi));
+            }
+
+            // Copy out the scalar information
+            static void stateToScalars(
+                typename State::t & state,
+                Reals & reals,
+                Naturals & nats,
+                Params & params
+            ) {
+                reals.emplace_back("gamma",std::move(state.gamma));
+                reals.emplace_back("bound_push",std::move(state.bound_push));
+            }
+
+            // Copy in the bounds
+            static void vectorsToState(
+                typename State::t & state,
+                X_Vectors & xs
+            ) {
+                for(typename X_Vectors::iterator item = xs.begin();
+                    item!=xs.end();
+                    item++
+                ){
+                    if(item->first=="x_lo")
+                        state.x_lo = std::move(item->second);
+                    else if(item->first=="x_hi")
+                        state.x_hi = std::move(item->second);
+                }
+            }
+
+            // Copy in the scalar information
+            static void scalarsToState(
+                typename State::t & state,
+                Reals & reals,
+                Naturals & nats,
+                Params & params
+            ) {
+                for(typename Reals::iterator item = reals.begin();
+                    item!=reals.end();
+                    item++
+                ){
+                    if(item->first=="gamma")
+                        state.gamma=std::move(item->second);
+                    else if(item->first=="bound_push")
+                        state.bound_push=std::move(item->second);
+                }
+            }
+
+            // Release the data into structures controlled by the user
+            static void release(
+                typename State::t & state,
+                X_Vectors & xs,
+                Reals & reals,
+                Naturals & nats,
+                Params & params
+            ) {
+                // Copy out all of the variable information
+                Unconstrained <Real,XX>
+                    ::Restart::stateToVectors(state,xs);
+                BoundConstrained <Real,XX>
+                    ::Restart::stateToVectors(state,xs);
+
+                // Copy out all of the scalar information
+                Unconstrained <Real,XX>
+                    ::Restart::stateToScalars(state,reals,nats,params);
+                BoundConstrained <Real,XX>
+                    ::Restart::stateToScalars(state,reals,nats,params);
+            }
+
+            // Capture data from structures controlled by the user.
+            static void capture(
+                typename State::t & state,
+                X_Vectors & xs,
+                Reals & reals,
+                Naturals & nats,
+                Params & params
+            ) {
+                // Check the user input
+                checkItems(reals,nats,params,xs);
+
+                // Copy in the variables
+                Unconstrained <Real,XX>
+                    ::Restart::vectorsToState(state,xs);
+                BoundConstrained <Real,XX>
+                    ::Restart::vectorsToState(state,xs);
+
+                // Copy in all of the scalar information
+                Unconstrained <Real,XX>
+                    ::Restart::scalarsToState(state,reals,nats,params);
+                BoundConstrained <Real,XX>
+                    ::Restart::scalarsToState(state,reals,nats,params);
+
+                // Check that we have a valid state
+                State::check(state);
+            }
+
+            // Pieces of a solved state that we carry over to the next problem
+            // in a sequence of related problems
+            struct Warm {
+                // Pieces of the state that we carry over.  See WarmStart.
+                Natural items;
+
+                // The pieces themselves
+                X_Vectors xs;
+                Reals reals;
+
+                // Start with nothing
+                Warm() : items(0), xs(), reals() {}
+            };
+
+            // Copies the pieces of the state that items selects into warm
+            static void warmRelease(
+                Natural const & items,
+                typename State::t & state,
+                Warm & warm
+            ) {
+                // Release the state
+                X_Vectors xs;
+                Reals reals;
+                Naturals nats;
+                Params params;
+                BoundConstrained <Real,XX>
+                    ::Restart::release(state,xs,reals,nats,params);
+
+                // Copy out the pieces that we carry over
+                auto select = [&](std::string const & name) {
+                    return WarmStart::is_selected(items,name);
+                };
+                warm.items = items;
+                warm.xs.clear();
+                warm.reals.clear();
+                Utility::copyVectors <X> (select,xs,warm.xs);
+                Utility::copyScalars <Real> (select,reals,warm.reals);
+
+                // Put the state back together
+                BoundConstrained <Real,XX>
+                    ::Restart::capture(state,xs,reals,nats,params);
+            }
+
+            // Replaces the pieces of the state with those in warm
+            static void warmCapture(
+                Warm const & warm,
+                typename State::t & state
+            ) {
+                // Release the state
+                X_Vectors xs;
+                Reals reals;
+                Naturals nats;
+                Params params;
+                BoundConstrained <Real,XX>
+                    ::Restart::release(state,xs,reals,nats,params);
+
+                // Swap in the pieces that we carry over
+                auto select = [&](std::string const & name) {
+                    return WarmStart::is_selected(warm.items,name);
+                };
+                Utility::removeItems <X_Vector> (select,xs);
+                Utility::removeItems <Real> (select,reals);
+                Utility::copyVectors <X> (select,warm.xs,xs);
+                Utility::copyScalars <Real> (select,warm.reals,reals);
+
+                // Put the state back together
+                BoundConstrained <Real,XX>
+                    ::Restart::capture(state,xs,reals,nats,params);
+            }
+        };
+
+        // All the functions required by an optimization algorithm.  Note, this
+        // routine owns the memory for these operations.
+        struct Functions {
+            // Disallow constructors
+            NO_CONSTRUCTORS(Functions)
+
+            // Actual storage of the functions required.  The bounds live in
+            // the state, so we don't require anything beyond the objective.
+            struct t: public virtual Unconstrained <Real,XX>::Functions::t {
+                // Prevent the use of the copy constructor and the assignment
+                // operator.  Since this class holds a number of unique_ptrs
+                // to different functions, it is not safe to allow them to
+                // be copied.
+                NO_COPY_ASSIGNMENT(t)
+
+                // Initialize all of the pointers to null
+                t() : Unconstrained <Real,XX>::Functions::t() {}
+            };
+
+            // Coleman and Li scale the trust-region subproblem by the
+            // distance to the bounds.  In the original variables, this
+            // adds the diagonal term
+            //
+            // C = diag(|grad f(x)| / dist(x,bound))
+            //
+            // to the Hessian where we take the bound that -grad f(x) points
+            // toward.  As x approaches a bound that the gradient pushes
+            // against, this term dominates, so the step moves a fixed fraction
+            // of the distance to that bound while the free variables see the
+            // usual Newton step.  At the solution, the projected gradient
+            // x - proj(x - grad f(x)) is zero, so we use it to stop.
+            struct BoundModifications
+                : public Optizelle::ScalarValuedFunctionModifications <Real,XX>
+            {
+            public:
+                // Disallow constructors
+                NO_COPY_ASSIGNMENT(BoundModifications)
+
+            private:
+                // Underlying modification.  This takes control of the memory
+                std::unique_ptr <
+                    Optizelle::ScalarValuedFunctionModifications <Real,XX> >
+                    f_mod;
+
+                // Bounds on the variables
+                X_Vector const & x_lo;
+                X_Vector const & x_hi;
+
+                // Gradient at the current iterate
+                X_Vector const & grad;
+
+                // Some workspace for the below functions
+                mutable X_Vector grad_tmp;
+                mutable X_Vector x_tmp1;
+
+                // The diagonal of C and the square root of the affine scaling,
+                // which we cache since they only change with the iterate
+                mutable std::pair <bool,X_Vector> x_scaling;
+                mutable X_Vector c;
+                mutable X_Vector d;
+
+            public:
+                BoundModifications(
+                    typename State::t const & state,
+                    std::unique_ptr <
+                        ScalarValuedFunctionModifications<Real,XX>
+                    > && f_mod_
+                ) : f_mod(std::move(f_mod_)),
+                    x_lo(state.x_lo),
+                    x_hi(state.x_hi),
+                    grad(state.grad),
+                    grad_tmp(X::init(state.x)),
+                    x_tmp1(X::init(state.x)),
+                    x_scaling(false,X::init(state.x)),
+                    c(X::init(state.x)),
+                    d(X::init(state.x))
+                {}
+
+                // Finds the scaling at x if we've not done so already
+                void scaling(X_Vector const & x) const {
+                    // If the relative error between the current and cached
+                    // iterates is large, find the scaling anew
+                    if( rel_err_cached <Real,XX> (x,x_scaling)
+                            >= std::numeric_limits <Real>::epsilon()*1e1
+                    ) {
+                        // c <- |grad_step| / dist(x,bound)
+                        // d <- sqrt(min(1,dist(x,bound)))
+                        f_mod->grad_step(x,grad,grad_tmp);
+                        B::scaling(x_lo,x_hi,x,grad_tmp,c,d);
+
+                        // Cache the values
+                        x_scaling.first=true;
+                        X::copy(x,x_scaling.second);
+                    }
+                }
+
+                // Square root of the affine scaling at x
+                X_Vector const & sqrt_affine(X_Vector const & x) const {
+                    scaling(x);
+                    return d;
+                }
+
+                // Merit function additions to the objective
+                virtual Real merit(X_Vector const & x,Real const & f_x) const {
+                    return f_mod->merit(x,f_x);
+                }
+
+                // Stopping condition modification of the gradient
+                virtual void grad_stop(
+                    X_Vector const & x,
+                    X_Vector const & grad,
+                    X_Vector & grad_stop
+                ) const {
+                    f_mod->grad_stop(x,grad,grad_tmp);
+                    B::pgrad(x_lo,x_hi,x,grad_tmp,grad_stop);
+                }
+
+                // Diagnostic modification of the gradient
+                virtual void grad_diag(
+                    X_Vector const & x,
+                    X_Vector const & grad,
+                    X_Vector & grad_diag
+                ) const {
+                    f_mod->grad_diag(x,grad,grad_diag);
+                }
+
+                // Modification of the gradient when finding a trial step
+                virtual void grad_step(
+                    X_Vector const & x,
+                    X_Vector const & grad,
+                    X_Vector & grad_step
+                ) const {
+                    f_mod->grad_step(x,grad,grad_step);
+                }
+
+                // Modification of the gradient for a quasi-Newton method
+                virtual void grad_quasi(
+                    X_Vector const & x,
+                    X_Vector const & grad,
+                    X_Vector & grad_quasi
+                ) const {
+                    f_mod->grad_quasi(x,grad,grad_quasi);
+                }
+
+                // Modification of the gradient when solving for the equality
+                // multiplier
+                virtual void grad_mult(
+                    X_Vector const & x,
+                    X_Vector const & grad,
+                    X_Vector & grad_mult
+                ) const {
+                    f_mod->grad_mult(x,grad,grad_mult);
+                }
+
+                // Modification of the Hessian-vector product when finding a
+                // trial step
+                virtual void hessvec_step(
+                    X_Vector const & x,
+                    X_Vector const & dx,
+                    X_Vector const & H_dx,
+                    X_Vector & Hdx_step
+                ) const {
+                    // Modify the Hessian-vector product
+                    f_mod->hessvec_step(x,dx,H_dx,Hdx_step);
+
+                    // Hdx_step <- hess f(x) dx + C dx
+                    scaling(x);
+                    X::prod(c,dx,x_tmp1);
+                    X::axpy(Real(1.),x_tmp1,Hdx_step);
+                }
+            };
+
+            // Since C becomes unbounded as x approaches the bounds, truncated
+            // CG stalls on the active variables unless we also scale the
+            // subproblem.  Coleman and Li work with D^(-1) dx where
+            // D^2 = diag(dist(x,bound)).  Here, we use the equivalent
+            // preconditioner D PH D where we cap D at 1 so that we leave
+            // variables far from their bounds to the user's preconditioner.
+            struct BoundPreconditioner : public Operator <Real,XX,XX> {
+            private:
+                // Underlying preconditioner.  This takes control of the memory
+                std::unique_ptr <Operator <Real,XX,XX>> PH;
+
+                // Modifications that hold the affine scaling
+                BoundModifications const & f_mod;
+
+                // Current iterate
+                X_Vector const & x;
+
+                // Some workspace for the below functions
+                mutable X_Vector x_tmp1;
+                mutable X_Vector x_tmp2;
+
+            public:
+                // Disallow constructors
+                NO_COPY_ASSIGNMENT(BoundPreconditioner)
+
+                BoundPreconditioner(
+                    typename State::t const & state,
+                    BoundModifications const & f_mod_,
+                    std::unique_ptr <Operator <Real,XX,XX>> && PH_
+                ) : PH(std::move(PH_)),
+                    f_mod(f_mod_),
+                    x(state.x),
+                    x_tmp1(X::init(state.x)),
+                    x_tmp2(X::init(state.x))
+                {}
+
+                // result <- D PH D dx
+                void eval(X_Vector const & dx,X_Vector & result) const {
+                    auto const & d = f_mod.sqrt_affine(x);
+                    X::prod(d,dx,x_tmp1);
+                    PH->eval(x_tmp1,x_tmp2);
+                    X::prod(d,x_tmp2,result);
+                }
+            };
+
+            // Check that the algorithm can handle the bounds.  We keep the
+            // iterates inside the bounds by truncating each trial step
+            // before we compare the actual and predicted reduction, which
+            // only exists for trust-region methods.
+            static void check_algorithm(typename State::t const & state) {
+                if(state.algorithm_class!=AlgorithmClass::TrustRegion)
+                    throw Exception::t(__LOC__
+                        + ", bound constrained problems require a "
+                        "trust-region algorithm");
+            }
+
+            // Initialize any missing functions for just bound constrained
+            // optimization.
+            static void init_(
+                typename State::t & state,
+                t& fns
+            ) {
+                // Check that the algorithm supports the bounds
+                check_algorithm(state);
+
+                // Modify the objective
+                auto f_mod = new BoundModifications(state,std::move(fns.f_mod));
+                fns.f_mod.reset(f_mod);
+
+                // Scale the preconditioner
+                fns.PH.reset(new BoundPreconditioner(
+                    state,*f_mod,std::move(fns.PH)));
+            }
+
+            // Initialize any missing functions
+            static void init(
+                typename State::t & state,
+                t& fns
+            ) {
+                Unconstrained <Real,XX>
+                    ::Functions::init_(state,fns);
+                BoundConstrained <Real,XX>
+                    ::Functions::init_(state,fns);
+            }
+        };
+
+        // Contains functions that assist in creating an output for diagonstics
+        struct Diagnostics {
+            // Disallow constructors
+            NO_CONSTRUCTORS(Diagnostics)
+
+            // Gets the header for the state information
+            static void getStateHeader_(
+                typename State::t const & state,
+                std::list <std::string> & out
+            ) {
+                // Create some shortcuts
+                auto const & msg_level = state.msg_level;
+
+                // More detailed information
+                if(msg_level >= 2)
+                    out.emplace_back(Utility::atos("alpha_x"));
+            }
+
+            // Combines all of the state headers
+            static void getStateHeader(
+                typename State::t const & state,
+                std::list <std::string> & out
+            ) {
+                Unconstrained <Real,XX>::Diagnostics::getStateHeader_(
+                    state,out);
+                BoundConstrained <Real,XX>::Diagnostics::getStateHeader_(
+                    state,out);
+                Unconstrained <Real,XX>::Diagnostics::getProfileHeader_(
+                    state,out);
+            }
+
+            // Gets the state information for output
+            static void getState_(
+                typename Functions::t const &,
+                typename State::t const & state,
+                bool const & blank,
+                std::list <std::string> & out
+            ) {
+                // Create some shortcuts
+                auto const & alpha_x =state.alpha_x;
+                auto const & msg_level = state.msg_level;
+
+                // Figure out if we're at the absolute beginning of the
+                // optimization.
+                bool opt_begin = Utility::is_opt_begin <BoundConstrained> (
+                    state);
+
+                // More detailed information
+                if(msg_level >= 2)
+                    out.emplace_back(!opt_begin && !blank ?
+                        Utility::atos(alpha_x) : Utility::blankSeparator);
+            }
+
+            // Combines all of the state information
+            static void getState(
+                typename Functions::t const & fns,
+                typename State::t const & state,
+                bool const & blank,
+                bool const & noiter,
+                std::list <std::string> & out
+            ) {
+                Unconstrained <Real,XX>::Diagnostics
+                    ::getState_(fns,state,blank,noiter,out);
+                BoundConstrained <Real,XX>::Diagnostics
+                    ::getState_(fns,state,blank,out);
+                Unconstrained <Real,XX>::Diagnostics
+                    ::getProfile_(state,blank,out);
+            }
+
+            // Runs the specified function diagnostics
+            static void checkFunctions(
+                Messaging::t const & msg,
+                typename Functions::t const & fns,
+                typename State::t const & state
+            ) {
+                Unconstrained <Real,XX>::Diagnostics::checkFunctions_(
+                    msg,fns,state);
+            }
+
+            // Runs the specified Lagrangian diagnostics
+            static void checkLagrangian(
+                Messaging::t const & msg,
+                typename Functions::t const & fns,
+                typename State::t const & state
+            ) {
+                Unconstrained <Real,XX>::Diagnostics::checkLagrangian_(
+                    msg,fns,state);
+            }
+
+            // Runs the specified vector space diagnostics
+            static void checkVectorSpace(
+                Messaging::t const & msg,
+                typename Functions::t const & fns,
+                typename State::t const & state
+            ) {
+                Unconstrained <Real,XX>::Diagnostics
+                    ::checkVectorSpace_(msg,fns,state);
+            }
+        };
+
+        // This contains the different algorithms used for optimization
+        struct Algorithms {
+            // Disallow constructors
+            NO_CONSTRUCTORS(Algorithms)
+
+            // This moves the starting point into the interior of the bounds
+            // and keeps each trial step there through use of a state
+            // manipulator.
+            template <typename ProblemClass>
+            struct BoundManipulator
+                : public StateManipulator <ProblemClass>
+            {
+            private:
+                // A reference to the user-defined state manipulator
+                StateManipulator<ProblemClass> const & smanip;
+
+                // Finds the model, < grad_step,dx > + 0.5 < H dx,dx >, where
+                // H includes the Coleman-Li term
+                static Real model(
+                    typename ProblemClass::Functions::t const & fns,
+                    typename State::t const & state,
+                    X_Vector const & grad_step,
+                    X_Vector const & dx
+                ) {
+                    auto H_dx = X::init(state.x);
+                    fns.f->hessvec(state.x,dx,H_dx);
+                    auto Hdx_step = X::init(state.x);
+                    fns.f_mod->hessvec_step(state.x,dx,H_dx,Hdx_step);
+                    return X::innr(grad_step,dx)
+                        + Real(.5)*X::innr(Hdx_step,dx);
+                }
+
+                // Keeps the trial step inside the bounds.  We truncate dx
+                // elementwise and keep it as long as it still decreases the
+                // model.  Otherwise, truncation ruined the step, so we
+                // compare dx scaled back to its first breakpoint with the
+                // scaled Cauchy point, which minimizes the model along
+                // -D^2 grad_step inside both the trust-region and the
+                // truncated bounds, and keep whichever does best.  This
+                // costs a single Hessian-vector product unless we fall back.
+                static void safeguard(
+                    typename ProblemClass::Functions::t const & fns,
+                    typename State::t & state
+                ) {
+                    // Create some shortcuts
+                    auto const & x = state.x;
+                    auto const & x_lo = state.x_lo;
+                    auto const & x_hi = state.x_hi;
+                    auto const & gamma = state.gamma;
+                    auto const & delta = state.delta;
+                    auto const & alpha_x = state.alpha_x;
+                    auto & dx = state.dx;
+
+                    // Find the gradient used in the model
+                    auto grad_step = X::init(x);
+                    fns.f_mod->grad_step(x,state.grad,grad_step);
+
+                    // Truncate the step, but save the scaled step in case
+                    // we need it
+                    auto dx_scaled = X::init(x);
+                    X::copy(dx,dx_scaled);
+                    X::scal(alpha_x,dx_scaled);
+                    B::trunc(x_lo,x_hi,x,gamma,dx);
+                    auto model_dx = model(fns,state,grad_step,dx);
+                    if(model_dx < Real(0.))
+                        return;
+
+                    // Use the scaled step when it does better
+                    auto model_scaled = model(fns,state,grad_step,dx_scaled);
+                    if(model_scaled < model_dx) {
+                        X::copy(dx_scaled,dx);
+                        model_dx = model_scaled;
+                    }
+
+                    // Find the direction, dx_cp = -D^2 grad_step
+                    auto c = X::init(x);
+                    auto d = X::init(x);
+                    B::scaling(x_lo,x_hi,x,grad_step,c,d);
+                    auto dx_cp = X::init(x);
+                    X::prod(d,grad_step,c);
+                    X::prod(d,c,dx_cp);
+                    X::scal(Real(-1.),dx_cp);
+
+                    // If we're not a descent direction, we're at a critical
+                    // point of the scaled problem, so keep dx
+                    auto g_dxcp = X::innr(grad_step,dx_cp);
+                    if(!(g_dxcp < Real(0.)))
+                        return;
+
+                    // Minimize the model along dx_cp.  Without positive
+                    // curvature, we step until we hit a boundary.
+                    auto kappa = Real(2.)*(model(fns,state,grad_step,dx_cp)
+                        - g_dxcp);
+                    auto t = kappa > Real(0.) ? -g_dxcp/kappa
+                        : std::numeric_limits <Real>::infinity();
+                    t = std::min(t,delta/std::sqrt(X::innr(dx_cp,dx_cp)));
+                    t = std::min(t,B::srch(x_lo,x_hi,x,dx_cp,gamma));
+                    auto model_cp = t*g_dxcp + Real(.5)*t*t*kappa;
+
+                    // Keep whichever step does best on the model
+                    if(model_cp < model_dx) {
+                        X::copy(dx_cp,dx);
+                        X::scal(t,dx);
+                    }
+                }
+
+            public:
+                BoundManipulator(
+                    StateManipulator <ProblemClass> const & smanip_
+                ) : smanip(smanip_) {}
+
+                // Application
+                void eval(
+                    typename ProblemClass::Functions::t const & fns_,
+                    typename ProblemClass::State::t& state_,
+                    OptimizationLocation::t const & loc
+                ) const {
+                    // Call the user define manipulator
+                    smanip.eval(fns_,state_,loc);
+
+                    // Dynamically cast the incoming state to work with the
+                    // bounds
+                    typename State::t & state
+                        =dynamic_cast <typename State::t &> (state_);
+
+                    // Before we evaluate anything, make sure that we start
+                    // strictly inside the bounds.  We only get here when
+                    // we're not restarting.
+                    if(loc==OptimizationLocation::BeforeInitialFuncAndGrad)
+                        B::proj(state.x_lo,state.x_hi,state.bound_push,
+                            state.x);
+
+                    // Truncated CG and GLTR solve the trust-region subproblem
+                    // without regard to the bounds.  Before we check the
+                    // step, we truncate each element, so that we move at most
+                    // the fraction gamma of the distance to the bounds.  We
+                    // truncate elementwise, so that a single variable near a
+                    // bound does not stall the rest.  However, truncation can
+                    // ruin the decrease in the model, so, following Coleman
+                    // and Li, we then fall back to the scaled step or the
+                    // scaled Cauchy point.
+                    // Since this happens before we compute the predicted
+                    // reduction, the model stays consistent with the step
+                    // that we take.  For diagnostics, alpha_x records the
+                    // first breakpoint of the untruncated step.
+                    else if(loc==OptimizationLocation
+                        ::BeforeActualVersusPredicted
+                    ) {
+                        state.alpha_x = std::min(Real(1.),B::srch(
+                            state.x_lo,state.x_hi,state.x,state.dx,
+                            state.gamma));
+                        if(state.alpha_x < Real(1.))
+                            safeguard(fns_,state);
+                    }
+                }
+            };
+
+            // Checks whether the iterate that we carried over from a related
+            // problem is a valid starting point for this one.  Without
+            // inequality constraints, any iterate works.
+            static bool warmStartFeasible(
+                typename Functions::t const &,
+                typename State::t const &
+            ) {
+                return true;
+            }
+
+            // Solves an optimization problem where the user doesn't know about
+            // the state manipulator
+            static void getMin(
+                Messaging::t const & msg,
+                typename Functions::t & fns,
+                typename State::t & state
+            ){
+                // Create an empty state manipulator
+                EmptyManipulator <BoundConstrained <Real,XX> > smanip;
+
+                // Minimize the problem
+                getMin(msg,fns,state,smanip);
+            }
+
+            // Initializes remaining functions then solves an optimization
+            // problem
+            static void getMin(
+                Messaging::t const & msg,
+                typename Functions::t & fns,
+                typename State::t & state,
+                StateManipulator <BoundConstrained <Real,XX> > const & smanip
+            ){
+                // Adds the output pieces to the state manipulator
+                DiagnosticManipulator <BoundConstrained <Real,XX> >
+                    dmanip(smanip,msg);
+
+                // Add the bound pieces to the state manipulator
+                BoundManipulator <BoundConstrained <Real,XX> > bmanip(dmanip);
+
+                // Insures that we can interact with unconstrained code
+                ConversionManipulator
+                    <BoundConstrained <Real,XX>,Unconstrained <Real,XX> >
+                    cmanip(bmanip);
+
+                // Initialize any remaining functions required for optimization
+                Functions::init(state,fns);
+
+                // Check the inputs to the optimization
+                State::check(state);
+
+                // Minimize the problem
+                Unconstrained <Real,XX>::Algorithms
+                    ::getMin_(cmanip,fns,state);
+            }
+        };
+    };
+
+    // Routines that manipulate and support problems of the form
+    // problem of the form
+    // 
+    // min_{x \in X} f(x) st g(x) = 0, h(x) >=_K 0
+    //
+    // where f : X -> R, g : X -> Y, and h : X -> Z
+    template <
+        typename Real,
+        template <typename> class XX,
+        template <typename> class YY,
+        template <typename> class ZZ
+    > 
+    struct Constrained {
+        // Disallow constructors
+        NO_CONSTRUCTORS(Constrained)
+
+        // Create some shortcuts for some type names
+        typedef Profile::Timed <XX <Real> > X;
+        typedef typename X::Vector X_Vector;
+        typedef Profile::Timed <YY <Real> > Y;
+        typedef typename Y::Vector Y_Vector;
+        typedef Profile::Timed <ZZ <Real> > Z;
+        typedef typename Z::Vector Z_Vector;
+
+        // Routines that manipulate the internal state of the optimization 
+        // algorithm.
+        struct State {
+            // Disallow constructors
+            NO_CONSTRUCTORS(State)
+            
+            // Internal state of the optimization
+            struct t: 
+                public EqualityConstrained <Real,XX,YY>::State::t,
+                public InequalityConstrained <Real,XX,ZZ>::State::t
+            {
+                // Prevent the use of the copy constructor and the assignment
+                // operator.  Basically, the state can hold a large amount
+                // of memory and the safe way to move this memory around
+                // is through the use of the capture and release methodology
+                // inside of the restart section.
+                NO_DEFAULT_COPY_ASSIGNMENT(t)
+
+                // Initialization constructors
+                explicit t(
+                    X_Vector const & x,Y_Vector const & y,Z_Vector const & z
+                ) : Unconstrained <Real,XX>::State::t(x), 
+                    EqualityConstrained <Real,XX,YY>::State::t(x,y),
+                    InequalityConstrained <Real,XX,ZZ>::State::t(x,z)
+                {}
+            };
+            
+            // Check that we have a valid set of parameters.
+            static void check(t const & state) {
+                Unconstrained <Real,XX>::State::check_(state);
+                EqualityConstrained <Real,XX,YY>::State::check_(state);
+                InequalityConstrained <Real,XX,ZZ>::State::check_(state);
+            }
+        };
+        
+        // Utilities for restarting the optimization
+        struct Restart {
+            // Disallow constructors
+            NO_CONSTRUCTORS(Restart)
+       
+            // Create some type shortcuts 
+            typedef typename RestartPackage <Real>::t Reals;
+            typedef typename RestartPackage <Natural>::t Naturals;
+            typedef typename RestartPackage <std::string>::t Params;
+            typedef typename RestartPackage <X_Vector>::t X_Vectors;
+            typedef typename RestartPackage <Y_Vector>::t Y_Vectors;
+            typedef typename RestartPackage <Z_Vector>::t Z_Vectors;
             
             // Checks whether we have a valid real 
             static bool is_real(
@@ -11974,6 +16517,90 @@ namespace Optizelle{
                 // Check that we have a valid state 
                 State::check(state);
             }
+
+            // Pieces of a solved state that we carry over to the next problem
+            // in a sequence of related problems
+            struct Warm {
+                // Pieces of the state that we carry over.  See WarmStart.
+                Natural items;
+
+                // The pieces themselves
+                X_Vectors xs;
+                Y_Vectors ys;
+                Z_Vectors zs;
+                Reals reals;
+
+                // Start with nothing
+                Warm() : items(0), xs(), ys(), zs(), reals() {}
+            };
+
+            // Copies the pieces of the state that items selects into warm
+            static void warmRelease(
+                Natural const & items,
+                typename State::t & state,
+                Warm & warm
+            ) {
+                // Release the state
+                X_Vectors xs;
+                Y_Vectors ys;
+                Z_Vectors zs;
+                Reals reals;
+                Naturals nats;
+                Params params;
+                Constrained <Real,XX,YY,ZZ>
+                    ::Restart::release(state,xs,ys,zs,reals,nats,params);
+
+                // Copy out the pieces that we carry over
+                auto select = [&](std::string const & name) {
+                    return WarmStart::is_selected(items,name);
+                };
+                warm.items = items;
+                warm.xs.clear();
+                warm.ys.clear();
+                warm.zs.clear();
+                warm.reals.clear();
+                Utility::copyVectors <X> (select,xs,warm.xs);
+                Utility::copyVectors <Y> (select,ys,warm.ys);
+                Utility::copyVectors <Z> (select,zs,warm.zs);
+                Utility::copyScalars <Real> (select,reals,warm.reals);
+
+                // Put the state back together
+                Constrained <Real,XX,YY,ZZ>
+                    ::Restart::capture(state,xs,ys,zs,reals,nats,params);
+            }
+
+            // Replaces the pieces of the state with those in warm
+            static void warmCapture(
+                Warm const & warm,
+                typename State::t & state
+            ) {
+                // Release the state
+                X_Vectors xs;
+                Y_Vectors ys;
+                Z_Vectors zs;
+                Reals reals;
+                Naturals nats;
+                Params params;
+                Constrained <Real,XX,YY,ZZ>
+                    ::Restart::release(state,xs,ys,zs,reals,nats,params);
+
+                // Swap in the pieces that we carry over
+                auto select = [&](std::string const & name) {
+                    return WarmStart::is_selected(warm.items,name);
+                };
+                Utility::removeItems <X_Vector> (select,xs);
+                Utility::removeItems <Y_Vector> (select,ys);
+                Utility::removeItems <Z_Vector> (select,zs);
+                Utility::removeItems <Real> (select,reals);
+                Utility::copyVectors <X> (select,warm.xs,xs);
+                Utility::copyVectors <Y> (select,warm.ys,ys);
+                Utility::copyVectors <Z> (select,warm.zs,zs);
+                Utility::copyScalars <Real> (select,warm.reals,reals);
+
+                // Put the state back together
+                Constrained <Real,XX,YY,ZZ>
+                    ::Restart::capture(state,xs,ys,zs,reals,nats,params);
+            }
         };
 
         // All the functions required by an optimization algorithm.  Note, this
@@ -12009,6 +16636,13 @@ namespace Optizelle{
                 typename State::t & state,
                 t& fns
             ) {
+                // The composite-step method finds its step in pieces, so
+                // there's no single Newton system for Mehrotra's predictor
+                if(state.ip_scheme==InteriorPointScheme::Mehrotra)
+                    throw Exception::t(__LOC__
+                        + ", the Mehrotra interior point scheme is not "
+                        "supported with equality constraints");
+
                 Unconstrained <Real,XX>
                     ::Functions::init_(state,fns);
                 EqualityConstrained <Real,XX,YY>
@@ -12048,6 +16682,8 @@ namespace Optizelle{
                     state,out);
                 Constrained<Real,XX,YY,ZZ>::Diagnostics::getStateHeader_(
                     state,out);
+                Unconstrained <Real,XX>::Diagnostics::getProfileHeader_(
+                    state,out);
             }
 
             // Gets the state information for output
@@ -12106,6 +16742,8 @@ namespace Optizelle{
                     ::getState_(fns,state,blank,out);
                 Constrained <Real,XX,YY,ZZ>::Diagnostics
                     ::getState_(fns,state,blank,out);
+                Unconstrained <Real,XX>::Diagnostics
+                    ::getProfile_(state,blank,out);
             }
 
             // Runs the specified function diagnostics 
@@ -12156,6 +16794,16 @@ namespace Optizelle{
             // Disallow constructors
             NO_CONSTRUCTORS(Algorithms)
 
+            // Checks whether the iterate that we carried over from a related
+            // problem lies strictly inside the cone for this one
+            static bool warmStartFeasible(
+                typename Functions::t const & fns,
+                typename State::t const & state
+            ) {
+                return InequalityConstrained <Real,XX,ZZ>::Algorithms
+                    ::warmStartFeasible(fns,state);
+            }
+
             // Solves an optimization problem where the user doesn't know about
             // the state manipulator
             static void getMin(
@@ -12211,6 +16859,115 @@ namespace Optizelle{
             }
         };
     };
+
+    // Solves a sequence of related problems such as the horizons of a model
+    // predictive controller or the steps of a parameter sweep.  Each solve
+    // after the first starts with the pieces of the prior solution that
+    // items selects, which we carry over with Restart.  Since the first
+    // solve starts cold, we measure the iterations that each warm start saves
+    // relative to it.  The problems differ, so this is only an estimate.
+    // Solves that fall back to a cold start don't count.  Here, ProblemClass
+    // is one of Unconstrained,
+    // EqualityConstrained, InequalityConstrained, Constrained, or
+    // BoundConstrained.
+    template <typename ProblemClass>
+    struct Continuation {
+    private:
+        // Pieces of the last solution that we carry over
+        typename ProblemClass::Restart::Warm warm;
+
+    public:
+        // Prevent the use of the copy constructor and the assignment operator
+        NO_COPY_ASSIGNMENT(Continuation)
+
+        // Pieces of the prior solution that we carry over.  See WarmStart.
+        Natural items;
+
+        // Number of problems that we've solved
+        Natural solves;
+
+        // Number of solves that started from the prior solution
+        Natural warm_solves;
+
+        // Number of iterations required by the first, cold, solve
+        Natural iter_cold;
+
+        // Iterations that the last solve saved relative to the first solve.
+        // This is zero when the last solve started cold.
+        Integer iter_saved;
+
+        // Iterations that all of the warm solves saved relative to the
+        // first solve
+        Integer iter_saved_total;
+
+        // Carry over all of the pieces by default
+        Continuation(Natural const & items_ = WarmStart::All) :
+            warm(),
+            items(items_),
+            solves(0),
+            warm_solves(0),
+            iter_cold(0),
+            iter_saved(0),
+            iter_saved_total(0)
+        {}
+
+        // Solves the next problem in the sequence
+        void getMin(
+            Messaging::t const & msg,
+            typename ProblemClass::Functions::t & fns,
+            typename ProblemClass::State::t & state,
+            StateManipulator <ProblemClass> const & smanip
+        ) {
+            // Carry over the pieces of the last solution.  If the last
+            // iterate isn't a valid starting point for this problem, such as
+            // when the inequality constraints tighten, we put back the
+            // caller's pieces and start cold.
+            auto warm_started = false;
+            if(solves > 0) {
+                typename ProblemClass::Restart::Warm cold;
+                ProblemClass::Restart::warmRelease(items,state,cold);
+                ProblemClass::Restart::warmCapture(warm,state);
+                warm_started
+                    = ProblemClass::Algorithms::warmStartFeasible(fns,state);
+                if(!warm_started)
+                    ProblemClass::Restart::warmCapture(cold,state);
+            }
+
+            // Solve the problem
+            ProblemClass::Algorithms::getMin(msg,fns,state,smanip);
+
+            // Compare the work against the first solve
+            iter_saved = 0;
+            if(solves == 0)
+                iter_cold = state.iter;
+            else if(warm_started) {
+                iter_saved = Integer(iter_cold) - Integer(state.iter);
+                iter_saved_total += iter_saved;
+                warm_solves++;
+                if(state.msg_level >= 1) {
+                    std::stringstream ss;
+                    ss << "Warm start saved " << iter_saved
+                        << " iterations relative to the first solve";
+                    msg(ss.str());
+                }
+            }
+            solves++;
+
+            // Save the pieces of this solution for the next solve
+            ProblemClass::Restart::warmRelease(items,state,warm);
+        }
+
+        // Solves the next problem in the sequence when the user doesn't know
+        // about the state manipulator
+        void getMin(
+            Messaging::t const & msg,
+            typename ProblemClass::Functions::t & fns,
+            typename ProblemClass::State::t & state
+        ) {
+            EmptyManipulator <ProblemClass> smanip;
+            getMin(msg,fns,state,smanip);
+        }
+    };
 //---Optizelle2---
 }
 //---Optizelle3---
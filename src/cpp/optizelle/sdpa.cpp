@@ -0,0 +1,181 @@
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include "optizelle/sdpa.h"
+
+namespace Optizelle {
+    namespace sdpa {
+        // Reads the entire contents of a file into memory
+        std::string read_file(std::string const & fname) {
+            // Open the file and find its size
+            std::ifstream fin(fname.c_str(),
+                std::ifstream::in | std::ifstream::binary);
+            if(!fin.is_open())
+                throw Exception::t(__LOC__
+                    + ", unable to open the file: " + fname + ".");
+            fin.seekg(0,std::ifstream::end);
+            auto size = fin.tellg();
+            fin.seekg(0,std::ifstream::beg);
+
+            // Read everything in a single pass
+            auto contents = std::string(Natural(size),'\0');
+            if(size > 0)
+                fin.read(&(contents[0]),size);
+            if(fin.fail())
+                throw Exception::t(__LOC__
+                    + ", unable to read the file: " + fname + ".");
+            return contents;
+        }
+
+        // Throws an error about the current line
+        void Scanner::error(std::string const & what) const {
+            throw Exception::t(__LOC__
+                + ", error while parsing " + what + " on line "
+                + std::to_string(line) + " of the SDPA file");
+        }
+
+        // Take ownership of the contents of the file
+        Scanner::Scanner(std::string && buffer_) :
+            buffer(std::move(buffer_)),
+            pos(buffer.data()),
+            end(buffer.data()+buffer.size()),
+            line(1)
+        {}
+
+        // Skips the lines that start with a comment character
+        void Scanner::skip_comments() {
+            while(pos != end && (*pos=='"' || *pos=='*'))
+                skip_line();
+        }
+
+        // Skips the remainder of the current line
+        void Scanner::skip_line() {
+            while(pos != end && *pos != '\n')
+                pos++;
+            if(pos != end) {
+                pos++;
+                line++;
+            }
+        }
+
+        // Skips whitespace and the formatting characters ,(){}=.  When
+        // newlines is false, we stop at the end of the current line.
+        // Returns whether there's another token to read.
+        bool Scanner::skip_formatting(bool const & newlines) {
+            while(pos != end) {
+                switch(*pos) {
+                case '\n':
+                    if(!newlines) return false;
+                    line++;
+                    break;
+                case ' ': case '\t': case '\r':
+                case ',': case '(': case ')': case '{': case '}': case '=':
+                    break;
+                default:
+                    return true;
+                }
+                pos++;
+            }
+            return false;
+        }
+
+        // Reads an integer.  Four of the five fields of each element are
+        // integers, so we parse them directly rather than with strtol, which
+        // has to handle bases and the locale.
+        Integer Scanner::read_integer(std::string const & what) {
+            auto next = pos;
+            auto negative = next != end && *next == '-';
+            if(next != end && (*next == '-' || *next == '+'))
+                next++;
+            if(next == end || *next < '0' || *next > '9')
+                error(what);
+            auto val = Integer(0);
+            for(; next != end && *next >= '0' && *next <= '9'; next++)
+                val = 10*val + Integer(*next - '0');
+            pos = next;
+            return negative ? -val : val;
+        }
+
+        // Reads a real number.  Most elements have a short decimal expansion
+        // and, when the digits fit exactly in a double and the power of ten
+        // is at most 22, a single multiplication or division by an exact
+        // power of ten is correctly rounded.  This is Clinger's fast path and
+        // it's several times faster than strtod.  Anything else, such as
+        // long expansions, large exponents, or malformed numbers, falls back
+        // to strtod.
+        double Scanner::read_real(std::string const & what) {
+            // Exact powers of ten
+            static double const powers[] = {
+                1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21,
+                1e22};
+
+            // Read the sign
+            auto next = pos;
+            auto negative = next != end && *next == '-';
+            if(next != end && (*next == '-' || *next == '+'))
+                next++;
+
+            // Read the digits into an integer mantissa while tracking the
+            // power of ten
+            auto mantissa = std::uint64_t(0);
+            auto ndigits = Natural(0);
+            auto exponent = Integer(0);
+            auto exact = true;
+            auto found = false;
+            auto accumulate = [&](char const & c) {
+                found = true;
+                if(ndigits < 19) {
+                    mantissa = 10*mantissa + std::uint64_t(c - '0');
+                    if(mantissa > 0) ndigits++;
+                } else if(c != '0')
+                    exact = false;
+                else
+                    exponent++;
+            };
+            for(; next != end && *next >= '0' && *next <= '9'; next++)
+                accumulate(*next);
+            if(next != end && *next == '.')
+                for(next++; next != end && *next >= '0' && *next <= '9';
+                    next++
+                ) {
+                    accumulate(*next);
+                    exponent--;
+                }
+
+            // Read the exponent
+            if(found && next != end && (*next == 'e' || *next == 'E')) {
+                next++;
+                auto negative_exp = next != end && *next == '-';
+                if(next != end && (*next == '-' || *next == '+'))
+                    next++;
+                if(next == end || *next < '0' || *next > '9')
+                    exact = false;
+                auto e = Integer(0);
+                for(; next != end && *next >= '0' && *next <= '9'; next++)
+                    if(e < 10000) e = 10*e + Integer(*next - '0');
+                exponent += negative_exp ? -e : e;
+            }
+
+            // Use the fast path when we can
+            if( found && exact && mantissa <= (std::uint64_t(1) << 53) &&
+                exponent >= -22 && exponent <= 22
+            ) {
+                auto val = double(mantissa);
+                val = exponent < 0 ? val / powers[-exponent]
+                                   : val * powers[exponent];
+                pos = next;
+                return negative ? -val : val;
+            }
+
+            // Otherwise, fall back to strtod.  The buffer ends in a null
+            // character, so strtod always stops.
+            char * next_strtod;
+            auto val = std::strtod(pos,&next_strtod);
+            if(next_strtod==pos)
+                error(what);
+            pos = next_strtod;
+            return val;
+        }
+    }
+}
@@ -0,0 +1,1367 @@
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "optizelle/linalg.h"
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+
+namespace Optizelle {
+    using namespace Optizelle;
+    namespace sdpa {
+        // Reads the entire contents of a file into memory
+        std::string read_file(std::string const & fname);
+
+        // Tokenizes a sparse SDPA file that we've read into memory.  We walk
+        // the buffer directly rather than going through streams since the
+        // constraint matrices of larger problems have millions of entries.
+        struct Scanner {
+        private:
+            // Contents of the file
+            std::string const buffer;
+
+            // Current position in the buffer
+            char const * pos;
+
+            // One past the end of the buffer
+            char const * const end;
+
+            // Current line, which we use for errors
+            Natural line;
+
+            // Throws an error about the current line
+            [[noreturn]] void error(std::string const & what) const;
+
+        public:
+            // Disallow copying since we hold pointers into the buffer
+            NO_COPY_ASSIGNMENT(Scanner)
+
+            // Take ownership of the contents of the file
+            explicit Scanner(std::string && buffer_);
+
+            // Skips the lines that start with a comment character
+            void skip_comments();
+
+            // Skips the remainder of the current line
+            void skip_line();
+
+            // Skips whitespace and the formatting characters ,(){}=.  When
+            // newlines is false, we stop at the end of the current line.
+            // Returns whether there's another token to read.
+            bool skip_formatting(bool const & newlines);
+
+            // Reads an integer or a real number.  The string what describes
+            // the value for any errors.
+            Integer read_integer(std::string const & what);
+            double read_real(std::string const & what);
+        };
+
+        // Stores a sparse SDPA format problem of the form
+        //
+        // min b1*x1 + ... + bm*xm
+        // st  A1*x1 + ... + Am*xm - A0 >= 0
+        //
+        // where each A has a block structure with sizes
+        // blk_sizes_1,...,blk_sizes_nblocks.
+        template <typename Real>
+        struct Problem {
+            // Block sizes.  Negative means a diagonal block.
+            std::vector <Integer> blk_sizes;
+
+            // Objective function
+            std::vector <Real> b;
+
+            // Constraint matrices, A[i][blk] for i=0,...,m.  Each block is a
+            // CSR matrix with sorted columns and no duplicate entries.
+            // Semidefinite blocks hold both triangles and diagonal blocks
+            // hold only their diagonal.  Blocks without any elements are
+            // stored with no rows, so that problems with many constraints
+            // on a large block, such as max-cut relaxations, don't need
+            // memory for the rows of every block.
+            std::vector <std::vector <CSRMatrix <Real> > > A;
+
+            // Number of variables
+            Natural m() const {
+                return b.size();
+            }
+
+            // Number of blocks
+            Natural nblocks() const {
+                return blk_sizes.size();
+            }
+
+            // Size of a block
+            Natural blkSize(Natural const & blk) const {
+                return Natural(std::abs(blk_sizes[blk]));
+            }
+        };
+
+        // Assembles the constraint matrices of a problem from their elements.
+        // Element k belongs to the matrix keys[k] / nblocks and the block
+        // keys[k] % nblocks and may lie in either triangle.  We mirror the
+        // off-diagonal elements and sum any duplicates.  Blocks without
+        // elements are left empty.
+        template <typename Real>
+        void assemble(
+            Natural const & nmats,
+            std::vector <Natural> const & keys,
+            std::vector <Natural> const & is,
+            std::vector <Natural> const & js,
+            std::vector <Real> const & vals,
+            Problem <Real> & prob
+        ) {
+            auto const nblocks = prob.nblocks();
+            auto const nkeys = nmats*nblocks;
+
+            // Bucket the elements by their key
+            auto key_offsets = std::vector <Natural> (nkeys+1,0);
+            for(auto const & key : keys)
+                key_offsets[key+1]++;
+            for(Natural key=0;key<nkeys;key++)
+                key_offsets[key+1] += key_offsets[key];
+            auto order = std::vector <Natural> (keys.size());
+            {
+                auto next = std::vector <Natural> (key_offsets.begin(),
+                    key_offsets.end()-1);
+                for(Natural k=0;k<keys.size();k++)
+                    order[next[keys[k]]++] = k;
+            }
+
+            // Build each block.  We first scatter both triangles into a CSR
+            // matrix with unsorted columns.  Since the block is symmetric,
+            // its transpose is the same matrix with sorted columns.  Then, we
+            // sum any duplicate elements.
+            prob.A.assign(nmats,
+                std::vector <CSRMatrix <Real> > (nblocks));
+            #ifdef _OPENMP
+            #pragma omp parallel for schedule(dynamic)
+            #endif
+            for(Natural key=0;key<nkeys;key++) {
+                auto const blk = key % nblocks;
+                auto const n = prob.blkSize(blk);
+                auto & A = prob.A[key/nblocks][blk];
+                if(key_offsets[key]==key_offsets[key+1])
+                    continue;
+
+                // Scatter the elements into their rows
+                auto A0 = CSRMatrix <Real> (n,n);
+                for(Natural kk=key_offsets[key];kk<key_offsets[key+1];kk++){
+                    auto k = order[kk];
+                    A0.offsets[is[k]+1]++;
+                    if(is[k]!=js[k]) A0.offsets[js[k]+1]++;
+                }
+                for(Natural r=0;r<n;r++)
+                    A0.offsets[r+1] += A0.offsets[r];
+                A0.cols.resize(A0.offsets.back());
+                A0.vals.resize(A0.offsets.back());
+                auto next = std::vector <Natural> (A0.offsets.begin(),
+                    A0.offsets.end()-1);
+                for(Natural kk=key_offsets[key];kk<key_offsets[key+1];kk++){
+                    auto k = order[kk];
+                    auto kr = next[is[k]]++;
+                    A0.cols[kr] = js[k];
+                    A0.vals[kr] = vals[k];
+                    if(is[k]!=js[k]) {
+                        auto kc = next[js[k]]++;
+                        A0.cols[kc] = is[k];
+                        A0.vals[kc] = vals[k];
+                    }
+                }
+
+                // Sort the columns
+                csrtrans(A0,A);
+
+                // Sum the duplicates in place
+                auto nnz = Natural(0);
+                for(Natural r=0;r<n;r++) {
+                    auto start = nnz;
+                    for(Natural k=A.offsets[r];k<A.offsets[r+1];k++) {
+                        if(nnz > start && A.cols[nnz-1]==A.cols[k])
+                            A.vals[nnz-1] += A.vals[k];
+                        else {
+                            A.cols[nnz] = A.cols[k];
+                            A.vals[nnz] = A.vals[k];
+                            nnz++;
+                        }
+                    }
+                    A.offsets[r] = start;
+                }
+                A.offsets[n] = nnz;
+                A.cols.resize(nnz);
+                A.vals.resize(nnz);
+            }
+        }
+
+        // Reads a sparse SDPA problem from a buffer holding a file
+        template <typename Real>
+        void parse(std::string && contents,Problem <Real> & prob) {
+            Scanner scan(std::move(contents));
+
+            // Skip the comments and then read the number of constraint
+            // matrices and blocks.  Ignore anything else on these lines.
+            scan.skip_comments();
+            auto m = scan.read_integer("the number of constraint matrices");
+            scan.skip_line();
+            auto nblocks = scan.read_integer("the number of blocks");
+            scan.skip_line();
+            if(m < 0 || nblocks <= 0)
+                throw Exception::t(__LOC__
+                    + ", the number of constraint matrices must be "
+                    "nonnegative and the number of blocks must be positive");
+
+            // Read in the sizes of the blocks
+            prob.blk_sizes.resize(nblocks);
+            for(auto & blk_size : prob.blk_sizes) {
+                scan.skip_formatting(false);
+                blk_size = scan.read_integer("the block sizes");
+                if(blk_size == 0)
+                    throw Exception::t(__LOC__
+                        + ", the block sizes must be nonzero");
+            }
+            scan.skip_line();
+
+            // Read in the objective function
+            prob.b.resize(m);
+            for(auto & b_i : prob.b) {
+                scan.skip_formatting(true);
+                b_i = Real(scan.read_real("the objective"));
+            }
+            scan.skip_line();
+
+            // Read in the elements of the constraint matrices.  We bucket
+            // them by their matrix and block, so key = i*nblocks + blk.
+            auto keys = std::vector <Natural> ();
+            auto is = std::vector <Natural> ();
+            auto js = std::vector <Natural> ();
+            auto vals = std::vector <Real> ();
+            while(scan.skip_formatting(true)) {
+                auto matno = scan.read_integer("the matrix number");
+                scan.skip_formatting(false);
+                auto blkno = scan.read_integer("the block number");
+                scan.skip_formatting(false);
+                auto i = scan.read_integer("the row");
+                scan.skip_formatting(false);
+                auto j = scan.read_integer("the column");
+                scan.skip_formatting(false);
+                auto val = Real(scan.read_real("the matrix element"));
+
+                // Make sure the element is in range
+                if(matno < 0 || matno > m || blkno < 1 || blkno > nblocks)
+                    throw Exception::t(__LOC__
+                        + ", the matrix or block number of a constraint "
+                        "element is out of range");
+                auto n = Integer(prob.blkSize(blkno-1));
+                if(i < 1 || i > n || j < 1 || j > n)
+                    throw Exception::t(__LOC__
+                        + ", the row or column of a constraint element is "
+                        "out of range");
+                if(prob.blk_sizes[blkno-1] < 0 && i != j)
+                    throw Exception::t(__LOC__
+                        + ", specified an off-diagonal element of a diagonal "
+                        "block");
+
+                keys.emplace_back(Natural(matno)*nblocks + Natural(blkno-1));
+                is.emplace_back(i-1);
+                js.emplace_back(j-1);
+                vals.emplace_back(val);
+            }
+
+            // Assemble the constraint matrices
+            assemble <Real> (m+1,keys,is,js,vals,prob);
+        }
+
+        // Reads a sparse SDPA problem from file
+        template <typename Real>
+        void read(std::string const & fname,Problem <Real> & prob) {
+            parse <Real> (read_file(fname),prob);
+        }
+
+        // Creates an element in the codomain of the SDP inequality
+        template <typename Real>
+        typename SQL <Real>::Vector init_codomain(Problem <Real> const & prob){
+            auto sizes = std::vector <Natural> (prob.nblocks());
+            auto types = std::vector <Cone::t> (prob.nblocks());
+            for(Natural blk=0;blk<prob.nblocks();blk++) {
+                sizes[blk] = prob.blkSize(blk);
+                types[blk] = prob.blk_sizes[blk] < 0 ? Cone::Linear
+                                                     : Cone::Semidefinite;
+            }
+            return typename SQL <Real>::Vector(types,sizes);
+        }
+
+        // Chordal decomposition of an SDP.  Let
+        //
+        // S(x) = A1*x1 + ... + Am*xm - A0
+        //
+        // be a semidefinite block and let F be a chordal extension of its
+        // aggregate sparsity pattern, the union of the patterns of A0,...,Am.
+        // A positive semidefinite matrix with the pattern F is a sum of
+        // positive semidefinite matrices, each supported on one of the
+        // maximal cliques C_1,...,C_p of F.  Hence, S(x) >= 0 if and only if
+        // there are S_k >= 0 with
+        //
+        // S(x) = sum_k P_k' S_k P_k
+        //
+        // where P_k selects the rows in C_k.  We replace the block by one
+        // semidefinite block for each clique.  Elements of F that lie in a
+        // single clique keep their value from S(x).  For elements that lie in
+        // several cliques, we add free coupling variables u to the problem.
+        // The first clique holding the element gets its value from S(x)
+        // minus the sum of the u's and each of the other cliques gets one u.
+        // This keeps the problem in SDPA form, so none of the other pieces
+        // need to change.
+        //
+        // We find F from a minimum degree ordering and the symbolic Cholesky
+        // factorization.  The candidate clique for column j of the factor L
+        // is j along with the rows of L in column j.  It's not maximal
+        // exactly when a child c of j in the elimination tree has one more
+        // element in its column.
+        template <typename Real>
+        struct Decomposition {
+            // Converted problem.  The first m variables are the variables of
+            // the original problem and the rest are the coupling variables.
+            Problem <Real> prob;
+
+            // For each block of the converted problem, the block of the
+            // original problem that it came from and the rows of that block
+            // that it covers
+            std::vector <Natural> blk_origin;
+            std::vector <std::vector <Natural> > blk_rows;
+        };
+
+        // Finds the maximal cliques of a chordal extension of the aggregate
+        // sparsity pattern of a semidefinite block.  The rows in each clique
+        // are sorted.
+        template <typename Real>
+        std::vector <std::vector <Natural> > cliques(
+            Problem <Real> const & prob,
+            Natural const & blk
+        ) {
+            // Find the aggregate sparsity pattern.  We give it values that
+            // make it diagonally dominant, so the factorization never
+            // perturbs a pivot.
+            auto const n = prob.blkSize(blk);
+            auto adj = std::vector <std::vector <Natural> > (n);
+            for(Natural r=0;r<n;r++)
+                adj[r].emplace_back(r);
+            for(auto const & Ai : prob.A)
+                for(Natural r=0;r<Ai[blk].m;r++)
+                    for(Natural k=Ai[blk].offsets[r];k<Ai[blk].offsets[r+1];
+                        k++
+                    )
+                        adj[r].emplace_back(Ai[blk].cols[k]);
+            auto E = CSRMatrix <Real> (n,n);
+            for(Natural r=0;r<n;r++) {
+                std::sort(adj[r].begin(),adj[r].end());
+                adj[r].erase(std::unique(adj[r].begin(),adj[r].end()),
+                    adj[r].end());
+                for(auto const & c : adj[r]) {
+                    E.cols.emplace_back(c);
+                    E.vals.emplace_back(c==r ? Real(n) : Real(1.));
+                }
+                E.offsets[r+1] = E.cols.size();
+            }
+
+            // Find the structure of the Cholesky factor
+            SparseLDLT <Real> ldlt;
+            ldlt.analyze(E);
+            ldlt.factor(E,std::vector <Real> (n,Real(1.)),
+                std::numeric_limits <Real>::min());
+
+            // Find the maximal cliques
+            auto count = [&](Natural const & j) {
+                return ldlt.Lp[j+1]-ldlt.Lp[j];
+            };
+            auto maximal = std::vector <bool> (n,true);
+            for(Natural c=0;c<n;c++)
+                if(ldlt.parent[c]!=n && count(c)==count(ldlt.parent[c])+1)
+                    maximal[ldlt.parent[c]] = false;
+            auto C = std::vector <std::vector <Natural> > ();
+            for(Natural j=0;j<n;j++) {
+                if(!maximal[j]) continue;
+                C.emplace_back(1,ldlt.perm[j]);
+                for(Natural p=ldlt.Lp[j];p<ldlt.Lp[j+1];p++)
+                    C.back().emplace_back(ldlt.perm[ldlt.Li[p]]);
+                std::sort(C.back().begin(),C.back().end());
+            }
+            return C;
+        }
+
+        // Decomposes the semidefinite blocks with at least size_min rows
+        template <typename Real>
+        void decompose(
+            Problem <Real> const & prob,
+            Natural const & size_min,
+            Decomposition <Real> & dec
+        ) {
+            // Elements of the converted problem, which we assemble at the end
+            auto mats = std::vector <Natural> ();
+            auto blks = std::vector <Natural> ();
+            auto is = std::vector <Natural> ();
+            auto js = std::vector <Natural> ();
+            auto vals = std::vector <Real> ();
+            auto add = [&](
+                Natural const & i,
+                Natural const & blk,
+                Natural const & r,
+                Natural const & c,
+                Real const & val
+            ) {
+                mats.emplace_back(i);
+                blks.emplace_back(blk);
+                is.emplace_back(r);
+                js.emplace_back(c);
+                vals.emplace_back(val);
+            };
+
+            // Start with the original variables
+            auto & conv = dec.prob;
+            conv.b = prob.b;
+            conv.blk_sizes.clear();
+            dec.blk_origin.clear();
+            dec.blk_rows.clear();
+
+            // Convert each block
+            for(Natural blk=0;blk<prob.nblocks();blk++) {
+                auto const n = prob.blkSize(blk);
+
+                // Copy small blocks and diagonal blocks as they are.  We only
+                // need the upper triangle since assemble mirrors the rest.
+                if(prob.blk_sizes[blk] < 0 || n < size_min) {
+                    auto blk_new = conv.nblocks();
+                    conv.blk_sizes.emplace_back(prob.blk_sizes[blk]);
+                    dec.blk_origin.emplace_back(blk);
+                    dec.blk_rows.emplace_back(n);
+                    for(Natural r=0;r<n;r++)
+                        dec.blk_rows.back()[r] = r;
+                    for(Natural i=0;i<prob.A.size();i++) {
+                        auto const & A = prob.A[i][blk];
+                        for(Natural r=0;r<A.m;r++)
+                            for(Natural k=A.offsets[r];k<A.offsets[r+1];k++)
+                                if(r <= A.cols[k])
+                                    add(i,blk_new,r,A.cols[k],A.vals[k]);
+                    }
+                    continue;
+                }
+
+                // Add a block for each clique
+                auto const C = cliques(prob,blk);
+                auto const blk0 = conv.nblocks();
+                for(auto const & Ck : C) {
+                    conv.blk_sizes.emplace_back(Ck.size());
+                    dec.blk_origin.emplace_back(blk);
+                    dec.blk_rows.emplace_back(Ck);
+                }
+
+                // Find the cliques that hold each element (r,c) with r <= c.
+                // We sort by the element and then by the clique.
+                auto owners = std::vector <std::tuple <Natural,Natural> > ();
+                for(Natural k=0;k<C.size();k++)
+                    for(Natural a=0;a<C[k].size();a++)
+                        for(Natural b=a;b<C[k].size();b++)
+                            owners.emplace_back(C[k][a]*n+C[k][b],k);
+                std::sort(owners.begin(),owners.end());
+
+                // Finds the local row of r in clique k
+                auto local = [&](Natural const & k,Natural const & r) {
+                    return Natural(std::lower_bound(C[k].begin(),C[k].end(),r)
+                        - C[k].begin());
+                };
+
+                // Couple the elements held by several cliques
+                for(Natural p=0;p<owners.size();) {
+                    auto const key = std::get <0> (owners[p]);
+                    auto const r = key / n;
+                    auto const c = key % n;
+                    auto const k0 = std::get <1> (owners[p]);
+                    for(p++; p<owners.size() && std::get<0>(owners[p])==key;
+                        p++
+                    ) {
+                        auto const k = std::get <1> (owners[p]);
+                        auto const i = conv.b.size()+1;
+                        conv.b.emplace_back(Real(0.));
+                        add(i,blk0+k,local(k,r),local(k,c),Real(1.));
+                        add(i,blk0+k0,local(k0,r),local(k0,c),Real(-1.));
+                    }
+                }
+
+                // Give each element of S(x) to the first clique that holds it
+                for(Natural i=0;i<prob.A.size();i++) {
+                    auto const & A = prob.A[i][blk];
+                    for(Natural r=0;r<A.m;r++)
+                        for(Natural k=A.offsets[r];k<A.offsets[r+1];k++) {
+                            auto const c = A.cols[k];
+                            if(r > c) continue;
+                            auto const owner = std::lower_bound(
+                                owners.begin(),owners.end(),
+                                std::make_tuple(r*n+c,Natural(0)));
+                            if( owner==owners.end() ||
+                                std::get <0> (*owner)!=r*n+c
+                            )
+                                throw Exception::t(__LOC__
+                                    + ", the chordal extension is missing "
+                                    "an element of the sparsity pattern");
+                            auto const k0 = std::get <1> (*owner);
+                            add(i,blk0+k0,local(k0,r),local(k0,c),A.vals[k]);
+                        }
+                }
+            }
+
+            // Assemble the converted problem
+            auto const nblocks = conv.nblocks();
+            auto keys = std::vector <Natural> (mats.size());
+            for(Natural k=0;k<mats.size();k++)
+                keys[k] = mats[k]*nblocks + blks[k];
+            assemble <Real> (conv.b.size()+1,keys,is,js,vals,conv);
+        }
+
+        // The constraint matrices A1,...,Am stacked together and stored by
+        // row.  We number the rows of all of the blocks consecutively and then
+        // row r holds the elements A_mats[k](r,cols[k]) = vals[k] for
+        // k = offsets[r],...,offsets[r+1]-1.
+        template <typename Real>
+        struct Stacked {
+            // Elements of each row
+            std::vector <Natural> offsets;
+            std::vector <Natural> mats;
+            std::vector <Natural> cols;
+            std::vector <Real> vals;
+
+            // Block and offset of the block for each of the stacked rows
+            std::vector <Natural> row_blk;
+            std::vector <Natural> row_start;
+
+            // Stack the constraint matrices by row
+            explicit Stacked(Problem <Real> const & prob) :
+                offsets(), mats(), cols(), vals(), row_blk(),
+                row_start(prob.nblocks()+1,0)
+            {
+                // Figure out where each block starts
+                for(Natural blk=0;blk<prob.nblocks();blk++)
+                    row_start[blk+1] = row_start[blk] + prob.blkSize(blk);
+                auto nrows = row_start.back();
+                row_blk.resize(nrows);
+                for(Natural blk=0;blk<prob.nblocks();blk++)
+                    std::fill(row_blk.begin()+row_start[blk],
+                        row_blk.begin()+row_start[blk+1],blk);
+
+                // Count the elements in each row
+                offsets.assign(nrows+1,0);
+                for(Natural i=1;i<=prob.m();i++)
+                    for(Natural blk=0;blk<prob.nblocks();blk++) {
+                        auto const & A = prob.A[i][blk];
+                        for(Natural r=0;r<A.m;r++)
+                            offsets[row_start[blk]+r+1]
+                                += A.offsets[r+1]-A.offsets[r];
+                    }
+                for(Natural r=0;r<nrows;r++)
+                    offsets[r+1] += offsets[r];
+
+                // Scatter the elements into their rows
+                mats.resize(offsets.back());
+                cols.resize(offsets.back());
+                vals.resize(offsets.back());
+                auto next = std::vector <Natural> (offsets.begin(),
+                    offsets.end()-1);
+                for(Natural i=1;i<=prob.m();i++)
+                    for(Natural blk=0;blk<prob.nblocks();blk++) {
+                        auto const & A = prob.A[i][blk];
+                        for(Natural r=0;r<A.m;r++)
+                            for(Natural k=A.offsets[r];k<A.offsets[r+1];k++){
+                                auto kk = next[row_start[blk]+r]++;
+                                mats[kk] = i-1;
+                                cols[kk] = A.cols[k];
+                                vals[kk] = A.vals[k];
+                            }
+                    }
+            }
+        };
+
+        // Defines the SDP inequality
+        //
+        // h(x) = A1*x1 + ... + Am*xm - A0 >= 0
+        //
+        // The codomain may have additional cones past the blocks of the SDP.
+        // We zero these on output and ignore them on input, which lets other
+        // inequalities extend this one.  Similarly, x may have additional
+        // elements past the first m, which we ignore.
+        template <typename Real>
+        struct Inequality : public VectorValuedFunction <Real,Rm,SQL> {
+        public:
+            // Create some type shortcuts
+            typedef Rm <Real> X;
+            typedef typename X::Vector X_Vector;
+            typedef SQL <Real> Z;
+            typedef typename Z::Vector Z_Vector;
+
+        private:
+            // Underlying SDP problem
+            Problem <Real> const & prob;
+
+            // The matrices A1,...,Am stacked by row
+            Stacked <Real> const A;
+
+            // z <- A1*x1 + ... + Am*xm on the SDP blocks of z
+            void accumulate(X_Vector const & x,Z_Vector & z) const {
+                // Each row of a semidefinite block is a column of the
+                // column-major storage in z since the block is symmetric.
+                // This means that each row is written by a single thread.
+                #ifdef _OPENMP
+                #pragma omp parallel for schedule(static)
+                #endif
+                for(Natural r=0;r<A.row_blk.size();r++) {
+                    auto const blk = A.row_blk[r];
+                    auto const rr = r-A.row_start[blk];
+                    auto const n = prob.blkSize(blk);
+                    auto const z_r = &(z.data[z.offsets[blk]])
+                        + (prob.blk_sizes[blk] < 0 ? 0 : rr*n);
+                    for(Natural k=A.offsets[r];k<A.offsets[r+1];k++)
+                        z_r[A.cols[k]] += A.vals[k]*x[A.mats[k]];
+                }
+            }
+
+        public:
+            // Disallow copying since we hold a reference to the problem
+            NO_COPY_ASSIGNMENT(Inequality)
+
+            // Grab a reference to the problem and stack its constraint
+            // matrices
+            explicit Inequality(Problem <Real> const & prob_) :
+                prob(prob_), A(prob_) {}
+
+            // z=h(x)
+            void eval(
+                X_Vector const & x,
+                Z_Vector & z
+            ) const {
+                // z <- A1*x1 + ... + Am*xm
+                Z::zero(z);
+                accumulate(x,z);
+
+                // z <- z - A0
+                for(Natural blk=0;blk<prob.nblocks();blk++) {
+                    auto const & A = prob.A[0][blk];
+                    auto const n = prob.blkSize(blk);
+                    auto const diag = prob.blk_sizes[blk] < 0;
+                    auto const z_blk = &(z.data[z.offsets[blk]]);
+                    for(Natural r=0;r<A.m;r++)
+                        for(Natural k=A.offsets[r];k<A.offsets[r+1];k++)
+                            z_blk[diag ? r : A.cols[k]+r*n] -= A.vals[k];
+                }
+            }
+
+            // z=h'(x)dx
+            void p(
+                X_Vector const & x,
+                X_Vector const & dx,
+                Z_Vector & z
+            ) const {
+                Z::zero(z);
+                accumulate(dx,z);
+            }
+
+            // xhat=h'(x)*dz
+            void ps(
+                X_Vector const & x,
+                Z_Vector const & dz,
+                X_Vector & xhat
+            ) const {
+                // Each element of xhat is the inner product <A_i,dz>, so we
+                // split the constraint matrices between threads
+                X::zero(xhat);
+                auto const m = prob.m();
+                #ifdef _OPENMP
+                #pragma omp parallel for schedule(dynamic)
+                #endif
+                for(Natural i=0;i<m;i++) {
+                    auto xhat_i = Real(0.);
+                    for(Natural blk=0;blk<prob.nblocks();blk++) {
+                        auto const & A = prob.A[i+1][blk];
+                        auto const n = prob.blkSize(blk);
+                        auto const diag = prob.blk_sizes[blk] < 0;
+                        auto const dz_blk = &(dz.data[dz.offsets[blk]]);
+                        for(Natural r=0;r<A.m;r++)
+                            for(Natural k=A.offsets[r];k<A.offsets[r+1];k++)
+                                xhat_i += A.vals[k]
+                                    * dz_blk[diag ? r : A.cols[k]+r*n];
+                    }
+                    xhat[i] = xhat_i;
+                }
+            }
+
+            // xhat=(h''(x)dx)*dz
+            void pps(
+                X_Vector const & x,
+                X_Vector const & dx,
+                Z_Vector const & dz,
+                X_Vector & xhat
+            ) const {
+                X::zero(xhat);
+            }
+
+            // The SDP constraints are affine
+            bool is_affine() const {
+                return true;
+            }
+        };
+
+        // Columns of the Jacobian of an affine inequality into SQL.  Column i
+        // holds the sparse blocks of h'(x) e_i in the same format as the
+        // constraint matrices of a problem, so semidefinite blocks hold both
+        // triangles and diagonal blocks hold only their diagonal.
+        template <typename Real>
+        using Columns = std::vector <std::vector <CSRMatrix <Real> > >;
+
+        // Grabs the columns of the Jacobian of the SDP inequality
+        //
+        // h(x) = A1*x1 + ... + Am*xm - A0
+        //
+        template <typename Real>
+        Columns <Real> columns(Problem <Real> const & prob) {
+            return Columns <Real> (prob.A.begin()+1,prob.A.end());
+        }
+
+        // Preconditions the interior point Hessian of a linear SDP with the
+        // exact inverse of its Schur complement.  For an affine inequality
+        // with columns A_1,...,A_m and a linear objective, the Hessian used
+        // by the interior point method is
+        //
+        // M_ij = tr(A_i P A_j Q)
+        //
+        // where P = inv(h(x)) and Q = z or, with Nesterov-Todd scaling,
+        // P = Q = W.  Rather than forming M with m Hessian-vector products,
+        // we assemble it directly from the sparse A_i.  Following SDPA, we
+        // choose for each column between three formulas based on the
+        // sparsity of A_j:
+        //
+        // F1 : G = P A_j Q densely, then M_ij = sum_{(p,q) in A_i}
+        //          A_i(p,q) G(q,p)
+        // F2 : F = P A_j, then M_ij = sum_{(p,q) in A_i}
+        //          A_i(p,q) <F(q,:),Q(:,p)>
+        // F3 : M_ij = sum_{(p,q) in A_i} sum_{(r,s) in A_j}
+        //          A_i(p,q) A_j(r,s) P(q,r) Q(s,p)
+        //
+        // We assemble the columns in parallel and then factor M with a
+        // Cholesky factorization.  Since the preconditioner is then the
+        // inverse of the Hessian, truncated-CG converges in a single
+        // iteration.  Second-order cones aren't supported.
+        template <typename Real>
+        struct Schur : public Operator <Real,Rm,Rm> {
+        public:
+            // Create some type shortcuts
+            typedef Rm <Real> X;
+            typedef typename X::Vector X_Vector;
+            typedef SQL <Real> Z;
+            typedef typename Z::Vector Z_Vector;
+            typedef typename InequalityConstrained <Real,Rm,SQL>::State::t
+                State;
+
+        private:
+            // Columns of h'(x)
+            Columns <Real> const cols;
+
+            // Row of each nonzero in the columns of h'(x).  With the CSR
+            // columns, this lets us loop over the nonzeros of a block
+            // directly.
+            std::vector <std::vector <std::vector <Natural> > > rows;
+
+            // Number of nonzeros in each block summed over all of the columns
+            std::vector <Natural> nnz;
+
+            // Current iterate, inequality constraint, multiplier, and scaling
+            X_Vector const & x;
+            Z_Vector const & h_x;
+            Z_Vector const & z;
+            InteriorPointScaling::t const & ip_scaling;
+
+            // Variables used for caching.  The boolean values denote whether
+            // or not we've started caching yet.
+            mutable std::pair <bool,X_Vector> x_last;
+            mutable std::pair <bool,Z_Vector> z_last;
+
+            // Schur complement and then its Choleski factorization
+            mutable std::vector <Real> M;
+
+            // Whether the factorization succeeded and is well conditioned
+            mutable bool factored;
+
+            // Adds the contribution of a linear block to M
+            void assemble_linear(Natural const & blk) const {
+                // Get the number of columns and the size of the block
+                auto const m = cols.size();
+                auto const n = h_x.blkSize(blk);
+
+                // d <- z / h(x), which is also w^2 with Nesterov-Todd scaling
+                auto d = std::vector <Real> (n);
+                for(Natural k=1;k<=n;k++)
+                    d[k-1] = z(blk,k)/h_x(blk,k);
+
+                // Loop over the columns
+                #ifdef _OPENMP
+                #pragma omp parallel for schedule(dynamic)
+                #endif
+                for(Natural j=0;j<m;j++) {
+                    auto const & Aj = cols[j][blk-1];
+                    auto const & rows_j = rows[j][blk-1];
+                    if(Aj.nnz()==0) continue;
+
+                    // v <- d o A_j
+                    auto v = std::vector <Real> (n,Real(0.));
+                    for(Natural k=0;k<Aj.nnz();k++)
+                        v[rows_j[k]] += Aj.vals[k]*d[rows_j[k]];
+
+                    // M_ij += <A_i,v>
+                    for(Natural i=0;i<m;i++) {
+                        auto const & Ai = cols[i][blk-1];
+                        auto const & rows_i = rows[i][blk-1];
+                        for(Natural k=0;k<Ai.nnz();k++)
+                            M[i+j*m] += Ai.vals[k]*v[rows_i[k]];
+                    }
+                }
+            }
+
+            // Adds the contribution of a semidefinite block to M
+            void assemble_semidefinite(
+                Natural const & blk,
+                std::vector <Real> const & P,
+                std::vector <Real> const & Q
+            ) const {
+                // Get the number of columns and the size of the block
+                auto const m = cols.size();
+                auto const n = h_x.blkSize(blk);
+                auto const nn = Real(n);
+                auto const nnz_blk = Real(nnz[blk-1]);
+
+                // Loop over the columns
+                #ifdef _OPENMP
+                #pragma omp parallel for schedule(dynamic)
+                #endif
+                for(Natural j=0;j<m;j++) {
+                    auto const & Aj = cols[j][blk-1];
+                    auto const & rows_j = rows[j][blk-1];
+                    auto const nnz_j = Real(Aj.nnz());
+                    if(Aj.nnz()==0) continue;
+
+                    // Estimate the cost of each formula
+                    auto const cost1 = nn*nnz_j + nn*nn*nn + nnz_blk;
+                    auto const cost2 = nn*nnz_j + nn*nnz_blk;
+                    auto const cost3 = nnz_j*nnz_blk;
+
+                    // F3 works entirely with the sparse elements
+                    if(cost3 <= cost1 && cost3 <= cost2) {
+                        for(Natural i=0;i<m;i++) {
+                            auto const & Ai = cols[i][blk-1];
+                            auto const & rows_i = rows[i][blk-1];
+                            auto Mij = Real(0.);
+                            for(Natural k=0;k<Ai.nnz();k++)
+                                for(Natural l=0;l<Aj.nnz();l++)
+                                    Mij += Ai.vals[k]*Aj.vals[l]
+                                        * P[Ai.cols[k]+rows_j[l]*n]
+                                        * Q[Aj.cols[l]+rows_i[k]*n];
+                            M[i+j*m] += Mij;
+                        }
+                        continue;
+                    }
+
+                    // F <- P A_j
+                    auto F = std::vector <Real> (n*n,Real(0.));
+                    for(Natural l=0;l<Aj.nnz();l++)
+                        axpy <Real> (n,Aj.vals[l],
+                            &(P[rows_j[l]*n]),1,&(F[Aj.cols[l]*n]),1);
+
+                    // F1 forms P A_j Q densely
+                    if(cost1 < cost2) {
+                        auto G = std::vector <Real> (n*n);
+                        gemm <Real> ('N','N',n,n,n,Real(1.),&(F[0]),n,
+                            &(Q[0]),n,Real(0.),&(G[0]),n);
+                        for(Natural i=0;i<m;i++) {
+                            auto const & Ai = cols[i][blk-1];
+                            auto const & rows_i = rows[i][blk-1];
+                            for(Natural k=0;k<Ai.nnz();k++)
+                                M[i+j*m] += Ai.vals[k]
+                                    * G[Ai.cols[k]+rows_i[k]*n];
+                        }
+
+                    // F2 only finds the elements of P A_j Q that we need
+                    } else {
+                        for(Natural i=0;i<m;i++) {
+                            auto const & Ai = cols[i][blk-1];
+                            auto const & rows_i = rows[i][blk-1];
+                            for(Natural k=0;k<Ai.nnz();k++)
+                                M[i+j*m] += Ai.vals[k] * dot <Real> (n,
+                                    &(F[Ai.cols[k]]),n,&(Q[rows_i[k]*n]),1);
+                        }
+                    }
+                }
+            }
+
+        public:
+            // Disallow copying since we hold references to the state
+            NO_COPY_ASSIGNMENT(Schur)
+
+            // Take the columns of h'(x) and grab references to the state
+            Schur(Columns <Real> && cols_,State const & state) :
+                cols(std::move(cols_)),
+                rows(),
+                nnz(),
+                x(state.x),
+                h_x(state.h_x),
+                z(state.z),
+                ip_scaling(state.ip_scaling),
+                x_last(false,X::init(state.x)),
+                z_last(false,Z::init(state.z)),
+                M(cols.size()*cols.size()),
+                factored(false)
+            {
+                // We only know how to assemble linear and semidefinite blocks
+                for(Natural blk=1;blk<=state.z.numBlocks();blk++)
+                    if(state.z.blkType(blk)==Cone::Quadratic)
+                        throw Exception::t(__LOC__
+                            + ", the Schur complement does not support "
+                            "second-order cones");
+
+                // Find the row of each nonzero and count the nonzeros in each
+                // block
+                nnz.resize(state.z.numBlocks());
+                for(auto const & col : cols) {
+                    if(col.size() != nnz.size())
+                        throw Exception::t(__LOC__
+                            + ", each column of h'(x) must have a block for "
+                            "each cone");
+                    rows.emplace_back();
+                    for(Natural blk=0;blk<nnz.size();blk++) {
+                        auto const & A = col[blk];
+                        rows.back().emplace_back(A.nnz());
+                        for(Natural p=0;p<A.m;p++)
+                            for(Natural k=A.offsets[p];k<A.offsets[p+1];k++)
+                                rows.back().back()[k] = p;
+                        nnz[blk] += A.nnz();
+                    }
+                }
+            }
+
+            // Basic application
+            void eval(X_Vector const & dx,X_Vector & PH_dx) const {
+                // Determine the size of the Schur complement
+                auto const m = cols.size();
+
+                // See if we need to recalculate the preconditioner
+                if( rel_err_cached <Real,Rm> (x,x_last) >=
+                        std::numeric_limits <Real>::epsilon()*1e1 ||
+                    rel_err_cached <Real,SQL> (z,z_last) >=
+                        std::numeric_limits <Real>::epsilon()*1e1
+                ){
+                    // Cache the values
+                    x_last.first=true;
+                    X::copy(x,x_last.second);
+                    z_last.first=true;
+                    Z::copy(z,z_last.second);
+
+                    // Find the Nesterov-Todd scaling point if we need it
+                    auto w = Z::init(z);
+                    if(ip_scaling==InteriorPointScaling::NesterovTodd)
+                        NesterovTodd <Real,SQL>::point(h_x,z,w);
+
+                    // Assemble the Schur complement block by block
+                    std::fill(M.begin(),M.end(),Real(0.));
+                    auto P = std::vector <Real> ();
+                    auto Q = std::vector <Real> ();
+                    for(Natural blk=1;blk<=z.numBlocks();blk++) {
+                        auto const n = z.blkSize(blk);
+                        switch(z.blkType(blk)) {
+                        case Cone::Linear:
+                            assemble_linear(blk);
+                            break;
+                        case Cone::Semidefinite:
+                            if(ip_scaling==InteriorPointScaling::NesterovTodd){
+                                P.assign(&(w.front(blk)),&(w.front(blk))+n*n);
+                                Q = P;
+                            } else {
+                                Z::get_inverse(h_x,blk,P);
+                                Q.assign(&(z.front(blk)),&(z.front(blk))+n*n);
+                            }
+                            assemble_semidefinite(blk,P,Q);
+                            break;
+                        case Cone::Quadratic:
+                            // We reject these during construction
+                            break;
+                        }
+                    }
+
+                    // Find the Choleski factorization of M and then make sure
+                    // that it's well conditioned
+                    auto info = Integer(0);
+                    potrf <Real> ('U',m,&(M[0]),m,info);
+                    auto invCondU = Real(0.);
+                    if(info==0) {
+                        auto work = std::vector <Real> (3*m);
+                        auto iwork = std::vector <Integer> (m);
+                        trcon('I','U','N',m,&(M[0]),m,invCondU,&(work[0]),
+                            &(iwork[0]),info);
+                    }
+                    factored = info==0 &&
+                        invCondU >= std::numeric_limits <Real>::epsilon()*1e3;
+                }
+
+                // Start by copying over the direction
+                X::copy(dx,PH_dx);
+
+                // If we have a factorization, solve with it
+                if(factored) {
+                    trsv <Real> ('U','T','N',m,&(M[0]),m,&(PH_dx[0]),1);
+                    trsv <Real> ('U','N','N',m,&(M[0]),m,&(PH_dx[0]),1);
+                }
+            }
+        };
+
+        // Burer-Monteiro factorization of the dual SDP
+        //
+        // max <A0,X> st <Ai,X> = bi, X >= 0
+        //
+        // We write X = R R' where R has rank columns and minimize -<A0,R R'>
+        // over R subject to the equality constraints.  The blocks of R are
+        // stored by row and we number the rows of the blocks consecutively,
+        // the same as in Stacked, so R takes O(n rank) memory rather than the
+        // O(n^2) of the dense blocks.  Diagonal blocks use the same layout and
+        // only the squared norms of their rows matter.  When rank(rank+1)/2
+        // > m, there's a solution of this rank and, at a second order
+        // critical point, the equality multipliers are a solution x of the
+        // original problem.
+        template <typename Real>
+        struct LowRank {
+            // Create some type shortcuts
+            typedef Rm <Real> X;
+            typedef typename X::Vector X_Vector;
+
+            // Disallow copying since we hold a reference to the problem
+            NO_COPY_ASSIGNMENT(LowRank)
+
+            // Underlying SDP problem
+            Problem <Real> const & prob;
+
+            // Number of columns in R
+            Natural const rank;
+
+            // The matrices A1,...,Am stacked by row
+            Stacked <Real> const A;
+
+            // Elements of A0,...,Am listed by matrix, so that we can take
+            // inner products with a single matrix without looking at every
+            // row.  Matrix i holds the elements (rows[k],cols[k]) = vals[k]
+            // for k = mat_offsets[i],...,mat_offsets[i+1]-1 where the rows
+            // and columns are numbered the same as the rows of R.
+            std::vector <Natural> mat_offsets;
+            std::vector <Natural> mat_rows;
+            std::vector <Natural> mat_cols;
+            std::vector <Real> mat_vals;
+
+            // Grab a reference to the problem and list the elements of its
+            // constraint matrices
+            LowRank(Problem <Real> const & prob_,Natural const & rank_) :
+                prob(prob_), rank(rank_), A(prob_), mat_offsets(1,0),
+                mat_rows(), mat_cols(), mat_vals()
+            {
+                for(auto const & Ai : prob.A) {
+                    for(Natural blk=0;blk<prob.nblocks();blk++) {
+                        auto const & Ai_blk = Ai[blk];
+                        auto const start = A.row_start[blk];
+                        for(Natural j=0;j<Ai_blk.m;j++)
+                            for(Natural k=Ai_blk.offsets[j];
+                                k<Ai_blk.offsets[j+1];
+                                k++
+                            ) {
+                                mat_rows.emplace_back(start+j);
+                                mat_cols.emplace_back(start+Ai_blk.cols[k]);
+                                mat_vals.emplace_back(Ai_blk.vals[k]);
+                            }
+                    }
+                    mat_offsets.emplace_back(mat_vals.size());
+                }
+            }
+
+            // Smallest rank where rank(rank+1)/2 > m
+            static Natural rank_min(Natural const & m) {
+                auto rank = Natural(1);
+                while(rank*(rank+1)/2 <= m)
+                    rank++;
+                return rank;
+            }
+
+            // Number of rows in R
+            Natural nrows() const {
+                return A.row_start.back();
+            }
+
+            // Allocates memory for R
+            X_Vector init() const {
+                return X_Vector(nrows()*rank);
+            }
+
+            // <R_j,S_k> for rows j of R and k of S
+            Real dot(Real const * const R_j,Real const * const S_k) const {
+                auto result = Real(0.);
+                for(Natural l=0;l<rank;l++)
+                    result += R_j[l]*S_k[l];
+                return result;
+            }
+
+            // <Ai,R S'>
+            Real innr(
+                Natural const & i,
+                X_Vector const & R,
+                X_Vector const & S
+            ) const {
+                auto result = Real(0.);
+                for(Natural k=mat_offsets[i];k<mat_offsets[i+1];k++)
+                    result += mat_vals[k]*dot(&(R[mat_rows[k]*rank]),
+                        &(S[mat_cols[k]*rank]));
+                return result;
+            }
+
+            // y_i = <Ai,R S'> for i=1,...,m
+            void innrs(
+                X_Vector const & R,
+                X_Vector const & S,
+                X_Vector & y
+            ) const {
+                #ifdef _OPENMP
+                #pragma omp parallel for schedule(dynamic)
+                #endif
+                for(Natural i=0;i<prob.m();i++)
+                    y[i] = innr(i+1,R,S);
+            }
+
+            // W = A0 S
+            void mult0(X_Vector const & S,X_Vector & W) const {
+                X::zero(W);
+                for(Natural blk=0;blk<prob.nblocks();blk++) {
+                    auto const & A0 = prob.A[0][blk];
+                    auto const start = A.row_start[blk];
+                    #ifdef _OPENMP
+                    #pragma omp parallel for schedule(static)
+                    #endif
+                    for(Natural j=0;j<A0.m;j++) {
+                        auto const W_j = &(W[(start+j)*rank]);
+                        for(Natural k=A0.offsets[j];k<A0.offsets[j+1];k++) {
+                            auto const S_k = &(S[(start+A0.cols[k])*rank]);
+                            for(Natural l=0;l<rank;l++)
+                                W_j[l] += A0.vals[k]*S_k[l];
+                        }
+                    }
+                }
+            }
+
+            // W = (w1 A1 + ... + wm Am) S.  Each row of W only depends on
+            // the same row of the stacked matrices, so the rows are
+            // independent.
+            void mult(
+                X_Vector const & w,
+                X_Vector const & S,
+                X_Vector & W
+            ) const {
+                #ifdef _OPENMP
+                #pragma omp parallel for schedule(static)
+                #endif
+                for(Natural r=0;r<nrows();r++) {
+                    auto const start = A.row_start[A.row_blk[r]];
+                    auto const W_r = &(W[r*rank]);
+                    for(Natural l=0;l<rank;l++)
+                        W_r[l] = Real(0.);
+                    for(Natural k=A.offsets[r];k<A.offsets[r+1];k++) {
+                        auto const alpha = A.vals[k]*w[A.mats[k]];
+                        auto const S_k = &(S[(start+A.cols[k])*rank]);
+                        for(Natural l=0;l<rank;l++)
+                            W_r[l] += alpha*S_k[l];
+                    }
+                }
+            }
+        };
+
+        // Objective of the factored dual SDP
+        //
+        // f(R) = -<A0,R R'>
+        template <typename Real>
+        struct LowRankObjective : public ScalarValuedFunction <Real,Rm> {
+        public:
+            // Create some type shortcuts
+            typedef Rm <Real> X;
+            typedef typename X::Vector X_Vector;
+
+        private:
+            // Factored problem
+            LowRank <Real> const & lr;
+
+        public:
+            // Disallow copying since we hold a reference to the problem
+            NO_COPY_ASSIGNMENT(LowRankObjective)
+
+            // Grab a reference to the factored problem
+            explicit LowRankObjective(LowRank <Real> const & lr_) : lr(lr_) {}
+
+            // Evaluation
+            Real eval(X_Vector const & R) const {
+                return -lr.innr(0,R,R);
+            }
+
+            // grad = -2 A0 R
+            void grad(
+                X_Vector const & R,
+                X_Vector & grad
+            ) const {
+                lr.mult0(R,grad);
+                X::scal(Real(-2.),grad);
+            }
+
+            // H_dR = -2 A0 dR
+            void hessvec(
+                X_Vector const & R,
+                X_Vector const & dR,
+                X_Vector & H_dR
+            ) const {
+                lr.mult0(dR,H_dR);
+                X::scal(Real(-2.),H_dR);
+            }
+        };
+
+        // Equality constraints of the factored dual SDP
+        //
+        // g(R)_i = <Ai,R R'> - bi = 0
+        template <typename Real>
+        struct LowRankEquality : public VectorValuedFunction <Real,Rm,Rm> {
+        public:
+            // Create some type shortcuts
+            typedef Rm <Real> X;
+            typedef typename X::Vector X_Vector;
+            typedef Rm <Real> Y;
+            typedef typename Y::Vector Y_Vector;
+
+        private:
+            // Factored problem
+            LowRank <Real> const & lr;
+
+        public:
+            // Disallow copying since we hold a reference to the problem
+            NO_COPY_ASSIGNMENT(LowRankEquality)
+
+            // Grab a reference to the factored problem
+            explicit LowRankEquality(LowRank <Real> const & lr_) : lr(lr_) {}
+
+            // y=g(R)
+            void eval(
+                X_Vector const & R,
+                Y_Vector & y
+            ) const {
+                lr.innrs(R,R,y);
+                Y::axpy(Real(-1.),lr.prob.b,y);
+            }
+
+            // y=g'(R)dR = 2 <Ai,R dR'>
+            void p(
+                X_Vector const & R,
+                X_Vector const & dR,
+                Y_Vector & y
+            ) const {
+                lr.innrs(R,dR,y);
+                Y::scal(Real(2.),y);
+            }
+
+            // xhat=g'(R)*dy = 2 (dy1 A1 + ... + dym Am) R
+            void ps(
+                X_Vector const & R,
+                Y_Vector const & dy,
+                X_Vector & xhat
+            ) const {
+                lr.mult(dy,R,xhat);
+                X::scal(Real(2.),xhat);
+            }
+
+            // xhat=(g''(R)dR)*dy = 2 (dy1 A1 + ... + dym Am) dR
+            void pps(
+                X_Vector const & R,
+                X_Vector const & dR,
+                Y_Vector const & dy,
+                X_Vector & xhat
+            ) const {
+                lr.mult(dy,dR,xhat);
+                X::scal(Real(2.),xhat);
+            }
+        };
+
+        // Jacobi preconditioner for the Schur complement g'(R)g'(R)* of the
+        // factored dual SDP, whose diagonal is 4 ||Ai R||^2.  When the Ai
+        // have disjoint rows, such as the constraints diag(X) = 1 of a
+        // max-cut relaxation, this is the exact inverse.
+        template <typename Real>
+        struct LowRankSchur : public Operator <Real,Rm,Rm> {
+        public:
+            // Create some type shortcuts
+            typedef Rm <Real> X;
+            typedef typename X::Vector X_Vector;
+            typedef Rm <Real> Y;
+            typedef typename Y::Vector Y_Vector;
+
+        private:
+            // Factored problem
+            LowRank <Real> const & lr;
+
+            // Current iterate
+            X_Vector const & R;
+
+            // Iterate where we last computed the diagonal
+            mutable std::pair <bool,X_Vector> R_last;
+
+            // Diagonal of the Schur complement
+            mutable Y_Vector diag;
+
+        public:
+            // Disallow copying since we hold a reference to the problem
+            NO_COPY_ASSIGNMENT(LowRankSchur)
+
+            // Grab references to the factored problem and the iterate
+            LowRankSchur(LowRank <Real> const & lr_,X_Vector const & R_) :
+                lr(lr_), R(R_), R_last(false,X::init(R_)),
+                diag(lr_.prob.m())
+            {}
+
+            // result = inv(diag) dy
+            void eval(Y_Vector const & dy,Y_Vector & result) const {
+                // Update the diagonal when the iterate changes
+                if( rel_err_cached <Real,Rm> (R,R_last)
+                    >= std::numeric_limits <Real>::epsilon()*1e1
+                ) {
+                    R_last.first=true;
+                    X::copy(R,R_last.second);
+                    auto const rank = lr.rank;
+                    #ifdef _OPENMP
+                    #pragma omp parallel for schedule(dynamic)
+                    #endif
+                    for(Natural i=0;i<diag.size();i++) {
+                        // The elements of each matrix are sorted by row, so
+                        // we accumulate one row of Ai R at a time
+                        auto v = std::vector <Real> (rank);
+                        auto diag_i = Real(0.);
+                        auto const kend = lr.mat_offsets[i+2];
+                        for(Natural k=lr.mat_offsets[i+1];k<kend;) {
+                            auto const row = lr.mat_rows[k];
+                            std::fill(v.begin(),v.end(),Real(0.));
+                            for(; k<kend && lr.mat_rows[k]==row; k++) {
+                                auto const R_k = &(R[lr.mat_cols[k]*rank]);
+                                for(Natural l=0;l<rank;l++)
+                                    v[l] += lr.mat_vals[k]*R_k[l];
+                            }
+                            diag_i += lr.dot(&(v[0]),&(v[0]));
+                        }
+                        diag[i] = diag_i > Real(0.) ? Real(4.)*diag_i
+                                                    : Real(1.);
+                    }
+                }
+
+                // Apply the inverse of the diagonal
+                for(Natural i=0;i<diag.size();i++)
+                    result[i] = dy[i]/diag[i];
+            }
+        };
+    }
+}
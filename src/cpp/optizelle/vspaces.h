@@ -159,9 +159,10 @@ namespace Optizelle {
                 // Create a jsoncpp object to copy into
                 Json::Value x_json;  
 
-                // Copy the information
+                // Copy the information.  Write the elements as reals, so
+                // that infinite elements, such as missing bounds, survive.
                 for(Natural i=0;i<x.size();i++)
-                    x_json[Json::ArrayIndex(i)]=x[i];
+                    x_json[Json::ArrayIndex(i)]=write::real(x[i]);
 
                 // Return a string of the result
                 Json::StyledWriter writer;
@@ -179,7 +180,8 @@ namespace Optizelle {
                 // Create a vector from the json tree 
                 std::vector <Real> x(x_json.size());
                 for(Natural i=0;i<x.size();i++)
-                    x[i]=Real(x_json[Json::ArrayIndex(i)].asDouble());
+                    x[i]=read::real <Real> (x_json[Json::ArrayIndex(i)],
+                        "Rm vector element");
                 return std::move(x);
             }
         };
@@ -245,6 +247,11 @@ namespace Optizelle {
             // Offsets for the bases stored for the matrix inverses 
             std::vector <Natural> inverse_base_offsets;
 
+            // Cached symbolic factorizations of the sparse semidefinite
+            // blocks.  Vectors that we initialize from this one share the
+            // cache since their blocks normally share a sparsity pattern.
+            std::shared_ptr <std::vector <SparseLDLT <Real> > > ldlt;
+
             // Eliminate constructors 
             NO_DEFAULT_COPY_ASSIGNMENT(Vector)
 
@@ -257,7 +264,9 @@ namespace Optizelle {
             //---SQLVector3---
             : data(), offsets(), types(types_), sizes(sizes_),
                 inverse(), inverse_offsets(), inverse_base(),
-                inverse_base_offsets()
+                inverse_base_offsets(),
+                ldlt(std::make_shared <std::vector <SparseLDLT <Real> > > (
+                    types_.size()))
             {
 
                 // Insure that the type of cones and their sizes lines up.
@@ -463,7 +472,9 @@ namespace Optizelle {
         
         // Memory allocation and size setting
         static Vector init(Vector const & x) {
-            return std::move(Vector(x.types,x.sizes));
+            auto y = Vector(x.types,x.sizes);
+            y.ldlt = x.ldlt;
+            return y;
         }
         
         // y <- x (Shallow.  No memory allocation.)
@@ -721,11 +732,62 @@ namespace Optizelle {
             }
         }
 
+        // Extracts the semidefinite blocks of x and y into sparse matrices X
+        // and Y that share the union of their sparsity patterns.  Returns
+        // false, without extracting anything, when the block is too small or
+        // too dense for the sparse kernels to beat the dense ones.  This is
+        // the case for multipliers, but the iterates of SDPs with sparse
+        // constraint matrices share the sparsity of those matrices.
+        static bool sparse_block(
+            Vector const & x,
+            Vector const & y,
+            Natural const & blk,
+            CSRMatrix <Real> & X,
+            CSRMatrix <Real> & Y
+        ) {
+            // Skip small blocks
+            auto const m = x.blkSize(blk);
+            if(m < 64)
+                return false;
+
+            // Count the nonzeros and skip dense blocks
+            auto const x_blk = &(x.front(blk));
+            auto const y_blk = &(y.front(blk));
+            auto nnz = Natural(0);
+            for(Natural k=0;k<m*m;k++)
+                nnz += x_blk[k]!=Real(0.) || y_blk[k]!=Real(0.);
+            if(nnz > m*m/10)
+                return false;
+
+            // Since the blocks are symmetric, the columns of the column-major
+            // storage are the rows of the CSR matrices
+            X = CSRMatrix <Real> (m,m);
+            Y = CSRMatrix <Real> (m,m);
+            for(Natural j=0;j<m;j++) {
+                for(Natural i=0;i<m;i++) {
+                    auto const k = i+j*m;
+                    if(x_blk[k]!=Real(0.) || y_blk[k]!=Real(0.) || i==j) {
+                        X.cols.emplace_back(i);
+                        X.vals.emplace_back(x_blk[k]);
+                        Y.vals.emplace_back(y_blk[k]);
+                    }
+                }
+                X.offsets[j+1] = X.cols.size();
+            }
+            Y.offsets = X.offsets;
+            Y.cols = X.cols;
+            return true;
+        }
+
         // Barrier function, barr <- barr(x) where x o grad barr(x) = e
         static Real barr(Vector const & x) {
             // This accumulates the barrier's value
             Real z(0.);
 
+            // Sparse copies of the SDP blocks
+            CSRMatrix <Real> X;
+            CSRMatrix <Real> X_copy;
+
             // Loop over all the blocks
             for(Natural blk=1;blk<=x.numBlocks();blk++) {
 
@@ -763,6 +825,12 @@ namespace Optizelle {
                 //             = log(det(u)^2) = 2 log(det(u))
                 case Cone::Semidefinite: {
 
+                    // Use a sparse factorization when X is sparse
+                    if(sparse_block(x,x,blk,X,X_copy)) {
+                        z += sparse_logdet(X,(*x.ldlt)[itok(blk)]);
+                        break;
+                    }
+
                     // Find the Choleski factorization of X
                     U.resize(m*m);
                     Integer info;
@@ -796,6 +864,8 @@ namespace Optizelle {
                    
             // Variables required for the linesearch on SDP blocks 
             Integer info(0);
+            CSRMatrix <Real> X;
+            CSRMatrix <Real> Y;
             std::vector <Real> Xrf;
             std::vector <Real> Yrf;
             std::vector <Real> Zrf;
@@ -918,6 +988,15 @@ namespace Optizelle {
                 // in lambda, we can just back off of it by a small amount.
                 case Cone::Semidefinite: {
 
+                    // When X and Y are sparse, bisect with sparse Choleski
+                    // factorizations instead
+                    if(sparse_block(x,y,blk,X,Y)) {
+                        auto alpha0 = sparse_srch(X,Y,
+                            (*y.ldlt)[itok(blk)]);
+                        alpha = alpha0<alpha ? alpha0 : alpha;
+                        break;
+                    }
+
                     // Convert X and Y to rectangular packed storage
                     Xrf.resize(m*(m+1)/2);
                     Optizelle::trttf <Real>('N','U',m,&(x(blk,1,1)),m,&(Xrf[0]),
@@ -1157,6 +1236,791 @@ namespace Optizelle {
         };
     }
 
+    // Access to the elements of vector spaces that store them contiguously
+    template <typename Real,template <typename> class XX>
+    struct DenseStorage;
+
+    template <typename Real>
+    struct DenseStorage <Real,Rm> {
+        static std::vector <Real> & get(std::vector <Real> & x) {
+            return x;
+        }
+        static std::vector <Real> const & get(std::vector <Real> const & x) {
+            return x;
+        }
+    };
+
+    template <typename Real>
+    struct DenseStorage <Real,SQL> {
+        static std::vector <Real> & get(typename SQL <Real>::Vector & x) {
+            return x.data;
+        }
+        static std::vector <Real> const & get(
+            typename SQL <Real>::Vector const & x
+        ) {
+            return x.data;
+        }
+    };
+
+    // Nesterov-Todd scaling for the nonnegative orthant.  Here, P(w) = w^2
+    // pointwise, so w = sqrt(z/x).
+    template <typename Real>
+    struct NesterovTodd <Real,Rm> {
+        typedef std::true_type available;
+
+        // w <- the scaling point between x and z
+        static void point(
+            std::vector <Real> const & x,
+            std::vector <Real> const & z,
+            std::vector <Real> & w
+        ) {
+            #ifdef _OPENMP
+            #pragma omp parallel for schedule(static)
+            #endif
+            for(Natural i=0;i<x.size();i++)
+                w[i]=std::sqrt(z[i]/x[i]);
+        }
+
+        // y <- P(w) dx
+        static void quad(
+            std::vector <Real> const & w,
+            std::vector <Real> const & dx,
+            std::vector <Real> & y
+        ) {
+            #ifdef _OPENMP
+            #pragma omp parallel for schedule(static)
+            #endif
+            for(Natural i=0;i<w.size();i++)
+                y[i]=w[i]*w[i]*dx[i];
+        }
+    };
+
+    // Fused interior point kernels for the nonnegative orthant
+    template <typename Real>
+    struct InteriorPointFused <Real,Rm> {
+        typedef std::true_type available;
+
+        // y <- inv(L(x)) e
+        static void linv_id(
+            std::vector <Real> const & x,
+            std::vector <Real> & y
+        ) {
+            #ifdef _OPENMP
+            #pragma omp parallel for schedule(static)
+            #endif
+            for(Natural i=0;i<x.size();i++)
+                y[i]=Real(1.)/x[i];
+        }
+
+        // y <- inv(L(x)) (dx o z)
+        static void linv_prod(
+            std::vector <Real> const & x,
+            std::vector <Real> const & dx,
+            std::vector <Real> const & z,
+            std::vector <Real> & y
+        ) {
+            #ifdef _OPENMP
+            #pragma omp parallel for schedule(static)
+            #endif
+            for(Natural i=0;i<x.size();i++)
+                y[i]=dx[i]*z[i]/x[i];
+        }
+
+        // y <- y + mu inv(L(x)) e - z
+        static void linv_id_shift(
+            std::vector <Real> const & x,
+            Real const & mu,
+            std::vector <Real> const & z,
+            std::vector <Real> & y
+        ) {
+            #ifdef _OPENMP
+            #pragma omp parallel for schedule(static)
+            #endif
+            for(Natural i=0;i<x.size();i++)
+                y[i]=y[i]+mu/x[i]-z[i];
+        }
+    };
+
+    // Simple bounds on Rm.  Each operation is a single pass through the
+    // vectors, which matters since we use these on problems with many
+    // millions of variables.
+    template <typename Real>
+    struct Bounds <Real,Rm> {
+        typedef std::true_type available;
+        typedef std::vector <Real> Vector;
+
+        // Checks that x_lo < x_hi
+        static bool valid(Vector const & x_lo,Vector const & x_hi) {
+            // Check the sizes first since each thread starts its own
+            // reduction from true
+            if(x_lo.size()!=x_hi.size())
+                return false;
+
+            auto valid = true;
+            #ifdef _OPENMP
+            #pragma omp parallel for reduction(&&:valid) schedule(static)
+            #endif
+            for(Natural i=0;i<x_lo.size();i++)
+                valid = valid && x_lo[i] < x_hi[i];
+            return valid;
+        }
+
+        // x <- x projected into the bounds after we push each finite bound
+        // inward by min(kappa max(1,|bound|),kappa (x_hi-x_lo)).  When kappa
+        // is less than 1/2, this leaves x strictly inside the bounds.  When
+        // kappa is zero, this is the usual projection.
+        static void proj(
+            Vector const & x_lo,
+            Vector const & x_hi,
+            Real const & kappa,
+            Vector & x
+        ) {
+            auto const inf = std::numeric_limits <Real>::infinity();
+            #ifdef _OPENMP
+            #pragma omp parallel for schedule(static)
+            #endif
+            for(Natural i=0;i<x.size();i++) {
+                auto width = x_hi[i]-x_lo[i];
+                if(x_lo[i] > -inf)
+                    x[i] = std::max(x[i],x_lo[i]+std::min(
+                        kappa*std::max(Real(1.),std::fabs(x_lo[i])),
+                        kappa*width));
+                if(x_hi[i] < inf)
+                    x[i] = std::min(x[i],x_hi[i]-std::min(
+                        kappa*std::max(Real(1.),std::fabs(x_hi[i])),
+                        kappa*width));
+            }
+        }
+
+        // pg <- x - proj(x - grad), which is zero exactly at first-order
+        // critical points
+        static void pgrad(
+            Vector const & x_lo,
+            Vector const & x_hi,
+            Vector const & x,
+            Vector const & grad,
+            Vector & pg
+        ) {
+            #ifdef _OPENMP
+            #pragma omp parallel for schedule(static)
+            #endif
+            for(Natural i=0;i<x.size();i++)
+                pg[i] = x[i]-std::min(std::max(x[i]-grad[i],x_lo[i]),x_hi[i]);
+        }
+
+        // c <- |grad| / dist(x,bound) and d <- sqrt(min(1,dist(x,bound)))
+        // where we take the bound that -grad points toward.  Infinite
+        // bounds give c=0 and d=1.  When roundoff leaves x sitting on the
+        // bound, we set c=d=0, which fixes that variable since d scales
+        // both sides of the preconditioner.
+        static void scaling(
+            Vector const & x_lo,
+            Vector const & x_hi,
+            Vector const & x,
+            Vector const & grad,
+            Vector & c,
+            Vector & d
+        ) {
+            #ifdef _OPENMP
+            #pragma omp parallel for schedule(static)
+            #endif
+            for(Natural i=0;i<x.size();i++) {
+                auto dist = grad[i] < Real(0.) ? x_hi[i]-x[i] : x[i]-x_lo[i];
+                if(dist > Real(0.)) {
+                    c[i] = std::fabs(grad[i])/dist;
+                    d[i] = std::sqrt(std::min(Real(1.),dist));
+                } else {
+                    c[i] = Real(0.);
+                    d[i] = Real(0.);
+                }
+            }
+        }
+
+        // srch <- argmax {alpha >= 0 :
+        //     frac (x-x_lo) + alpha dx >= 0,
+        //     frac (x_hi-x) - alpha dx >= 0}
+        //
+        // This is the breakpoint where x + alpha dx first crosses a bound
+        // after we move the bounds toward x.
+        static Real srch(
+            Vector const & x_lo,
+            Vector const & x_hi,
+            Vector const & x,
+            Vector const & dx,
+            Real const & frac
+        ) {
+            auto alpha = std::numeric_limits <Real>::infinity();
+            #ifdef _OPENMP
+            #pragma omp parallel for reduction(min:alpha) schedule(static)
+            #endif
+            for(Natural i=0;i<x.size();i++) {
+                if(dx[i] < Real(0.))
+                    alpha = std::min(alpha,frac*(x[i]-x_lo[i])/(-dx[i]));
+                else if(dx[i] > Real(0.))
+                    alpha = std::min(alpha,frac*(x_hi[i]-x[i])/dx[i]);
+            }
+            return alpha;
+        }
+
+        // dx <- max(min(dx,frac (x_hi-x)),-frac (x-x_lo))
+        static void trunc(
+            Vector const & x_lo,
+            Vector const & x_hi,
+            Vector const & x,
+            Real const & frac,
+            Vector & dx
+        ) {
+            #ifdef _OPENMP
+            #pragma omp parallel for schedule(static)
+            #endif
+            for(Natural i=0;i<x.size();i++)
+                dx[i] = std::max(std::min(dx[i],frac*(x_hi[i]-x[i])),
+                    -frac*(x[i]-x_lo[i]));
+        }
+    };
+
+    // Nesterov-Todd scaling for each block of a SQL vector
+    template <typename Real>
+    struct NesterovTodd <Real,SQL> {
+        typedef std::true_type available;
+        typedef typename SQL <Real>::Vector Vector;
+
+        // w <- the scaling point between x and z
+        static void point(Vector const & x,Vector const & z,Vector & w) {
+            // Workspace for the SDP blocks
+            std::vector <Real> L;
+            std::vector <Real> ZL;
+            std::vector <Real> M;
+            std::vector <Real> V;
+            std::vector <Real> T;
+            std::vector <Real> sigma2;
+
+            // Loop over all the blocks
+            for(Natural blk=1;blk<=x.numBlocks();blk++) {
+
+                // Get the size of the block
+                Natural m=x.blkSize(blk);
+
+                // Depending on the block, compute a different scaling
+                switch(x.blkType(blk)) {
+
+                // w = sqrt(z/x) pointwise
+                case Cone::Linear:
+                    #ifdef _OPENMP
+                    #pragma omp parallel for schedule(static)
+                    #endif
+                    for(Natural i=1;i<=m;i++)
+                        w(blk,i)=std::sqrt(z(blk,i)/x(blk,i));
+                    break;
+
+                // Normalize x and z so that they have unit determinant,
+                //
+                // xt = x / sqrt(det(x)), zt = z / sqrt(det(z)),
+                //
+                // and find their scaled midpoint
+                //
+                // wt = (xt + J zt) / sqrt(2 (1 + <xt,zt>))
+                //
+                // where J = diag(1,-I).  Then, inv(P(u)) x = z where
+                // u = (det(x)/det(z))^(1/4) wt.  Since inv(P(u)) = P(inv(u)),
+                // we have that w = inv(u) = (det(z)/det(x))^(1/4) J wt.
+                case Cone::Quadratic: {
+                    // Get the size of the bar section
+                    Natural mbar=m-1;
+
+                    // Find the square root of the determinants
+                    Real sqrt_det_x = std::sqrt(x.naught(blk)*x.naught(blk)
+                        - dot <Real> (mbar,&(x.bar(blk)),1,&(x.bar(blk)),1));
+                    Real sqrt_det_z = std::sqrt(z.naught(blk)*z.naught(blk)
+                        - dot <Real> (mbar,&(z.bar(blk)),1,&(z.bar(blk)),1));
+
+                    // gamma <- sqrt(2 (1 + <xt,zt>))
+                    Real gamma = std::sqrt(Real(2.)*(Real(1.)
+                        + dot <Real> (m,&(x.front(blk)),1,&(z.front(blk)),1)
+                            / (sqrt_det_x*sqrt_det_z)));
+
+                    // w <- J wt
+                    w.naught(blk) = (x.naught(blk)/sqrt_det_x
+                        + z.naught(blk)/sqrt_det_z) / gamma;
+                    Optizelle::copy <Real> (
+                        mbar,&(z.bar(blk)),1,&(w.bar(blk)),1);
+                    Optizelle::scal <Real> (mbar,
+                        Real(1.)/(sqrt_det_z*gamma),&(w.bar(blk)),1);
+                    Optizelle::axpy <Real> (mbar,
+                        -Real(1.)/(sqrt_det_x*gamma),&(x.bar(blk)),1,
+                        &(w.bar(blk)),1);
+
+                    // w <- (det(z)/det(x))^(1/4) J wt
+                    Optizelle::scal <Real> (m,
+                        std::sqrt(sqrt_det_z/sqrt_det_x),&(w.front(blk)),1);
+                    break;
+                }
+
+                // Let X = L L' and L' Z L = V S^2 V'.  Then, the scaling
+                // matrix is W = T T' where T = inv(L') V S^(1/2).  Since
+                // Z L V = inv(L') V S^2, we can also find T = Z L V S^(-3/2),
+                // which avoids a triangular solve.
+                case Cone::Semidefinite: {
+                    // L <- chol(X) where we zero out the upper triangle
+                    L.resize(m*m);
+                    Integer info(0);
+                    Optizelle::copy <Real> (
+                        m*m,&(x.front(blk)),1,&(L.front()),1);
+                    Optizelle::potrf <Real> ('L',m,&(L.front()),m,info);
+                    if(info!=0)
+                        throw Exception::t(__LOC__
+                            + ", the Nesterov-Todd scaling requires x to be "
+                            "strictly feasible, but its Cholesky factorization "
+                            "failed");
+                    for(Natural j=2;j<=m;j++)
+                        for(Natural i=1;i<j;i++)
+                            L[ijtok(i,j,m)]=Real(0.);
+
+                    // ZL <- Z L
+                    ZL.resize(m*m);
+                    Optizelle::symm <Real> ('L','U',m,m,Real(1.),
+                        &(z.front(blk)),m,&(L.front()),m,Real(0.),
+                        &(ZL.front()),m);
+
+                    // M <- L' Z L
+                    M.resize(m*m);
+                    Optizelle::gemm <Real> ('T','N',m,m,m,Real(1.),
+                        &(L.front()),m,&(ZL.front()),m,Real(0.),
+                        &(M.front()),m);
+
+                    // Find the eigenvalue decomposition L' Z L = V S^2 V'
+                    sigma2.resize(m);
+                    V.resize(m*m);
+                    std::vector <Integer> isuppz(2*m);
+                    Integer lwork = 26*m;
+                    std::vector <Real> work(lwork);
+                    Integer liwork = 10*m;
+                    std::vector <Integer> iwork(liwork);
+                    Integer nevals(0);
+                    Optizelle::syevr <Real> ('V','A','U',m,&(M.front()),m,
+                        Real(0.),Real(0.),0,0,lamch <Real> ('S'),nevals,
+                        &(sigma2.front()),&(V.front()),m,&(isuppz.front()),
+                        &(work.front()),lwork,&(iwork.front()),liwork,info);
+                    if(info!=0)
+                        throw Exception::t(__LOC__
+                            + ", the eigenvalue decomposition for the "
+                            "Nesterov-Todd scaling failed");
+                    if(!(sigma2.front() > Real(0.)))
+                        throw Exception::t(__LOC__
+                            + ", the Nesterov-Todd scaling requires z to be "
+                            "strictly feasible");
+
+                    // T <- Z L V S^(-3/2)
+                    T.resize(m*m);
+                    Optizelle::gemm <Real> ('N','N',m,m,m,Real(1.),
+                        &(ZL.front()),m,&(V.front()),m,Real(0.),
+                        &(T.front()),m);
+                    for(Natural j=1;j<=m;j++)
+                        Optizelle::scal <Real> (m,
+                            std::pow(sigma2[itok(j)],Real(-0.75)),
+                            &(T[ijtok(1,j,m)]),1);
+
+                    // W <- T T'
+                    Optizelle::gemm <Real> ('N','T',m,m,m,Real(1.),
+                        &(T.front()),m,&(T.front()),m,Real(0.),
+                        &(w.front(blk)),m);
+                    break;
+                } }
+            }
+        }
+
+        // y <- P(w) dx
+        static void quad(Vector const & w,Vector const & dx,Vector & y) {
+            // Workspace for the SDP blocks
+            std::vector <Real> WDX;
+
+            // Loop over all the blocks
+            for(Natural blk=1;blk<=w.numBlocks();blk++) {
+
+                // Get the size of the block
+                Natural m=w.blkSize(blk);
+
+                // Depending on the block, compute a different operator
+                switch(w.blkType(blk)) {
+
+                // y = w^2 dx pointwise
+                case Cone::Linear:
+                    #ifdef _OPENMP
+                    #pragma omp parallel for schedule(static)
+                    #endif
+                    for(Natural i=1;i<=m;i++)
+                        y(blk,i)=w(blk,i)*w(blk,i)*dx(blk,i);
+                    break;
+
+                // y = 2 <w,dx> w - det(w) J dx
+                case Cone::Quadratic: {
+                    // Get the size of the bar section
+                    Natural mbar=m-1;
+
+                    // Find the determinant and the projection
+                    Real det_w = w.naught(blk)*w.naught(blk)
+                        - dot <Real> (mbar,&(w.bar(blk)),1,&(w.bar(blk)),1);
+                    Real innr_w_dx =
+                        dot <Real> (m,&(w.front(blk)),1,&(dx.front(blk)),1);
+
+                    // y <- -det(w) J dx
+                    Optizelle::copy <Real> (
+                        m,&(dx.front(blk)),1,&(y.front(blk)),1);
+                    Optizelle::scal <Real> (m,det_w,&(y.front(blk)),1);
+                    y.naught(blk) = -y.naught(blk);
+
+                    // y <- 2 <w,dx> w - det(w) J dx
+                    Optizelle::axpy <Real> (m,Real(2.)*innr_w_dx,
+                        &(w.front(blk)),1,&(y.front(blk)),1);
+                    break;
+                }
+
+                // Y = W DX W
+                case Cone::Semidefinite:
+                    WDX.resize(m*m);
+                    Optizelle::symm <Real> ('L','U',m,m,Real(1.),
+                        &(w.front(blk)),m,&(dx.front(blk)),m,Real(0.),
+                        &(WDX.front()),m);
+                    Optizelle::symm <Real> ('R','U',m,m,Real(1.),
+                        &(w.front(blk)),m,&(WDX.front()),m,Real(0.),
+                        &(y.front(blk)),m);
+                    break;
+                }
+            }
+        }
+    };
+
+    // Fused interior point kernels for each block of a SQL vector.  On the
+    // quadratic cones, we use that for det(x) = x0^2 - <xbar,xbar>,
+    //
+    // inv(Arw(x)) w = (y0, (wbar - y0 xbar) / x0)
+    //
+    // where y0 = (x0 w0 - <xbar,wbar>) / det(x).  This avoids forming the
+    // Jordan product and the Schur complement explicitly.  When w = mu e,
+    // we order the operations exactly as linv does, so the fused kernels
+    // give the same iterates as the composed operations.
+    template <typename Real>
+    struct InteriorPointFused <Real,SQL> {
+        typedef std::true_type available;
+        typedef typename SQL <Real>::Vector Vector;
+
+        // y <- inv(L(x)) e
+        static void linv_id(Vector const & x,Vector & y) {
+            // Workspace for the SDP blocks
+            std::vector <Real> Xinv;
+
+            // Loop over all the blocks
+            for(Natural blk=1;blk<=x.numBlocks();blk++) {
+
+                // Get the size of the block
+                Natural m=x.blkSize(blk);
+
+                // Depending on the block, compute a different operator
+                switch(x.blkType(blk)) {
+
+                // y = 1 / x pointwise
+                case Cone::Linear:
+                    #ifdef _OPENMP
+                    #pragma omp parallel for schedule(static)
+                    #endif
+                    for(Natural i=1;i<=m;i++)
+                        y(blk,i)=Real(1.)/x(blk,i);
+                    break;
+
+                // y = (y0, gamma (alpha xbar + beta xbar))
+                case Cone::Quadratic: {
+                    Real y0, alpha, beta, gamma;
+                    linv_id_quadratic(x,blk,Real(1.),y0,alpha,beta,gamma);
+                    Real const * const xx = &(x.front(blk));
+                    Real * const yy = &(y.front(blk));
+                    for(Natural i=1;i<m;i++)
+                        yy[i]=gamma*(alpha*xx[i]+beta*xx[i]);
+                    yy[0]=y0;
+                    break;
+
+                // Y = inv(X)
+                } case Cone::Semidefinite:
+                    Optizelle::SQL <Real>::get_inverse(x,blk,Xinv);
+                    Optizelle::copy <Real> (
+                        m*m,&(Xinv.front()),1,&(y.front(blk)),1);
+                    break;
+                }
+            }
+        }
+
+        // y <- inv(L(x)) (dx o z)
+        static void linv_prod(
+            Vector const & x,
+            Vector const & dx,
+            Vector const & z,
+            Vector & y
+        ) {
+            // Workspace for the SDP blocks
+            std::vector <Real> Xinv;
+            std::vector <Real> DXZ;
+
+            // Loop over all the blocks
+            for(Natural blk=1;blk<=x.numBlocks();blk++) {
+
+                // Get the size of the block
+                Natural m=x.blkSize(blk);
+
+                // Depending on the block, compute a different operator
+                switch(x.blkType(blk)) {
+
+                // y = dx z / x pointwise
+                case Cone::Linear:
+                    #ifdef _OPENMP
+                    #pragma omp parallel for schedule(static)
+                    #endif
+                    for(Natural i=1;i<=m;i++)
+                        y(blk,i)=dx(blk,i)*z(blk,i)/x(blk,i);
+                    break;
+
+                // Here, w = dx o z = (<dx,z>, dx0 zbar + z0 dxbar), so
+                // <xbar,wbar> = dx0 <xbar,zbar> + z0 <xbar,dxbar>.  We
+                // accumulate all of the inner products in one pass.
+                case Cone::Quadratic: {
+                    Real const * const xx = &(x.front(blk));
+                    Real const * const dd = &(dx.front(blk));
+                    Real const * const zz = &(z.front(blk));
+                    Real innr_dx_z = dd[0]*zz[0];
+                    Real innr_xbar_xbar = Real(0.);
+                    Real innr_xbar_zbar = Real(0.);
+                    Real innr_xbar_dxbar = Real(0.);
+                    for(Natural i=1;i<m;i++) {
+                        innr_dx_z += dd[i]*zz[i];
+                        innr_xbar_xbar += xx[i]*xx[i];
+                        innr_xbar_zbar += xx[i]*zz[i];
+                        innr_xbar_dxbar += xx[i]*dd[i];
+                    }
+
+                    // y0 <- (x0 w0 - <xbar,wbar>) / det(x)
+                    Real const x0 = xx[0];
+                    Real const dx0 = dd[0];
+                    Real const z0 = zz[0];
+                    Real const y0 = (x0*innr_dx_z
+                        - dx0*innr_xbar_zbar - z0*innr_xbar_dxbar)
+                        / (x0*x0 - innr_xbar_xbar);
+
+                    // ybar <- (dx0 zbar + z0 dxbar - y0 xbar) / x0.  Since
+                    // we save y0 until the end, y may be the same as dx.
+                    Real * const yy = &(y.front(blk));
+                    for(Natural i=1;i<m;i++)
+                        yy[i]=(dx0*zz[i]+z0*dd[i]-y0*xx[i])/x0;
+                    yy[0]=y0;
+                    break;
+
+                // Y = inv(X) (DX Z)
+                } case Cone::Semidefinite:
+                    DXZ.resize(m*m);
+                    Optizelle::symm <Real> ('L','U',m,m,Real(1.),
+                        &(dx.front(blk)),m,&(z.front(blk)),m,Real(0.),
+                        &(DXZ.front()),m);
+                    Optizelle::SQL <Real>::get_inverse(x,blk,Xinv);
+                    Optizelle::symm <Real> ('L','U',m,m,Real(1.),
+                        &(Xinv.front()),m,&(DXZ.front()),m,Real(0.),
+                        &(y.front(blk)),m);
+                    break;
+                }
+            }
+        }
+
+        // y <- y + mu inv(L(x)) e - z
+        static void linv_id_shift(
+            Vector const & x,
+            Real const & mu,
+            Vector const & z,
+            Vector & y
+        ) {
+            // Workspace for the SDP blocks
+            std::vector <Real> Xinv;
+
+            // Loop over all the blocks
+            for(Natural blk=1;blk<=x.numBlocks();blk++) {
+
+                // Get the size of the block
+                Natural m=x.blkSize(blk);
+
+                // Depending on the block, compute a different operator
+                switch(x.blkType(blk)) {
+
+                // y = y + mu / x - z pointwise
+                case Cone::Linear:
+                    #ifdef _OPENMP
+                    #pragma omp parallel for schedule(static)
+                    #endif
+                    for(Natural i=1;i<=m;i++)
+                        y(blk,i)=y(blk,i)+mu/x(blk,i)-z(blk,i);
+                    break;
+
+                // y = y + (y0, gamma (alpha xbar + beta xbar)) - z
+                case Cone::Quadratic: {
+                    Real y0, alpha, beta, gamma;
+                    linv_id_quadratic(x,blk,mu,y0,alpha,beta,gamma);
+                    Real const * const xx = &(x.front(blk));
+                    Real const * const zz = &(z.front(blk));
+                    Real * const yy = &(y.front(blk));
+                    yy[0]=yy[0]+y0-zz[0];
+                    for(Natural i=1;i<m;i++)
+                        yy[i]=yy[i]+gamma*(alpha*xx[i]+beta*xx[i])-zz[i];
+                    break;
+
+                // Y = Y + mu inv(X) - Z
+                } case Cone::Semidefinite: {
+                    Optizelle::SQL <Real>::get_inverse(x,blk,Xinv);
+                    Real const * const zz = &(z.front(blk));
+                    Real * const yy = &(y.front(blk));
+                    #ifdef _OPENMP
+                    #pragma omp parallel for schedule(static)
+                    #endif
+                    for(Natural k=0;k<m*m;k++)
+                        yy[k]=yy[k]+mu*Xinv[k]-zz[k];
+                    break;
+                }}
+            }
+        }
+
+    private:
+        // Finds the pieces of mu inv(Arw(x)) e on the quadratic block blk,
+        //
+        // mu inv(Arw(x)) e = (y0, gamma (alpha xbar + beta xbar))
+        //
+        // where gamma (alpha xbar + beta xbar) = (-mu/x0) invSchur(x)(xbar).
+        // Since ybar = 0 in e, we skip the temporaries that linv needs for
+        // the Schur complement, but otherwise match its arithmetic.
+        static void linv_id_quadratic(
+            Vector const & x,
+            Natural const & blk,
+            Real const & mu,
+            Real & y0,
+            Real & alpha,
+            Real & beta,
+            Real & gamma
+        ) {
+            Natural const mbar=x.blkSize(blk)-1;
+            Real const x0 = x.naught(blk);
+            Real const innr_xbar_xbar = Optizelle::dot <Real> (
+                mbar,&(x.bar(blk)),1,&(x.bar(blk)),1);
+            y0 = mu / (x0 - (Real(1.)/x0) * innr_xbar_xbar);
+            alpha = Real(1.)/x0;
+            beta = innr_xbar_xbar / (x0*(x0*x0 - innr_xbar_xbar));
+            gamma = -mu/x0;
+        }
+    };
+
+    // Vector valued function g : Rm -> Y whose derivative is given by a sparse
+    // Jacobian.  Rather than implementing p and ps, the user implements
+    // jacobian, which returns g'(x) in CSR format.  Row i of the Jacobian
+    // corresponds to the ith element of the storage of Y, which, for
+    // semidefinite cones, includes both triangles of the matrix.  We cache
+    // the Jacobian and its transpose at the last point that we were called
+    // with and apply both with a threaded sparse matrix-vector product.
+    // This works when Y is Rm or SQL.  When Y is Rm, the Jacobian also allows
+    // the augmented system to be factored directly.
+    template <typename Real,template <typename> class YY>
+    struct SparseVectorValuedFunction
+        : public VectorValuedFunction <Real,Rm,YY>,
+        public SparseJacobian <Real>
+    {
+        // Create some type shortcuts
+        typedef Rm <Real> X;
+        typedef typename X::Vector X_Vector; 
+        typedef YY <Real> Y;
+        typedef typename Y::Vector Y_Vector; 
+
+    private:
+        // Jacobian and its transpose at x_base
+        mutable CSRMatrix <Real> J;
+        mutable CSRMatrix <Real> Jt;
+
+        // Point where we last found the Jacobian
+        mutable std::pair <bool,X_Vector> x_base;
+
+    public:
+        // Disallow constructors
+        NO_COPY_ASSIGNMENT(SparseVectorValuedFunction)
+
+        // Start without a Jacobian
+        SparseVectorValuedFunction() : J(), Jt(), x_base(false,X_Vector()) {}
+
+        // J <- g'(x)
+        virtual void jacobian(
+            X_Vector const & x,
+            CSRMatrix <Real> & J
+        ) const = 0;
+
+        // Returns g'(x), which we only recompute when x moves and g isn't
+        // affine.  When threaded, concurrent calls must share the same x.
+        CSRMatrix <Real> const & jac(X_Vector const & x) const {
+            // Since we can't throw out of a critical section, we note
+            // whether the Jacobian is malformed and then throw afterwards
+            auto valid = true;
+            #ifdef _OPENMP
+            #pragma omp critical(SparseVectorValuedFunction)
+            #endif
+            {
+                if( !(this->is_affine() && x_base.first) &&
+                    rel_err_cached <Real,Rm> (x,x_base)
+                        >= std::numeric_limits <Real>::epsilon()*1e1
+                ) {
+                    // Find the Jacobian and check its structure 
+                    jacobian(x,J);
+                    valid = J.valid() && J.n == x.size();
+
+                    // Form the transpose for ps and remember where we are
+                    if(valid) {
+                        csrtrans <Real> (J,Jt);
+                        x_base.first = true;
+                        x_base.second = x;
+                    } else
+                        x_base.first = false;
+                }
+            }
+            if(!valid)
+                throw Exception::t(__LOC__
+                    + ", the sparse Jacobian is not a valid CSR matrix with "
+                    "a column for each element of x");
+            return J;
+        }
+
+        // Returns g'(x)', which we cache along with g'(x)
+        CSRMatrix <Real> const & jac_trans(X_Vector const & x) const {
+            jac(x);
+            return Jt;
+        }
+
+        // y=g'(x)dx 
+        void p(
+            X_Vector const & x,
+            X_Vector const & dx,
+            Y_Vector & y
+        ) const {
+            auto const & A = jac(x);
+            auto & y_data = DenseStorage <Real,YY>::get(y);
+            if(y_data.size() != A.m)
+                throw Exception::t(__LOC__
+                    + ", the sparse Jacobian must have a row for each "
+                    "element of g(x)");
+            csrmv <Real> (Real(1.),A,dx.data(),Real(0.),y_data.data());
+        }
+
+        // z=g'(x)*dy
+        void ps(
+            X_Vector const & x,
+            Y_Vector const & dy,
+            X_Vector & z
+        ) const {
+            auto const & At = jac_trans(x);
+            auto const & dy_data = DenseStorage <Real,YY>::get(dy);
+            if(dy_data.size() != At.n)
+                throw Exception::t(__LOC__
+                    + ", the sparse Jacobian must have a row for each "
+                    "element of g(x)");
+            csrmv <Real> (Real(1.),At,dy_data.data(),Real(0.),z.data());
+        }
+    };
+
     // Optimization problems instantiated on these vector spaces.  In theory,
     // this should help our compilation times.
     extern template struct Unconstrained<double,Rm>;
@@ -0,0 +1,163 @@
+// Times the sparse SDPA reader and the SDP inequality on a bundled problem
+// and on a larger, randomly generated one.  Along the way, we check that the
+// derivative of the inequality and its adjoint agree.
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <chrono>
+#include <random>
+#include <string>
+#include <cstdlib>
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "optizelle/sdpa.h"
+
+// Grab the Optizelle Natural type
+using Optizelle::Natural;
+
+// Type shortcuts
+typedef double Real;
+typedef Optizelle::Rm <Real> X;
+typedef Optizelle::SQL <Real> Z;
+typedef std::chrono::steady_clock Clock;
+
+// Finds the number of seconds since start
+double elapsed(Clock::time_point const & start) {
+    return std::chrono::duration <double> (Clock::now()-start).count();
+}
+
+// Writes a random SDPA problem with m constraint matrices, a semidefinite
+// block of size n, and a diagonal block of size n.  Each constraint matrix
+// has roughly nnz elements in each block.
+void generate(
+    std::string const & fname,
+    Natural const & m,
+    Natural const & n,
+    Natural const & nnz
+) {
+    std::ofstream fout(fname.c_str());
+    if(!fout.is_open()) {
+        std::cerr << "Unable to open the file: " << fname << '.' << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    fout << std::setprecision(16);
+
+    // Write the header and objective
+    fout << "\"Randomly generated SDPA problem" << std::endl
+         << m << " = mDIM" << std::endl
+         << "2 = nBLOCK" << std::endl
+         << "{" << n << ", -" << n << "} = bLOCKsTRUCT" << std::endl;
+    std::mt19937 gen(1);
+    std::uniform_real_distribution <> dis(-1.,1.);
+    std::uniform_int_distribution <Natural> idx(1,n);
+    for(Natural i=0;i<m;i++)
+        fout << dis(gen) << ' ';
+    fout << std::endl;
+
+    // Write the constraint matrices.  We keep A0 diagonally dominant, so
+    // the problem is well posed.
+    for(Natural i=0;i<=m;i++) {
+        for(Natural k=0;k<nnz;k++) {
+            auto r = idx(gen);
+            auto c = idx(gen);
+            if(r>c) std::swap(r,c);
+            fout << i << " 1 " << r << ' ' << c << ' ' << dis(gen) << '\n'
+                 << i << " 2 " << r << ' ' << r << ' ' << dis(gen) << '\n';
+        }
+    }
+    for(Natural r=1;r<=n;r++)
+        fout << "0 1 " << r << ' ' << r << ' ' << Real(2*nnz) << '\n';
+}
+
+// Reads a problem and then times the inequality on it
+void benchmark(std::string const & fname,Natural const & reps) {
+    // Time the reader
+    auto start = Clock::now();
+    Optizelle::sdpa::Problem <Real> prob;
+    Optizelle::sdpa::read <Real> (fname,prob);
+    auto t_read = elapsed(start);
+
+    // Count the nonzeros
+    auto nnz = Natural(0);
+    for(auto const & Ai : prob.A)
+        for(auto const & Aij : Ai)
+            nnz += Aij.nnz();
+
+    // Create some random points and directions
+    auto x = X::Vector(prob.m());
+    auto dx = X::Vector(prob.m());
+    auto dz = Optizelle::sdpa::init_codomain(prob);
+    std::mt19937 gen(1);
+    std::uniform_real_distribution <> dis(-1.,1.);
+    for(auto & x_i : x) x_i = dis(gen);
+    for(auto & dx_i : dx) dx_i = dis(gen);
+    for(auto & dz_i : dz.data) dz_i = dis(gen);
+    auto h_dx = Z::init(dz);
+    auto hs_dz = X::init(x);
+
+    // Time the derivative and its adjoint
+    start = Clock::now();
+    Optizelle::sdpa::Inequality <Real> h(prob);
+    auto t_setup = elapsed(start);
+    start = Clock::now();
+    for(Natural k=0;k<reps;k++)
+        h.p(x,dx,h_dx);
+    auto t_p = elapsed(start)/Real(reps);
+    start = Clock::now();
+    for(Natural k=0;k<reps;k++)
+        h.ps(x,dz,hs_dz);
+    auto t_ps = elapsed(start)/Real(reps);
+
+    // Check that <h'(x)dx,dz> = <dx,h'(x)*dz>
+    auto lhs = Z::innr(h_dx,dz);
+    auto rhs = X::innr(dx,hs_dz);
+    auto err = std::fabs(lhs-rhs)/(Real(1e-16)+std::fabs(lhs));
+
+    // Check that h'(x)dx = h(dx) - h(0)
+    auto h_0 = Z::init(dz);
+    auto h_dx_fd = Z::init(dz);
+    h.eval(X::Vector(prob.m(),Real(0.)),h_0);
+    h.eval(dx,h_dx_fd);
+    Z::axpy(Real(-1.),h_0,h_dx_fd);
+    Z::axpy(Real(-1.),h_dx,h_dx_fd);
+    auto err_p = std::sqrt(Z::innr(h_dx_fd,h_dx_fd)/Z::innr(h_dx,h_dx));
+
+    // Report the results
+    std::cout << std::scientific << std::setprecision(3)
+        << "Problem: " << fname << std::endl
+        << "    variables: " << prob.m()
+        << ", blocks: " << prob.nblocks()
+        << ", nonzeros: " << nnz << std::endl
+        << "    read: " << t_read << "s"
+        << ", setup: " << t_setup << "s"
+        << ", h.p: " << t_p << "s"
+        << ", h.ps: " << t_ps << "s" << std::endl
+        << "    adjoint error: " << err
+        << ", derivative error: " << err_p << std::endl;
+    if(err > Real(1e-12) || err_p > Real(1e-12)) {
+        std::cerr << "The SDP inequality is inconsistent." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+}
+
+int main(int argc,char* argv[]) {
+    // Check that we have sufficient inputs
+    if(argc!=5) {
+        std::cerr << "Usage: sdpa_benchmark <problem> <variables> "
+            << "<block size> <nonzeros per block>" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // Benchmark the given problem
+    benchmark(argv[1],100);
+
+    // Generate and benchmark a larger problem.  We avoid the .dat-s
+    // extension since those files are registered as example problems.
+    auto fname = std::string("sdpa_benchmark.dat");
+    auto start = Clock::now();
+    generate(fname,std::atoi(argv[2]),std::atoi(argv[3]),std::atoi(argv[4]));
+    std::cout << "Generated " << fname << " in " << elapsed(start) << "s"
+        << std::endl;
+    benchmark(fname,10);
+}
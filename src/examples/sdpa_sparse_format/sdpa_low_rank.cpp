@@ -0,0 +1,107 @@
+// Solves the dual of a linear SDP stored in the sparse SDPA format with the
+// Burer-Monteiro factorization X = R R'.  This avoids storing the
+// semidefinite blocks, which is useful when the solution has low rank, such
+// as in max-cut relaxations.
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <cstdlib>
+#include <random>
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "optizelle/json.h"
+#include "optizelle/sdpa.h"
+
+// Grab the Optizelle Natural type
+using Optizelle::Natural;
+
+// Reads the rank of the factorization.  Zero means that we use the smallest
+// rank that's guaranteed to hold a solution.
+Natural parseRank(std::string const & fname) {
+    Json::Value root=Optizelle::json::parse(fname);
+    return Natural(root["sdp_settings"].get("rank",0).asUInt());
+}
+
+// Sets up and runs the problem
+int main(int argc,char* argv[]) {
+    // Type shortcuts
+    typedef double Real;
+    typedef Optizelle::Rm <Real> Rm;
+    typedef Optizelle::EqualityConstrained <Real,Optizelle::Rm,Optizelle::Rm>
+        EqualityConstrained;
+
+    // Check that we have sufficient inputs
+    if(argc!=3) {
+        std::cerr << "Usage: sdpa_low_rank <problem> <parameters>"
+            << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // Grab the filenames
+    std::string fname(argv[1]);
+    std::string params(argv[2]);
+
+    // Parse the file sparse SDPA file
+    Optizelle::sdpa::Problem <Real> prob;
+    Optizelle::sdpa::read <Real> (fname,prob);
+
+    // Factor the problem
+    auto rank = parseRank(params);
+    if(rank==0)
+        rank = Optizelle::sdpa::LowRank <Real>::rank_min(prob.m());
+    Optizelle::sdpa::LowRank <Real> lr(prob,rank);
+    std::cout << "Factoring " << lr.nrows() << " rows with rank " << rank
+        << '.' << std::endl;
+
+    // Start from a random factor and zero multipliers.  We fix the seed so
+    // that the runs are repeatable.
+    auto R = lr.init();
+    std::mt19937 gen(1);
+    std::normal_distribution <Real> dist;
+    for(auto & R_i : R)
+        R_i = dist(gen);
+    auto y = Rm::Vector(prob.m());
+
+    // Create the optimization state and read the parameters
+    EqualityConstrained::State::t state(R,y);
+    Optizelle::json::EqualityConstrained <Real,Optizelle::Rm,Optizelle::Rm>
+        ::read(params,state);
+
+    // Create the functions
+    EqualityConstrained::Functions::t fns;
+    fns.f.reset(new Optizelle::sdpa::LowRankObjective <Real> (lr));
+    fns.g.reset(new Optizelle::sdpa::LowRankEquality <Real> (lr));
+    fns.PSchur_left.reset(
+        new Optizelle::sdpa::LowRankSchur <Real> (lr,state.x));
+
+    // Solve the optimization problem
+    std::cout << std::endl << "Solving the factored SDP problem: " << fname
+        << std::endl;
+    EqualityConstrained::Algorithms::getMin(
+        Optizelle::Messaging::stdout,fns,state);
+
+    // Print out the reason for convergence
+    std::cout << "Factored SDP problem converged due to: "
+        << Optizelle::OptimizationStop::to_string(state.opt_stop)
+        << std::endl;
+
+    // The multipliers solve the original problem, so we print both its
+    // objective and the objective of the factored dual
+    std::cout << std::scientific << std::setprecision(16)
+        << "Objective value: " << Rm::innr(prob.b,state.y) << std::endl
+        << "Dual objective value: " << lr.innr(0,state.x,state.x)
+        << std::endl;
+
+    // Write out the solution of the original problem to file.  We skip the
+    // full restart since it holds several copies of the factor.
+    Json::Value root;
+    root["Naturals"]["iter"]=Optizelle::json::write::natural(state.iter);
+    root["X_Vectors"]["x"]=Json::Value(Json::arrayValue);
+    for(auto const & y_i : state.y)
+        root["X_Vectors"]["x"].append(Optizelle::json::write::real(y_i));
+    Optizelle::json::write_to_file("solution.json",root);
+
+    // Return that we've exited successfuly
+    return EXIT_SUCCESS;
+}
@@ -2,7 +2,6 @@
 
 #include <iostream>
 #include <fstream>
-#include <sstream>
 #include <vector>
 #include <string>
 #include <cstdlib>
@@ -11,6 +10,7 @@
 #include "optizelle/optizelle.h"
 #include "optizelle/vspaces.h"
 #include "optizelle/json.h"
+#include "optizelle/sdpa.h"
 
 // Grab the Optizelle Natural and Integer types
 using Optizelle::Natural;
@@ -20,304 +20,16 @@ using Optizelle::Integer;
 inline Natural itok(Natural const & i) {
     return i-1;
 }
-// Index packed matrices starting from 1
-inline Natural ijtokp(Natural const & i,Natural const & j) {
-    return i+j*(j-1)/2-1;
-}
 
-// A simple structure that contains either a digonal matrix or a sparse matrix
-// in triple format.  If we have a diagonal matrix, the js are empty.
-template <typename Real>
-struct SparseMat{
-    std::vector <Natural> is;
-    std::vector <Natural> js;
-    std::vector <Real> data;
-};
-
-// Stores a sparse SDPA format problem of the form
+// Sparse SDPA problems and the SDP inequality
 //
-// min b1*x1 + ... + bm*xm
-// st  A1*x1 + ... + Am*xm - A0 >= 0
+// h(x) = A1*x1 + ... + Am*xm - A0 >= 0
 //
-// where each A has a block structure with sizes blksizes_1,...,blksizes_nblocks
+// come from the library
 template <typename Real>
-struct SparseSDP {
-    // Block sizes.  Negative means a diagonal block.
-    std::vector <Integer> blk_sizes;
-
-    // Objective function
-    std::vector <Real> b;
-
-    // Constraint matrices
-    std::vector < std::vector <SparseMat<Real> > > A;
-};
-
-// Clears out whitespace
-void eat_whitespace(std::stringstream & sin) {
-    while(!sin.eof() && (sin.peek() == ' ' || sin.peek()=='\t'))
-        sin.get();
-}
-
-// Clears out the formating characters
-void eat_formatting(std::stringstream & sin) {
-    while(!sin.eof() && (sin.peek() == ' ' || sin.peek()=='\t' ||
-        sin.peek()==',' || sin.peek() =='(' || sin.peek() == ')' ||
-        sin.peek()=='{' || sin.peek() == '}')
-    )
-        sin.get();
-}
-
-// Reads in the sparse SDPA format
-template <typename Real>
-void parse_sdpa(std::string const & fname,SparseSDP <Real> & prob) {
-    // Open the file
-    std::ifstream fin(fname.c_str());
-
-    // Check if we were able to open the file
-    if(fin.fail()) {
-        std::cerr << "Unable to open the file: " << fname << '.' << std::endl;
-        exit(EXIT_FAILURE);
-    }
-
-    // Get rid of all the lines with comments
-    std::string line;
-    do {
-        std::getline (fin,line);
-        if(fin.fail()) {
-            std::cerr << "Error while parsing initial comments." << std::endl;
-            exit(EXIT_FAILURE);
-        } else if(fin.eof()) {
-            std::cerr << "Found end of file while parsing initial comments."
-                << std::endl;
-            exit(EXIT_FAILURE);
-        }
-    } while(line[0]=='"' || line[0]=='*');
-
-    // Next, read in the number of constraint matrices
-    std::stringstream sin(line);
-    Natural m(0);
-    sin >> m;
-    if(sin.fail()) {
-        std::cerr << "Error while parsing the number of constraint matrices."
-            << std::endl;
-        exit(EXIT_FAILURE);
-    }
-
-    // Read in the number of blocks
-    std::getline (fin,line);
-    if(fin.fail()) {
-        std::cerr << "Error while reading the number of blocks." << std::endl;
-        exit(EXIT_FAILURE);
-    } else if(fin.eof()) {
-        std::cerr << "Found end of file while reading the number of blocks."
-            << std::endl;
-        exit(EXIT_FAILURE);
-    }
-    sin.str(line);
-    sin.clear();
-    Natural nblocks(0);
-    sin >> nblocks;
-    if(sin.fail()) {
-        std::cerr << "Error while parsing the number of blocks." << std::endl;
-        exit(EXIT_FAILURE);
-    }
-
-    // Read in the sizes of the blocks
-    prob.blk_sizes.clear();
-    std::getline (fin,line);
-    if(fin.fail()) {
-        std::cerr << "Error while reading the sizes of blocks." << std::endl;
-        exit(EXIT_FAILURE);
-    } else if(fin.eof()) {
-        std::cerr << "Found end of file while reading the sizes of blocks."
-            << std::endl;
-        exit(EXIT_FAILURE);
-    }
-    sin.str(line);
-    sin.clear();
-    while(!sin.eof()) {
-        // Clear out the formating characters
-        eat_formatting(sin);
-        if(sin.eof()) break;
-
-        // Parse the block size
-        Integer blk_size(0);
-        sin >> blk_size;
-        if(sin.fail()) {
-            std::cerr << "Error while parsing the block size." << std::endl;
-            exit(EXIT_FAILURE);
-        }
-        prob.blk_sizes.emplace_back(blk_size);
-    }
-
-    // Check that the number of blocks corresponds to what we parsed
-    if(nblocks != prob.blk_sizes.size()) 
-        std::cerr << "The number of parsed block sizes differs from the "
-            "specified number." << std::endl;
-
-    // Read in the objective function
-    prob.b.clear();
-    std::getline (fin,line);
-    if(fin.fail()) {
-        std::cerr << "Error while reading the objective." << std::endl;
-        exit(EXIT_FAILURE);
-    } else if(fin.eof()) {
-        std::cerr << "Found end of file while reading the objective."
-            << std::endl;
-        exit(EXIT_FAILURE);
-    }
-    sin.str(line);
-    sin.clear();
-    while(!sin.eof()) {
-        // Clear out the formating characters
-        eat_formatting(sin);
-        if(sin.eof()) break;
-
-        // Read the objective
-        Real val(0.);
-        sin >> val;
-        if(sin.fail()) {
-            std::cerr << "Error while parsing the objective." << std::endl;
-            exit(EXIT_FAILURE);
-        }
-        prob.b.emplace_back(val);
-    }
-
-    // Create structure for the constraint matrices
-    prob.A= std::vector < std::vector <SparseMat<Real> > >
-        (m+1, std::vector <SparseMat<Real> > (nblocks));
-    for(Natural i=0;i<m+1;i++)
-        for(Natural j=0;j<prob.blk_sizes.size();j++) {
-            prob.A[i][j].data.clear();
-            prob.A[i][j].is.clear();
-            prob.A[i][j].js.clear();
-        }
-
-    // Read constraints until we finish
-    while(1) {
-        // Read in the constraint matrices
-        std::getline (fin,line);
-        if(fin.eof())
-            break;
-        else if(fin.fail()) {
-            std::cerr << "Error while reading the constraints." << std::endl;
-            exit(EXIT_FAILURE);
-        }
-
-        // Read in the matno, blkno, i, j and entry
-        Integer matno(0), blkno(0), i(0), j(0);
-        Real entry;
-        sin.str(line);
-        sin.clear();
-        sin >> matno >> blkno >> i >> j >> entry;
-        if(sin.fail()) {
-            std::cerr << "Error while parsing the constraint." << std::endl;
-            exit(EXIT_FAILURE);
-        }
-
-        // Insert the element into the appropriate slot
-        if(prob.blk_sizes[itok(blkno)] < 0) {
-            if(i!=j) {
-                std::cerr
-                    << "Specified a off-diagonal element of a diagonal block."
-                    << std::endl;
-                exit(EXIT_FAILURE);
-            }
-            prob.A[matno][itok(blkno)].is.emplace_back(i);
-            prob.A[matno][itok(blkno)].data.emplace_back(entry);
-        } else {
-            if(i>j) std::swap(i,j);
-            prob.A[matno][itok(blkno)].is.emplace_back(i);
-            prob.A[matno][itok(blkno)].js.emplace_back(j);
-            prob.A[matno][itok(blkno)].data.emplace_back(entry);
-        }
-    }
-
-    // Close the file
-    fin.close();
-}
-
-// Used for doing a tagged sort on sparse matrices
-struct MatComparison{
-    std::vector <Natural> const & is;
-    std::vector <Natural> const & js;
-    MatComparison(
-        std::vector <Natural> const & is_,
-        std::vector <Natural> const & js_
-    ) : is(is_), js(js_) {}
-    bool operator () (Natural const & k,Natural const & l) {
-        return ijtokp(is[k],js[k]) < ijtokp(is[l],js[l]);
-    }
-};
-
-// Used for doing a tagged sort on digonal matrices 
-struct DiagComparison{
-    std::vector <Natural> const & is;
-    DiagComparison(std::vector <Natural> const & is_) : is(is_) {}
-    bool operator () (Natural const & k,Natural const & l) {
-        return is[k] < is[l];
-    }
-};
-
-// Sorts the indices used in the SDP problem first by column and then by row.
+using SparseSDP = Optizelle::sdpa::Problem <Real>;
 template <typename Real>
-void sort_sdp (SparseSDP <Real> & prob) {
-    // Loop over the constraints
-    for(Natural i=0;i<prob.A.size();i++) {
-        // Loop over the blocks
-        for(Natural j=0;j<prob.blk_sizes.size();j++) {
-            // Diagonal blocks
-            if(prob.blk_sizes[j]<0) {
-                // Do the tagged sort
-                std::vector <Natural> tag(prob.A[i][j].is.size());
-                for(Natural k=0;k<prob.A[i][j].is.size();k++)
-                    tag[k]=k;
-                DiagComparison comp(prob.A[i][j].is);
-                std::sort(tag.begin(),tag.end(),comp);
-
-                // Create new memory for the indices and data
-                std::vector <Natural> is_new(prob.A[i][j].is.size());
-                std::vector <Real> data_new(prob.A[i][j].data.size());
-
-                // Insert the data where it needs to be
-                for(Natural k=0;k<prob.A[i][j].is.size();k++) {
-                    is_new[k]=prob.A[i][j].is[tag[k]];
-                    data_new[k]=prob.A[i][j].data[tag[k]];
-                }
-
-                // Reassign the indices and data
-                prob.A[i][j].is=is_new;
-                prob.A[i][j].data=data_new;
-
-            // Sparse blocks
-            } else {
-                // Do the tagged sort
-                std::vector <Natural> tag(prob.A[i][j].is.size());
-                for(Natural k=0;k<prob.A[i][j].is.size();k++)
-                    tag[k]=k;
-                MatComparison comp(prob.A[i][j].is,prob.A[i][j].js);
-                std::sort(tag.begin(),tag.end(),comp);
-
-                // Create new memory for the indices and data
-                std::vector <Natural> is_new(prob.A[i][j].is.size());
-                std::vector <Natural> js_new(prob.A[i][j].js.size());
-                std::vector <Real> data_new(prob.A[i][j].data.size());
-
-                // Insert the data where it needs to be
-                for(Natural k=0;k<prob.A[i][j].is.size();k++) {
-                    is_new[k]=prob.A[i][j].is[tag[k]];
-                    js_new[k]=prob.A[i][j].js[tag[k]];
-                    data_new[k]=prob.A[i][j].data[tag[k]];
-                }
-
-                // Reassign the indices and data
-                prob.A[i][j].is=is_new;
-                prob.A[i][j].js=js_new;
-                prob.A[i][j].data=data_new;
-            }
-        }
-    }
-}
+using SDPIneq = Optizelle::sdpa::Inequality <Real>;
 
 // Define the SDP objective where 
 // 
@@ -359,145 +71,6 @@ public:
 };
 
 
-// Define the SDP inequality where 
-//
-// h(x) = A1*x1 + ... + Am*xm - A0 >= 0
-//
-template <typename Real>
-struct SDPIneq :
-    public Optizelle::VectorValuedFunction <Real,Optizelle::Rm,Optizelle::SQL>
-{
-public:
-    typedef Optizelle::Rm <Real> X;
-    typedef Optizelle::SQL <Real> Z;
-    typedef typename X::Vector X_Vector;
-    typedef typename Z::Vector Z_Vector;
-
-private:
-    SparseSDP <Real> const & prob;
-
-    // z=h(x), except that we de start with A_start.  Mostly, this is
-    // to toggle whether we start from A0 or A1.
-    template <Natural start>
-    void eval_from(
-        X_Vector const & x,
-        Z_Vector & z
-    ) const {
-        // Zero out the solution
-        Z::zero(z);
-
-        // Loop over the constraints
-        for(Natural i=start;i<prob.A.size();i++) {
-            // Loop over the blocks
-            for(Natural j=0;j<prob.blk_sizes.size();j++) {
-                // Diagonal blocks
-                if(prob.blk_sizes[j]<0) {
-                    // Loop over the indices
-                    for(Natural k=0;k<prob.A[i][j].is.size();k++) {
-                        // Constant block
-                        if(i==0)
-                            z(j+1,prob.A[i][j].is[k]) -= prob.A[i][j].data[k];
-                        // Variable block
-                        else 
-                            z(j+1,prob.A[i][j].is[k])
-                                += prob.A[i][j].data[k]*x[itok(i)];
-                    }
-
-                // Sparse blocks
-                } else {
-                    // Loop over the indices
-                    for(Natural k=0;k<prob.A[i][j].is.size();k++) {
-                        // Constant block
-                        if(i==0) {
-                            z(j+1,prob.A[i][j].is[k],prob.A[i][j].js[k])
-                                -= prob.A[i][j].data[k];
-                            if(prob.A[i][j].is[k] != prob.A[i][j].js[k])
-                                z(j+1,prob.A[i][j].js[k],prob.A[i][j].is[k])
-                                    -= prob.A[i][j].data[k];
-                        // Variable block
-                        } else {
-                            z(j+1,prob.A[i][j].is[k],prob.A[i][j].js[k])
-                                += prob.A[i][j].data[k]*x[itok(i)];
-                            if(prob.A[i][j].is[k] != prob.A[i][j].js[k])
-                                z(j+1,prob.A[i][j].js[k],prob.A[i][j].is[k])
-                                    += prob.A[i][j].data[k]*x[itok(i)];
-                        }
-                    }
-                }
-            }
-        }
-    }
-
-public:
-    // Grab a reference to the underlying SDP problem
-    SDPIneq(SparseSDP <Real> const & prob_) : prob(prob_) {}
-
-    // z=h(x) 
-    void eval(
-        X_Vector const & x,
-        Z_Vector & z
-    ) const {
-        eval_from <0> (x,z);
-    }
-
-    // z=h'(x)dx
-    void p(
-        X_Vector const & x,
-        X_Vector const & dx,
-        Z_Vector & z
-    ) const {
-        eval_from <1> (dx,z);
-    }
-
-    // xhat=h'(x)*dz
-    void ps(
-        X_Vector const & x,
-        Z_Vector const & dz,
-        X_Vector & xhat 
-    ) const {
-        // Zero out the solution
-        X::zero(xhat);
-
-        // Loop over the constraints
-        for(Natural i=1;i<prob.A.size();i++) {
-            // Loop over the blocks
-            for(Natural j=0;j<prob.blk_sizes.size();j++) {
-                // Diagonal blocks
-                if(prob.blk_sizes[j]<0) {
-                    // Loop over the indices
-                    for(Natural k=0;k<prob.A[i][j].is.size();k++) {
-                        xhat[itok(i)]+=
-                            dz(j+1,prob.A[i][j].is[k]) * prob.A[i][j].data[k];
-                    }
-
-                // Sparse blocks
-                } else {
-                    // Loop over the indices
-                    for(Natural k=0;k<prob.A[i][j].is.size();k++) {
-                        xhat[itok(i)]+=
-                            dz(j+1,prob.A[i][j].is[k],prob.A[i][j].js[k])
-                            * prob.A[i][j].data[k];
-                        if(prob.A[i][j].is[k] != prob.A[i][j].js[k])
-                            xhat[itok(i)]+=
-                                dz(j+1,prob.A[i][j].js[k],prob.A[i][j].is[k])
-                                * prob.A[i][j].data[k];
-                    }
-                }
-            }
-        }
-    }
-
-    // xhat=(h''(x)dx)*dz
-    void pps(
-        X_Vector const & x,
-        X_Vector const & dx,
-        Z_Vector const & dz,
-        X_Vector & xhat 
-    ) const {
-        X::zero(xhat);
-    }
-};
-
 // Initializes an SQL vector 
 template <typename Real>
 typename Optizelle::SQL <Real>::Vector initSQL(
@@ -691,6 +264,11 @@ public:
     ) const {
         Rm::zero(xhat);
     }
+
+    // Since h is affine, so is the phase-1 constraint
+    bool is_affine() const {
+        return true;
+    }
 };
 
 // Creates the ith cannonical vector
@@ -836,6 +414,51 @@ public:
     }
 };
 
+// Creates a block that's a multiple of the identity
+template <typename Real>
+Optizelle::CSRMatrix <Real> scaledIdentity(Natural const & n,Real const & a){
+    Optizelle::CSRMatrix <Real> A(n,n);
+    for(Natural i=0;i<n;i++) {
+        A.offsets[i+1]=i+1;
+        A.cols.emplace_back(i);
+        A.vals.emplace_back(a);
+    }
+    return A;
+}
+
+// Grabs the columns of the Jacobian of the phase-1 inequality
+//
+// hh(x,y) = [ h(x) - y1 e ]
+//           [ -y1 + y2 + epsilon ]
+//           [ y1 + y2 - epsilon ]
+//
+template <typename Real>
+Optizelle::sdpa::Columns <Real> phase1Columns(SparseSDP <Real> const & prob) {
+    // Start with the columns from the SDP and add an empty extra cone
+    auto cols = Optizelle::sdpa::columns <Real> (prob);
+    for(auto & col : cols)
+        col.emplace_back(Optizelle::CSRMatrix <Real> (2,2));
+
+    // The column for y1 is -e followed by (-1,1)
+    std::vector <Optizelle::CSRMatrix <Real> > col_y1;
+    for(Natural blk=0;blk<prob.nblocks();blk++)
+        col_y1.emplace_back(
+            scaledIdentity <Real> (prob.blkSize(blk),Real(-1.)));
+    col_y1.emplace_back(scaledIdentity <Real> (2,Real(-1.)));
+    col_y1.back().vals[1] = Real(1.);
+    cols.emplace_back(std::move(col_y1));
+
+    // The column for y2 is 0 followed by (1,1)
+    std::vector <Optizelle::CSRMatrix <Real> > col_y2;
+    for(Natural blk=0;blk<prob.nblocks();blk++)
+        col_y2.emplace_back(Optizelle::CSRMatrix <Real> (
+            prob.blkSize(blk),prob.blkSize(blk)));
+    col_y2.emplace_back(scaledIdentity <Real> (2,Real(1.)));
+    cols.emplace_back(std::move(col_y2));
+
+    return cols;
+}
+
 // Creates an initial guess for x
 template <typename Real>
 bool initPhase1X(
@@ -924,10 +547,9 @@ typename Optizelle::SQL <Real>::Vector initZ(
     return std::move(z);
 }
 
-// Parse the value epsilon for the phase-1 problem.  In addition,
-// parse whether or not we want finite difference tests.
+// Parse the value epsilon for the phase-1 problem
 template <typename Real>
-void parseSDPSettings(
+void parsePhase1Settings(
     std::string const & fname,
     Real & epsilon
 ) {
@@ -935,6 +557,25 @@ void parseSDPSettings(
     epsilon=Real(root["sdp_settings"].get("epsilon",1.).asDouble());
 }
 
+// Parse how we form the Schur complement for the preconditioner, which is
+// either Assembled, where we build it directly from the sparse constraint
+// matrices, or HessianProducts, where we apply the Hessian to each canonical
+// vector.  In addition, parse whether we split the semidefinite blocks into
+// the cliques of a chordal extension of their sparsity pattern.
+void parseSDPSettings(
+    std::string const & fname,
+    std::string & schur,
+    bool & chordal
+) {
+    Json::Value root=Optizelle::json::parse(fname);
+    schur=root["sdp_settings"].get("schur",schur).asString();
+    chordal=root["sdp_settings"].get("chordal",chordal).asBool();
+    if(schur!="Assembled" && schur!="HessianProducts") {
+        std::cerr << "Unknown Schur complement type: " << schur << std::endl;
+        exit(EXIT_FAILURE);
+    }
+}
+
 // Sets up and runs the problem
 int main(int argc,char* argv[]) {
     // Type shortcuts
@@ -956,18 +597,27 @@ int main(int argc,char* argv[]) {
 
     // Grab the settings for the phase-1 problem 
     double epsilon;
+    parsePhase1Settings(phase1_params,epsilon);
 
-    // Note, we're going to ignore the values of epsilon from the phase-2
-    // parsing.  Mostly, it's just easier not to have two different routines.
-    parseSDPSettings(phase2_params,epsilon);
-    parseSDPSettings(phase1_params,epsilon);
+    // Grab the settings for the SDP from the phase-2 parameters, which
+    // describe the problem that we actually want to solve
+    std::string schur("Assembled");
+    bool chordal(false);
+    parseSDPSettings(phase2_params,schur,chordal);
 
     // Parse the file sparse SDPA file
     SparseSDP <Real> prob;
-    parse_sdpa <Real> (fname,prob);
+    Optizelle::sdpa::read <Real> (fname,prob);
 
-    // Sort the indices of the resulting problem
-    sort_sdp <Real> (prob);
+    // Split the semidefinite blocks into cliques if requested
+    if(chordal) {
+        Optizelle::sdpa::Decomposition <Real> dec;
+        Optizelle::sdpa::decompose <Real> (prob,1,dec);
+        std::cout << "Split " << prob.nblocks() << " blocks into "
+            << dec.prob.nblocks() << " blocks with "
+            << dec.prob.m()-prob.m() << " coupling variables." << std::endl;
+        prob = std::move(dec.prob);
+    }
 
     // Create an initial guess for the problem
     Rm::Vector x;
@@ -995,8 +645,12 @@ int main(int argc,char* argv[]) {
         ::Functions::t phase1_fns;
     phase1_fns.f.reset(new Phase1Obj <Real> ()); 
     phase1_fns.h.reset(new Phase1Ineq <Real> (prob,epsilon));
-    phase1_fns.PH.reset(new SDPPreconditioner <Real,Optizelle::Rm> (
-        new ProjectRm <Real> (),phase1_fns.f_mod,phase1_state.x));
+    if(schur=="Assembled")
+        phase1_fns.PH.reset(new Optizelle::sdpa::Schur <Real> (
+            phase1Columns <Real> (prob),phase1_state));
+    else
+        phase1_fns.PH.reset(new SDPPreconditioner <Real,Optizelle::Rm> (
+            new ProjectRm <Real> (),phase1_fns.f_mod,phase1_state.x));
 
     // Solve the phase-1 problem if we're infeasible.
     if(!feasible) {
@@ -1046,8 +700,12 @@ int main(int argc,char* argv[]) {
         ::Functions::t fns;
     fns.f.reset(new SDPObj <Real> (prob));
     fns.h.reset(new SDPIneq <Real> (prob));
-    fns.PH.reset(new SDPPreconditioner <Real,Optizelle::Rm> (
-        new ProjectRm <Real> (),fns.f_mod,state.x));
+    if(schur=="Assembled")
+        fns.PH.reset(new Optizelle::sdpa::Schur <Real> (
+            Optizelle::sdpa::columns <Real> (prob),state));
+    else
+        fns.PH.reset(new SDPPreconditioner <Real,Optizelle::Rm> (
+            new ProjectRm <Real> (),fns.f_mod,state.x));
     
     // Keep our user informed
     std::cout << std::endl << "Solving the SDP probem: " << fname << std::endl;
@@ -0,0 +1,102 @@
+// Minimize the Rosenbrock function subject to the bounds x <= 1/2 and
+// y >= 0.  The optimal solution is (1/2,1/4) where only the bound on x is
+// active.
+
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "optizelle/json.h"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <limits>
+
+// Squares its input
+template <typename Real>
+Real sq(Real const & x){
+    return x*x;
+}
+
+// Define the Rosenbrock function where
+//
+// f(x,y)=(1-x)^2+100(y-x^2)^2
+//
+struct Rosenbrock
+    : public Optizelle::ScalarValuedFunction <double,Optizelle::Rm>
+{
+    typedef Optizelle::Rm <double> X;
+
+    // Evaluation of the Rosenbrock function
+    double eval(X::Vector const & x) const {
+        return sq(1.-x[0])+100.*sq(x[1]-sq(x[0]));
+    }
+
+    // Gradient
+    void grad(
+        X::Vector const & x,
+        X::Vector & grad
+    ) const {
+        grad[0]=-400.*x[0]*(x[1]-sq(x[0]))-2.*(1.-x[0]);
+        grad[1]=200.*(x[1]-sq(x[0]));
+    }
+
+    // Hessian-vector product
+    void hessvec(
+        X::Vector const & x,
+        X::Vector const & dx,
+        X::Vector & H_dx
+    ) const {
+        H_dx[0]=(1200.*sq(x[0])-400.*x[1]+2)*dx[0]-400.*x[0]*dx[1];
+        H_dx[1]=-400.*x[0]*dx[0]+200.*dx[1];
+    }
+};
+
+int main(int argc,char* argv[]){
+    // Read in the name for the input file
+    if(argc!=2) {
+        std::cerr << "simple_bound <parameters>" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    auto fname = argv[1];
+
+    // Create a type shortcut
+    using Optizelle::Rm;
+
+    // Generate an initial guess
+    auto x = std::vector <double> {-1.2, 1.};
+
+    // Set the bounds.  Use infinity for variables without a bound.
+    auto inf = std::numeric_limits <double>::infinity();
+    auto x_lo = std::vector <double> {-inf, 0.};
+    auto x_hi = std::vector <double> {0.5, inf};
+
+    // Create an optimization state
+    Optizelle::BoundConstrained <double,Rm>::State::t state(x,x_lo,x_hi);
+
+    // Read the parameters from file
+    Optizelle::json::BoundConstrained <double,Rm>::read(fname,state);
+
+    // Create a bundle of functions
+    Optizelle::BoundConstrained <double,Rm>::Functions::t fns;
+    fns.f.reset(new Rosenbrock);
+
+    // Solve the optimization problem
+    Optizelle::BoundConstrained <double,Rm>::Algorithms
+        ::getMin(Optizelle::Messaging::stdout,fns,state);
+
+    // Print out the reason for convergence
+    std::cout << "The algorithm converged due to: " <<
+        Optizelle::OptimizationStop::to_string(state.opt_stop) <<
+        std::endl;
+
+    // Print out the final answer
+    std::cout << std::scientific << std::setprecision(16)
+        << "The optimal point is: (" << state.x[0] << ','
+        << state.x[1] << ')' << std::endl;
+
+    // Write out the final answer to file
+    Optizelle::json::BoundConstrained <double,Rm>
+        ::write_restart("solution.json",state);
+
+    // Return that the program exited properly
+    return EXIT_SUCCESS;
+}
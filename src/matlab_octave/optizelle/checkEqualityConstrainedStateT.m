@@ -32,8 +32,12 @@ function checkEqualityConstrainedStateT(name,value)
         'rpred', ...
         'PSchur_left_type', ...
         'PSchur_right_type', ...
+        'augsys_solver', ...
         'augsys_iter_max', ...
         'augsys_rst_freq', ...
+        'augsys_recycle', ...
+        'augsys_proj_cache', ...
+        'augsys_broyden', ...
         'augsys_qn_iter', ...
         'augsys_pg_iter', ...
         'augsys_proj_iter', ...
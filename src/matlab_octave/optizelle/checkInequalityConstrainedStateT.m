@@ -17,6 +17,7 @@ function checkInequalityConstrainedStateT(name,value)
         'z', ...
         'dz', ...
         'h_x', ...
+        'comp_target', ...
         'mu', ...
         'mu_est', ...
         'mu_typ', ...
@@ -24,6 +25,8 @@ function checkInequalityConstrainedStateT(name,value)
         'sigma', ...
         'gamma', ...
         'alpha_z', ...
+        'ip_scheme', ...
+        'ip_scaling', ...
         'h_diag', ...
         'z_diag'}, ...
         value))
@@ -31,6 +31,7 @@ function checkUnconstrainedStateT(name,value)
         'x_old', ...
         'grad_old', ...
         'dx_old', ...
+        'grad_xpdx', ...
         'oldY', ...
         'oldS', ...
         'f_x', ...
@@ -49,6 +50,7 @@ function checkUnconstrainedStateT(name,value)
         'alpha0', ...
         'alpha', ...
         'c1', ...
+        'c2', ...
         'ls_iter', ...
         'ls_iter_max', ...
         'ls_iter_total', ...
@@ -59,7 +61,17 @@ function checkUnconstrainedStateT(name,value)
         'L_diag', ...
         'x_diag', ...
         'dscheme', ...
-        'eps_kind'}, ...
+        'eps_kind', ...
+        'trunc_reuse', ...
+        'trunc_solver', ...
+        'trunc_forcing', ...
+        'norm_gradold', ...
+        'nonmono_kind', ...
+        'nonmono_mem', ...
+        'nonmono_eta', ...
+        'merit_ref', ...
+        'merit_ref_q', ...
+        'merit_hist'}, ...
         value))
         error(sprintf( ...
             'The %s argument must have type Unconstrained.State.t.',name));
@@ -244,6 +244,9 @@ namespace Optizelle {
             case ObjectiveIncrease:
                 return Matlab::capi::enumToMxArray(
                     "TruncatedStop","ObjectiveIncrease");
+            case ModelDecreaseSmall:
+                return Matlab::capi::enumToMxArray(
+                    "TruncatedStop","ModelDecreaseSmall");
             }
         }
 
@@ -310,6 +313,10 @@ namespace Optizelle {
                 "TruncatedStop","ObjectiveIncrease")
             )
                 return ObjectiveIncrease;
+            else if(m==Matlab::capi::enumToNatural(
+                "TruncatedStop","ModelDecreaseSmall")
+            )
+                return ModelDecreaseSmall;
             else
                 throw Optizelle::Exception::t( __LOC__
                     + ", unknown TruncatedStop");
@@ -482,6 +489,9 @@ namespace Optizelle {
             case TwoPointB:
                 return Matlab::capi::enumToMxArray(
                     "LineSearchKind","TwoPointB");
+            case MoreThuente:
+                return Matlab::capi::enumToMxArray(
+                    "LineSearchKind","MoreThuente");
             }
         }
 
@@ -504,6 +514,10 @@ namespace Optizelle {
                 "LineSearchKind","TwoPointB")
             )
                 return TwoPointB;
+            else if(m==Matlab::capi::enumToNatural(
+                "LineSearchKind","MoreThuente")
+            )
+                return MoreThuente;
             else
                 throw Optizelle::Exception::t( __LOC__
                     + ", unknown LineSearchKind");
@@ -799,6 +813,286 @@ namespace Optizelle {
         }
     }
 
+    namespace KrylovReuse { 
+        // Converts t to a Matlab enumerated type
+        Matlab::mxArrayPtr toMatlab(t const & trunc_reuse) {
+            // Do the conversion
+            switch(trunc_reuse){
+            case NoReuse:
+                return Matlab::capi::enumToMxArray(
+                    "KrylovReuse","NoReuse");
+            case Subspace:
+                return Matlab::capi::enumToMxArray(
+                    "KrylovReuse","Subspace");
+            case SubspaceWarmStart:
+                return Matlab::capi::enumToMxArray(
+                    "KrylovReuse","SubspaceWarmStart");
+            }
+        }
+
+        // Converts a Matlab enumerated type to t 
+        t fromMatlab(Matlab::mxArrayPtr const & member) {
+            // Convert the member to a Natural 
+            auto m = Matlab::capi::mxArrayToNatural(member);
+
+            if(m==Matlab::capi::enumToNatural(
+                "KrylovReuse","NoReuse")
+            )
+                return NoReuse;
+            else if(m==Matlab::capi::enumToNatural(
+                "KrylovReuse","Subspace")
+            )
+                return Subspace;
+            else if(m==Matlab::capi::enumToNatural(
+                "KrylovReuse","SubspaceWarmStart")
+            )
+                return SubspaceWarmStart;
+            else
+                throw Optizelle::Exception::t( __LOC__
+                    + ", unknown KrylovReuse");
+        }
+    }
+
+    namespace TrustRegionSolver { 
+        // Converts t to a Matlab enumerated type
+        Matlab::mxArrayPtr toMatlab(t const & trunc_solver) {
+            // Do the conversion
+            switch(trunc_solver){
+            case TruncatedCG:
+                return Matlab::capi::enumToMxArray(
+                    "TrustRegionSolver","TruncatedCG");
+            case GLTR:
+                return Matlab::capi::enumToMxArray(
+                    "TrustRegionSolver","GLTR");
+            }
+        }
+
+        // Converts a Matlab enumerated type to t 
+        t fromMatlab(Matlab::mxArrayPtr const & member) {
+            // Convert the member to a Natural 
+            auto m = Matlab::capi::mxArrayToNatural(member);
+
+            if(m==Matlab::capi::enumToNatural(
+                "TrustRegionSolver","TruncatedCG")
+            )
+                return TruncatedCG;
+            else if(m==Matlab::capi::enumToNatural(
+                "TrustRegionSolver","GLTR")
+            )
+                return GLTR;
+            else
+                throw Optizelle::Exception::t( __LOC__
+                    + ", unknown TrustRegionSolver");
+        }
+    }
+
+    namespace ForcingTerm { 
+        // Converts t to a Matlab enumerated type
+        Matlab::mxArrayPtr toMatlab(t const & trunc_forcing) {
+            // Do the conversion
+            switch(trunc_forcing){
+            case Constant:
+                return Matlab::capi::enumToMxArray(
+                    "ForcingTerm","Constant");
+            case EisenstatWalker1:
+                return Matlab::capi::enumToMxArray(
+                    "ForcingTerm","EisenstatWalker1");
+            case EisenstatWalker2:
+                return Matlab::capi::enumToMxArray(
+                    "ForcingTerm","EisenstatWalker2");
+            case NashSofer:
+                return Matlab::capi::enumToMxArray(
+                    "ForcingTerm","NashSofer");
+            }
+        }
+
+        // Converts a Matlab enumerated type to t 
+        t fromMatlab(Matlab::mxArrayPtr const & member) {
+            // Convert the member to a Natural 
+            auto m = Matlab::capi::mxArrayToNatural(member);
+
+            if(m==Matlab::capi::enumToNatural(
+                "ForcingTerm","Constant")
+            )
+                return Constant;
+            else if(m==Matlab::capi::enumToNatural(
+                "ForcingTerm","EisenstatWalker1")
+            )
+                return EisenstatWalker1;
+            else if(m==Matlab::capi::enumToNatural(
+                "ForcingTerm","EisenstatWalker2")
+            )
+                return EisenstatWalker2;
+            else if(m==Matlab::capi::enumToNatural(
+                "ForcingTerm","NashSofer")
+            )
+                return NashSofer;
+            else
+                throw Optizelle::Exception::t( __LOC__
+                    + ", unknown ForcingTerm");
+        }
+    }
+
+    namespace NonmonotoneKind { 
+        // Converts t to a Matlab enumerated type
+        Matlab::mxArrayPtr toMatlab(t const & nonmono) {
+            // Do the conversion
+            switch(nonmono){
+            case Monotone:
+                return Matlab::capi::enumToMxArray(
+                    "NonmonotoneKind","Monotone");
+            case MaxWindow:
+                return Matlab::capi::enumToMxArray(
+                    "NonmonotoneKind","MaxWindow");
+            case WeightedAverage:
+                return Matlab::capi::enumToMxArray(
+                    "NonmonotoneKind","WeightedAverage");
+            }
+        }
+
+        // Converts a Matlab enumerated type to t 
+        t fromMatlab(Matlab::mxArrayPtr const & member) {
+            // Convert the member to a Natural 
+            auto m = Matlab::capi::mxArrayToNatural(member);
+
+            if(m==Matlab::capi::enumToNatural(
+                "NonmonotoneKind","Monotone")
+            )
+                return Monotone;
+            else if(m==Matlab::capi::enumToNatural(
+                "NonmonotoneKind","MaxWindow")
+            )
+                return MaxWindow;
+            else if(m==Matlab::capi::enumToNatural(
+                "NonmonotoneKind","WeightedAverage")
+            )
+                return WeightedAverage;
+            else
+                throw Optizelle::Exception::t( __LOC__
+                    + ", unknown NonmonotoneKind");
+        }
+    }
+
+    namespace AugmentedSystemSolver { 
+        // Converts t to a Matlab enumerated type
+        Matlab::mxArrayPtr toMatlab(t const & solver) {
+            // Do the conversion
+            switch(solver){
+            case GMRES:
+                return Matlab::capi::enumToMxArray(
+                    "AugmentedSystemSolver","GMRES");
+            case MINRES:
+                return Matlab::capi::enumToMxArray(
+                    "AugmentedSystemSolver","MINRES");
+            case QR:
+                return Matlab::capi::enumToMxArray(
+                    "AugmentedSystemSolver","QR");
+            case LDLT:
+                return Matlab::capi::enumToMxArray(
+                    "AugmentedSystemSolver","LDLT");
+            case FGMRES:
+                return Matlab::capi::enumToMxArray(
+                    "AugmentedSystemSolver","FGMRES");
+            }
+        }
+
+        // Converts a Matlab enumerated type to t 
+        t fromMatlab(Matlab::mxArrayPtr const & member) {
+            // Convert the member to a Natural 
+            auto m = Matlab::capi::mxArrayToNatural(member);
+
+            if(m==Matlab::capi::enumToNatural(
+                "AugmentedSystemSolver","GMRES")
+            )
+                return GMRES;
+            else if(m==Matlab::capi::enumToNatural(
+                "AugmentedSystemSolver","MINRES")
+            )
+                return MINRES;
+            else if(m==Matlab::capi::enumToNatural(
+                "AugmentedSystemSolver","QR")
+            )
+                return QR;
+            else if(m==Matlab::capi::enumToNatural(
+                "AugmentedSystemSolver","LDLT")
+            )
+                return LDLT;
+            else if(m==Matlab::capi::enumToNatural(
+                "AugmentedSystemSolver","FGMRES")
+            )
+                return FGMRES;
+            else
+                throw Optizelle::Exception::t( __LOC__
+                    + ", unknown AugmentedSystemSolver");
+        }
+    }
+
+    namespace InteriorPointScheme { 
+        // Converts t to a Matlab enumerated type
+        Matlab::mxArrayPtr toMatlab(t const & scheme) {
+            // Do the conversion
+            switch(scheme){
+            case FixedReduction:
+                return Matlab::capi::enumToMxArray(
+                    "InteriorPointScheme","FixedReduction");
+            case Mehrotra:
+                return Matlab::capi::enumToMxArray(
+                    "InteriorPointScheme","Mehrotra");
+            }
+        }
+
+        // Converts a Matlab enumerated type to t 
+        t fromMatlab(Matlab::mxArrayPtr const & member) {
+            // Convert the member to a Natural 
+            auto m = Matlab::capi::mxArrayToNatural(member);
+
+            if(m==Matlab::capi::enumToNatural(
+                "InteriorPointScheme","FixedReduction")
+            )
+                return FixedReduction;
+            else if(m==Matlab::capi::enumToNatural(
+                "InteriorPointScheme","Mehrotra")
+            )
+                return Mehrotra;
+            else
+                throw Optizelle::Exception::t( __LOC__
+                    + ", unknown InteriorPointScheme");
+        }
+    }
+
+    namespace InteriorPointScaling { 
+        // Converts t to a Matlab enumerated type
+        Matlab::mxArrayPtr toMatlab(t const & scaling) {
+            // Do the conversion
+            switch(scaling){
+            case Unscaled:
+                return Matlab::capi::enumToMxArray(
+                    "InteriorPointScaling","Unscaled");
+            case NesterovTodd:
+                return Matlab::capi::enumToMxArray(
+                    "InteriorPointScaling","NesterovTodd");
+            }
+        }
+
+        // Converts a Matlab enumerated type to t 
+        t fromMatlab(Matlab::mxArrayPtr const & member) {
+            // Convert the member to a Natural 
+            auto m = Matlab::capi::mxArrayToNatural(member);
+
+            if(m==Matlab::capi::enumToNatural(
+                "InteriorPointScaling","Unscaled")
+            )
+                return Unscaled;
+            else if(m==Matlab::capi::enumToNatural(
+                "InteriorPointScaling","NesterovTodd")
+            )
+                return NesterovTodd;
+            else
+                throw Optizelle::Exception::t( __LOC__
+                    + ", unknown InteriorPointScaling");
+        }
+    }
+
     namespace QuasinormalStop{ 
         // Converts t to a Matlab enumerated type
         Matlab::mxArrayPtr toMatlab(t const & qn_stop) {
@@ -1648,6 +1942,26 @@ namespace Optizelle {
                 // Insert the items into mxstate 
                 capi::mxSetField(mxstate,0,name,mxvectors);
             }
+
+            // Sets a list of reals in a Matlab state 
+            void RealList(
+                std::string const & name,
+                std::list <double> const & values,
+                mxArrayPtr & mxstate 
+            ) {
+                // Create a new Matlab cell array that we insert elements into
+                auto mxvalues = capi::mxCreateCellMatrix(1,values.size());
+
+                // Insert each real into the cell array
+                auto i = Optizelle::Natural(0);
+                for(auto const & value : values) {
+                    capi::mxSetCell(mxvalues,i,capi::mxArrayFromDouble(value));
+                    i++;
+                }
+                
+                // Insert the items into mxstate 
+                capi::mxSetField(mxstate,0,name,mxvalues);
+            }
         
             // Sets restart vectors in Matlab 
             void Vectors(
@@ -1805,6 +2119,23 @@ namespace Optizelle {
                     values.back().fromMatlab(item);
                 }
             }
+
+            // Sets a list of reals in a C++ state 
+            void RealList(
+                std::string const & name,
+                mxArrayPtr const & mxstate,
+                std::list <double> & values
+            ) {
+                // Grab the list of items
+                auto items = capi::mxGetField(mxstate,0,name);
+
+                // Loop over all the elements in items and insert them one
+                // at a time into values
+                values.clear();
+                for(auto i=0;i<capi::mxGetN(items);i++)
+                    values.emplace_back(
+                        capi::mxArrayToDouble(capi::mxGetCell(items,i)));
+            }
             
             // Sets restart vectors in C++ 
             void Vectors(
@@ -2011,6 +2342,7 @@ namespace Optizelle {
                         "x_old",
                         "grad_old",
                         "dx_old",
+                        "grad_xpdx",
                         "oldY",
                         "oldS",
                         "f_x",
@@ -2029,6 +2361,7 @@ namespace Optizelle {
                         "alpha0",
                         "alpha",
                         "c1",
+                        "c2",
                         "ls_iter",
                         "ls_iter_max",
                         "ls_iter_total",
@@ -2039,7 +2372,17 @@ namespace Optizelle {
                         "L_diag",
                         "x_diag",
                         "dscheme",
-                        "eps_kind"};
+                        "eps_kind",
+                        "trunc_reuse",
+                        "trunc_solver",
+                        "trunc_forcing",
+                        "norm_gradold",
+                        "nonmono_kind",
+                        "nonmono_mem",
+                        "nonmono_eta",
+                        "merit_ref",
+                        "merit_ref_q",
+                        "merit_hist"};
 
                     return names;
                 }
@@ -2116,6 +2459,7 @@ namespace Optizelle {
                     toMatlab::Vector("x_old",state.x_old,mxstate);
                     toMatlab::Vector("grad_old",state.grad_old,mxstate);
                     toMatlab::Vector("dx_old",state.dx_old,mxstate);
+                    toMatlab::Vector("grad_xpdx",state.grad_xpdx,mxstate);
                     toMatlab::VectorList("oldY",state.oldY,mxstate);
                     toMatlab::VectorList("oldS",state.oldS,mxstate);
                     toMatlab::Real("f_x",state.f_x,mxstate);
@@ -2137,6 +2481,7 @@ namespace Optizelle {
                     toMatlab::Real("alpha0",state.alpha0,mxstate);
                     toMatlab::Real("alpha",state.alpha,mxstate);
                     toMatlab::Real("c1",state.c1,mxstate);
+                    toMatlab::Real("c2",state.c2,mxstate);
                     toMatlab::Natural("ls_iter",
                         state.ls_iter,mxstate);
                     toMatlab::Natural("ls_iter_max",
@@ -2179,6 +2524,33 @@ namespace Optizelle {
                         ToleranceKind::toMatlab,
                         state.eps_kind,
                         mxstate);
+                    toMatlab::Param <KrylovReuse::t> (
+                        "trunc_reuse",
+                        KrylovReuse::toMatlab,
+                        state.trunc_reuse,
+                        mxstate);
+                    toMatlab::Param <TrustRegionSolver::t> (
+                        "trunc_solver",
+                        TrustRegionSolver::toMatlab,
+                        state.trunc_solver,
+                        mxstate);
+                    toMatlab::Param <ForcingTerm::t> (
+                        "trunc_forcing",
+                        ForcingTerm::toMatlab,
+                        state.trunc_forcing,
+                        mxstate);
+                    toMatlab::Real("norm_gradold",state.norm_gradold,mxstate);
+                    toMatlab::Param <NonmonotoneKind::t> (
+                        "nonmono_kind",
+                        NonmonotoneKind::toMatlab,
+                        state.nonmono_kind,
+                        mxstate);
+                    toMatlab::Natural("nonmono_mem",
+                        state.nonmono_mem,mxstate);
+                    toMatlab::Real("nonmono_eta",state.nonmono_eta,mxstate);
+                    toMatlab::Real("merit_ref",state.merit_ref,mxstate);
+                    toMatlab::Real("merit_ref_q",state.merit_ref_q,mxstate);
+                    toMatlab::RealList("merit_hist",state.merit_hist,mxstate);
                 }
                 void toMatlab(
                     typename MxUnconstrained::State::t const & state,
@@ -2252,6 +2624,7 @@ namespace Optizelle {
                     fromMatlab::Vector("x_old",mxstate,state.x_old);
                     fromMatlab::Vector("grad_old",mxstate,state.grad_old);
                     fromMatlab::Vector("dx_old",mxstate,state.dx_old);
+                    fromMatlab::Vector("grad_xpdx",mxstate,state.grad_xpdx);
                     fromMatlab::VectorList("oldY",mxstate,state.x,state.oldY);
                     fromMatlab::VectorList("oldS",mxstate,state.x,state.oldS);
                     fromMatlab::Real("f_x",mxstate,state.f_x);
@@ -2273,6 +2646,7 @@ namespace Optizelle {
                     fromMatlab::Real("alpha0",mxstate,state.alpha0);
                     fromMatlab::Real("alpha",mxstate,state.alpha);
                     fromMatlab::Real("c1",mxstate,state.c1);
+                    fromMatlab::Real("c2",mxstate,state.c2);
                     fromMatlab::Natural("ls_iter",
                         mxstate,state.ls_iter);
                     fromMatlab::Natural("ls_iter_max",
@@ -2315,6 +2689,33 @@ namespace Optizelle {
                         ToleranceKind::fromMatlab,
                         mxstate,
                         state.eps_kind);
+                    fromMatlab::Param <KrylovReuse::t> (
+                        "trunc_reuse",
+                        KrylovReuse::fromMatlab,
+                        mxstate,
+                        state.trunc_reuse);
+                    fromMatlab::Param <TrustRegionSolver::t> (
+                        "trunc_solver",
+                        TrustRegionSolver::fromMatlab,
+                        mxstate,
+                        state.trunc_solver);
+                    fromMatlab::Param <ForcingTerm::t> (
+                        "trunc_forcing",
+                        ForcingTerm::fromMatlab,
+                        mxstate,
+                        state.trunc_forcing);
+                    fromMatlab::Real("norm_gradold",mxstate,state.norm_gradold);
+                    fromMatlab::Param <NonmonotoneKind::t> (
+                        "nonmono_kind",
+                        NonmonotoneKind::fromMatlab,
+                        mxstate,
+                        state.nonmono_kind);
+                    fromMatlab::Natural("nonmono_mem",
+                        mxstate,state.nonmono_mem);
+                    fromMatlab::Real("nonmono_eta",mxstate,state.nonmono_eta);
+                    fromMatlab::Real("merit_ref",mxstate,state.merit_ref);
+                    fromMatlab::Real("merit_ref_q",mxstate,state.merit_ref_q);
+                    fromMatlab::RealList("merit_hist",mxstate,state.merit_hist);
                 }
                 void fromMatlab(
                     mxArrayPtr const & mxstate,
@@ -2647,8 +3048,12 @@ namespace Optizelle {
                         "rpred",
                         "PSchur_left_type",
                         "PSchur_right_type",
+                        "augsys_solver",
                         "augsys_iter_max",
                         "augsys_rst_freq",
+                        "augsys_recycle",
+                        "augsys_proj_cache",
+                        "augsys_broyden",
                         "augsys_qn_iter",
                         "augsys_pg_iter",
                         "augsys_proj_iter",
@@ -2744,10 +3149,21 @@ namespace Optizelle {
                         Operators::toMatlab,
                         state.PSchur_right_type,
                         mxstate);
+                    toMatlab::Param <AugmentedSystemSolver::t> (
+                        "augsys_solver",
+                        AugmentedSystemSolver::toMatlab,
+                        state.augsys_solver,
+                        mxstate);
                     toMatlab::Natural("augsys_iter_max",
                         state.augsys_iter_max,mxstate);
                     toMatlab::Natural("augsys_rst_freq",
                         state.augsys_rst_freq,mxstate);
+                    toMatlab::Natural("augsys_recycle",
+                        state.augsys_recycle,mxstate);
+                    toMatlab::Natural("augsys_proj_cache",
+                        state.augsys_proj_cache,mxstate);
+                    toMatlab::Natural("augsys_broyden",
+                        state.augsys_broyden,mxstate);
                     toMatlab::Natural("augsys_qn_iter",
                         state.augsys_qn_iter,mxstate);
                     toMatlab::Natural("augsys_pg_iter",
@@ -2875,10 +3291,21 @@ namespace Optizelle {
                         Operators::fromMatlab,
                         mxstate,
                         state.PSchur_right_type);
+                    fromMatlab::Param <AugmentedSystemSolver::t> (
+                        "augsys_solver",
+                        AugmentedSystemSolver::fromMatlab,
+                        mxstate,
+                        state.augsys_solver);
                     fromMatlab::Natural("augsys_iter_max",
                         mxstate,state.augsys_iter_max);
                     fromMatlab::Natural("augsys_rst_freq",
                         mxstate,state.augsys_rst_freq);
+                    fromMatlab::Natural("augsys_recycle",
+                        mxstate,state.augsys_recycle);
+                    fromMatlab::Natural("augsys_proj_cache",
+                        mxstate,state.augsys_proj_cache);
+                    fromMatlab::Natural("augsys_broyden",
+                        mxstate,state.augsys_broyden);
                     fromMatlab::Natural("augsys_qn_iter",
                         mxstate,state.augsys_qn_iter);
                     fromMatlab::Natural("augsys_pg_iter",
@@ -3311,6 +3738,7 @@ namespace Optizelle {
                         "z",
                         "dz",
                         "h_x",
+                        "comp_target",
                         "mu",
                         "mu_est",
                         "mu_typ",
@@ -3318,6 +3746,8 @@ namespace Optizelle {
                         "sigma",
                         "gamma",
                         "alpha_z",
+                        "ip_scheme",
+                        "ip_scaling",
                         "h_diag",
                         "z_diag"};
 
@@ -3348,6 +3778,7 @@ namespace Optizelle {
                     toMatlab::Vector("z",state.z,mxstate);
                     toMatlab::Vector("dz",state.dz,mxstate);
                     toMatlab::Vector("h_x",state.h_x,mxstate);
+                    toMatlab::Vector("comp_target",state.comp_target,mxstate);
                     toMatlab::Real("mu",state.mu,mxstate);
                     toMatlab::Real("mu_est",state.mu_est,mxstate);
                     toMatlab::Real("mu_typ",state.mu_typ,mxstate);
@@ -3355,6 +3786,16 @@ namespace Optizelle {
                     toMatlab::Real("sigma",state.sigma,mxstate);
                     toMatlab::Real("gamma",state.gamma,mxstate);
                     toMatlab::Real("alpha_z",state.alpha_z,mxstate);
+                    toMatlab::Param <InteriorPointScheme::t> (
+                        "ip_scheme",
+                        InteriorPointScheme::toMatlab,
+                        state.ip_scheme,
+                        mxstate);
+                    toMatlab::Param <InteriorPointScaling::t> (
+                        "ip_scaling",
+                        InteriorPointScaling::toMatlab,
+                        state.ip_scaling,
+                        mxstate);
                     toMatlab::Param <FunctionDiagnostics::t> (
                         "h_diag",
                         FunctionDiagnostics::toMatlab,
@@ -3382,6 +3823,8 @@ namespace Optizelle {
                     fromMatlab::Vector("z",mxstate,state.z);
                     fromMatlab::Vector("dz",mxstate,state.dz);
                     fromMatlab::Vector("h_x",mxstate,state.h_x);
+                    fromMatlab::Vector("comp_target",mxstate,
+                        state.comp_target);
                     fromMatlab::Real("mu",mxstate,state.mu);
                     fromMatlab::Real("mu_est",mxstate,state.mu_est);
                     fromMatlab::Real("mu_typ",mxstate,state.mu_typ);
@@ -3389,6 +3832,16 @@ namespace Optizelle {
                     fromMatlab::Real("sigma",mxstate,state.sigma);
                     fromMatlab::Real("gamma",mxstate,state.gamma);
                     fromMatlab::Real("alpha_z",mxstate,state.alpha_z);
+                    fromMatlab::Param <InteriorPointScheme::t> (
+                        "ip_scheme",
+                        InteriorPointScheme::fromMatlab,
+                        mxstate,
+                        state.ip_scheme);
+                    fromMatlab::Param <InteriorPointScaling::t> (
+                        "ip_scaling",
+                        InteriorPointScaling::fromMatlab,
+                        mxstate,
+                        state.ip_scaling);
                     fromMatlab::Param <FunctionDiagnostics::t> (
                         "h_diag",
                         FunctionDiagnostics::fromMatlab,
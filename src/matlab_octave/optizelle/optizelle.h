@@ -714,6 +714,13 @@ namespace Optizelle {
                 std::list <Matlab::Vector> const & values,
                 mxArrayPtr & mxstate 
             );
+
+            // Sets a list of reals in a Matlab state 
+            void RealList(
+                std::string const & name,
+                std::list <double> const & values,
+                mxArrayPtr & mxstate 
+            );
         
             // Sets restart vectors in Matlab 
             void Vectors(
@@ -782,6 +789,13 @@ namespace Optizelle {
                 Matlab::Vector const & vec,
                 std::list <Matlab::Vector> & values
             );
+
+            // Sets a list of reals in a C++ state 
+            void RealList(
+                std::string const & name,
+                mxArrayPtr const & mxstate,
+                std::list <double> & values
+            );
             
             // Sets a scalar-valued function in a C++ function bundle 
             template <typename ProblemClass>
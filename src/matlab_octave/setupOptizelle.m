@@ -45,7 +45,8 @@ Optizelle.TruncatedStop = createEnum( { ...
     'OffsetViolatesTrustRegion', ...
     'OffsetViolatesSafeguard', ...
     'TooManyFailedSafeguard', ...
-    'ObjectiveIncrease'} );
+    'ObjectiveIncrease', ...
+    'ModelDecreaseSmall'} );
 
 % Which algorithm Optizelle.do we use
 Optizelle.AlgorithmClass = createEnum( { ...
@@ -88,7 +89,8 @@ Optizelle.LineSearchKind = createEnum( { ...
     'GoldenSection', ...
     'BackTracking', ...
     'TwoPointA', ...
-    'TwoPointB' } );
+    'TwoPointB', ...
+    'MoreThuente' } );
     
 % Different points in the optimization algorithm
 Optizelle.OptimizationLocation = createEnum( { ...
@@ -149,6 +151,48 @@ Optizelle.ToleranceKind = createEnum( { ...
     'Absolute', ...
     'Relative'});
 
+% How we reuse the Krylov subspace built by truncated CG
+Optizelle.KrylovReuse = createEnum( { ...
+    'NoReuse', ...
+    'Subspace', ...
+    'SubspaceWarmStart'});
+
+% Different solvers for the trust-region subproblem
+Optizelle.TrustRegionSolver = createEnum( { ...
+    'TruncatedCG', ...
+    'GLTR'});
+
+% How we choose the stopping tolerance for truncated CG
+Optizelle.ForcingTerm = createEnum( { ...
+    'Constant', ...
+    'EisenstatWalker1', ...
+    'EisenstatWalker2', ...
+    'NashSofer'});
+
+% Reference value used when accepting a step
+Optizelle.NonmonotoneKind = createEnum( { ...
+    'Monotone', ...
+    'MaxWindow', ...
+    'WeightedAverage'});
+
+% Different solvers for the augmented system
+Optizelle.AugmentedSystemSolver = createEnum( { ...
+    'GMRES', ...
+    'MINRES', ...
+    'QR', ...
+    'LDLT', ...
+    'FGMRES'});
+
+% Different schemes for updating the interior point parameter
+Optizelle.InteriorPointScheme = createEnum( { ...
+    'FixedReduction', ...
+    'Mehrotra'});
+
+% Different scalings for the interior point linearization
+Optizelle.InteriorPointScaling = createEnum( { ...
+    'Unscaled', ...
+    'NesterovTodd'});
+
 % Reasons why the quasinormal problem exited
 Optizelle.QuasinormalStop = createEnum( { ...
     'Newton', ...
@@ -24,8 +24,9 @@ class TruncatedStop(EnumeratedType):
     OffsetViolatesTrustRegion, \
     OffsetViolatesSafeguard, \
     TooManyFailedSafeguard, \
-    ObjectiveIncrease \
-    = range(15)
+    ObjectiveIncrease, \
+    ModelDecreaseSmall \
+    = range(16)
 
 class AlgorithmClass(EnumeratedType):
     """Which algorithm class do we use"""
@@ -72,8 +73,9 @@ class LineSearchKind(EnumeratedType):
     GoldenSection, \
     BackTracking, \
     TwoPointA, \
-    TwoPointB \
-    = range(4)
+    TwoPointB, \
+    MoreThuente \
+    = range(5)
     
 class OptimizationLocation(EnumeratedType):
     """Different points in the optimization algorithm"""
@@ -134,6 +136,55 @@ class ToleranceKind(EnumeratedType):
     Absolute \
     = range(2)
 
+class KrylovReuse(EnumeratedType):
+    """How we reuse the Krylov subspace built by truncated CG"""
+    NoReuse, \
+    Subspace, \
+    SubspaceWarmStart \
+    = range(3)
+
+class TrustRegionSolver(EnumeratedType):
+    """Different solvers for the trust-region subproblem"""
+    TruncatedCG, \
+    GLTR \
+    = range(2)
+
+class ForcingTerm(EnumeratedType):
+    """How we choose the stopping tolerance for truncated CG"""
+    Constant, \
+    EisenstatWalker1, \
+    EisenstatWalker2, \
+    NashSofer \
+    = range(4)
+
+class NonmonotoneKind(EnumeratedType):
+    """Reference value used when accepting a step"""
+    Monotone, \
+    MaxWindow, \
+    WeightedAverage \
+    = range(3)
+
+class AugmentedSystemSolver(EnumeratedType):
+    """Different solvers for the augmented system"""
+    GMRES, \
+    MINRES, \
+    QR, \
+    LDLT, \
+    FGMRES \
+    = range(5)
+
+class InteriorPointScheme(EnumeratedType):
+    """Different schemes for updating the interior point parameter"""
+    FixedReduction, \
+    Mehrotra \
+    = range(2)
+
+class InteriorPointScaling(EnumeratedType):
+    """Different scalings for the interior point linearization"""
+    Unscaled, \
+    NesterovTodd \
+    = range(2)
+
 class QuasinormalStop(EnumeratedType):
     """Reasons why the quasinormal problem exited"""
     Newton, \
@@ -106,12 +106,29 @@ class t(Optizelle.Unconstrained.State.t):
         "PSchur_right_type",
         Operators,
         "Right preconditioner for the augmented system")
+    augsys_solver = createEnumProperty(
+        "augsys_solver",
+        AugmentedSystemSolver,
+        "Krylov solver for the augmented system")
     augsys_iter_max = createNatProperty(
         "augsys_iter_max",
         "Maximum number of iterations used when solving the augmented system")
     augsys_rst_freq = createNatProperty(
         "augsys_rst_freq",
         ("How often we restart the augmented system solve"))
+    augsys_recycle = createNatProperty(
+        "augsys_recycle",
+        ("Number of directions recycled between the augmented system solves.  "
+        "When 0, we do not recycle."))
+    augsys_proj_cache = createNatProperty(
+        "augsys_proj_cache",
+        ("Maximum number of vectors cached from the nullspace projections as "
+        "a basis for the range of g'(x)*.  When 0, we do not cache."))
+    augsys_broyden = createNatProperty(
+        "augsys_broyden",
+        ("Maximum number of Broyden updates to the approximation of g'(x) "
+        "used by the augmented system solves before we rebuild it.  When 0, "
+        "we use g'(x) directly."))
     augsys_qn_iter = createNatProperty(
         "augsys_qn_iter",
         ("Number of augmented system solve iterations used on the quasi-normal "
@@ -12,6 +12,7 @@ def allocateVectors(self,X,Z,x,z):
     self.z=Z.init(z)
     self.dz=Z.init(z)
     self.h_x=Z.init(z)
+    self.comp_target=Z.init(z)
 
 class t(Optizelle.Unconstrained.State.t):
     """Internal state of the optimization"""
@@ -40,6 +41,10 @@ class t(Optizelle.Unconstrained.State.t):
     h_x = createVectorProperty(
         "h_x",
         "The inequality constraint evaluated at x.")
+    comp_target = createVectorProperty(
+        "comp_target",
+        ("Target for the complementarity h(x) o z in the Newton system.  "
+        "Only used by the Mehrotra scheme."))
     mu = createFloatProperty(
         "mu",
         "Interior point parameter")
@@ -63,6 +68,14 @@ class t(Optizelle.Unconstrained.State.t):
         "alpha_z",
         ("Amount we truncate dx in order to maintain feasibility "
         " of the inequality multiplier"))
+    ip_scheme = createEnumProperty(
+        "ip_scheme",
+        InteriorPointScheme,
+        "Scheme for updating the interior point parameter")
+    ip_scaling = createEnumProperty(
+        "ip_scaling",
+        InteriorPointScaling,
+        "Scaling for the linearization of the complementarity conditions")
     h_diag = createEnumProperty(
         "h_diag",
         FunctionDiagnostics,
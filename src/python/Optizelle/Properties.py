@@ -34,6 +34,12 @@ def checkVectorList(name,value):
     if not isinstance(value,list): 
         raise TypeError("%s member must be a list of vectors" % name)
 
+def checkFloatList(name,value):
+    """Checks that an input is a list of floating-point numbers"""
+    if not isinstance(value,list) or \
+        not all(map(lambda x:isinstance(x,float),value)): 
+        raise TypeError("%s member must be a list of floating points" % name)
+
 def checkFunction(name,value):
     """Checks that an input is a function"""
     if not inspect.isfunction(value):
@@ -225,6 +231,20 @@ def createVectorListProperty(name,desc):
 
     return property(getter,setter,deleter,desc)
 
+def createFloatListProperty(name,desc):
+    """Create a list of floating-point numbers property"""
+    def getter(self):
+        return self.__dict__["_%s" % name] 
+
+    def setter(self, value):
+        checkFloatList(name,value)
+        self.__dict__["_%s" % name] = value
+
+    def deleter(self):
+        checkDelete(name)
+
+    return property(getter,setter,deleter,desc)
+
 
 def createScalarValuedFunctionProperty(name,desc):
     """Create a scalar-valued function property"""
@@ -14,6 +14,7 @@ def allocateVectors(self,X,x):
     self.x_old=X.init(x)
     self.grad_old=X.init(x)
     self.dx_old=X.init(x)
+    self.grad_xpdx=X.init(x)
 
 class t(object):
     """Internal state of the optimization"""
@@ -88,6 +89,43 @@ class t(object):
     eps_trunc = createFloatProperty(
         "eps_trunc",
         "Stopping tolerance for truncated CG")
+    trunc_reuse = createEnumProperty(
+        "trunc_reuse",
+        KrylovReuse,
+        "How we reuse the Krylov subspace built by truncated CG")
+    trunc_solver = createEnumProperty(
+        "trunc_solver",
+        TrustRegionSolver,
+        "Solver for the trust-region subproblem")
+    trunc_forcing = createEnumProperty(
+        "trunc_forcing",
+        ForcingTerm,
+        "How we choose the stopping tolerance for truncated CG")
+    norm_gradold = createFloatProperty(
+        "norm_gradold",
+        "Norm of the gradient step at the prior iterate")
+    nonmono_kind = createEnumProperty(
+        "nonmono_kind",
+        NonmonotoneKind,
+        "Reference value used when accepting a step")
+    nonmono_mem = createNatProperty(
+        "nonmono_mem",
+        ("Number of prior merit values used by the max-window "
+        "nonmonotone reference"))
+    nonmono_eta = createFloatProperty(
+        "nonmono_eta",
+        ("Weight of the prior reference in the weighted-average "
+        "nonmonotone reference"))
+    merit_ref = createFloatProperty(
+        "merit_ref",
+        ("Reference value of the merit function that we compare "
+        "against when accepting a step"))
+    merit_ref_q = createFloatProperty(
+        "merit_ref_q",
+        "Accumulated weight of the weighted-average reference")
+    merit_hist = createFloatListProperty(
+        "merit_hist",
+        "Prior merit values used by the max-window reference")
     algorithm_class = createEnumProperty(
         "algorithm_class",
         AlgorithmClass,
@@ -125,6 +163,9 @@ class t(object):
     dx_old = createVectorProperty(
         "dx_old",
         "Old trial step") 
+    grad_xpdx = createVectorProperty(
+        "grad_xpdx",
+        "Gradient at the trial step") 
     oldY = createVectorListProperty(
         "oldY",
         "Difference in prior gradients")
@@ -184,6 +225,10 @@ class t(object):
     c1 = createFloatProperty(
         "c1",
         "Parameter that helps govern the sufficient decrease")
+    c2 = createFloatProperty(
+        "c2",
+        ("Parameter that helps govern the curvature condition in the "
+        "strong-Wolfe line-search"))
     ls_iter = createNatProperty(
         "ls_iter",
         "Current number of iterations used in the line-search")
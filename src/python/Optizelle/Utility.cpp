@@ -297,6 +297,9 @@ namespace Optizelle {
             case ObjectiveIncrease:
                 return Python::capi::enumToPyObject(
                     "TruncatedStop","ObjectiveIncrease");
+            case ModelDecreaseSmall:
+                return Python::capi::enumToPyObject(
+                    "TruncatedStop","ModelDecreaseSmall");
             }
         }
 
@@ -363,6 +366,10 @@ namespace Optizelle {
                 "TruncatedStop","ObjectiveIncrease")
             )
                 return ObjectiveIncrease;
+            else if(m==Python::capi::enumToNatural(
+                "TruncatedStop","ModelDecreaseSmall")
+            )
+                return ModelDecreaseSmall;
             else
                 throw Optizelle::Exception::t( __LOC__
                     + ", unknown TruncatedStop");
@@ -541,6 +548,9 @@ namespace Optizelle {
             case TwoPointB:
                 return Python::capi::enumToPyObject(
                     "LineSearchKind","TwoPointB");
+            case MoreThuente:
+                return Python::capi::enumToPyObject(
+                    "LineSearchKind","MoreThuente");
             }
         }
 
@@ -565,6 +575,10 @@ namespace Optizelle {
                 "LineSearchKind","TwoPointB")
             )
                 return TwoPointB;
+            else if(m==Python::capi::enumToNatural(
+                "LineSearchKind","MoreThuente")
+            )
+                return MoreThuente;
             else
                 throw Optizelle::Exception::t( __LOC__
                     + ", unknown LineSearchKind");
@@ -860,6 +874,286 @@ namespace Optizelle {
         }
     }
 
+    namespace KrylovReuse { 
+        // Converts t to a Python enumerated type
+        Python::PyObjectPtr toPython(t const & trunc_reuse) {
+            // Do the conversion
+            switch(trunc_reuse){
+            case NoReuse:
+                return Python::capi::enumToPyObject("KrylovReuse",
+                    "NoReuse");
+            case Subspace:
+                return Python::capi::enumToPyObject("KrylovReuse",
+                    "Subspace");
+            case SubspaceWarmStart:
+                return Python::capi::enumToPyObject("KrylovReuse",
+                    "SubspaceWarmStart");
+            }
+        }
+
+        // Converts a Python enumerated type to t 
+        t fromPython(Python::PyObjectPtr const & member) {
+            // Convert the member to a Natural 
+            auto m=Python::capi::PyInt_AsNatural(member);
+
+            if(m==Python::capi::enumToNatural("KrylovReuse",
+                "NoReuse")
+            )
+                return NoReuse;
+            else if(m==Python::capi::enumToNatural("KrylovReuse",
+                "Subspace")
+            )
+                return Subspace;
+            else if(m==Python::capi::enumToNatural("KrylovReuse",
+                "SubspaceWarmStart")
+            )
+                return SubspaceWarmStart;
+            else
+                throw Optizelle::Exception::t( __LOC__
+                    + ", unknown KrylovReuse");
+        }
+    }
+
+    namespace TrustRegionSolver { 
+        // Converts t to a Python enumerated type
+        Python::PyObjectPtr toPython(t const & trunc_solver) {
+            // Do the conversion
+            switch(trunc_solver){
+            case TruncatedCG:
+                return Python::capi::enumToPyObject("TrustRegionSolver",
+                    "TruncatedCG");
+            case GLTR:
+                return Python::capi::enumToPyObject("TrustRegionSolver",
+                    "GLTR");
+            }
+        }
+
+        // Converts a Python enumerated type to t 
+        t fromPython(Python::PyObjectPtr const & member) {
+            // Convert the member to a Natural 
+            auto m=Python::capi::PyInt_AsNatural(member);
+
+            if(m==Python::capi::enumToNatural("TrustRegionSolver",
+                "TruncatedCG")
+            )
+                return TruncatedCG;
+            else if(m==Python::capi::enumToNatural("TrustRegionSolver",
+                "GLTR")
+            )
+                return GLTR;
+            else
+                throw Optizelle::Exception::t( __LOC__
+                    + ", unknown TrustRegionSolver");
+        }
+    }
+
+    namespace ForcingTerm { 
+        // Converts t to a Python enumerated type
+        Python::PyObjectPtr toPython(t const & trunc_forcing) {
+            // Do the conversion
+            switch(trunc_forcing){
+            case Constant:
+                return Python::capi::enumToPyObject("ForcingTerm",
+                    "Constant");
+            case EisenstatWalker1:
+                return Python::capi::enumToPyObject("ForcingTerm",
+                    "EisenstatWalker1");
+            case EisenstatWalker2:
+                return Python::capi::enumToPyObject("ForcingTerm",
+                    "EisenstatWalker2");
+            case NashSofer:
+                return Python::capi::enumToPyObject("ForcingTerm",
+                    "NashSofer");
+            }
+        }
+
+        // Converts a Python enumerated type to t 
+        t fromPython(Python::PyObjectPtr const & member) {
+            // Convert the member to a Natural 
+            auto m=Python::capi::PyInt_AsNatural(member);
+
+            if(m==Python::capi::enumToNatural("ForcingTerm",
+                "Constant")
+            )
+                return Constant;
+            else if(m==Python::capi::enumToNatural("ForcingTerm",
+                "EisenstatWalker1")
+            )
+                return EisenstatWalker1;
+            else if(m==Python::capi::enumToNatural("ForcingTerm",
+                "EisenstatWalker2")
+            )
+                return EisenstatWalker2;
+            else if(m==Python::capi::enumToNatural("ForcingTerm",
+                "NashSofer")
+            )
+                return NashSofer;
+            else
+                throw Optizelle::Exception::t( __LOC__
+                    + ", unknown ForcingTerm");
+        }
+    }
+
+    namespace NonmonotoneKind { 
+        // Converts t to a Python enumerated type
+        Python::PyObjectPtr toPython(t const & nonmono) {
+            // Do the conversion
+            switch(nonmono){
+            case Monotone:
+                return Python::capi::enumToPyObject("NonmonotoneKind",
+                    "Monotone");
+            case MaxWindow:
+                return Python::capi::enumToPyObject("NonmonotoneKind",
+                    "MaxWindow");
+            case WeightedAverage:
+                return Python::capi::enumToPyObject("NonmonotoneKind",
+                    "WeightedAverage");
+            }
+        }
+
+        // Converts a Python enumerated type to t 
+        t fromPython(Python::PyObjectPtr const & member) {
+            // Convert the member to a Natural 
+            auto m=Python::capi::PyInt_AsNatural(member);
+
+            if(m==Python::capi::enumToNatural("NonmonotoneKind",
+                "Monotone")
+            )
+                return Monotone;
+            else if(m==Python::capi::enumToNatural("NonmonotoneKind",
+                "MaxWindow")
+            )
+                return MaxWindow;
+            else if(m==Python::capi::enumToNatural("NonmonotoneKind",
+                "WeightedAverage")
+            )
+                return WeightedAverage;
+            else
+                throw Optizelle::Exception::t( __LOC__
+                    + ", unknown NonmonotoneKind");
+        }
+    }
+
+    namespace AugmentedSystemSolver { 
+        // Converts t to a Python enumerated type
+        Python::PyObjectPtr toPython(t const & solver) {
+            // Do the conversion
+            switch(solver){
+            case GMRES:
+                return Python::capi::enumToPyObject("AugmentedSystemSolver",
+                    "GMRES");
+            case MINRES:
+                return Python::capi::enumToPyObject("AugmentedSystemSolver",
+                    "MINRES");
+            case QR:
+                return Python::capi::enumToPyObject("AugmentedSystemSolver",
+                    "QR");
+            case LDLT:
+                return Python::capi::enumToPyObject("AugmentedSystemSolver",
+                    "LDLT");
+            case FGMRES:
+                return Python::capi::enumToPyObject("AugmentedSystemSolver",
+                    "FGMRES");
+            }
+        }
+
+        // Converts a Python enumerated type to t 
+        t fromPython(Python::PyObjectPtr const & member) {
+            // Convert the member to a Natural 
+            auto m=Python::capi::PyInt_AsNatural(member);
+
+            if(m==Python::capi::enumToNatural("AugmentedSystemSolver",
+                "GMRES")
+            )
+                return GMRES;
+            else if(m==Python::capi::enumToNatural("AugmentedSystemSolver",
+                "MINRES")
+            )
+                return MINRES;
+            else if(m==Python::capi::enumToNatural("AugmentedSystemSolver",
+                "QR")
+            )
+                return QR;
+            else if(m==Python::capi::enumToNatural("AugmentedSystemSolver",
+                "LDLT")
+            )
+                return LDLT;
+            else if(m==Python::capi::enumToNatural("AugmentedSystemSolver",
+                "FGMRES")
+            )
+                return FGMRES;
+            else
+                throw Optizelle::Exception::t( __LOC__
+                    + ", unknown AugmentedSystemSolver");
+        }
+    }
+
+    namespace InteriorPointScheme { 
+        // Converts t to a Python enumerated type
+        Python::PyObjectPtr toPython(t const & scheme) {
+            // Do the conversion
+            switch(scheme){
+            case FixedReduction:
+                return Python::capi::enumToPyObject("InteriorPointScheme",
+                    "FixedReduction");
+            case Mehrotra:
+                return Python::capi::enumToPyObject("InteriorPointScheme",
+                    "Mehrotra");
+            }
+        }
+
+        // Converts a Python enumerated type to t 
+        t fromPython(Python::PyObjectPtr const & member) {
+            // Convert the member to a Natural 
+            auto m=Python::capi::PyInt_AsNatural(member);
+
+            if(m==Python::capi::enumToNatural("InteriorPointScheme",
+                "FixedReduction")
+            )
+                return FixedReduction;
+            else if(m==Python::capi::enumToNatural("InteriorPointScheme",
+                "Mehrotra")
+            )
+                return Mehrotra;
+            else
+                throw Optizelle::Exception::t( __LOC__
+                    + ", unknown InteriorPointScheme");
+        }
+    }
+
+    namespace InteriorPointScaling { 
+        // Converts t to a Python enumerated type
+        Python::PyObjectPtr toPython(t const & scaling) {
+            // Do the conversion
+            switch(scaling){
+            case Unscaled:
+                return Python::capi::enumToPyObject("InteriorPointScaling",
+                    "Unscaled");
+            case NesterovTodd:
+                return Python::capi::enumToPyObject("InteriorPointScaling",
+                    "NesterovTodd");
+            }
+        }
+
+        // Converts a Python enumerated type to t 
+        t fromPython(Python::PyObjectPtr const & member) {
+            // Convert the member to a Natural 
+            auto m=Python::capi::PyInt_AsNatural(member);
+
+            if(m==Python::capi::enumToNatural("InteriorPointScaling",
+                "Unscaled")
+            )
+                return Unscaled;
+            else if(m==Python::capi::enumToNatural("InteriorPointScaling",
+                "NesterovTodd")
+            )
+                return NesterovTodd;
+            else
+                throw Optizelle::Exception::t( __LOC__
+                    + ", unknown InteriorPointScaling");
+        }
+    }
+
     namespace QuasinormalStop{ 
         // Converts t to a Python enumerated type
         Python::PyObjectPtr toPython(t const & qn_stop) {
@@ -1829,6 +2123,23 @@ namespace Optizelle {
                 capi::PyObject_SetAttrString(pystate,name.c_str(),items);
             }
 
+            // Sets a list of reals in a Python state 
+            void RealList(
+                std::string const & name,
+                std::list <double> const & values,
+                PyObjectPtr & pystate 
+            ) {
+                // Create a new Python list that we insert elements into
+                auto items = capi::PyList_New(0);
+
+                // Append each real to the list
+                for(auto const & value : values)
+                    capi::PyList_Append(items,capi::PyFloat_FromDouble(value));
+                
+                // Insert the items into pystate 
+                capi::PyObject_SetAttrString(pystate,name.c_str(),items);
+            }
+
             // Sets restart vectors in Python 
             void Vectors(
                 Python::Vectors const & values,
@@ -1966,6 +2277,26 @@ namespace Optizelle {
                     values.back().fromPython(item);
                 }
             }
+
+            // Sets a list of reals in a C++ state 
+            void RealList(
+                std::string const & name,
+                PyObjectPtr const & pystate,
+                std::list <double> & values
+            ) {
+                // Grab the list of items
+                auto items = capi::PyObject_GetAttrString(pystate,name.c_str());
+
+                // Loop over all the elements in items and insert them one
+                // at a time into values
+                values.clear();
+                for(auto i=Optizelle::Natural(0);
+                    i<capi::PyList_Size(items);
+                    i++
+                )
+                    values.emplace_back(
+                        capi::PyFloat_AsDouble(capi::PyList_GetItem(items,i)));
+            }
         
             // Sets a scalar-valued function in a C++ function bundle 
             void ScalarValuedFunction(
@@ -2174,6 +2505,7 @@ namespace Optizelle {
                     toPython::Vector("x_old",state.x_old,pystate);
                     toPython::Vector("grad_old",state.grad_old,pystate);
                     toPython::Vector("dx_old",state.dx_old,pystate);
+                    toPython::Vector("grad_xpdx",state.grad_xpdx,pystate);
                     toPython::VectorList("oldY",state.oldY,pystate);
                     toPython::VectorList("oldS",state.oldS,pystate);
                     toPython::Real("f_x",state.f_x,pystate);
@@ -2195,6 +2527,7 @@ namespace Optizelle {
                     toPython::Real("alpha0",state.alpha0,pystate);
                     toPython::Real("alpha",state.alpha,pystate);
                     toPython::Real("c1",state.c1,pystate);
+                    toPython::Real("c2",state.c2,pystate);
                     toPython::Natural("ls_iter",
                         state.ls_iter,pystate);
                     toPython::Natural("ls_iter_max",
@@ -2237,6 +2570,33 @@ namespace Optizelle {
                         ToleranceKind::toPython,
                         state.eps_kind,
                         pystate);
+                    toPython::Param <KrylovReuse::t> (
+                        "trunc_reuse",
+                        KrylovReuse::toPython,
+                        state.trunc_reuse,
+                        pystate);
+                    toPython::Param <TrustRegionSolver::t> (
+                        "trunc_solver",
+                        TrustRegionSolver::toPython,
+                        state.trunc_solver,
+                        pystate);
+                    toPython::Param <ForcingTerm::t> (
+                        "trunc_forcing",
+                        ForcingTerm::toPython,
+                        state.trunc_forcing,
+                        pystate);
+                    toPython::Real("norm_gradold",state.norm_gradold,pystate);
+                    toPython::Param <NonmonotoneKind::t> (
+                        "nonmono_kind",
+                        NonmonotoneKind::toPython,
+                        state.nonmono_kind,
+                        pystate);
+                    toPython::Natural("nonmono_mem",
+                        state.nonmono_mem,pystate);
+                    toPython::Real("nonmono_eta",state.nonmono_eta,pystate);
+                    toPython::Real("merit_ref",state.merit_ref,pystate);
+                    toPython::Real("merit_ref_q",state.merit_ref_q,pystate);
+                    toPython::RealList("merit_hist",state.merit_hist,pystate);
                 }
                 void toPython(
                     typename PyUnconstrained::State::t const & state,
@@ -2310,6 +2670,7 @@ namespace Optizelle {
                     fromPython::Vector("x_old",pystate,state.x_old);
                     fromPython::Vector("grad_old",pystate,state.grad_old);
                     fromPython::Vector("dx_old",pystate,state.dx_old);
+                    fromPython::Vector("grad_xpdx",pystate,state.grad_xpdx);
                     fromPython::VectorList("oldY",pystate,state.x,state.oldY);
                     fromPython::VectorList("oldS",pystate,state.x,state.oldS);
                     fromPython::Real("f_x",pystate,state.f_x);
@@ -2331,6 +2692,7 @@ namespace Optizelle {
                     fromPython::Real("alpha0",pystate,state.alpha0);
                     fromPython::Real("alpha",pystate,state.alpha);
                     fromPython::Real("c1",pystate,state.c1);
+                    fromPython::Real("c2",pystate,state.c2);
                     fromPython::Natural("ls_iter",
                         pystate,state.ls_iter);
                     fromPython::Natural("ls_iter_max",
@@ -2373,6 +2735,33 @@ namespace Optizelle {
                         ToleranceKind::fromPython,
                         pystate,
                         state.eps_kind);
+                    fromPython::Param <KrylovReuse::t> (
+                        "trunc_reuse",
+                        KrylovReuse::fromPython,
+                        pystate,
+                        state.trunc_reuse);
+                    fromPython::Param <TrustRegionSolver::t> (
+                        "trunc_solver",
+                        TrustRegionSolver::fromPython,
+                        pystate,
+                        state.trunc_solver);
+                    fromPython::Param <ForcingTerm::t> (
+                        "trunc_forcing",
+                        ForcingTerm::fromPython,
+                        pystate,
+                        state.trunc_forcing);
+                    fromPython::Real("norm_gradold",pystate,state.norm_gradold);
+                    fromPython::Param <NonmonotoneKind::t> (
+                        "nonmono_kind",
+                        NonmonotoneKind::fromPython,
+                        pystate,
+                        state.nonmono_kind);
+                    fromPython::Natural("nonmono_mem",
+                        pystate,state.nonmono_mem);
+                    fromPython::Real("nonmono_eta",pystate,state.nonmono_eta);
+                    fromPython::Real("merit_ref",pystate,state.merit_ref);
+                    fromPython::Real("merit_ref_q",pystate,state.merit_ref_q);
+                    fromPython::RealList("merit_hist",pystate,state.merit_hist);
                 }
                 void fromPython(
                     Python::State <PyUnconstrained> const & pystate,
@@ -2709,10 +3098,21 @@ namespace Optizelle {
                         Operators::toPython,
                         state.PSchur_right_type,
                         pystate);
+                    toPython::Param <AugmentedSystemSolver::t> (
+                        "augsys_solver",
+                        AugmentedSystemSolver::toPython,
+                        state.augsys_solver,
+                        pystate);
                     toPython::Natural("augsys_iter_max",
                         state.augsys_iter_max,pystate);
                     toPython::Natural("augsys_rst_freq",
                         state.augsys_rst_freq,pystate);
+                    toPython::Natural("augsys_recycle",
+                        state.augsys_recycle,pystate);
+                    toPython::Natural("augsys_proj_cache",
+                        state.augsys_proj_cache,pystate);
+                    toPython::Natural("augsys_broyden",
+                        state.augsys_broyden,pystate);
                     toPython::Natural("augsys_qn_iter",
                         state.augsys_qn_iter,pystate);
                     toPython::Natural("augsys_pg_iter",
@@ -2840,10 +3240,21 @@ namespace Optizelle {
                         Operators::fromPython,
                         pystate,
                         state.PSchur_right_type);
+                    fromPython::Param <AugmentedSystemSolver::t> (
+                        "augsys_solver",
+                        AugmentedSystemSolver::fromPython,
+                        pystate,
+                        state.augsys_solver);
                     fromPython::Natural("augsys_iter_max",
                         pystate,state.augsys_iter_max);
                     fromPython::Natural("augsys_rst_freq",
                         pystate,state.augsys_rst_freq);
+                    fromPython::Natural("augsys_recycle",
+                        pystate,state.augsys_recycle);
+                    fromPython::Natural("augsys_proj_cache",
+                        pystate,state.augsys_proj_cache);
+                    fromPython::Natural("augsys_broyden",
+                        pystate,state.augsys_broyden);
                     fromPython::Natural("augsys_qn_iter",
                         pystate,state.augsys_qn_iter);
                     fromPython::Natural("augsys_pg_iter",
@@ -3273,6 +3684,7 @@ namespace Optizelle {
                     toPython::Vector("z",state.z,pystate);
                     toPython::Vector("dz",state.dz,pystate);
                     toPython::Vector("h_x",state.h_x,pystate);
+                    toPython::Vector("comp_target",state.comp_target,pystate);
                     toPython::Real("mu",state.mu,pystate);
                     toPython::Real("mu_est",state.mu_est,pystate);
                     toPython::Real("mu_typ",state.mu_typ,pystate);
@@ -3280,6 +3692,16 @@ namespace Optizelle {
                     toPython::Real("sigma",state.sigma,pystate);
                     toPython::Real("gamma",state.gamma,pystate);
                     toPython::Real("alpha_z",state.alpha_z,pystate);
+                    toPython::Param <InteriorPointScheme::t> (
+                        "ip_scheme",
+                        InteriorPointScheme::toPython,
+                        state.ip_scheme,
+                        pystate);
+                    toPython::Param <InteriorPointScaling::t> (
+                        "ip_scaling",
+                        InteriorPointScaling::toPython,
+                        state.ip_scaling,
+                        pystate);
                     toPython::Param <FunctionDiagnostics::t> (
                         "h_diag",
                         FunctionDiagnostics::toPython,
@@ -3307,6 +3729,8 @@ namespace Optizelle {
                     fromPython::Vector("z",pystate,state.z);
                     fromPython::Vector("dz",pystate,state.dz);
                     fromPython::Vector("h_x",pystate,state.h_x);
+                    fromPython::Vector("comp_target",pystate,
+                        state.comp_target);
                     fromPython::Real("mu",pystate,state.mu);
                     fromPython::Real("mu_est",pystate,state.mu_est);
                     fromPython::Real("mu_typ",pystate,state.mu_typ);
@@ -3314,6 +3738,16 @@ namespace Optizelle {
                     fromPython::Real("sigma",pystate,state.sigma);
                     fromPython::Real("gamma",pystate,state.gamma);
                     fromPython::Real("alpha_z",pystate,state.alpha_z);
+                    fromPython::Param <InteriorPointScheme::t> (
+                        "ip_scheme",
+                        InteriorPointScheme::fromPython,
+                        pystate,
+                        state.ip_scheme);
+                    fromPython::Param <InteriorPointScaling::t> (
+                        "ip_scaling",
+                        InteriorPointScaling::fromPython,
+                        pystate,
+                        state.ip_scaling);
                     fromPython::Param <FunctionDiagnostics::t> (
                         "h_diag",
                         FunctionDiagnostics::fromPython,
@@ -714,6 +714,13 @@ namespace Optizelle {
                 std::list <Python::Vector> const & values,
                 PyObjectPtr & state 
             );
+
+            // Sets a list of reals in a Python state 
+            void RealList(
+                std::string const & name,
+                std::list <double> const & values,
+                PyObjectPtr & state 
+            );
         
             // Sets restart vectors in Python 
             void Vectors(
@@ -782,6 +789,13 @@ namespace Optizelle {
                 Python::Vector const & vec,
                 std::list <Python::Vector> & values
             );
+
+            // Sets a list of reals in a C++ state 
+            void RealList(
+                std::string const & name,
+                PyObjectPtr const & pystate,
+                std::list <double> & values
+            );
             
             // Sets a scalar-valued function in a C++ function bundle 
             void ScalarValuedFunction(
@@ -71,6 +71,37 @@ struct Unit {
                 X::copy(dx,H_dx);
             }
         };
+
+        // Rosenbrock function shifted so that its minimum lies at (p,p^2)
+        //
+        // f(x,y)=(p-x)^2+100(y-x^2)^2
+        //
+        struct Rosenbrock : public Optizelle::ScalarValuedFunction <Real,XX> {
+            // Location of the minimum
+            Real p;
+
+            Rosenbrock(Real const & p_ = Real(1.)) : p(p_) {}
+
+            Real eval(X_Vector const & x) const {
+                return sq(p-x[0])+Real(100.)*sq(x[1]-sq(x[0]));
+            }
+            void grad(
+                X_Vector const & x,
+                X_Vector & grad
+            ) const {
+                grad[0]=Real(-400.)*x[0]*(x[1]-sq(x[0]))-Real(2.)*(p-x[0]);
+                grad[1]=Real(200.)*(x[1]-sq(x[0]));
+            }
+            void hessvec(
+                X_Vector const & x,
+                X_Vector const & dx,
+                X_Vector & H_dx
+            ) const {
+                H_dx[0]=(Real(1200.)*sq(x[0])-Real(400.)*x[1]+Real(2.))*dx[0]
+                    -Real(400.)*x[0]*dx[1];
+                H_dx[1]=Real(-400.)*x[0]*dx[0]+Real(200.)*dx[1];
+            }
+        };
     };
 
     // Various constraints
@@ -118,6 +149,43 @@ struct Unit {
             }
         };
         
+        // Define the same linear constraint with a sparse Jacobian
+        //
+        // g(x,y)= [ x + y = 1 ] 
+        //
+        struct SparseLinear
+            : public Optizelle::SparseVectorValuedFunction<Real,YY>
+        {
+            // y=g(x) 
+            void eval(
+                X_Vector const & x,
+                Y_Vector & y
+            ) const {
+                y[0] = x[0] + x[1] - Real(1.); 
+            }
+
+            // J=g'(x)
+            void jacobian(
+                X_Vector const & x,
+                Optizelle::CSRMatrix <Real> & J
+            ) const {
+                J = Optizelle::CSRMatrix <Real> (1,2);
+                J.offsets = {0,2};
+                J.cols = {0,1};
+                J.vals = {Real(1.),Real(1.)};
+            }
+
+            // x_hat=(g''(x)dx)*dy
+            void pps(
+                X_Vector const & x,
+                X_Vector const & dx,
+                Y_Vector const & dy,
+                X_Vector & x_hat 
+            ) const {
+                X::zero(x_hat);
+            }
+        };
+        
         // Define a quadratic constraint
         //
         // g(x,y)= [ a x^2 + b y^2 = 1 ] 
@@ -417,6 +485,9 @@ struct Unit {
 
         // Check that we exited the augmented system solve early
         bool check_augsys_exit;
+
+        // Solver for the augmented system
+        Optizelle::AugmentedSystemSolver::t augsys_solver;
         
         // Setup some simple parameters
         Augsys(X_Vector const & x_,Y_Vector const & y_) :
@@ -430,7 +501,8 @@ struct Unit {
             delta(1e16),
             do_diagnostics(false),
             check_augsys(false),
-            check_augsys_exit(false)
+            check_augsys_exit(false),
+            augsys_solver(Optizelle::AugmentedSystemSolver::GMRES)
         {
             X::copy(x_,x); 
             Y::copy(y_,y);
@@ -526,6 +598,7 @@ struct Unit {
 
         // Set some appropriate state information
         state.delta = setup.delta;
+        state.augsys_solver = setup.augsys_solver;
 
         // Create a bundle of functions
         typename Optizelle::Constrained <Real,XX,YY,ZZ>::Functions::t fns;
@@ -696,6 +769,7 @@ struct Unit {
         // Create an optimization state
         typename Optizelle::EqualityConstrained <Real,XX,YY>::State::t
             state(setup.x,setup.y);
+        state.augsys_solver = setup.augsys_solver;
 
         // Create a bundle of functions
         typename Optizelle::Constrained <Real,XX,YY,ZZ>::Functions::t fns;
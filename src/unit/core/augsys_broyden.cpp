@@ -0,0 +1,91 @@
+// Solve an equality constrained problem with a Broyden approximation of
+// g'(x) in the augmented system solves and check that we find the same
+// solution with fewer applications of g'(x) and g'(x)*
+
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "augsys.h"
+#include "spaces.h"
+
+// Set some type shortcuts
+typedef Optizelle::EqualityConstrained <Real,XX,YY> EqualityConstrained;
+typedef Optizelle::Natural Natural;
+
+// Ellipse constraint that counts how often we apply its Jacobian or adjoint
+struct CountedQuadratic : public Unit <Real>::Constraint::Quadratic {
+    mutable Natural count;
+
+    CountedQuadratic() :
+        Unit <Real>::Constraint::Quadratic(1.,4.),
+        count(0)
+    {}
+
+    void p(
+        X_Vector const & x,
+        X_Vector const & dx,
+        X_Vector & y
+    ) const {
+        count++;
+        Unit <Real>::Constraint::Quadratic::p(x,dx,y);
+    }
+
+    void ps(
+        X_Vector const & x,
+        X_Vector const & dy,
+        X_Vector & x_hat
+    ) const {
+        count++;
+        Unit <Real>::Constraint::Quadratic::ps(x,dy,x_hat);
+    }
+};
+
+// Finds the point on the ellipse x^2 + 4 y^2 = 1 closest to the origin and
+// returns the solution along with the number of applications of g'(x) and
+// g'(x)*
+std::pair <X_Vector,Natural> solve(Natural const & augsys_broyden) {
+    // Generate an initial guess
+    auto x = std::vector <Real> { 1., 1.};
+    auto y = std::vector <Real> { 0. };
+
+    // Create an optimization state and a bundle of functions
+    EqualityConstrained::State::t state(x,y);
+    state.augsys_broyden = augsys_broyden;
+    EqualityConstrained::Functions::t fns;
+    fns.f.reset(new Unit <Real>::Objective::Quadratic);
+    auto g = new CountedQuadratic;
+    fns.g.reset(g);
+
+    // Solve the problem
+    EqualityConstrained::Algorithms::getMin(
+        Optizelle::Messaging::stdout,fns,state);
+
+    // Check that we converged to the solution
+    auto x_star = std::vector <Real> { 0., 0.5 };
+    auto norm_r = Real(0.);
+    auto norm_star = Real(0.);
+    std::tie(norm_r,norm_star)=Unit <Real>::error(state.x,x_star);
+    CHECK(state.opt_stop == Optizelle::OptimizationStop::GradientSmall);
+    CHECK(norm_r <= Real(1e-8)*norm_star);
+
+    // Return the solution and the number of applications
+    return std::pair <X_Vector,Natural> (state.x,g->count);
+}
+
+int main(int argc,char* argv[]){
+    // Solve the problem with g'(x) and then with the approximation
+    auto exact = solve(0);
+    auto broyden = solve(5);
+
+    // Make sure that we find the same solution, but apply g'(x) and g'(x)*
+    // less often
+    auto norm_r = Real(0.);
+    auto norm_star = Real(0.);
+    std::tie(norm_r,norm_star)=Unit <Real>::error(broyden.first,exact.first);
+    CHECK(norm_r <= Real(1e-8)*norm_star);
+    std::cout << "Applications of g'(x) and g'(x)*: " << exact.second
+        << " exact, " << broyden.second << " Broyden" << std::endl;
+    CHECK(broyden.second < exact.second);
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,232 @@
+// Check the kernels for simple bounds on Rm, check that we fall back to the
+// scaled Cauchy point when truncation ruins a step, and then solve a large,
+// bound constrained quadratic where many of the bounds are active at the
+// solution
+
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "unit.h"
+
+// Set some type shortcuts
+typedef double Real;
+typedef Optizelle::Rm <Real> X;
+typedef typename X::Vector X_Vector;
+typedef Optizelle::Bounds <Real,Optizelle::Rm> B;
+typedef Optizelle::Natural Natural;
+
+// Define a quadratic that pulls each variable toward a target outside of the
+// bounds while coupling neighboring variables
+//
+// f(x) = 1/2 sum_i (x_i - t_i)^2 + beta/2 sum_i (x_{i+1} - x_i)^2
+//
+struct CoupledQuadratic
+    : public Optizelle::ScalarValuedFunction <Real,Optizelle::Rm>
+{
+    X_Vector t;
+    Real beta;
+
+    CoupledQuadratic(X_Vector const & t_,Real const & beta_)
+        : t(t_), beta(beta_) {}
+
+    Real eval(X_Vector const & x) const {
+        auto f = Real(0.);
+        for(Natural i=0;i<x.size();i++) {
+            f += Real(0.5)*(x[i]-t[i])*(x[i]-t[i]);
+            if(i+1<x.size())
+                f += Real(0.5)*beta*(x[i+1]-x[i])*(x[i+1]-x[i]);
+        }
+        return f;
+    }
+
+    void grad(X_Vector const & x,X_Vector & grad) const {
+        for(Natural i=0;i<x.size();i++)
+            grad[i]=x[i]-t[i];
+        hessvec_coupling(x,grad);
+    }
+
+    void hessvec(
+        X_Vector const & x,
+        X_Vector const & dx,
+        X_Vector & H_dx
+    ) const {
+        X::copy(dx,H_dx);
+        hessvec_coupling(dx,H_dx);
+    }
+
+private:
+    // y <- y + beta L x where L is the 1-D Laplacian
+    void hessvec_coupling(X_Vector const & x,X_Vector & y) const {
+        for(Natural i=0;i+1<x.size();i++) {
+            y[i] -= beta*(x[i+1]-x[i]);
+            y[i+1] += beta*(x[i+1]-x[i]);
+        }
+    }
+};
+
+// Replaces the first trial step with one that overshoots the bounds and,
+// once truncated, increases the model.  Then, record the predicted reduction
+// of the step that we actually take.
+struct Overshoot : public Optizelle::StateManipulator <
+    Optizelle::BoundConstrained <Real,Optizelle::Rm> >
+{
+    X_Vector dx;
+    mutable Real pred;
+    mutable bool first;
+
+    explicit Overshoot(X_Vector const & dx_) :
+        dx(dx_),
+        pred(std::numeric_limits <Real>::quiet_NaN()),
+        first(true)
+    {}
+
+    void eval(
+        Optizelle::BoundConstrained <Real,Optizelle::Rm>::Functions::t const &,
+        Optizelle::BoundConstrained <Real,Optizelle::Rm>::State::t & state,
+        Optizelle::OptimizationLocation::t const & loc
+    ) const {
+        if(!first) return;
+        if(loc==Optizelle::OptimizationLocation::BeforeActualVersusPredicted)
+            X::copy(dx,state.dx);
+        else if(
+            loc==Optizelle::OptimizationLocation::AfterRejectedTrustRegion ||
+            loc==Optizelle::OptimizationLocation::AfterStepBeforeGradient
+        ) {
+            pred = state.pred;
+            first = false;
+        }
+    }
+};
+
+int main(int argc,char* argv[]){
+    // Set up some bounds with infinite elements
+    auto const inf = std::numeric_limits <Real>::infinity();
+    auto x_lo = X_Vector {-inf, 0., -1., -inf, 2.};
+    auto x_hi = X_Vector {inf, inf, 1., 0., 2.5};
+    CHECK(B::valid(x_lo,x_hi));
+    CHECK(!B::valid(x_hi,x_lo));
+
+    // Pushing into the interior leaves points strictly inside the bounds
+    auto x = X_Vector {5., -3., 0.999, 1., 2.};
+    B::proj(x_lo,x_hi,Real(1e-2),x);
+    CHECK(x[0] == Real(5.));
+    CHECK(x[1] == Real(1e-2));
+    CHECK(x[2] == Real(1.-1e-2));
+    CHECK(x[3] == Real(-1e-2));
+    CHECK(x[4] > Real(2.) && x[4] < Real(2.5));
+
+    // The projected gradient ignores the parts of the gradient that push
+    // against an active bound
+    auto xb = X_Vector {1., 0., 1., 0., 2.};
+    auto grad = X_Vector {2., 3., -4., -1., -5.};
+    auto pg = X::init(xb);
+    B::pgrad(x_lo,x_hi,xb,grad,pg);
+    CHECK(pg[0] == Real(2.));
+    CHECK(pg[1] == Real(0.));
+    CHECK(pg[2] == Real(0.));
+    CHECK(pg[3] == Real(0.));
+    CHECK(pg[4] == Real(-0.5));
+
+    // The scaling measures the distance to the bound that -grad points
+    // toward and infinite bounds do not scale the problem
+    auto c = X::init(x);
+    auto d = X::init(x);
+    auto g = X_Vector {1., 2., -1., 1., -2.};
+    B::scaling(x_lo,x_hi,x,g,c,d);
+    CHECK(c[0] == Real(0.) && d[0] == Real(1.));
+    CHECK(std::fabs(c[1]-Real(2.)/Real(1e-2)) <= Real(1e-8));
+    CHECK(std::fabs(d[1]-Real(0.1)) <= Real(1e-12));
+    CHECK(std::fabs(c[2]-Real(1.)/Real(1e-2)) <= Real(1e-8));
+    CHECK(c[3] == Real(0.) && d[3] == Real(1.));
+
+    // The search finds the first bound that we cross
+    auto dx = X_Vector {-100., -1., 0., 0., 0.};
+    CHECK(std::fabs(B::srch(x_lo,x_hi,x,dx,Real(1.))-Real(1e-2))
+        <= Real(1e-14));
+    dx = X_Vector {1., 1., 0., 1., 0.};
+    CHECK(std::fabs(B::srch(x_lo,x_hi,x,dx,Real(0.5))-Real(0.5e-2))
+        <= Real(1e-14));
+    dx = X_Vector {-1., 1., 0., -1., 0.};
+    CHECK(B::srch(x_lo,x_hi,x,dx,Real(1.)) == inf);
+
+    // Truncation only shortens the elements that cross a bound
+    dx = X_Vector {-100., -1., 1., 1., 1.};
+    B::trunc(x_lo,x_hi,x,Real(0.5),dx);
+    CHECK(dx[0] == Real(-100.));
+    CHECK(std::fabs(dx[1]+Real(0.5e-2)) <= Real(1e-14));
+    CHECK(std::fabs(dx[2]-Real(0.5e-2)) <= Real(1e-14));
+    CHECK(std::fabs(dx[3]-Real(0.5e-2)) <= Real(1e-14));
+    CHECK(dx[4] > Real(0.) && x[4]+dx[4] < Real(2.5));
+
+    // When truncation ruins a step, we take the scaled Cauchy point instead,
+    // which decreases the model
+    {
+        Optizelle::BoundConstrained <Real,Optizelle::Rm>::State::t state(
+            X_Vector {1.,0.},X_Vector {0.,-inf},X_Vector {inf,inf});
+        state.H_type = Optizelle::Operators::UserDefined;
+        state.iter_max = 1;
+        Optizelle::BoundConstrained <Real,Optizelle::Rm>::Functions::t fns;
+        fns.f.reset(new CoupledQuadratic(X_Vector {-10.,0.},Real(0.)));
+        Overshoot smanip(X_Vector {-100.,5.});
+        Optizelle::BoundConstrained <Real,Optizelle::Rm>::Algorithms::getMin(
+            Optizelle::Messaging::stdout,fns,state,smanip);
+        CHECK(smanip.pred > Real(0.));
+    }
+
+    // Now, solve a large problem.  Every fourth variable is free and the
+    // rest lie between -1 and 1 while the targets jump between -3, 1/2, and
+    // 3 on blocks of ten variables.  This keeps the gradient bounded away
+    // from zero on the active bounds.
+    auto const n = Natural(100000);
+    auto t = X_Vector(n);
+    auto x0 = X_Vector(n,Real(0.));
+    auto lo = X_Vector(n,Real(-1.));
+    auto hi = X_Vector(n,Real(1.));
+    for(Natural i=0;i<n;i++) {
+        t[i] = (i/10)%3==0 ? Real(3.) : (i/10)%3==1 ? Real(-3.) : Real(0.5);
+        if(i%4==0) {
+            lo[i] = -inf;
+            hi[i] = inf;
+        }
+    }
+
+    // Set up the optimization
+    Optizelle::BoundConstrained <Real,Optizelle::Rm>::State::t state(
+        x0,lo,hi);
+    state.H_type = Optizelle::Operators::UserDefined;
+    state.eps_grad = Real(1e-5);
+    state.eps_dx = Real(1e-16);
+    state.eps_trunc = Real(1e-12);
+    state.iter_max = 100;
+    state.trunc_iter_max = 100;
+    Optizelle::BoundConstrained <Real,Optizelle::Rm>::Functions::t fns;
+    fns.f.reset(new CoupledQuadratic(t,Real(0.5)));
+
+    // Solve the problem
+    Optizelle::BoundConstrained <Real,Optizelle::Rm>::Algorithms::getMin(
+        Optizelle::Messaging::stdout,fns,state);
+
+    // Make sure we converged and stayed inside the bounds
+    CHECK(state.opt_stop == Optizelle::OptimizationStop::GradientSmall);
+    auto inside = true;
+    for(Natural i=0;i<n;i++)
+        inside = inside && lo[i] <= state.x[i] && state.x[i] <= hi[i];
+    CHECK(inside);
+
+    // Check that many of the bounds are nearly active
+    auto active = Natural(0);
+    for(Natural i=0;i<n;i++)
+        if(hi[i]-state.x[i] < Real(1e-6) || state.x[i]-lo[i] < Real(1e-6))
+            active++;
+    CHECK(active > n/4);
+
+    // Check the first-order optimality conditions with the projected
+    // gradient
+    auto grad_x = X::init(state.x);
+    fns.f->grad(state.x,grad_x);
+    auto pg_x = X::init(state.x);
+    B::pgrad(lo,hi,state.x,grad_x,pg_x);
+    CHECK(std::sqrt(X::innr(pg_x,pg_x)) < state.eps_grad);
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,111 @@
+// Check that the fused interior point kernels match the compositions of the
+// Jordan algebra operations that they replace on each kind of cone
+
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "unit.h"
+
+// Set some type shortcuts
+typedef double Real;
+typedef Optizelle::Natural Natural;
+
+// Finds || x - y || / || y ||
+template <template <typename> class ZZ>
+Real rel_err(
+    typename ZZ <Real>::Vector const & x,
+    typename ZZ <Real>::Vector const & y
+) {
+    typedef ZZ <Real> Z;
+    auto diff = Z::init(x);
+    Z::copy(x,diff);
+    Z::axpy(Real(-1.),y,diff);
+    return std::sqrt(Z::innr(diff,diff) / Z::innr(y,y));
+}
+
+// Compares the fused kernels against the composed operations at the point
+// x with the multiplier z and direction dz
+template <template <typename> class ZZ>
+void check_fused(
+    typename ZZ <Real>::Vector const & x,
+    typename ZZ <Real>::Vector const & z,
+    typename ZZ <Real>::Vector const & dz
+) {
+    typedef ZZ <Real> Z;
+    typedef Optizelle::InteriorPointFused <Real,ZZ> IP;
+    auto const mu = Real(0.3);
+
+    // inv(L(x)) e
+    auto e = Z::init(x);
+    Z::id(e);
+    auto linv_e = Z::init(x);
+    Z::linv(x,e,linv_e);
+    auto y = Z::init(x);
+    IP::linv_id(x,y);
+    CHECK(rel_err <ZZ> (y,linv_e) <= Real(1e-12));
+
+    // inv(L(x)) (dz o z)
+    auto dz_z = Z::init(x);
+    Z::prod(dz,z,dz_z);
+    auto linv_dz_z = Z::init(x);
+    Z::linv(x,dz_z,linv_dz_z);
+    IP::linv_prod(x,dz,z,y);
+    CHECK(rel_err <ZZ> (y,linv_dz_z) <= Real(1e-12));
+
+    // The same, but we overwrite the direction
+    Z::copy(dz,y);
+    IP::linv_prod(x,y,z,y);
+    CHECK(rel_err <ZZ> (y,linv_dz_z) <= Real(1e-12));
+
+    // dz + mu inv(L(x)) e - z
+    auto shift = Z::init(x);
+    Z::copy(linv_e,shift);
+    Z::scal(mu,shift);
+    Z::axpy(Real(-1.),z,shift);
+    Z::axpy(Real(1.),dz,shift);
+    Z::copy(dz,y);
+    IP::linv_id_shift(x,mu,z,y);
+    CHECK(rel_err <ZZ> (y,shift) <= Real(1e-12));
+}
+
+int main(int argc,char* argv[]){
+    // Check the nonnegative orthant
+    {
+        auto x = std::vector <Real> {2.,0.5,3.,1e-3};
+        auto z = std::vector <Real> {0.1,4.,1.,2.};
+        auto dz = std::vector <Real> {1.,-1.,0.5,2.};
+        check_fused <Optizelle::Rm> (x,z,dz);
+    }
+
+    // Check a mix of cones
+    {
+        typedef Optizelle::SQL <Real> Z;
+        typedef typename Z::Vector Z_Vector;
+        auto x = Z_Vector(
+            {Optizelle::Cone::Linear,
+             Optizelle::Cone::Quadratic,
+             Optizelle::Cone::Semidefinite,
+             Optizelle::Cone::Quadratic},
+            {2,3,3,4});
+        auto z = Z::init(x);
+        auto dz = Z::init(x);
+        x.data = {
+            2.,0.5,
+            3.,1.,-2.,
+            4.,1.,0.5, 1.,3.,-1., 0.5,-1.,2.,
+            5.,1.,2.,-3.};
+        z.data = {
+            0.1,4.,
+            1.,0.25,0.5,
+            1.,-0.5,0., -0.5,2.,0.25, 0.,0.25,0.5,
+            2.,0.5,-0.5,1.};
+        dz.data = {
+            1.,-1.,
+            0.5,2.,-1.,
+            1.,2.,3., 2.,-1.,0., 3.,0.,1.,
+            -1.,0.5,0.25,2.};
+        check_fused <Optizelle::SQL> (x,z,dz);
+    }
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
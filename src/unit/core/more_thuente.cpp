@@ -0,0 +1,109 @@
+// Check that the strong-Wolfe line-search hands the gradient at the accepted
+// step back to the main loop, so that we evaluate the gradient exactly once
+// per trial step, and that this gradient matches the one at the new iterate
+
+#include "augsys.h"
+
+// Set some type shortcuts
+typedef double Real;
+typedef Unit <Real>::X X;
+typedef Unit <Real>::X_Vector X_Vector;
+typedef Unit <Real>::Natural Natural;
+typedef Optizelle::Unconstrained <Real,Unit <Real>::XX> UP;
+typedef Optizelle::InequalityConstrained <Real,Unit <Real>::XX,Unit <Real>::ZZ>
+    IP;
+
+// Rosenbrock's function that counts the number of gradient evaluations
+struct Counted : public Unit <Real>::Objective::Rosenbrock {
+    mutable Natural grads;
+    Counted() : grads(0) {}
+    void grad(X_Vector const & x,X_Vector & grad) const {
+        grads++;
+        Unit <Real>::Objective::Rosenbrock::grad(x,grad);
+    }
+};
+
+// Checks that the gradient in the state matches the one at the iterate
+template <typename ProblemClass>
+struct GradientCheck : public Optizelle::StateManipulator <ProblemClass> {
+    // Number of iterations that we checked
+    mutable Natural checked;
+
+    GradientCheck() : checked(0) {}
+
+    void eval(
+        typename ProblemClass::Functions::t const & fns,
+        typename ProblemClass::State::t & state,
+        Optizelle::OptimizationLocation::t const & loc
+    ) const {
+        if(loc!=Optizelle::OptimizationLocation::AfterGradient) return;
+        auto grad = X::init(state.x);
+        Unit <Real>::Objective::Rosenbrock().grad(state.x,grad);
+        auto norm_grad = std::sqrt(X::innr(grad,grad));
+        X::axpy(Real(-1.),state.grad,grad);
+        CHECK(std::sqrt(X::innr(grad,grad)) <= Real(1e-12)*(norm_grad+1.));
+        checked++;
+    }
+};
+
+int main(int argc,char* argv[]){
+    // Minimize Rosenbrock's function with BFGS
+    {
+        UP::State::t state(X_Vector {-1.2,1.});
+        state.algorithm_class = Optizelle::AlgorithmClass::LineSearch;
+        state.kind = Optizelle::LineSearchKind::MoreThuente;
+        state.dir = Optizelle::LineSearchDirection::BFGS;
+        state.stored_history = 10;
+        state.eps_grad = Real(1e-10);
+        state.iter_max = 200;
+
+        UP::Functions::t fns;
+        auto f = new Counted;
+        fns.f.reset(f);
+
+        GradientCheck <UP> smanip;
+        UP::Algorithms::getMin(
+            Optizelle::Messaging::stdout,fns,state,smanip);
+
+        // Make sure we found the solution
+        CHECK(state.opt_stop == Optizelle::OptimizationStop::GradientSmall);
+        CHECK(std::fabs(state.x[0]-Real(1.)) < Real(1e-6));
+        CHECK(std::fabs(state.x[1]-Real(1.)) < Real(1e-6));
+
+        // Besides the initial gradient, we only evaluate the gradient at
+        // the trial steps
+        CHECK(smanip.checked > 0);
+        CHECK(f->grads == state.ls_iter_total+1);
+    }
+
+    // Minimize Rosenbrock's function over the box [-2,0.5]x[-2,2], which
+    // modifies the gradient used in the line-search with the barrier
+    {
+        IP::State::t state(X_Vector {-1.2,1.},X_Vector(4));
+        state.algorithm_class = Optizelle::AlgorithmClass::LineSearch;
+        state.kind = Optizelle::LineSearchKind::MoreThuente;
+        state.dir = Optizelle::LineSearchDirection::NewtonCG;
+        state.H_type = Optizelle::Operators::UserDefined;
+        state.eps_grad = Real(1e-8);
+        state.eps_mu = Real(1e-8);
+        state.iter_max = 300;
+
+        IP::Functions::t fns;
+        auto f = new Counted;
+        fns.f.reset(f);
+        fns.h.reset(new Unit <Real>::Constraint::Box(
+            X_Vector {-2.,-2.},X_Vector {0.5,2.}));
+
+        GradientCheck <IP> smanip;
+        IP::Algorithms::getMin(
+            Optizelle::Messaging::stdout,fns,state,smanip);
+
+        // Make sure we converged and checked the gradients along the way
+        CHECK(state.opt_stop == Optizelle::OptimizationStop::GradientSmall);
+        CHECK(smanip.checked > 0);
+        CHECK(f->grads == state.ls_iter_total+1);
+    }
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
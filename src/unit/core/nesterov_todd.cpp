@@ -0,0 +1,118 @@
+// Check that the Nesterov-Todd scaling point maps x to z, that the
+// resulting scaling is symmetric on each kind of cone, and that we reject
+// points outside of the semidefinite cone
+
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "unit.h"
+
+// Set some type shortcuts
+typedef double Real;
+typedef Optizelle::SQL <Real> Z;
+typedef typename Z::Vector Z_Vector;
+typedef Optizelle::NesterovTodd <Real,Optizelle::SQL> NT;
+typedef Optizelle::Natural Natural;
+
+// Finds || x - y || / || y ||
+Real rel_err(Z_Vector const & x,Z_Vector const & y) {
+    auto diff = Z::init(x);
+    Z::copy(x,diff);
+    Z::axpy(Real(-1.),y,diff);
+    return std::sqrt(Z::innr(diff,diff) / Z::innr(y,y));
+}
+
+int main(int argc,char* argv[]){
+    // Create two points in the interior of a mix of cones
+    auto x = Z_Vector(
+        {Optizelle::Cone::Linear,
+         Optizelle::Cone::Quadratic,
+         Optizelle::Cone::Semidefinite},
+        {2,3,3});
+    auto z = Z::init(x);
+    x.data = {
+        2.,0.5,
+        3.,1.,-2.,
+        4.,1.,0.5, 1.,3.,-1., 0.5,-1.,2.};
+    z.data = {
+        0.1,4.,
+        1.,0.25,0.5,
+        1.,-0.5,0., -0.5,2.,0.25, 0.,0.25,0.5};
+
+    // Find the scaling point
+    auto w = Z::init(x);
+    NT::point(x,z,w);
+
+    // The scaling point must be in the interior of the cone, so we can move
+    // past it when searching from e toward w
+    auto e = Z::init(x);
+    Z::id(e);
+    auto w_m_e = Z::init(x);
+    Z::copy(w,w_m_e);
+    Z::axpy(Real(-1.),e,w_m_e);
+    CHECK(Z::srch(w_m_e,e) > Real(1.));
+
+    // P(w) x = z
+    auto Pw_x = Z::init(x);
+    NT::quad(w,x,Pw_x);
+    CHECK(rel_err(Pw_x,z) <= Real(1e-12));
+
+    // <P(w) u,v> = <u,P(w) v> for symmetric directions
+    auto u = Z::init(x);
+    auto v = Z::init(x);
+    u.data = {
+        1.,-1.,
+        0.5,2.,-1.,
+        1.,2.,3., 2.,-1.,0., 3.,0.,1.};
+    v.data = {
+        -2.,3.,
+        1.,1.,0.25,
+        0.,1.,-1., 1.,2.,0.5, -1.,0.5,-3.};
+    auto Pw_u = Z::init(x);
+    auto Pw_v = Z::init(x);
+    NT::quad(w,u,Pw_u);
+    NT::quad(w,v,Pw_v);
+    CHECK(std::fabs(Z::innr(Pw_u,v)-Z::innr(u,Pw_v))
+        <= Real(1e-12)*std::fabs(Z::innr(Pw_u,v)));
+
+    // P(w) is positive definite
+    CHECK(Z::innr(Pw_u,u) > Real(0.));
+    CHECK(Z::innr(Pw_v,v) > Real(0.));
+
+    // Check the same thing on the nonnegative orthant
+    typedef Optizelle::NesterovTodd <Real,Optizelle::Rm> NT_Rm;
+    auto x_rm = std::vector <Real> {1.,0.25,9.};
+    auto z_rm = std::vector <Real> {4.,1.,1.};
+    auto w_rm = std::vector <Real> (3);
+    NT_Rm::point(x_rm,z_rm,w_rm);
+    auto Pw_x_rm = std::vector <Real> (3);
+    NT_Rm::quad(w_rm,x_rm,Pw_x_rm);
+    for(Natural i=0;i<3;i++) {
+        CHECK(std::fabs(Pw_x_rm[i]-z_rm[i]) <= Real(1e-14));
+        CHECK(w_rm[i] > Real(0.));
+    }
+
+    // On a semidefinite block, we can't find the scaling point unless both
+    // x and z are strictly feasible
+    auto x_sdp = Z_Vector({Optizelle::Cone::Semidefinite},{2});
+    auto z_sdp = Z::init(x_sdp);
+    auto w_sdp = Z::init(x_sdp);
+    Z::id(x_sdp);
+    Z::id(z_sdp);
+    auto throws = [&]() {
+        try {
+            NT::point(x_sdp,z_sdp,w_sdp);
+        } catch(Optizelle::Exception::t const & e) {
+            return true;
+        }
+        return false;
+    };
+    CHECK(!throws());
+    x_sdp.data = {1.,2.,2.,1.};
+    CHECK(throws());
+    Z::id(x_sdp);
+    z_sdp.data = {1.,0.,0.,-1.};
+    CHECK(throws());
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
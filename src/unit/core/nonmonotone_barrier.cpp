@@ -0,0 +1,111 @@
+// Check that the nonmonotone acceptance tests forget their merit history
+// whenever an interior point method changes the barrier parameter and that
+// the equality constrained algorithms reject them
+
+#include "augsys.h"
+
+// Set some type shortcuts
+typedef double Real;
+typedef Unit <Real>::X X;
+typedef Unit <Real>::X_Vector X_Vector;
+typedef Unit <Real>::Natural Natural;
+typedef Optizelle::InequalityConstrained <Real,Unit <Real>::XX,Unit <Real>::ZZ>
+    IP;
+typedef Optizelle::EqualityConstrained <Real,Unit <Real>::XX,Unit <Real>::YY>
+    EP;
+
+// Checks that the merit history only holds values from the current barrier
+struct MeritHistoryCheck : public Optizelle::StateManipulator <IP> {
+    // Interior point parameter when we last computed a step
+    mutable Real mu_old;
+
+    // Number of times we saw mu change
+    mutable Natural mu_changes;
+
+    MeritHistoryCheck() :
+        mu_old(std::numeric_limits <Real>::quiet_NaN()),
+        mu_changes(0)
+    {}
+
+    void eval(
+        IP::Functions::t const & fns,
+        IP::State::t & state,
+        Optizelle::OptimizationLocation::t const & loc
+    ) const {
+        switch(loc) {
+        // By now, we've updated the nonmonotone reference for this step
+        case Optizelle::OptimizationLocation::BeforeLineSearch:
+        case Optizelle::OptimizationLocation::BeforeActualVersusPredicted:
+            if(state.mu != mu_old) {
+                if(mu_old == mu_old) {
+                    mu_changes++;
+                    CHECK(state.merit_hist.size() <= 1);
+                    CHECK(!(state.merit_ref_q > Real(1.)));
+                }
+                mu_old = state.mu;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+};
+
+int main(int argc,char* argv[]){
+    // Minimize 0.5 || x ||^2 over the box [1,3]x[1,3] using each of the
+    // nonmonotone references and interior point schemes
+    for(auto const & algorithm_class : {
+        Optizelle::AlgorithmClass::TrustRegion,
+        Optizelle::AlgorithmClass::LineSearch})
+    for(auto const & nonmono_kind : {
+        Optizelle::NonmonotoneKind::MaxWindow,
+        Optizelle::NonmonotoneKind::WeightedAverage})
+    for(auto const & ip_scheme : {
+        Optizelle::InteriorPointScheme::FixedReduction,
+        Optizelle::InteriorPointScheme::Mehrotra})
+    {
+        IP::State::t state(X_Vector {2.,2.},X_Vector(4));
+        state.algorithm_class = algorithm_class;
+        state.nonmono_kind = nonmono_kind;
+        state.ip_scheme = ip_scheme;
+        state.H_type = Optizelle::Operators::UserDefined;
+        state.dir = Optizelle::LineSearchDirection::NewtonCG;
+        state.eps_grad = Real(1e-8);
+        state.eps_mu = Real(1e-8);
+        state.iter_max = 200;
+
+        IP::Functions::t fns;
+        fns.f.reset(new Unit <Real>::Objective::Quadratic);
+        fns.h.reset(new Unit <Real>::Constraint::Box(
+            X_Vector {1.,1.},X_Vector {3.,3.}));
+
+        MeritHistoryCheck smanip;
+        IP::Algorithms::getMin(
+            Optizelle::Messaging::stdout,fns,state,smanip);
+
+        // Make sure we found the solution
+        CHECK(state.opt_stop == Optizelle::OptimizationStop::GradientSmall);
+        CHECK(std::fabs(state.x[0]-Real(1.)) < Real(1e-6));
+        CHECK(std::fabs(state.x[1]-Real(1.)) < Real(1e-6));
+
+        // Make sure that we actually moved the barrier
+        CHECK(smanip.mu_changes > 0);
+    }
+
+    // The composite step method has no nonmonotone reference, so make sure
+    // that we can't ask for one
+    {
+        EP::State::t state(X_Vector {2.,2.},X_Vector(1));
+        state.nonmono_kind = Optizelle::NonmonotoneKind::MaxWindow;
+        auto caught = false;
+        try {
+            EP::State::check(state);
+        } catch(Optizelle::Exception::t const & e) {
+            caught = true;
+        }
+        CHECK(caught);
+    }
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,100 @@
+// Tests that the cached basis for the range of g'(x)* only holds vectors in
+// that range, even when the augmented system solves are inexact, and that we
+// skip the augmented system solve when the cache removes everything outside
+// of the nullspace
+
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "augsys.h"
+#include "spaces.h"
+
+// Set some type shortcuts
+typedef Optizelle::EqualityConstrained <Real,XX,YY> EP;
+
+// Define a linear constraint on R^6 whose Jacobian has distinct singular
+// values, so that the augmented system solves take several iterations
+//
+// g(x) = [ x1; 2 x2; 3 x3 ]
+//
+// Hence, the range of g'(x)* is span {e1,e2,e3} and the nullspace of g'(x)
+// is span {e4,e5,e6}.
+struct Scaled : public Optizelle::VectorValuedFunction <Real,XX,YY> {
+    // y=g(x)
+    void eval(X_Vector const & x,Y_Vector & y) const {
+        for(auto i=0;i<3;i++)
+            y[i] = Real(i+1)*x[i];
+    }
+
+    // y=g'(x)dx
+    void p(X_Vector const & x,X_Vector const & dx,Y_Vector & y) const {
+        eval(dx,y);
+    }
+
+    // x_hat=g'(x)*dy
+    void ps(X_Vector const & x,Y_Vector const & dy,X_Vector & x_hat) const {
+        X::zero(x_hat);
+        for(auto i=0;i<3;i++)
+            x_hat[i] = Real(i+1)*dy[i];
+    }
+
+    // x_hat=(g''(x)dx)*dy
+    void pps(
+        X_Vector const & x,
+        X_Vector const & dx,
+        Y_Vector const & dy,
+        X_Vector & x_hat
+    ) const {
+        X::zero(x_hat);
+    }
+};
+
+int main(int argc,char* argv[]){
+
+    // Generate an initial guess
+    auto x = std::vector <Real> (6,Real(0.));
+    auto y = std::vector <Real> (3,Real(0.));
+
+    // Use a loose tolerance for the projections and cache the directions
+    EP::State::t state(x,y);
+    state.augsys_proj_cache = 3;
+    state.xi_proj = Real(0.9);
+    state.eps_dx = Real(1e-8);
+
+    // Set up the functions
+    EP::Functions::t fns;
+    fns.f.reset(new Unit <Real>::Objective::Quadratic);
+    fns.g.reset(new Scaled);
+    EP::Functions::init(state,fns);
+    fns.g->eval(state.x,state.g_x);
+
+    // Project the first direction, which requires a solve
+    auto P_dx = X::init(x);
+    EP::Algorithms::NullspaceProjForTrunc(state,fns)
+        .eval(std::vector <Real> (6,Real(1.)),P_dx);
+    CHECK(state.augsys_proj_iter_total > 0);
+
+    // No matter how accurately we solved the system, the cached vector
+    // must not have a component in the nullspace
+    auto const & ws = fns.augsys_proj_cache->ws;
+    CHECK(ws.size() == 1);
+    auto const & w = ws.front();
+    auto const eps = std::numeric_limits <Real>::epsilon()*Real(1e1);
+    for(auto i=3;i<6;i++)
+        CHECK(std::fabs(w[i]) <= eps);
+
+    // Project a direction that lies in the nullspace, but that we perturb
+    // by the cached vector.  The cache should remove the perturbation
+    // exactly, so we shouldn't need a solve.
+    auto dx = std::vector <Real> {0.,0.,0.,1.,2.,3.};
+    auto dx_pert = X::init(dx);
+    X::copy(dx,dx_pert);
+    X::axpy(Real(5.),w,dx_pert);
+    auto iter_total = state.augsys_proj_iter_total;
+    EP::Algorithms::NullspaceProjForTrunc(state,fns).eval(dx_pert,P_dx);
+    CHECK(state.augsys_proj_iter_total == iter_total);
+    for(auto i=0;i<6;i++)
+        CHECK(std::fabs(P_dx[i]-dx[i]) <= eps);
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,112 @@
+// Check that the instrumentation charges the time and calls of a solve to
+// the right phases when we compile with OPTIZELLE_PROFILE and that it stays
+// out of the way otherwise.  The profile_enabled unit runs these same
+// checks with the timers compiled in.
+
+#include "augsys.h"
+
+// A copy of Rm.  The library precompiles the solvers on Rm, possibly
+// without the timers, so we solve on this space, which compiles the solver
+// into this test.
+template <typename Real>
+struct Rn : public Optizelle::Rm <Real> {};
+
+// Set some type shortcuts
+typedef double Real;
+typedef Rn <Real> X;
+typedef typename X::Vector X_Vector;
+typedef Optizelle::Natural Natural;
+typedef Optizelle::Unconstrained <Real,Rn> UP;
+
+// Rosenbrock function on Rn
+struct Rosenbrock : public Optizelle::ScalarValuedFunction <Real,Rn> {
+    Unit <Real>::Objective::Rosenbrock f;
+
+    Real eval(X_Vector const & x) const {
+        return f.eval(x);
+    }
+    void grad(X_Vector const & x,X_Vector & grad) const {
+        f.grad(x,grad);
+    }
+    void hessvec(X_Vector const & x,X_Vector const & dx,X_Vector & H_dx)
+        const
+    {
+        f.hessvec(x,dx,H_dx);
+    }
+};
+
+int main(int argc,char* argv[]){
+    // Timers outside of a solve don't record anything
+    {
+        Optizelle::Profile::Counters counters;
+        {
+            Optizelle::Profile::Timer timer(Optizelle::Profile::Objective);
+        }
+        CHECK(counters.calls[Optizelle::Profile::Objective] == 0);
+        CHECK(counters.elapsed() == Real(0.));
+    }
+
+    // Phases that nest inside of themselves count once, while the time of
+    // a nested phase doesn't count toward its parent
+    {
+        Optizelle::Profile::Counters counters;
+        {
+            Optizelle::Profile::Session session(counters);
+            Optizelle::Profile::Timer ls(Optizelle::Profile::LineSearch);
+            {
+                Optizelle::Profile::Timer f(Optizelle::Profile::Objective);
+                Optizelle::Profile::Timer f_inner(
+                    Optizelle::Profile::Objective);
+            }
+        }
+    #ifdef OPTIZELLE_PROFILE
+        CHECK(counters.calls[Optizelle::Profile::LineSearch] == 1);
+        CHECK(counters.calls[Optizelle::Profile::Objective] == 1);
+        CHECK(counters.seconds[Optizelle::Profile::Objective]
+            <= counters.elapsed());
+        CHECK(counters.solver() >= Real(0.));
+        CHECK(counters.top == nullptr);
+    #else
+        for(Natural i=0;i<Optizelle::Profile::Size;i++)
+            CHECK(counters.calls[i] == 0);
+        CHECK(counters.elapsed() == Real(0.));
+    #endif
+    }
+
+    // Solve a problem and check where we spent our time
+    UP::State::t state(X_Vector {-1.2,1.});
+    state.H_type = Optizelle::Operators::UserDefined;
+    state.algorithm_class = Optizelle::AlgorithmClass::LineSearch;
+    state.dir = Optizelle::LineSearchDirection::NewtonCG;
+    state.kind = Optizelle::LineSearchKind::BackTracking;
+    state.iter_max = 100;
+    UP::Functions::t fns;
+    fns.f.reset(new Rosenbrock);
+    UP::Algorithms::getMin(Optizelle::Messaging::stdout,fns,state);
+    CHECK(state.opt_stop == Optizelle::OptimizationStop::GradientSmall);
+
+    // Every gradient and Hessian-vector product goes through the timers
+    auto const & profile = state.profile;
+#ifdef OPTIZELLE_PROFILE
+    CHECK(profile.calls[Optizelle::Profile::Objective] > 0);
+    CHECK(profile.calls[Optizelle::Profile::Gradient] >= state.iter);
+    CHECK(profile.calls[Optizelle::Profile::HessVec]
+        >= state.trunc_iter_total);
+    CHECK(profile.calls[Optizelle::Profile::VectorSpace] > 0);
+    CHECK(profile.calls[Optizelle::Profile::Krylov] >= state.iter-1);
+    CHECK(profile.calls[Optizelle::Profile::LineSearch] >= state.iter-1);
+    CHECK(profile.calls[Optizelle::Profile::Constraints] == 0);
+    CHECK(profile.calls[Optizelle::Profile::Checkpoint] == 0);
+    CHECK(profile.elapsed() > Real(0.));
+    CHECK(profile.model() <= profile.elapsed());
+    CHECK(Optizelle::Profile::to_json(profile).find("\"Krylov\"")
+        != std::string::npos);
+#else
+    for(Natural i=0;i<Optizelle::Profile::Size;i++)
+        CHECK(profile.calls[i] == 0);
+    CHECK(profile.elapsed() == Real(0.));
+#endif
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,7 @@
+// Run the profiling checks with the timers compiled in, so that we test
+// them even when we build everything else without OPTIZELLE_PROFILE
+
+#ifndef OPTIZELLE_PROFILE
+#define OPTIZELLE_PROFILE
+#endif
+#include "profile.cpp"
@@ -0,0 +1,176 @@
+// Check the derivatives of the Burer-Monteiro factorization of an SDP and
+// that we solve the max-cut relaxation of a cycle with it
+
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "optizelle/sdpa.h"
+#include "unit.h"
+
+// Set some type shortcuts
+typedef double Real;
+typedef Optizelle::Rm <Real> X;
+typedef typename X::Vector X_Vector;
+typedef Optizelle::EqualityConstrained <Real,Optizelle::Rm,Optizelle::Rm>
+    EqualityConstrained;
+typedef Optizelle::Natural Natural;
+
+// Check whether two vectors match relative to the size of the first
+bool match(X_Vector const & x,X_Vector const & y,Real const & tol) {
+    auto diff = X::init(x);
+    X::copy(x,diff);
+    X::axpy(Real(-1.),y,diff);
+    return std::sqrt(X::innr(diff,diff)) <= tol*std::sqrt(X::innr(x,x));
+}
+
+// Fills a vector with a fixed pattern
+X_Vector pattern(Natural const & n,Natural const & seed) {
+    auto x = X_Vector(n);
+    for(Natural i=0;i<n;i++)
+        x[i] = Real((i*7+seed*3)%11)/Real(5.)-Real(1.);
+    return x;
+}
+
+// Creates the max-cut relaxation of the n-cycle, whose optimal value is n
+std::string maxcut_cycle(Natural const & n) {
+    auto sdpa = std::to_string(n) + "\n1\n" + std::to_string(n) + "\n";
+    for(Natural i=1;i<=n;i++)
+        sdpa += "1 ";
+    sdpa += "\n";
+    for(Natural i=1;i<=n;i++) {
+        auto j = i%n+1;
+        sdpa += "0 1 " + std::to_string(i) + " " + std::to_string(i)
+            + " 0.5\n";
+        sdpa += "0 1 " + std::to_string(std::min(i,j)) + " "
+            + std::to_string(std::max(i,j)) + " -0.25\n";
+        sdpa += std::to_string(i) + " 1 " + std::to_string(i) + " "
+            + std::to_string(i) + " 1\n";
+    }
+    return sdpa;
+}
+
+int main(int argc,char* argv[]){
+    // Create a problem with a semidefinite block and a diagonal block
+    Optizelle::sdpa::Problem <Real> prob;
+    Optizelle::sdpa::parse <Real> (
+        "3\n2\n3 -2\n1.0 -2.0 0.5\n"
+        "0 1 1 1 2.0\n"
+        "0 1 1 3 0.5\n"
+        "0 2 2 2 1.0\n"
+        "1 1 1 2 1.5\n"
+        "1 1 3 3 -1.0\n"
+        "1 2 1 1 2.0\n"
+        "2 1 2 2 0.5\n"
+        "2 1 2 3 -0.75\n"
+        "3 2 2 2 1.0\n"
+        "3 1 1 1 0.25\n",
+        prob);
+
+    // The smallest rank that holds a solution has rank(rank+1)/2 > m
+    CHECK(Optizelle::sdpa::LowRank <Real>::rank_min(3) == 3);
+    CHECK(Optizelle::sdpa::LowRank <Real>::rank_min(12) == 5);
+
+    // Factor the problem with rank 2
+    Optizelle::sdpa::LowRank <Real> lr(prob,2);
+    Optizelle::sdpa::LowRankObjective <Real> f(lr);
+    Optizelle::sdpa::LowRankEquality <Real> g(lr);
+    CHECK(lr.nrows() == 5);
+    auto R = pattern(lr.init().size(),1);
+    auto dR = pattern(R.size(),2);
+    auto dy = pattern(prob.m(),3);
+
+    // Compare the derivatives against central differences, which are exact
+    // for quadratics up to rounding
+    auto eps = Real(1e-3);
+    auto R_p = X::init(R);
+    auto R_m = X::init(R);
+    X::copy(R,R_p);
+    X::axpy(eps,dR,R_p);
+    X::copy(R,R_m);
+    X::axpy(-eps,dR,R_m);
+
+    auto grad = X::init(R);
+    f.grad(R,grad);
+    auto fd = (f.eval(R_p)-f.eval(R_m))/(Real(2.)*eps);
+    CHECK(std::fabs(fd-X::innr(grad,dR)) <= Real(1e-10)*std::fabs(fd));
+
+    auto grad_p = X::init(R);
+    auto grad_m = X::init(R);
+    auto H_dR = X::init(R);
+    f.grad(R_p,grad_p);
+    f.grad(R_m,grad_m);
+    X::axpy(Real(-1.),grad_m,grad_p);
+    X::scal(Real(1.)/(Real(2.)*eps),grad_p);
+    f.hessvec(R,dR,H_dR);
+    CHECK(match(H_dR,grad_p,Real(1e-10)));
+
+    auto g_p = X_Vector(prob.m());
+    auto g_m = X_Vector(prob.m());
+    auto gp_dR = X_Vector(prob.m());
+    g.eval(R_p,g_p);
+    g.eval(R_m,g_m);
+    X::axpy(Real(-1.),g_m,g_p);
+    X::scal(Real(1.)/(Real(2.)*eps),g_p);
+    g.p(R,dR,gp_dR);
+    CHECK(match(gp_dR,g_p,Real(1e-10)));
+
+    // The adjoint should satisfy <g'(R)dR,dy> = <dR,g'(R)*dy>
+    auto gps_dy = X::init(R);
+    g.ps(R,dy,gps_dy);
+    CHECK(std::fabs(X::innr(gp_dR,dy)-X::innr(dR,gps_dy))
+        <= Real(1e-12)*std::fabs(X::innr(gp_dR,dy)));
+
+    // The second derivative is the derivative of the adjoint
+    auto gps_p = X::init(R);
+    auto gps_m = X::init(R);
+    auto gpps = X::init(R);
+    g.ps(R_p,dy,gps_p);
+    g.ps(R_m,dy,gps_m);
+    X::axpy(Real(-1.),gps_m,gps_p);
+    X::scal(Real(1.)/(Real(2.)*eps),gps_p);
+    g.pps(R,dR,dy,gpps);
+    CHECK(match(gpps,gps_p,Real(1e-10)));
+
+    // Solve the max-cut relaxation of the 12-cycle
+    Optizelle::sdpa::Problem <Real> maxcut;
+    Optizelle::sdpa::parse <Real> (maxcut_cycle(12),maxcut);
+    Optizelle::sdpa::LowRank <Real> lr_maxcut(maxcut,
+        Optizelle::sdpa::LowRank <Real>::rank_min(maxcut.m()));
+    auto x = lr_maxcut.init();
+    for(Natural i=0;i<x.size();i++)
+        x[i] = std::cos(Real(i));
+    auto y = X_Vector(maxcut.m());
+    EqualityConstrained::State::t state(x,y);
+    state.H_type = Optizelle::Operators::UserDefined;
+    state.PSchur_left_type = Optizelle::Operators::UserDefined;
+    state.trunc_iter_max = 200;
+    state.eps_grad = Real(1e-8);
+    EqualityConstrained::Functions::t fns;
+    fns.f.reset(new Optizelle::sdpa::LowRankObjective <Real> (lr_maxcut));
+    fns.g.reset(new Optizelle::sdpa::LowRankEquality <Real> (lr_maxcut));
+    fns.PSchur_left.reset(
+        new Optizelle::sdpa::LowRankSchur <Real> (lr_maxcut,state.x));
+
+    // The Jacobi preconditioner is exact since the constraints touch
+    // different rows
+    auto gps_ones = X::init(x);
+    auto gp_gps_ones = X_Vector(maxcut.m());
+    auto P_gp_gps_ones = X_Vector(maxcut.m());
+    auto ones = X_Vector(maxcut.m(),Real(1.));
+    fns.g->ps(state.x,ones,gps_ones);
+    fns.g->p(state.x,gps_ones,gp_gps_ones);
+    fns.PSchur_left->eval(gp_gps_ones,P_gp_gps_ones);
+    CHECK(match(ones,P_gp_gps_ones,Real(1e-14)));
+
+    EqualityConstrained::Algorithms::getMin(
+        Optizelle::Messaging::stdout,fns,state);
+    CHECK(state.opt_stop == Optizelle::OptimizationStop::GradientSmall);
+
+    // Both the factored objective and the objective of the multipliers
+    // should match the optimal value
+    CHECK(std::fabs(lr_maxcut.innr(0,state.x,state.x)-Real(12.))
+        <= Real(1e-6));
+    CHECK(std::fabs(X::innr(maxcut.b,state.y)-Real(12.)) <= Real(1e-6));
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
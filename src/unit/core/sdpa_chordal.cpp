@@ -0,0 +1,96 @@
+// Check that the chordal decomposition of an SDP splits a sparse block into
+// small clique blocks whose sum recovers the original block for any choice
+// of the coupling variables
+
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "optizelle/sdpa.h"
+#include "unit.h"
+
+// Set some type shortcuts
+typedef double Real;
+typedef Optizelle::Rm <Real> X;
+typedef typename X::Vector X_Vector;
+typedef Optizelle::SQL <Real> Z;
+typedef typename Z::Vector Z_Vector;
+typedef Optizelle::Natural Natural;
+
+int main(int argc,char* argv[]){
+    // Create a problem with three blocks.  The first is a 10-cycle, which
+    // isn't chordal.  The second is a small semidefinite block, which we
+    // leave alone, and the last is diagonal.
+    auto n = Natural(10);
+    auto sdpa = std::string("3\n3\n10 2 -2\n1 1 1\n");
+    for(Natural i=1;i<=n;i++) {
+        auto j = i%n+1;
+        sdpa += "0 1 " + std::to_string(i) + " " + std::to_string(i)
+            + " 2.0\n";
+        sdpa += "1 1 " + std::to_string(std::min(i,j)) + " "
+            + std::to_string(std::max(i,j)) + " -0.5\n";
+        sdpa += "2 1 " + std::to_string(i) + " " + std::to_string(i) + " "
+            + std::to_string(Real(i)/Real(n)) + "\n";
+    }
+    sdpa += "3 1 1 6 0.25\n"
+        "0 2 1 1 1.0\n"
+        "1 2 1 2 0.5\n"
+        "2 3 2 2 1.0\n"
+        "3 3 1 1 -1.0\n";
+    Optizelle::sdpa::Problem <Real> prob;
+    Optizelle::sdpa::parse <Real> (std::move(sdpa),prob);
+
+    // Decompose the blocks with at least three rows
+    Optizelle::sdpa::Decomposition <Real> dec;
+    Optizelle::sdpa::decompose <Real> (prob,3,dec);
+
+    // The chordal extension of the cycle with the chord (1,6) splits into
+    // triangles.  The other two blocks come through unchanged.
+    CHECK(dec.prob.nblocks() == dec.blk_origin.size());
+    CHECK(dec.prob.m() > prob.m());
+    auto nclique = Natural(0);
+    for(Natural blk=0;blk<dec.prob.nblocks();blk++) {
+        if(dec.blk_origin[blk]==0) {
+            CHECK(dec.prob.blk_sizes[blk] == 3);
+            nclique++;
+        } else
+            CHECK(dec.prob.blk_sizes[blk]
+                == prob.blk_sizes[dec.blk_origin[blk]]);
+    }
+    CHECK(nclique == n-2);
+    CHECK(dec.prob.nblocks() == nclique+2);
+    for(Natural i=0;i<prob.m();i++)
+        CHECK(dec.prob.b[i]==prob.b[i]);
+    for(Natural i=prob.m();i<dec.prob.m();i++)
+        CHECK(dec.prob.b[i]==Real(0.));
+
+    // For arbitrary values of the coupling variables, summing the clique
+    // blocks gives back the original block
+    auto x = X_Vector {0.5,-2.,3.};
+    auto xx = X_Vector(dec.prob.m());
+    for(Natural i=0;i<xx.size();i++)
+        xx[i] = i < x.size() ? x[i] : Real(i%7)-Real(3.);
+    Optizelle::sdpa::Inequality <Real> h(prob);
+    Optizelle::sdpa::Inequality <Real> hh(dec.prob);
+    auto h_x = Optizelle::sdpa::init_codomain(prob);
+    auto hh_xx = Optizelle::sdpa::init_codomain(dec.prob);
+    h.eval(x,h_x);
+    hh.eval(xx,hh_xx);
+    auto sum = Z::init(h_x);
+    Z::zero(sum);
+    for(Natural blk=0;blk<dec.prob.nblocks();blk++) {
+        auto const & rows = dec.blk_rows[blk];
+        auto const orig = dec.blk_origin[blk];
+        for(Natural a=0;a<rows.size();a++) {
+            if(prob.blk_sizes[orig] < 0)
+                sum(orig+1,rows[a]+1) += hh_xx(blk+1,a+1);
+            else
+                for(Natural b=0;b<rows.size();b++)
+                    sum(orig+1,rows[a]+1,rows[b]+1)
+                        += hh_xx(blk+1,a+1,b+1);
+        }
+    }
+    for(Natural k=0;k<sum.data.size();k++)
+        CHECK(std::fabs(sum.data[k]-h_x.data[k]) <= Real(1e-14));
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,109 @@
+// Check that we read sparse SDPA files with comments, formatting characters,
+// and duplicate elements and that the SDP inequality built from them applies
+// the constraint matrices and their adjoint correctly
+
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "optizelle/sdpa.h"
+#include "unit.h"
+
+// Set some type shortcuts
+typedef double Real;
+typedef Optizelle::Rm <Real> X;
+typedef typename X::Vector X_Vector;
+typedef Optizelle::SQL <Real> Z;
+typedef typename Z::Vector Z_Vector;
+typedef Optizelle::Natural Natural;
+
+// Check whether two vectors match
+bool match(std::vector <Real> const & x,std::vector <Real> const & y) {
+    if(x.size() != y.size()) return false;
+    for(Natural i=0;i<x.size();i++)
+        if(std::fabs(x[i]-y[i]) > Real(1e-14)) return false;
+    return true;
+}
+
+// Check whether we reject a file
+bool rejects(std::string && contents) {
+    Optizelle::sdpa::Problem <Real> prob;
+    try {
+        Optizelle::sdpa::parse <Real> (std::move(contents),prob);
+    } catch(Optizelle::Exception::t const & e) {
+        return true;
+    }
+    return false;
+}
+
+int main(int argc,char* argv[]){
+    // Read a problem with a semidefinite and a diagonal block.  The element
+    // (2,1) in A1 duplicates (1,2), so the two are summed.
+    //
+    // A0 = [ 1 0 ]  [ 0 0 0 ]
+    //      [ 0 0 ]  [ 0 0 0 ]
+    //               [ 0 0 0 ]
+    //
+    // A1 = [ 0   2.5 ]  [ 0 0 0 ]
+    //      [ 2.5 0   ]  [ 0 0 0 ]
+    //                   [ 0 0 4 ]
+    //
+    // A2 = [ 0 0  ]  [ 3 0 0 ]
+    //      [ 0 -1 ]  [ 0 0 0 ]
+    //                [ 0 0 0 ]
+    Optizelle::sdpa::Problem <Real> prob;
+    Optizelle::sdpa::parse <Real> (
+        "\"A comment\n"
+        "* Another comment\n"
+        "2 = mDIM\n"
+        "2 = nBLOCK\n"
+        "{2, -3} = bLOCKsTRUCT\n"
+        "{1.0, -2.5}\n"
+        "0 1 1 1 1.0\n"
+        "1 1 1 2 2.0\n"
+        "1 1 2 1 0.5\n"
+        "1 2 3 3 4.0\n"
+        "2 1 2 2 -1.0\n"
+        "2 2 1 1 3.0\n",
+        prob);
+    CHECK(prob.m()==2);
+    CHECK(prob.blk_sizes==std::vector <Optizelle::Integer>({2,-3}));
+    CHECK(match(prob.b,{1.,-2.5}));
+
+    // Semidefinite blocks hold both triangles
+    auto const & A1 = prob.A[1][0];
+    CHECK(A1.valid());
+    CHECK(A1.offsets==std::vector <Natural>({0,1,2}));
+    CHECK(A1.cols==std::vector <Natural>({1,0}));
+    CHECK(match(A1.vals,{2.5,2.5}));
+
+    // Diagonal blocks hold only their diagonal
+    auto const & A1_diag = prob.A[1][1];
+    CHECK(A1_diag.valid());
+    CHECK(A1_diag.offsets==std::vector <Natural>({0,0,0,1}));
+    CHECK(A1_diag.cols==std::vector <Natural>({2}));
+
+    // Evaluate the inequality and its adjoint
+    Optizelle::sdpa::Inequality <Real> h(prob);
+    auto x = X_Vector {1.,2.};
+    auto z = Optizelle::sdpa::init_codomain(prob);
+    h.eval(x,z);
+    CHECK(match(z.data,{-1.,2.5,2.5,-2., 6.,0.,4.}));
+
+    auto dx = X_Vector {-1.,0.5};
+    h.p(x,dx,z);
+    CHECK(match(z.data,{0.,-2.5,-2.5,-0.5, 1.5,0.,-4.}));
+
+    auto dz = Z::init(z);
+    dz.data = {1.,2.,3.,4., 5.,6.,7.};
+    auto xhat = X_Vector(2);
+    h.ps(x,dz,xhat);
+    CHECK(match(xhat,{2.5*2.+2.5*3.+4.*7.,-4.+3.*5.}));
+
+    // Reject malformed files
+    CHECK(rejects("1\n1\n-2\n1.0\n1 1 1 2 1.0\n"));
+    CHECK(rejects("1\n1\n2\n1.0\n1 2 1 1 1.0\n"));
+    CHECK(rejects("1\n1\n2\n1.0\n1 1 3 1 1.0\n"));
+    CHECK(rejects("1\n1\n2\n1.0\n1 1 1 1\n"));
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
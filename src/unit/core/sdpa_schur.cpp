@@ -0,0 +1,142 @@
+// Check that the Schur complement that we assemble from the sparse constraint
+// matrices of an SDP inverts the Hessian of the interior point method, with
+// and without Nesterov-Todd scaling, and that we reject second-order cones
+
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "optizelle/sdpa.h"
+#include "unit.h"
+
+// Set some type shortcuts
+typedef double Real;
+typedef Optizelle::Rm <Real> X;
+typedef typename X::Vector X_Vector;
+typedef Optizelle::SQL <Real> Z;
+typedef typename Z::Vector Z_Vector;
+typedef Optizelle::Natural Natural;
+typedef Optizelle::InequalityConstrained <Real,Optizelle::Rm,Optizelle::SQL>
+    InequalityConstrained;
+
+// Linear objective f(x) = <b,x>
+struct Linear : public Optizelle::ScalarValuedFunction <Real,Optizelle::Rm> {
+    X_Vector const b;
+    explicit Linear(X_Vector const & b_) : b(b_) {}
+    Real eval(X_Vector const & x) const {
+        return X::innr(b,x);
+    }
+    void grad(X_Vector const & x,X_Vector & grad) const {
+        X::copy(b,grad);
+    }
+    void hessvec(X_Vector const & x,X_Vector const & dx,X_Vector & H_dx)
+        const
+    {
+        X::zero(H_dx);
+    }
+};
+
+// Checks that the Schur complement inverts the Hessian of the interior point
+// method at x and z
+void check(
+    Optizelle::sdpa::Problem <Real> const & prob,
+    X_Vector const & x,
+    Optizelle::InteriorPointScaling::t const & ip_scaling
+) {
+    // Find a strictly feasible multiplier that isn't a multiple of the
+    // identity
+    auto z = Optizelle::sdpa::init_codomain(prob);
+    Z::id(z);
+    for(Natural i=0;i<z.data.size();i++)
+        z.data[i] *= Real(1.) + Real(0.1)*Real(i%3);
+    z.data[z.offsets[0]+1] = Real(0.1);
+    z.data[z.offsets[0]+3] = Real(0.1);
+
+    // Set up the state and the functions
+    InequalityConstrained::State::t state(x,z);
+    state.ip_scaling = ip_scaling;
+    InequalityConstrained::Functions::t fns;
+    fns.f.reset(new Linear(prob.b));
+    fns.h.reset(new Optizelle::sdpa::Inequality <Real> (prob));
+    fns.PH.reset(new Optizelle::sdpa::Schur <Real> (
+        Optizelle::sdpa::columns <Real> (prob),state));
+    state.PH_type = Optizelle::Operators::UserDefined;
+    InequalityConstrained::Functions::init(state,fns);
+    fns.h->eval(state.x,state.h_x);
+
+    // Apply the Hessian to each canonical vector and then the Schur
+    // complement, which should bring us back
+    auto m = prob.m();
+    auto zero = X::init(x);
+    X::zero(zero);
+    for(Natural j=0;j<m;j++) {
+        auto ej = X::init(x);
+        X::zero(ej);
+        ej[j] = Real(1.);
+        auto H_ej = X::init(x);
+        fns.f_mod->hessvec_step(state.x,ej,zero,H_ej);
+        auto PH_H_ej = X::init(x);
+        fns.PH->eval(H_ej,PH_H_ej);
+        X::axpy(Real(-1.),ej,PH_H_ej);
+        CHECK(std::sqrt(X::innr(PH_H_ej,PH_H_ej)) <= Real(1e-10));
+    }
+}
+
+int main(int argc,char* argv[]){
+    // Create a problem with a semidefinite block and a diagonal block.  The
+    // first and last constraint matrices fill the semidefinite block, so
+    // that we use the dense formulas, while the others are sparse.
+    Optizelle::sdpa::Problem <Real> prob;
+    Optizelle::sdpa::parse <Real> (
+        "4\n"
+        "2\n"
+        "{3, -2}\n"
+        "{1.0, 2.0, -1.0, 0.5}\n"
+        "0 1 1 1 -1.0\n"
+        "0 1 2 2 -1.0\n"
+        "0 1 3 3 -1.0\n"
+        "0 2 1 1 -1.0\n"
+        "0 2 2 2 -1.0\n"
+        "1 1 1 1 1.0\n"
+        "1 1 1 2 0.5\n"
+        "1 1 1 3 0.25\n"
+        "1 1 2 2 2.0\n"
+        "1 1 2 3 -0.5\n"
+        "1 1 3 3 1.0\n"
+        "2 1 1 3 1.0\n"
+        "2 2 1 1 1.0\n"
+        "3 1 2 2 1.0\n"
+        "3 2 2 2 -1.0\n"
+        "4 1 1 1 -1.0\n"
+        "4 1 1 2 0.5\n"
+        "4 1 1 3 1.0\n"
+        "4 1 2 2 1.0\n"
+        "4 1 2 3 0.75\n"
+        "4 1 3 3 2.0\n",
+        prob);
+
+    // Pick a point where h(x) = A1 x1 + ... + A4 x4 - A0 is strictly
+    // feasible
+    auto x = X_Vector {0.5,0.1,0.2,0.1};
+    check(prob,x,Optizelle::InteriorPointScaling::Unscaled);
+    check(prob,x,Optizelle::InteriorPointScaling::NesterovTodd);
+
+    // The Schur complement doesn't support second-order cones
+    auto types = std::vector <Optizelle::Cone::t> {
+        Optizelle::Cone::Quadratic};
+    auto sizes = std::vector <Natural> {3};
+    auto z = Z_Vector(types,sizes);
+    Z::id(z);
+    InequalityConstrained::State::t state(x,z);
+    auto cols = Optizelle::sdpa::Columns <Real> (3,
+        std::vector <Optizelle::CSRMatrix <Real> > (1,
+            Optizelle::CSRMatrix <Real> (3,3)));
+    auto rejected = false;
+    try {
+        Optizelle::sdpa::Schur <Real> PH(std::move(cols),state);
+    } catch(Optizelle::Exception::t const & e) {
+        rejected = true;
+    }
+    CHECK(rejected);
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
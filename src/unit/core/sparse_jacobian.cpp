@@ -0,0 +1,171 @@
+// Check that a vector valued function with a sparse Jacobian applies the
+// Jacobian and its adjoint correctly and only refreshes the Jacobian when
+// x moves
+
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "unit.h"
+
+// Set some type shortcuts
+typedef double Real;
+typedef Optizelle::Rm <Real> X;
+typedef typename X::Vector X_Vector;
+typedef Optizelle::SQL <Real> Z;
+typedef typename Z::Vector Z_Vector;
+typedef Optizelle::Natural Natural;
+
+// Define a constraint with an empty row and unsorted columns
+//
+// g(x) = [ x0 x1 + x3 ]
+//        [ 1          ]
+//        [ x2^2 - x0  ]
+//
+// The Jacobian is
+//
+// g'(x) = [ x1 x0 0    1 ]
+//         [ 0  0  0    0 ]
+//         [ -1 0  2 x2 0 ]
+template <template <typename> class YY>
+struct G : public Optizelle::SparseVectorValuedFunction <Real,YY> {
+    // Number of times that we've formed the Jacobian
+    mutable Natural count;
+
+    // Whether or not to return a malformed Jacobian
+    bool broken;
+
+    // Whether or not to claim that we're affine
+    bool affine;
+
+    G() : count(0), broken(false), affine(false) {}
+
+    // Claim to be affine when asked, which lets us check the caching
+    bool is_affine() const {
+        return affine;
+    }
+
+    // y=g(x)
+    void eval(
+        X_Vector const & x,
+        typename YY <Real>::Vector & y
+    ) const {
+        auto & y_data = Optizelle::DenseStorage <Real,YY>::get(y);
+        y_data[0] = x[0]*x[1]+x[3];
+        y_data[1] = Real(1.);
+        y_data[2] = x[2]*x[2]-x[0];
+    }
+
+    // J <- g'(x)
+    void jacobian(
+        X_Vector const & x,
+        Optizelle::CSRMatrix <Real> & J
+    ) const {
+        count++;
+        J = Optizelle::CSRMatrix <Real> (3,4);
+        J.offsets = {0,3,3,5};
+        J.cols = {3,0,1,2,0};
+        J.vals = {Real(1.),x[1],x[0],Real(2.)*x[2],Real(-1.)};
+        if(broken)
+            J.cols[0] = 4;
+    }
+
+    // z=(g''(x)dx)*dy
+    void pps(
+        X_Vector const & x,
+        X_Vector const & dx,
+        typename YY <Real>::Vector const & dy,
+        X_Vector & z
+    ) const {
+        auto const & dy_data = Optizelle::DenseStorage <Real,YY>::get(dy);
+        X::zero(z);
+        z[0] = dy_data[0]*dx[1];
+        z[1] = dy_data[0]*dx[0];
+        z[2] = Real(2.)*dy_data[2]*dx[2];
+    }
+};
+
+// Check whether two vectors match
+bool match(std::vector <Real> const & x,std::vector <Real> const & y) {
+    if(x.size() != y.size()) return false;
+    for(Natural i=0;i<x.size();i++)
+        if(std::fabs(x[i]-y[i]) > Real(1e-14)) return false;
+    return true;
+}
+
+int main(int argc,char* argv[]){
+    // Create some points and directions
+    auto x = X_Vector {1.,2.,3.,4.};
+    auto dx = X_Vector {-1.,0.5,2.,3.};
+    auto dy = X_Vector {0.5,-2.,3.};
+
+    // Check the product and its adjoint when Y is Rm
+    {
+        G <Optizelle::Rm> g;
+        auto y = X_Vector(3);
+        auto z = X_Vector(4);
+
+        g.p(x,dx,y);
+        CHECK(match(y,{2.*-1.+1.*0.5+3.,0.,1.+6.*2.}));
+
+        g.ps(x,dy,z);
+        CHECK(match(z,{2.*0.5-3.,1.*0.5,6.*3.,0.5}));
+
+        // We should have only formed the Jacobian once
+        CHECK(g.count==1);
+
+        // Moving x should cause the Jacobian to be refreshed
+        auto x2 = X_Vector {0.,1.,-1.,0.};
+        g.ps(x2,dy,z);
+        CHECK(match(z,{1.*0.5-3.,0.,-2.*3.,0.5}));
+        CHECK(g.count==2);
+
+        // The transpose should be sorted by column
+        auto const & Jt = g.jac_trans(x2);
+        CHECK(Jt.offsets==std::vector <Natural>({0,2,3,4,5}));
+        CHECK(Jt.cols==std::vector <Natural>({0,2,0,2,0}));
+    }
+
+    // Check the product and its adjoint when Y is SQL
+    {
+        G <Optizelle::SQL> g;
+        auto y = Z_Vector({Optizelle::Cone::Linear},{3});
+        auto dy_sql = Z::init(y);
+        dy_sql.data = dy;
+        auto z = X_Vector(4);
+
+        g.p(x,dx,y);
+        CHECK(match(y.data,{2.*-1.+1.*0.5+3.,0.,1.+6.*2.}));
+
+        g.ps(x,dy_sql,z);
+        CHECK(match(z,{2.*0.5-3.,1.*0.5,6.*3.,0.5}));
+        CHECK(g.count==1);
+    }
+
+    // Check that we keep the Jacobian when g is affine
+    {
+        G <Optizelle::Rm> g;
+        g.affine = true;
+        auto z = X_Vector(4);
+        g.ps(x,dy,z);
+        auto x2 = X_Vector {0.,1.,-1.,0.};
+        g.ps(x2,dy,z);
+        CHECK(match(z,{2.*0.5-3.,1.*0.5,6.*3.,0.5}));
+        CHECK(g.count==1);
+    }
+
+    // Check that we reject a malformed Jacobian
+    {
+        G <Optizelle::Rm> g;
+        g.broken = true;
+        auto y = X_Vector(3);
+        auto caught = false;
+        try {
+            g.p(x,dx,y);
+        } catch(Optizelle::Exception::t const & e) {
+            caught = true;
+        }
+        CHECK(caught);
+    }
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
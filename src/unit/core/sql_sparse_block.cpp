@@ -0,0 +1,79 @@
+// Check that the barrier and the line search on a large, sparse
+// semidefinite block, which use a sparse Cholesky factorization, match the
+// dense computations and reuse the symbolic factorization
+
+#include "optizelle/optizelle.h"
+#include "optizelle/vspaces.h"
+#include "unit.h"
+
+// Set some type shortcuts
+typedef double Real;
+typedef Optizelle::SQL <Real> Z;
+typedef typename Z::Vector Z_Vector;
+typedef Optizelle::Natural Natural;
+typedef Optizelle::Integer Integer;
+
+// Checks whether a block is positive definite with a dense Cholesky
+// factorization
+bool definite(std::vector <Real> A,Natural const & m) {
+    Integer info(0);
+    Optizelle::potrf <Real> ('U',m,&(A[0]),m,info);
+    return info==0;
+}
+
+int main(int argc,char* argv[]){
+    // Create a block large enough to use the sparse kernels.  The matrix
+    // y is an arrow matrix, which fills in badly with the natural ordering,
+    // and x is tridiagonal.
+    auto m = Natural(100);
+    auto x = Z_Vector({Optizelle::Cone::Semidefinite},{m});
+    auto y = Z::init(x);
+    Z::zero(x);
+    Z::zero(y);
+    for(Natural i=1;i<=m;i++) {
+        y(1,i,i) = Real(4.) + Real(i%3);
+        x(1,i,i) = Real(i%5)-Real(2.);
+        if(i>1) {
+            y(1,1,i) = y(1,i,1) = Real(0.1);
+            x(1,i-1,i) = x(1,i,i-1) = Real(0.5);
+        }
+    }
+    y(1,1,1) = Real(2.)*Real(m);
+
+    // Find the barrier densely
+    auto U = std::vector <Real> (&(y(1,1,1)),&(y(1,1,1))+m*m);
+    Integer info(0);
+    Optizelle::potrf <Real> ('U',m,&(U[0]),m,info);
+    auto log_det = Real(0.);
+    for(Natural i=1;i<=m;i++)
+        log_det += Real(2.)*std::log(U[Optizelle::ijtok(i,i,m)]);
+    CHECK(std::fabs(Z::barr(y)-log_det) <= Real(1e-12)*std::fabs(log_det));
+
+    // The line search should land just inside the boundary
+    auto alpha = Z::srch(x,y);
+    CHECK(alpha > Real(0.) && alpha < std::numeric_limits <Real>::infinity());
+    auto y_p_ax = std::vector <Real> (m*m);
+    for(Natural k=0;k<m*m;k++)
+        y_p_ax[k] = y.data[k] + Real(0.9999)*alpha*x.data[k];
+    CHECK(definite(y_p_ax,m));
+    for(Natural k=0;k<m*m;k++)
+        y_p_ax[k] = y.data[k] + Real(1.0001)*alpha*x.data[k];
+    CHECK(!definite(y_p_ax,m));
+
+    // Vectors that we initialize from each other share the symbolic
+    // factorizations.  As long as the sparsity pattern of the block doesn't
+    // change, we keep the ordering from the last line search.
+    CHECK(x.ldlt == y.ldlt);
+    auto const & ldlt = (*y.ldlt)[0];
+    CHECK(ldlt.n == m);
+    auto const perm = ldlt.perm.data();
+    Z::scal(Real(2.),x);
+    CHECK(std::fabs(Z::srch(x,y)-Real(0.5)*alpha) <= Real(1e-6)*alpha);
+    CHECK(ldlt.perm.data() == perm);
+
+    // We can step forever in a positive definite direction
+    CHECK(Z::srch(y,y) == std::numeric_limits <Real>::infinity());
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,202 @@
+// Check that we can warm start a sequence of related unconstrained and
+// inequality constrained problems and that doing so saves iterations
+
+#include "augsys.h"
+
+// Set some type shortcuts
+typedef double Real;
+typedef Optizelle::Rm <Real> X;
+typedef typename X::Vector X_Vector;
+typedef Optizelle::Natural Natural;
+typedef Optizelle::Unconstrained <Real,Optizelle::Rm> UP;
+typedef Optizelle::InequalityConstrained <Real,Optizelle::Rm,Optizelle::Rm>
+    IP;
+typedef Unit <Real>::Objective::Rosenbrock Rosenbrock;
+
+// Define the objective
+//
+// f(x,y)=(x+1)^2+(y+1)^2
+//
+struct Quadratic
+    : public Optizelle::ScalarValuedFunction <Real,Optizelle::Rm>
+{
+    Real eval(X_Vector const & x) const {
+        return sq(x[0]+Real(1.))+sq(x[1]+Real(1.));
+    }
+
+    void grad(X_Vector const & x,X_Vector & grad) const {
+        grad[0]=Real(2.)*x[0]+Real(2.);
+        grad[1]=Real(2.)*x[1]+Real(2.);
+    }
+
+    void hessvec(
+        X_Vector const & x,
+        X_Vector const & dx,
+        X_Vector & H_dx
+    ) const {
+        H_dx[0]=Real(2.)*dx[0];
+        H_dx[1]=Real(2.)*dx[1];
+    }
+};
+
+// Define the constraints
+//
+// x + 2y >= c
+// 2x + y >= c
+//
+// which are both active at the solution (c/3,c/3)
+struct Constraints
+    :public Optizelle::VectorValuedFunction<Real,Optizelle::Rm,Optizelle::Rm>
+{
+    Real c;
+    Constraints(Real const & c_) : c(c_) {}
+
+    void eval(X_Vector const & x,X_Vector & y) const {
+        y[0]=x[0]+Real(2.)*x[1]-c;
+        y[1]=Real(2.)*x[0]+x[1]-c;
+    }
+
+    void p(X_Vector const & x,X_Vector const & dx,X_Vector & y) const {
+        y[0]=dx[0]+Real(2.)*dx[1];
+        y[1]=Real(2.)*dx[0]+dx[1];
+    }
+
+    void ps(X_Vector const & x,X_Vector const & dy,X_Vector & z) const {
+        z[0]=dy[0]+Real(2.)*dy[1];
+        z[1]=Real(2.)*dy[0]+dy[1];
+    }
+
+    void pps(
+        X_Vector const & x,
+        X_Vector const & dx,
+        X_Vector const & dy,
+        X_Vector & z
+    ) const {
+        X::zero(z);
+    }
+};
+
+// Sets up the parameters for the unconstrained solves
+void setup(UP::State::t & state) {
+    state.H_type = Optizelle::Operators::UserDefined;
+    state.eps_grad = Real(1e-10);
+    state.iter_max = 200;
+}
+
+// Sets up the parameters for the inequality constrained solves
+void setup(IP::State::t & state) {
+    state.algorithm_class = Optizelle::AlgorithmClass::LineSearch;
+    state.H_type = Optizelle::Operators::UserDefined;
+    state.dir = Optizelle::LineSearchDirection::NewtonCG;
+    state.eps_trunc = Real(1e-12);
+    state.eps_dx = Real(1e-16);
+    state.eps_grad = Real(1e-8);
+    state.eps_mu = Real(1e-6);
+    state.iter_max = 200;
+}
+
+int main(int argc,char* argv[]){
+    // Solve a sequence of Rosenbrock problems whose solutions move along
+    // the curve (p,p^2).  Each solve starts from the same cold guess, so the
+    // warm start has to bring in the prior solution.
+    {
+        Optizelle::Continuation <UP> cont;
+        auto const n = Natural(5);
+        auto saved = Optizelle::Integer(0);
+        for(Natural i=0;i<n;i++) {
+            auto const p = Real(1.) + Real(0.05)*Real(i);
+            UP::State::t state(X_Vector {-1.2,1.});
+            setup(state);
+            UP::Functions::t fns;
+            fns.f.reset(new Rosenbrock(p));
+            cont.getMin(Optizelle::Messaging::stdout,fns,state);
+
+            // Make sure we found the solution
+            CHECK(state.opt_stop == Optizelle::OptimizationStop::GradientSmall);
+            CHECK(std::fabs(state.x[0]-p) < Real(1e-6));
+            CHECK(std::fabs(state.x[1]-p*p) < Real(1e-6));
+
+            // Make sure that warm starting saves iterations
+            if(i>0)
+                CHECK(cont.iter_saved > 0);
+            saved += cont.iter_saved;
+        }
+        CHECK(cont.solves == n);
+        CHECK(cont.warm_solves == n-1);
+        CHECK(cont.iter_saved_total == saved);
+    }
+
+    // When we carry nothing over, we don't save anything
+    {
+        Optizelle::Continuation <UP> cont(0);
+        for(Natural i=0;i<2;i++) {
+            UP::State::t state(X_Vector {-1.2,1.});
+            setup(state);
+            UP::Functions::t fns;
+            fns.f.reset(new Rosenbrock(Real(1.)));
+            cont.getMin(Optizelle::Messaging::stdout,fns,state);
+        }
+        CHECK(cont.iter_saved == 0);
+    }
+
+    // Solve a sequence of inequality constrained problems where the
+    // constraints relax, so that the prior solution remains feasible, but
+    // lies close to the boundary.  Here, the safeguards have to move the
+    // inequality multiplier and the interior point parameter back into the
+    // interior.
+    {
+        Optizelle::Continuation <IP> cont;
+        auto const n = Natural(5);
+        for(Natural i=0;i<n;i++) {
+            auto const c = Real(1.) - Real(0.1)*Real(i);
+            IP::State::t state(X_Vector {2.1,1.1},X_Vector(2));
+            setup(state);
+            IP::Functions::t fns;
+            fns.f.reset(new Quadratic);
+            fns.h.reset(new Constraints(c));
+            cont.getMin(Optizelle::Messaging::stdout,fns,state);
+
+            // Make sure we found the solution
+            CHECK(state.opt_stop == Optizelle::OptimizationStop::GradientSmall);
+            CHECK(std::fabs(state.x[0]-c/Real(3.)) < Real(1e-4));
+            CHECK(std::fabs(state.x[1]-c/Real(3.)) < Real(1e-4));
+            CHECK(state.z[0] > Real(0.) && state.z[1] > Real(0.));
+        }
+        CHECK(cont.solves == n);
+        CHECK(cont.iter_saved_total > 0);
+    }
+
+    // Solve a sequence of inequality constrained problems where the
+    // constraints tighten, so that the prior solution is infeasible for the
+    // next problem.  Here, we have to fall back to the caller's starting
+    // point and the cold initialization of the interior point method.
+    {
+        Optizelle::Continuation <IP> cont;
+        auto const n = Natural(3);
+        for(Natural i=0;i<n;i++) {
+            auto const c = Real(1.) + Real(0.1)*Real(i);
+            IP::State::t state(X_Vector {2.1,1.1},X_Vector(2));
+            setup(state);
+            IP::Functions::t fns;
+            fns.f.reset(new Quadratic);
+            fns.h.reset(new Constraints(c));
+            cont.getMin(Optizelle::Messaging::stdout,fns,state);
+
+            // Make sure we found the solution
+            CHECK(state.opt_stop == Optizelle::OptimizationStop::GradientSmall);
+            CHECK(std::fabs(state.x[0]-c/Real(3.)) < Real(1e-4));
+            CHECK(std::fabs(state.x[1]-c/Real(3.)) < Real(1e-4));
+            CHECK(state.z[0] > Real(0.) && state.z[1] > Real(0.));
+            CHECK(state.mu > Real(0.));
+
+            // Make sure that we don't count the cold starts as savings
+            CHECK(cont.iter_saved == 0);
+        }
+        CHECK(cont.solves == n);
+        CHECK(cont.warm_solves == 0);
+        CHECK(cont.iter_saved_total == 0);
+    }
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,120 @@
+// Run block GMRES on several right hand sides at once where one of the right
+// hand sides is a combination of the others and another is zero.  The
+// dependent right hand side should deflate the Krylov space and the zero
+// right hand side should take no iterations.  Then, check that we still
+// converge when we restart.
+
+#include "linear_algebra.h"
+#include "spaces.h"
+
+using Optizelle::Natural;
+
+// An operator that counts how often it's applied to a batch of vectors
+struct CountedMatrix : public Optizelle::Operator <Real,Rm,Rm> {
+    // Underlying matrix
+    Matrix A;
+
+    // Number of batches and the largest batch that we've seen
+    mutable Natural batches;
+    mutable Natural batch_max;
+
+    CountedMatrix(Matrix const & A_) : A(A_), batches(0), batch_max(0) {}
+
+    void eval(Vector const & x,Vector & y) const {
+        A.eval(x,y);
+    }
+
+    void eval_many(
+        std::list <Vector> const & xs,
+        std::list <Vector> & ys
+    ) const {
+        batches++;
+        batch_max = std::max(batch_max,xs.size());
+        Optizelle::Operator <Real,Rm,Rm>::eval_many(xs,ys);
+    }
+};
+
+int main() {
+    // Setup the problem
+    auto m = Natural(5);
+    auto A = CountedMatrix(Unit::Matrix <Real>::nonsymmetric(m,0));
+    auto b1 = Unit::Vector <Real>::basic(m);
+    auto b2 = Unit::Vector <Real>::alternate(m);
+    auto b3 = b1;
+    X::axpy(Real(2.),b2,b3);
+    auto b4 = Unit::Vector <Real>::zero(m);
+    auto bs = std::list <Vector> {b1,b2,b3,b4};
+    auto xs = std::list <Vector> (4,Vector(m,Real(0.)));
+    auto eps = Real(1e-12);
+
+    // Stop each system based on its own relative residual
+    typename Optizelle::Unconstrained <Real,Rm>::Functions::Identity I;
+    Optizelle::EmptyGMRESManipulator <Real,Rm> gmanip;
+    auto gmanips = std::list <std::reference_wrapper <
+        Optizelle::GMRESManipulator <Real,Rm> const> > (4,std::cref(gmanip));
+
+    // Solve the systems without restarting
+    auto results = Optizelle::block_gmres <Real,Rm> (
+        A,bs,eps,50,0,I,I,gmanips,xs);
+
+    // The space has dimension five, so it takes three block iterations to
+    // span it when we start from two independent directions
+    auto iter_star = std::vector <Natural> {3,3,3,0};
+    auto result = results.cbegin();
+    auto x = xs.cbegin();
+    auto b = bs.cbegin();
+    for(Natural j=0;j<4;j++) {
+        auto norm_r = Real(0.);
+        auto norm_b = Real(0.);
+        std::tie(norm_r,norm_b) = Unit::residual <Real,Rm>(A,*x,*b);
+        CHECK(result->second == iter_star[j]);
+        CHECK(norm_r <= eps*std::max(norm_b,Real(1.)));
+        CHECK(std::fabs(norm_r-result->first) <= eps);
+        result++;
+        x++;
+        b++;
+    }
+    CHECK(A.batches == 7);
+    CHECK(A.batch_max == 4);
+
+    // The first system matches the one that we solve with plain GMRES
+    auto x_star = Vector({
+        6.71115708873876e-01,
+        1.06789410922663e+00,
+        -1.31466092004730e+00,
+        5.25893325732259e-02,
+        9.35912328721990e-01});
+    auto norm_err = Real(0.);
+    auto norm_xstar = Real(0.);
+    std::tie(norm_err,norm_xstar)=Unit::error <Real,Rm>(xs.front(),x_star);
+    CHECK(norm_err <= Real(1e-10)*norm_xstar);
+
+    // Restart after every iteration on a larger, better conditioned system.
+    // We converge slowly, but the solutions still need to be correct.
+    auto n = Natural(10);
+    auto B = CountedMatrix(Unit::Matrix <Real>::symmetric(n,0));
+    bs = std::list <Vector> {
+        Unit::Vector <Real>::basic(n),
+        Unit::Vector <Real>::alternate(n)};
+    xs.assign(2,Vector(n,Real(0.)));
+    gmanips.pop_back();
+    gmanips.pop_back();
+    results = Optizelle::block_gmres <Real,Rm> (
+        B,bs,eps,500,1,I,I,gmanips,xs);
+    result = results.cbegin();
+    x = xs.cbegin();
+    b = bs.cbegin();
+    for(Natural j=0;j<2;j++) {
+        auto norm_r = Real(0.);
+        auto norm_b = Real(0.);
+        std::tie(norm_r,norm_b) = Unit::residual <Real,Rm>(B,*x,*b);
+        CHECK(result->second > n);
+        CHECK(norm_r <= eps);
+        result++;
+        x++;
+        b++;
+    }
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,75 @@
+// Check that the dense QR solver for the augmented system
+//
+// [ I  A ] [ u ] = [ b1 ]
+// [ A' 0 ] [ v ]   [ b2 ]
+//
+// recovers a known solution and rejects matrices without full column rank
+
+#include "optizelle/optizelle.h"
+#include "unit.h"
+
+// Set some type shortcuts
+typedef double Real;
+typedef Optizelle::Natural Natural;
+
+// Finds || x - y ||
+Real dist(std::vector <Real> const & x,std::vector <Real> const & y) {
+    auto z = Real(0.);
+    for(Natural i=0;i<x.size();i++)
+        z += (x[i]-y[i])*(x[i]-y[i]);
+    return std::sqrt(z);
+}
+
+int main(int argc,char* argv[]){
+    // Create a tall matrix, stored column major
+    //
+    // A = [ 1  2 ]
+    //     [ 0  1 ]
+    //     [ 3 -1 ]
+    //     [ 1  4 ]
+    auto m = Natural(4);
+    auto n = Natural(2);
+    auto A = std::vector <Real> {1.,0.,3.,1.,2.,1.,-1.,4.};
+
+    // Pick a solution and find the right hand side densely
+    auto u_star = std::vector <Real> {1.,-2.,0.5,3.};
+    auto v_star = std::vector <Real> {-1.,2.};
+    auto b1 = u_star;
+    auto b2 = std::vector <Real> (n);
+    for(Natural j=1;j<=n;j++)
+        for(Natural i=1;i<=m;i++) {
+            auto A_ij = A[Optizelle::ijtok(i,j,m)];
+            b1[i-1] += A_ij*v_star[j-1];
+            b2[j-1] += A_ij*u_star[i-1];
+        }
+
+    // Factor the matrix and solve the system
+    Optizelle::DenseAugmentedSystemQR <Real> qr;
+    auto A_copy = A;
+    qr.factor(m,n,A_copy);
+    CHECK(qr.factored);
+    auto u = std::vector <Real> (m);
+    auto v = std::vector <Real> (n);
+    qr.solve(b1.data(),b2.data(),u.data(),v.data());
+    CHECK(dist(u,u_star) <= Real(1e-12));
+    CHECK(dist(v,v_star) <= Real(1e-12));
+
+    // Without any columns, u is just b1
+    qr.factor(m,0,A_copy);
+    CHECK(qr.factored);
+    qr.solve(b1.data(),b2.data(),u.data(),v.data());
+    CHECK(dist(u,b1) == Real(0.));
+
+    // Reject a matrix with two parallel columns
+    auto B = std::vector <Real> {1.,0.,3.,1.,2.,0.,6.,2.};
+    qr.factor(m,n,B);
+    CHECK(!qr.factored);
+
+    // Reject a matrix that's wider than it is tall
+    auto C = std::vector <Real> {1.,0.,0.,1.,1.,1.};
+    qr.factor(2,3,C);
+    CHECK(!qr.factored);
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
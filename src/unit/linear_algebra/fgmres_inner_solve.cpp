@@ -0,0 +1,49 @@
+// Run FGMRES where the right preconditioner is a few iterations of GMRES on
+// the same system.  This preconditioner is not linear, so we need the flexible
+// variant in order to converge to the right solution.  Unpreconditioned, this
+// system takes 20 iterations.
+
+#include "linear_algebra.h"
+#include "spaces.h"
+
+// Approximately inverts a matrix with a fixed number of GMRES iterations
+struct InnerSolve : public Optizelle::Operator <Real,Rm,Rm> {
+    // Matrix that we approximately invert
+    Matrix A;
+
+    // Number of inner iterations
+    Optizelle::Natural iter_max;
+
+    InnerSolve(Matrix const & A_,Optizelle::Natural const & iter_max_) :
+        A(A_), iter_max(iter_max_) {}
+
+    void eval(Vector const & x,Vector & y) const {
+        typename Optizelle::Unconstrained <Real,Rm>::Functions::Identity I;
+        Optizelle::EmptyGMRESManipulator <Real,Rm> gmanip;
+        X::zero(y);
+        Optizelle::gmres <Real,Rm> (A,x,Real(0.),iter_max,0,I,I,gmanip,y);
+    }
+};
+
+int main() {
+    // Setup the problem 
+    auto setup = Unit::gmres <Real,Rm> ();
+
+    setup.m = 20;
+    setup.A = std::make_unique <Matrix>(
+        Unit::Matrix <Real>::symmetric(setup.m,0));
+    setup.b = std::make_unique <Vector> (Unit::Vector <Real>::basic(setup.m));
+    setup.B_right = std::make_unique <InnerSolve>(
+        Unit::Matrix <Real>::symmetric(setup.m,0),5);
+    setup.flexible = true;
+    setup.iter_star = 12;
+
+    setup.check_iter=true;
+    setup.check_res=true;
+
+    // Check the solver 
+    Unit::run_and_verify <Real,Rm> (setup);
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
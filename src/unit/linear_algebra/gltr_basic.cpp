@@ -0,0 +1,51 @@
+// Run GLTR on a positive definite system with an infinite trust-region
+// radius.  This verifies that we recover the solution to the linear system.
+
+#include "linear_algebra.h"
+#include "spaces.h"
+
+int main() {
+    // Problem setup
+    auto m = Unit::Natural(5);
+    auto A = Unit::Matrix <Real>::symmetric(m,0);
+    auto b = Unit::Vector <Real>::basic(m);
+    auto eps = Real(1e-12);
+
+    // Run GLTR
+    auto x = X::init(b);
+    auto x_cp = X::init(b);
+    auto norm_Br0 = Real(0.);
+    auto norm_Br = Real(0.);
+    auto iter = Unit::Natural(0);
+    auto stop = Optizelle::TruncatedStop::NotConverged;
+    auto alpha = Real(0.);
+    Optizelle::gltr <Real,Rm> (
+        A,
+        b,
+        Unit::Operator <Real,Rm>::Identity(),
+        eps,
+        m,
+        std::numeric_limits <Real>::infinity(),
+        Unit::Safeguard <Real,Rm>::none,
+        x,
+        x_cp,
+        norm_Br0,
+        norm_Br,
+        iter,
+        stop,
+        alpha);
+
+    // Check that we converged
+    CHECK(stop == Optizelle::TruncatedStop::RelativeErrorSmall);
+    CHECK(iter <= m);
+    CHECK(norm_Br <= eps*norm_Br0);
+
+    // Check the residual
+    auto norm_r = Real(0.);
+    auto norm_b = Real(0.);
+    std::tie(norm_r,norm_b) = Unit::residual <Real,Rm>(A,x,b);
+    CHECK(norm_r <= Real(1e-8)*norm_b);
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
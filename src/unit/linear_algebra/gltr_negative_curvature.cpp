@@ -0,0 +1,93 @@
+// Run GLTR on an indefinite system.  Truncated CG stops at the trust-region
+// on the first direction of negative curvature whereas GLTR continues.  This
+// verifies that GLTR touches the radius, reports the negative curvature, and
+// finds a step that does at least as well as truncated CG on the model.
+
+#include "linear_algebra.h"
+#include "spaces.h"
+
+// Evaluates the model 0.5 <A x,x> - <b,x>
+Real model(Matrix const & A,Vector const & b,Vector const & x) {
+    auto A_x = X::init(x);
+    A.eval(x,A_x);
+    return Real(0.5)*X::innr(A_x,x)-X::innr(b,x);
+}
+
+int main() {
+    // Problem setup
+    auto m = Unit::Natural(5);
+    auto A = Unit::Matrix <Real>::mostly_dd_indef(m);
+    auto b = Unit::Vector <Real>::basic(m);
+    auto delta = Real(1.);
+    auto eps = Real(1e-12);
+    auto I = Unit::Operator <Real,Rm>::Identity();
+
+    // Run GLTR
+    auto x = X::init(b);
+    auto x_cp = X::init(b);
+    auto norm_Br0 = Real(0.);
+    auto norm_Br = Real(0.);
+    auto iter = Unit::Natural(0);
+    auto stop = Optizelle::TruncatedStop::NotConverged;
+    auto alpha = Real(0.);
+    Optizelle::gltr <Real,Rm> (
+        A,
+        b,
+        I,
+        eps,
+        m,
+        delta,
+        Unit::Safeguard <Real,Rm>::none,
+        x,
+        x_cp,
+        norm_Br0,
+        norm_Br,
+        iter,
+        stop,
+        alpha);
+
+    // Check that we touch the trust-region and detect negative curvature
+    CHECK(stop == Optizelle::TruncatedStop::NegativeCurvature);
+    auto norm_x = std::sqrt(X::innr(x,x));
+    CHECK(std::fabs(norm_x-delta) <= Real(1e-8)*delta);
+
+    // Check that the Cauchy point lies inside the trust-region
+    CHECK(std::sqrt(X::innr(x_cp,x_cp)) <= delta*(Real(1.)+Real(1e-8)));
+
+    // Run truncated CG on the same problem
+    auto x_tcg = X::init(b);
+    auto x_tcg_cp = X::init(b);
+    auto x_offset = X::init(b);
+    X::zero(x_offset);
+    auto failed = Unit::Natural(0);
+    Optizelle::truncated_cg <Real,Rm> (
+        A,
+        b,
+        I,
+        eps,
+        Real(0.),
+        m,
+        1,
+        1,
+        delta,
+        x_offset,
+        std::numeric_limits <Unit::Natural>::max(),
+        Unit::Safeguard <Real,Rm>::none,
+        false,
+        false,
+        false,
+        x_tcg,
+        x_tcg_cp,
+        norm_Br0,
+        norm_Br,
+        iter,
+        stop,
+        failed,
+        alpha);
+
+    // Check that GLTR does at least as well as truncated CG
+    CHECK(model(A,b,x) <= model(A,b,x_tcg));
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
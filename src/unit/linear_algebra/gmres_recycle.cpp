@@ -0,0 +1,55 @@
+// Run GMRES several times while recycling the correction from the prior
+// solves.  Resolving the same system should take no iterations and a new
+// right hand side should need fewer iterations than the size of the space
+// since the Krylov space only has to cover the complement of the recycled
+// images.
+
+#include "linear_algebra.h"
+#include "spaces.h"
+
+int main() {
+    // Setup the problem 
+    auto setup = Unit::gmres <Real,Rm> ();
+
+    setup.A = std::make_unique <Matrix>(
+        Unit::Matrix <Real>::nonsymmetric(setup.m,0));
+    setup.b = std::make_unique <Vector> (Unit::Vector <Real>::basic(setup.m));
+    setup.B_left = std::make_unique <Matrix>(
+        Unit::Matrix <Real>::nonsymmetric(setup.m,30));
+    setup.recycle = std::make_unique <Optizelle::GMRESRecycle <Real,Rm>>(3);
+
+    setup.x_star = std::make_unique <Vector> (Vector({
+        6.71115708873876e-01,
+        1.06789410922663e+00,
+        -1.31466092004730e+00,
+        5.25893325732259e-02,
+        9.35912328721990e-01}));
+    setup.iter_star = 5;
+
+    setup.check_sol=true;
+    setup.check_iter=true;
+    setup.check_res=true;
+
+    // Check the solver 
+    Unit::run_and_verify <Real,Rm> (setup);
+    CHECK(setup.recycle->Us.size() == 1);
+
+    // Resolve the same system after marking the images out of date.  The
+    // recycled direction is the solution, so we should be done immediately.
+    Rm <Real>::zero(*setup.x);
+    setup.recycle->stale();
+    setup.iter_star = 0;
+    Unit::run_and_verify <Real,Rm> (setup);
+
+    // Solve with a new right hand side
+    Rm <Real>::zero(*setup.x);
+    setup.b = std::make_unique <Vector> (
+        Unit::Vector <Real>::alternate(setup.m));
+    setup.iter_star = 4;
+    setup.check_sol=false;
+    Unit::run_and_verify <Real,Rm> (setup);
+    CHECK(setup.recycle->Us.size() == 2);
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
@@ -478,6 +478,12 @@ namespace Unit {
         // GMRES manipulator
         std::unique_ptr <Optizelle::GMRESManipulator <Real,XX>> gmanip;
 
+        // Recycled subspace
+        std::unique_ptr <Optizelle::GMRESRecycle <Real,XX>> recycle;
+
+        // Whether to use flexible GMRES
+        bool flexible;
+
         // Setup some simple parameters
         gmres():
             Solver <Real,XX> (),
@@ -486,6 +492,30 @@ namespace Unit {
                 Functions::Identity()),
             B_right(new typename Optizelle::Unconstrained <Real,XX>::
                 Functions::Identity()),
+            gmanip(new Optizelle::EmptyGMRESManipulator <Real,XX>()),
+            recycle(new Optizelle::GMRESRecycle <Real,XX>(0)),
+            flexible(false)
+        {}
+    };
+
+    // Base MINRES setup 
+    template <typename Real,template <typename> class XX>
+    struct minres : public Solver <Real,XX> {
+        // Type shortcuts
+        typedef XX <Real> X;
+        typedef typename X::Vector X_Vector;
+
+        // Preconditioner
+        std::unique_ptr <Optizelle::Operator <Real,XX,XX>> B;
+
+        // Manipulator for the stopping tolerance
+        std::unique_ptr <Optizelle::GMRESManipulator <Real,XX>> gmanip;
+
+        // Setup some simple parameters
+        minres():
+            Solver <Real,XX> (),
+            B(new typename Optizelle::Unconstrained <Real,XX>::
+                Functions::Identity()),
             gmanip(new Optizelle::EmptyGMRESManipulator <Real,XX>())
         {}
     };
@@ -500,6 +530,9 @@ namespace Unit {
         // Trust-region radius 
         Real delta; 
 
+        // Tolerance for the Nash-Sofer model-decrease test
+        Real eps_model;
+
         // Preconditioners
         std::unique_ptr <Optizelle::Operator <Real,XX,XX>> B;
 
@@ -555,6 +588,7 @@ namespace Unit {
         tcg():
             Solver <Real,XX> (),
             delta(std::numeric_limits <Real>::infinity()),
+            eps_model(0.),
             B(new typename Optizelle::Unconstrained <Real,XX>::
                 Functions::Identity()),
             x_offset(),
@@ -592,14 +626,77 @@ namespace Unit {
 
         // Solve this linear system
         auto err = Real(0.);
-        std::tie(err,setup.iter) = Optizelle::gmres <Real,XX> (
+        if(setup.flexible)
+            std::tie(err,setup.iter) = Optizelle::fgmres <Real,XX> (
+                *setup.A,
+                *setup.b,
+                setup.eps,
+                setup.iter_max,
+                setup.rst_freq,
+                *setup.B_left,
+                *setup.B_right,
+                *setup.gmanip,
+                *setup.recycle,
+                *setup.x);
+        else
+            std::tie(err,setup.iter) = Optizelle::gmres <Real,XX> (
+                *setup.A,
+                *setup.b,
+                setup.eps,
+                setup.iter_max,
+                setup.rst_freq,
+                *setup.B_left,
+                *setup.B_right,
+                *setup.gmanip,
+                *setup.recycle,
+                *setup.x);
+
+        // Check that the number of iterations matches 
+        if(setup.check_iter)
+            CHECK(setup.iter == setup.iter_star);
+
+        // Check the residual is less than our tolerance.  We do this two
+        // different ways in case our solver is lying to us.
+        if(setup.check_res) {
+            CHECK(err < setup.eps_res);
+            auto norm_r = Real(0.);
+            auto norm_b = Real(0.);
+            std::tie(norm_r,norm_b) =
+                residual <Real,XX>(*setup.A,*setup.x,*setup.b);
+            CHECK(norm_r <= setup.eps_res*norm_b);
+            CHECK(std::fabs(norm_r-err) <= setup.eps_res);
+        }
+
+        // Check that the solution is correct
+        if(setup.check_sol) {
+            auto norm_r = Real(0.);
+            auto norm_xstar = Real(0.);
+            std::tie(norm_r,norm_xstar)=error <Real,XX>(*setup.x,*setup.x_star);
+            CHECK(norm_r <= setup.eps_sol*norm_xstar);
+        }
+    }
+
+    // Run and verify the problem setup 
+    template <typename Real,template <typename> class XX>
+    void run_and_verify(minres <Real,XX> & setup) {
+        // Type shortcuts
+        typedef XX <Real> X;
+        typedef typename X::Vector X_Vector;
+
+        // Fill in some pieces if they're missing
+        if(!setup.x) {
+            setup.x = std::make_unique <X_Vector> (X::init(*setup.b));
+            X::zero(*setup.x);
+        }
+
+        // Solve this linear system
+        auto err = Real(0.);
+        std::tie(err,setup.iter) = Optizelle::minres <Real,XX> (
             *setup.A,
             *setup.b,
             setup.eps,
             setup.iter_max,
-            setup.rst_freq,
-            *setup.B_left,
-            *setup.B_right,
+            *setup.B,
             *setup.gmanip,
             *setup.x);
 
@@ -660,6 +757,7 @@ namespace Unit {
             *setup.b,
             *setup.B,
             setup.eps,
+            setup.eps_model,
             setup.iter_max,
             setup.orthog_storage_max,
             setup.orthog_iter_max,
@@ -0,0 +1,32 @@
+// Run MINRES on a symmetric indefinite system.  Since the system is small, we
+// should converge in at most the size of the system.
+
+#include "linear_algebra.h"
+#include "spaces.h"
+
+int main() {
+    // Setup the problem 
+    auto setup = Unit::minres <Real,Rm> ();
+
+    setup.A = std::make_unique <Matrix>(
+        Unit::Matrix <Real>::mostly_dd_indef(setup.m));
+    setup.b = std::make_unique <Vector> (Unit::Vector <Real>::basic(setup.m));
+
+    setup.x_star = std::make_unique <Vector> (Vector({
+        -2.26121482635960e-01,
+        1.94676357056722e-01,
+        -4.55370040211320e-01,
+        -2.46542142947648e-01,
+        2.00396796417616e-01}));
+    setup.iter_star = 5;
+
+    setup.check_sol=true;
+    setup.check_iter=true;
+    setup.check_res=true;
+
+    // Check the solver 
+    Unit::run_and_verify <Real,Rm> (setup);
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
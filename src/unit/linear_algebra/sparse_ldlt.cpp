@@ -0,0 +1,114 @@
+// Check the sparse LDL' factorization on an arrowhead matrix, which has a
+// large elimination tree once ordered, and then check that iterative
+// refinement with the regularized augmented system converges to the solution
+// of the original augmented system
+
+#include "optizelle/optizelle.h"
+#include "unit.h"
+
+// Set some type shortcuts
+typedef double Real;
+typedef Optizelle::Natural Natural;
+
+// Computes y = A x for a CSR matrix
+std::vector <Real> matvec(
+    Optizelle::CSRMatrix <Real> const & A,
+    std::vector <Real> const & x
+) {
+    auto y = std::vector <Real> (A.m);
+    Optizelle::csrmv <Real> (Real(1.),A,x.data(),Real(0.),y.data());
+    return y;
+}
+
+// Finds || x - y ||
+Real dist(std::vector <Real> const & x,std::vector <Real> const & y) {
+    auto z = Real(0.);
+    for(Natural i=0;i<x.size();i++)
+        z += (x[i]-y[i])*(x[i]-y[i]);
+    return std::sqrt(z);
+}
+
+int main(int argc,char* argv[]){
+    // Create a symmetric positive definite arrowhead matrix where the last
+    // row is dense.  In the natural order, this fills in completely.
+    auto n = Natural(200);
+    auto A = Optizelle::CSRMatrix <Real> (n,n);
+    for(Natural i=0;i<n;i++) {
+        if(i+1 < n) {
+            A.cols.emplace_back(i);
+            A.vals.emplace_back(Real(4.));
+            A.cols.emplace_back(n-1);
+            A.vals.emplace_back(Real(1.));
+        } else {
+            for(Natural j=0;j+1<n;j++) {
+                A.cols.emplace_back(j);
+                A.vals.emplace_back(Real(1.));
+            }
+            A.cols.emplace_back(n-1);
+            A.vals.emplace_back(Real(2.*n));
+        }
+        A.offsets[i+1] = A.cols.size();
+    }
+
+    // Factor the matrix and solve a system
+    Optizelle::SparseLDLT <Real> ldlt;
+    ldlt.analyze(A);
+    ldlt.factor(A,std::vector <Real> (n,Real(1.)),Real(1e-300));
+    auto x_star = std::vector <Real> (n);
+    for(Natural i=0;i<n;i++)
+        x_star[i] = Real(1.)+Real(i)/Real(n);
+    auto x = matvec(A,x_star);
+    ldlt.solve(x.data());
+
+    // Make sure we didn't need to perturb the pivots and that our ordering
+    // caused no fill
+    CHECK(ldlt.perturbed == 0);
+    CHECK(ldlt.Lp.back() == n-1);
+    CHECK(ldlt.subtrees.size() > 1);
+    CHECK(dist(x,x_star) <= Real(1e-12));
+
+    // Create a sparse Jacobian
+    //
+    // J = [ 1 0 2 0 0 ]
+    //     [ 0 3 0 0 1 ]
+    //     [ 1 0 0 1 1 ]
+    auto J = Optizelle::CSRMatrix <Real> (3,5);
+    J.offsets = {0,2,4,7};
+    J.cols = {0,2,1,4,0,3,4};
+    J.vals = {1.,2.,3.,1.,1.,1.,1.};
+    auto Jt = Optizelle::CSRMatrix <Real> ();
+    Optizelle::csrtrans <Real> (J,Jt);
+
+    // Factor the augmented system
+    Optizelle::SparseAugmentedSystemLDLT <Real> augsys;
+    augsys.factor(J,Jt);
+    CHECK(augsys.ldlt.perturbed == 0);
+
+    // Solve [I J'; J 0] [u;v] = [b1;b2] with iterative refinement
+    auto b1 = std::vector <Real> {1.,-1.,2.,0.5,3.};
+    auto b2 = std::vector <Real> {-2.,1.,0.25};
+    auto u = std::vector <Real> (5,Real(0.));
+    auto v = std::vector <Real> (3,Real(0.));
+    auto r1 = b1;
+    auto r2 = b2;
+    auto du = std::vector <Real> (5);
+    auto dv = std::vector <Real> (3);
+    auto norm_r = Real(0.);
+    for(Natural iter=1;iter<=5;iter++) {
+        augsys.solve(r1.data(),r2.data(),du.data(),dv.data());
+        for(Natural i=0;i<5;i++) u[i] += du[i];
+        for(Natural i=0;i<3;i++) v[i] += dv[i];
+
+        // r1 = b1 - u - J' v, r2 = b2 - J u
+        auto Jtv = matvec(Jt,v);
+        auto Ju = matvec(J,u);
+        for(Natural i=0;i<5;i++) r1[i] = b1[i]-u[i]-Jtv[i];
+        for(Natural i=0;i<3;i++) r2[i] = b2[i]-Ju[i];
+        norm_r = std::sqrt(std::pow(dist(r1,std::vector <Real> (5)),2)
+            + std::pow(dist(r2,std::vector <Real> (3)),2));
+    }
+    CHECK(norm_r <= Real(1e-13));
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,32 @@
+// Run TCG with the Nash-Sofer model-decrease test.  This verifies that we
+// exit early once the relative decrease in the CG objective becomes small
+// even though the residual remains large.
+
+#include "linear_algebra.h"
+#include "spaces.h"
+
+int main() {
+    // Setup the problem 
+    auto setup = Unit::tcg <Real,Rm> ();
+
+    // Problem setup 
+    setup.A = std::make_unique <Matrix>(
+        Unit::Matrix <Real>::symmetric(setup.m,0));
+    setup.b = std::make_unique <Vector> (Unit::Vector <Real>::basic(setup.m));
+    setup.eps_model = Real(0.5);
+
+    // Target solutions
+    setup.stop_star = Optizelle::TruncatedStop::ModelDecreaseSmall;
+
+    // Tests
+    setup.check_stop = true;
+
+    // Check the solver 
+    Unit::run_and_verify <Real,Rm> (setup);
+
+    // Make sure that we exited early
+    CHECK(setup.iter < setup.m);
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
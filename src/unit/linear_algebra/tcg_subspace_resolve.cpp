@@ -0,0 +1,86 @@
+// Record the Krylov subspace generated by TCG and then resolve the
+// trust-region subproblem inside of it.  With a large radius, this should
+// reproduce the TCG solution.  With a small radius, the solution should touch
+// the radius and do at least as well as a scaled TCG step.
+
+#include "linear_algebra.h"
+#include "spaces.h"
+
+// Evaluates the model 0.5 <A x,x> - <b,x>
+Real model(Matrix const & A,Vector const & b,Vector const & x) {
+    auto A_x = X::init(x);
+    A.eval(x,A_x);
+    return Real(0.5)*X::innr(A_x,x)-X::innr(b,x);
+}
+
+int main() {
+    // Problem setup
+    auto m = Unit::Natural(5);
+    auto A = Unit::Matrix <Real>::symmetric(m,0);
+    auto b = Unit::Vector <Real>::basic(m);
+    auto iter_max = Unit::Natural(3);
+
+    // Run TCG and record the subspace
+    Optizelle::RecordedOperator <Real,Rm> A_rec(A,iter_max);
+    auto x = X::init(b);
+    auto x_cp = X::init(b);
+    auto x_offset = X::init(b);
+    X::zero(x_offset);
+    auto norm_Br0 = Real(0.);
+    auto norm_Br = Real(0.);
+    auto iter = Unit::Natural(0);
+    auto stop = Optizelle::TruncatedStop::NotConverged;
+    auto failed = Unit::Natural(0);
+    auto alpha = Real(0.);
+    Optizelle::truncated_cg <Real,Rm> (
+        A_rec,
+        b,
+        Unit::Operator <Real,Rm>::Identity(),
+        Real(1e-16),
+        Real(0.),
+        iter_max,
+        1,
+        1,
+        std::numeric_limits <Real>::infinity(),
+        x_offset,
+        std::numeric_limits <Unit::Natural>::max(),
+        Unit::Safeguard <Real,Rm>::none,
+        false,
+        false,
+        false,
+        x,
+        x_cp,
+        norm_Br0,
+        norm_Br,
+        iter,
+        stop,
+        failed,
+        alpha);
+    CHECK(stop == Optizelle::TruncatedStop::MaxItersExceeded);
+    CHECK(A_rec.vs.size() == iter_max);
+    auto norm_x = std::sqrt(X::innr(x,x));
+
+    // With a large radius, we should recover the TCG solution
+    auto x_sub = X::init(b);
+    Optizelle::trust_region_subspace <Real,Rm> (
+        A_rec.vs,A_rec.Avs,b,Real(1e10),x_sub);
+    auto err = Real(0.);
+    auto norm_xx = Real(0.);
+    std::tie(err,norm_xx) = Unit::error <Real,Rm> (x_sub,x);
+    CHECK(err <= Real(1e-8)*norm_xx);
+
+    // With a smaller radius, we should touch the radius and beat the
+    // scaled TCG step
+    auto delta = Real(0.5)*norm_x;
+    Optizelle::trust_region_subspace <Real,Rm> (
+        A_rec.vs,A_rec.Avs,b,delta,x_sub);
+    auto norm_x_sub = std::sqrt(X::innr(x_sub,x_sub));
+    CHECK(std::fabs(norm_x_sub-delta) <= Real(1e-8)*delta);
+    auto x_scaled = X::init(b);
+    X::copy(x,x_scaled);
+    X::scal(delta/norm_x,x_scaled);
+    CHECK(model(A,b,x_sub) <= model(A,b,x_scaled));
+
+    // Declare success
+    return EXIT_SUCCESS;
+}
@@ -84,6 +84,7 @@ int main() {
     CHECK(state.x_old.size()==0);
     CHECK(state.grad_old.size()==0);
     CHECK(state.dx_old.size()==0);
+    CHECK(state.grad_xpdx.size()==0);
     CHECK(state.oldY.size()==0);
     CHECK(state.oldS.size()==0);
     CHECK(state.y.size()==0);
@@ -101,11 +102,12 @@ int main() {
     CHECK(state.z.size()==0);
     CHECK(state.dz.size()==0);
     CHECK(state.h_x.size()==0);
+    CHECK(state.comp_target.size()==0);
     
     // Check that we have the correct number of vectors
-    CHECK(xs.size() == 14);
+    CHECK(xs.size() == 15);
     CHECK(ys.size() == 5);
-    CHECK(zs.size() == 3);
+    CHECK(zs.size() == 4);
     
     // Modify some vectors 
     xs.front().second = x0;
@@ -125,6 +127,7 @@ int main() {
     CHECK(state.x_old.size()>0);
     CHECK(state.grad_old.size()>0);
     CHECK(state.dx_old.size()>0);
+    CHECK(state.grad_xpdx.size()>0);
     CHECK(state.y.size()>0);
     CHECK(state.g_x.size()>0);
     CHECK(state.gpxdxn_p_gx.size()>0);
@@ -140,6 +143,7 @@ int main() {
     CHECK(state.z.size()>0);
     CHECK(state.dz.size()>0);
     CHECK(state.h_x.size()>0);
+    CHECK(state.comp_target.size()>0);
 
     // Check the relative error between the vector created above and the one
     // left in the state.  
@@ -78,6 +78,7 @@ int main() {
     CHECK(state.x_old.size()==0);
     CHECK(state.grad_old.size()==0);
     CHECK(state.dx_old.size()==0);
+    CHECK(state.grad_xpdx.size()==0);
     CHECK(state.oldY.size()==0);
     CHECK(state.oldS.size()==0);
     CHECK(state.y.size()==0);
@@ -94,7 +95,7 @@ int main() {
     CHECK(state.H_dxtuncorrected.size()==0);
 
     // Check that we have the correct number of vectors
-    CHECK(xs.size() == 14);
+    CHECK(xs.size() == 15);
     CHECK(ys.size() == 5);
     
     // Modify some vectors 
@@ -114,6 +115,7 @@ int main() {
     CHECK(state.x_old.size()>0);
     CHECK(state.grad_old.size()>0);
     CHECK(state.dx_old.size()>0);
+    CHECK(state.grad_xpdx.size()>0);
     CHECK(state.y.size()>0);
     CHECK(state.g_x.size()>0);
     CHECK(state.gpxdxn_p_gx.size()>0);
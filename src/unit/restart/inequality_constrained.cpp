@@ -78,15 +78,17 @@ int main() {
     CHECK(state.x_old.size()==0);
     CHECK(state.grad_old.size()==0);
     CHECK(state.dx_old.size()==0);
+    CHECK(state.grad_xpdx.size()==0);
     CHECK(state.oldY.size()==0);
     CHECK(state.oldS.size()==0);
     CHECK(state.z.size()==0);
     CHECK(state.dz.size()==0);
     CHECK(state.h_x.size()==0);
+    CHECK(state.comp_target.size()==0);
     
     // Check that we have the correct number of vectors
-    CHECK(xs.size() == 6);
-    CHECK(zs.size() == 3);
+    CHECK(xs.size() == 7);
+    CHECK(zs.size() == 4);
     
     // Modify some vectors 
     xs.front().second = x0;
@@ -105,9 +107,11 @@ int main() {
     CHECK(state.x_old.size()>0);
     CHECK(state.grad_old.size()>0);
     CHECK(state.dx_old.size()>0);
+    CHECK(state.grad_xpdx.size()>0);
     CHECK(state.z.size()>0);
     CHECK(state.dz.size()>0);
     CHECK(state.h_x.size()>0);
+    CHECK(state.comp_target.size()>0);
 
     // Check the relative error between the vector created above and the one
     // left in the state.  
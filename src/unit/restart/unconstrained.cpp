@@ -97,11 +97,12 @@ int main() {
     CHECK(state.x_old.size()==0);
     CHECK(state.grad_old.size()==0);
     CHECK(state.dx_old.size()==0);
+    CHECK(state.grad_xpdx.size()==0);
     CHECK(state.oldY.size()==0);
     CHECK(state.oldS.size()==0);
 
     // Check that we have the correct number of vectors
-    CHECK(xs.size() == 6);
+    CHECK(xs.size() == 7);
 
     // Modify some vectors 
     xs.front().second = x0;
@@ -119,6 +120,7 @@ int main() {
     CHECK(state.x_old.size()>0);
     CHECK(state.grad_old.size()>0);
     CHECK(state.dx_old.size()>0);
+    CHECK(state.grad_xpdx.size()>0);
 
     // Check the relative error between the vector created above and the one
     // left in the state